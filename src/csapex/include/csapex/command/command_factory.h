@@ -8,6 +8,7 @@
 #include <csapex/command/command_fwd.h>
 #include <csapex/utility/uuid.h>
 #include <csapex/model/connector_type.h>
+#include <csapex/model/connection.h>
 #include <csapex/csapex_command_export.h>
 #include <csapex/scheduling/scheduling_fwd.h>
 
@@ -40,6 +41,7 @@ public:
 
 
     CommandPtr setConnectionActive(int connection, bool active);
+    CommandPtr setConnectionOverflowPolicy(int connection, Connection::OverflowPolicy policy);
 
     CommandPtr deleteConnectionFulcrumCommand(int connection, int fulcrum);
     CommandPtr deleteAllConnectionFulcrumsCommand(int connection);
@@ -63,6 +65,19 @@ public:
 
     CommandPtr deleteThreadGroup(csapex::ThreadGroup * group);
 
+    /**
+     * @brief partitionThreads creates a command that distributes all nodes onto new thread groups,
+     *        balanced by their profiled execution time and grouped by their connections
+     * @param groups the number of thread groups to create, e.g. the number of cores
+     */
+    CommandPtr partitionThreads(std::size_t groups);
+
+    /**
+     * @brief placeThreadsOnNumaNodes creates a command that restricts every thread group to one NUMA node,
+     *        so that groups exchanging messages run on the same node where possible
+     */
+    CommandPtr placeThreadsOnNumaNodes();
+
 private:
     GraphFacade* getGraphFacade() const;
 
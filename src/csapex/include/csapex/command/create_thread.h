@@ -15,7 +15,7 @@ class CSAPEX_COMMAND_EXPORT CreateThread : public CommandImplementation<CreateTh
     COMMAND_HEADER(CreateThread);
 
 public:
-    CreateThread(const AUUID &graph_uuid, const UUID& node, const std::string &name);
+    CreateThread(const AUUID &graph_uuid, const UUID& node, const std::string &name, int id = -1);
 
     virtual std::string getDescription() const override;
 
@@ -4,6 +4,7 @@
 /// COMPONENT
 #include "command_impl.hpp"
 #include <csapex/data/point.h>
+#include <csapex/model/connection.h>
 
 namespace csapex
 {
@@ -16,6 +17,7 @@ class CSAPEX_COMMAND_EXPORT ModifyConnection : public CommandImplementation<Modi
 
 public:
     ModifyConnection(const AUUID &graph_uuid, int connection_id, bool active);
+    ModifyConnection(const AUUID &graph_uuid, int connection_id, Connection::OverflowPolicy policy);
 
     virtual std::string getDescription() const override;
 
@@ -27,11 +29,21 @@ protected:
     bool doUndo() override;
     bool doRedo() override;
 
+private:
+    enum class Property {
+        ACTIVE,
+        OVERFLOW_POLICY
+    };
+
 private:
     int connection_id;
+    Property property;
 
     bool was_active;
     bool active;
+
+    Connection::OverflowPolicy previous_policy;
+    Connection::OverflowPolicy policy;
 };
 
 }
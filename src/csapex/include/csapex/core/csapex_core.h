@@ -103,6 +103,12 @@ private:
     CsApexCore(Settings& settings_, ExceptionHandler &handler, PluginLocatorPtr plugin_locator);
     CorePluginPtr makeCorePlugin(const std::string& name);
 
+    void startCompiledExecution();
+    void stopCompiledExecution();
+
+    void startOperatorFusion();
+    void stopOperatorFusion();
+
 private:
     bool is_root_;
 
@@ -114,6 +120,10 @@ private:
     SnippetFactoryPtr snippet_factory_;
 
     ThreadPoolPtr thread_pool_;
+    InlineExecutorPtr inline_executor_;
+    Executor* executor_;
+    ExecutionPlanPtr execution_plan_;
+    OperatorFusionPtr operator_fusion_;
 
     UUIDProviderPtr root_uuid_provider_;
     GraphFacadePtr root_;
@@ -3,6 +3,7 @@
 
 /// COMPONENT
 #include <csapex/model/graph.h>
+#include <csapex/model/connection.h>
 
 /// PROJECT
 #include <csapex/factory/factory_fwd.h>
@@ -61,6 +62,9 @@ private:
 
     void sendNotification(const std::string& notification);
 
+    static std::string overflowPolicyToString(Connection::OverflowPolicy policy);
+    static Connection::OverflowPolicy overflowPolicyFromString(const std::string& policy);
+
 protected:
     void saveNodes(YAML::Node &yaml, const std::vector<NodeHandle *> &nodes);
     void saveConnections(YAML::Node &yaml, const std::vector<ConnectionPtr> &connections);
@@ -68,7 +72,8 @@ protected:
     void serializeNode(YAML::Node& doc, NodeHandle* node_handle);
     void deserializeNode(const YAML::Node& doc, NodeFacadeLocalPtr node_handle);
 
-    void loadConnection(ConnectablePtr from, const UUID &to_uuid, const std::string& connection_type);
+    void loadConnection(ConnectablePtr from, const UUID &to_uuid, const std::string& connection_type,
+                        std::size_t capacity = 1, Connection::OverflowPolicy policy = Connection::OverflowPolicy::BLOCK);
 
     UUID readNodeUUID(std::weak_ptr<UUIDProvider> parent, const YAML::Node& doc);
     UUID readConnectorUUID(std::weak_ptr<UUIDProvider> parent, const YAML::Node& doc);
@@ -14,7 +14,7 @@ namespace csapex
 class Feedback : public Response
 {
 public:
-    Feedback(const std::string& message, uint8_t request_id);
+    Feedback(const std::string& message, uint32_t request_id);
     Feedback(const std::string& message);
 
     static const uint8_t PACKET_TYPE_ID = 6;
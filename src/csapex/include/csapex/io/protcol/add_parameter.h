@@ -17,7 +17,7 @@ public:
     {
     public:
         ParameterRequest(const AUUID& id, const std::string &name, const std::string &description, boost::any value, bool persistent);
-        ParameterRequest(uint8_t request_id);
+        ParameterRequest(uint32_t request_id);
 
         virtual void serialize(SerializationBuffer &data) const override;
         virtual void deserialize(SerializationBuffer& data) override;
@@ -41,8 +41,8 @@ public:
     class ParameterResponse : public ResponseImplementation<ParameterResponse>
     {
     public:
-        ParameterResponse(const param::ParameterConstPtr &parameter, uint8_t request_id);
-        ParameterResponse(uint8_t request_id);
+        ParameterResponse(const param::ParameterConstPtr &parameter, uint32_t request_id);
+        ParameterResponse(uint32_t request_id);
 
         virtual void serialize(SerializationBuffer &data) const override;
         virtual void deserialize(SerializationBuffer& data) override;
@@ -30,7 +30,7 @@ public:
     class CommandRequest : public RequestImplementation<CommandRequest>
     {
     public:
-        CommandRequest(uint8_t request_id);
+        CommandRequest(uint32_t request_id);
         CommandRequest(CommandRequestType request_type);
 
         CommandRequest(CommandRequestType request_type, const CommandPtr& param)
@@ -43,6 +43,7 @@ public:
         virtual void deserialize(SerializationBuffer& data) override;
 
         virtual ResponsePtr execute(CsApexCore& core) const override;
+        virtual bool isReadOnly() const override;
 
         std::string getType() const override
         {
@@ -59,9 +60,9 @@ public:
     class CommandResponse : public ResponseImplementation<CommandResponse>
     {
     public:
-        CommandResponse(uint8_t request_id);
-        CommandResponse(CommandRequestType request_type, uint8_t request_id);
-        CommandResponse(CommandRequestType request_type, bool result, uint8_t request_id);
+        CommandResponse(uint32_t request_id);
+        CommandResponse(CommandRequestType request_type, uint32_t request_id);
+        CommandResponse(CommandRequestType request_type, bool result, uint32_t request_id);
 
         virtual void serialize(SerializationBuffer &data) const override;
         virtual void deserialize(SerializationBuffer& data) override;
@@ -31,13 +31,16 @@ public:
         CoreSendNotification,
 
         CoreGetPause,
-        CoreGetSteppingMode
+        CoreGetSteppingMode,
+
+        CoreGetSchedulerTelemetry,
+        CoreResetSchedulerTelemetry
     };
 
     class CoreRequest : public RequestImplementation<CoreRequest>
     {
     public:
-        CoreRequest(uint8_t request_id);
+        CoreRequest(uint32_t request_id);
         CoreRequest(CoreRequestType request_type);
 
         template <typename... Args>
@@ -51,6 +54,7 @@ public:
         virtual void deserialize(SerializationBuffer& data) override;
 
         virtual ResponsePtr execute(CsApexCore& core) const override;
+        virtual bool isReadOnly() const override;
 
         std::string getType() const override
         {
@@ -67,9 +71,9 @@ public:
     class CoreResponse : public ResponseImplementation<CoreResponse>
     {
     public:
-        CoreResponse(uint8_t request_id);
-        CoreResponse(CoreRequestType request_type, uint8_t request_id);
-        CoreResponse(CoreRequestType request_type, boost::any result, uint8_t request_id);
+        CoreResponse(uint32_t request_id);
+        CoreResponse(CoreRequestType request_type, uint32_t request_id);
+        CoreResponse(CoreRequestType request_type, boost::any result, uint32_t request_id);
 
         virtual void serialize(SerializationBuffer &data) const override;
         virtual void deserialize(SerializationBuffer& data) override;
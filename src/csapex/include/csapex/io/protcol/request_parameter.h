@@ -17,12 +17,13 @@ public:
     {
     public:
         ParameterRequest(const AUUID& id);
-        ParameterRequest(uint8_t request_id);
+        ParameterRequest(uint32_t request_id);
 
         virtual void serialize(SerializationBuffer &data) const override;
         virtual void deserialize(SerializationBuffer& data) override;
 
         virtual ResponsePtr execute(CsApexCore& core) const override;
+        virtual bool isReadOnly() const override;
 
         std::string getType() const override
         {
@@ -37,8 +38,8 @@ public:
     class ParameterResponse : public ResponseImplementation<ParameterResponse>
     {
     public:
-        ParameterResponse(const param::ParameterConstPtr &parameter, uint8_t request_id);
-        ParameterResponse(uint8_t request_id);
+        ParameterResponse(const param::ParameterConstPtr &parameter, uint32_t request_id);
+        ParameterResponse(uint32_t request_id);
 
         virtual void serialize(SerializationBuffer &data) const override;
         virtual void deserialize(SerializationBuffer& data) override;
@@ -15,7 +15,7 @@ namespace csapex
 class Request : public Serializable
 {
 public:
-    Request(uint8_t id);
+    Request(uint32_t id);
 
     static const uint8_t PACKET_TYPE_ID = 2;
 
@@ -24,11 +24,17 @@ public:
 
     virtual ResponsePtr execute(CsApexCore& core) const = 0;
 
-    void overwriteRequestID(uint8_t id) const;
-    uint8_t getRequestID() const;
+    /**
+     * @brief isReadOnly tells whether the request leaves the core untouched.
+     *        Only read only requests may be handled concurrently, all others are handled in the order they arrived.
+     */
+    virtual bool isReadOnly() const;
+
+    void overwriteRequestID(uint32_t id) const;
+    uint32_t getRequestID() const;
 
 private:
-    mutable uint8_t request_id_;
+    mutable uint32_t request_id_;
 };
 
 }
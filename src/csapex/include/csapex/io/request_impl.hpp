@@ -12,7 +12,7 @@ template <typename I>
 class RequestImplementation : public Request
 {
 protected:
-    RequestImplementation(uint8_t id)
+    RequestImplementation(uint32_t id)
         : Request(id)
     {
     }
@@ -12,7 +12,7 @@ template <typename I>
 class ResponseImplementation : public Response
 {
 protected:
-    ResponseImplementation(uint8_t id)
+    ResponseImplementation(uint32_t id)
         : Response(id)
     {
     }
@@ -9,21 +9,67 @@
 
 /// SYSTEM
 #include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
 #include <deque>
+#include <functional>
 #include <future>
+#include <thread>
+#include <vector>
 
 namespace csapex
 {
 
+/**
+ * @brief The Session class exchanges packets over a tcp socket.
+ *        Packets are read asynchronously and handled by a pool of handler threads.
+ *        Read only requests may be handled concurrently, all other packets are handled one after another in the order they arrived.
+ *        A read only request never overtakes a packet that arrived before it.
+ *        Any number of requests can be in flight, with a request timeout each of them times out independently.
+ */
 class Session : public Observer, public std::enable_shared_from_this<Session>
 {
 public:
-  Session(boost::asio::ip::tcp::socket socket);
+  struct WriteStatistics
+  {
+      uint64_t bytes;
+      uint64_t packets;
+
+      /// calls to write_some on the socket, each of them is a single (vectored) write
+      uint64_t syscalls;
+  };
+
+public:
+  Session(boost::asio::ip::tcp::socket socket, std::size_t handler_threads = 4);
   ~Session();
 
   void start();
   void stop();
 
+  /**
+   * @brief setRequestTimeout sets how long sendRequest waits for a response, zero waits indefinitely.
+   *        By default, requests never time out. With a timeout, sendRequest returns nullptr for late responses,
+   *        so only callers that handle a missing response should set one.
+   */
+  void setRequestTimeout(std::chrono::milliseconds timeout);
+  std::chrono::milliseconds getRequestTimeout() const;
+
+  /**
+   * @brief setWriteCoalescing configures how outgoing packets are batched.
+   *        Packets are collected until flush_threshold bytes are pending or the oldest of them has waited for linger.
+   *        A batch is sent with a single vectored write, packets written meanwhile form the next batch.
+   *        A linger of zero sends right away, unless a write is still in progress.
+   */
+  void setWriteCoalescing(std::size_t flush_threshold, std::chrono::microseconds linger);
+  WriteStatistics getWriteStatistics() const;
+
+  /**
+   * @brief setRequestHandler installs a handler for incoming requests, it has to be set before start() is called.
+   *        The handler is called concurrently for read only requests, other requests are passed to it one at a time.
+   *        Without a handler, requests are emitted by packet_received, which handles one packet at a time.
+   */
+  void setRequestHandler(std::function<void(const RequestConstPtr&)> handler);
+
   void write(const SerializableConstPtr &packet);
   void write(const std::string &message);
 
@@ -64,23 +110,61 @@ public:
   slim_signal::Signal<void(SerializableConstPtr)> packet_received;
   slim_signal::Signal<void(BroadcastMessageConstPtr)> broadcast_received;
 
+private:
+  struct OpenRequest
+  {
+      std::promise<ResponseConstPtr>* promise;
+      std::chrono::steady_clock::time_point deadline;
+  };
+
 private:
   void read_async();
+  void read_body_async(const std::shared_ptr<SerializationBuffer>& message_data);
+  void handleReceivedPacket(const SerializablePtr& serial);
+  void resolveRequest(uint32_t request_id, const ResponseConstPtr& response);
+
+  void handlePackets();
+  void dispatchPacket(const SerializableConstPtr& packet);
+  void dispatchRequest(const SerializableConstPtr& packet);
+  bool isHandlerThread() const;
+  void stop_async();
 
   void write_packet(SerializationBuffer &buffer);
+  void flush_writes();
+  void linger();
 
-  std::thread packet_handler_thread_;
+  std::size_t handler_thread_count_;
+  std::function<void(const RequestConstPtr&)> request_handler_;
+  std::vector<std::thread> packet_handler_threads_;
   boost::asio::ip::tcp::socket socket_;
 
-  uint8_t next_request_id_;
+  std::atomic<uint32_t> next_request_id_;
+  std::atomic<int64_t> request_timeout_ms_;
 
 
   std::recursive_mutex packets_mutex_;
   std::condition_variable_any packets_available_;
   std::deque<SerializableConstPtr> packets_;
+  std::size_t active_requests_;
+  bool ordered_packet_active_;
+
+  boost::asio::steady_timer linger_timer_;
+
+  std::recursive_mutex write_mutex_;
+  std::deque<std::shared_ptr<SerializationBuffer>> write_queue_;
+  std::size_t queued_bytes_;
+  bool writing_;
+  bool lingering_;
+
+  std::size_t flush_threshold_;
+  std::chrono::microseconds linger_;
+
+  std::atomic<uint64_t> bytes_written_;
+  std::atomic<uint64_t> packets_written_;
+  std::atomic<uint64_t> write_syscalls_;
 
   std::recursive_mutex open_requests_mutex_;
-  std::map<uint8_t, std::promise<ResponseConstPtr>*> open_requests_;
+  std::map<uint32_t, OpenRequest> open_requests_;
 
   std::recursive_mutex running_mutex_;
   std::atomic<bool> running_;
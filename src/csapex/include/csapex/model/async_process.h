@@ -0,0 +1,110 @@
+#ifndef ASYNC_PROCESS_H
+#define ASYNC_PROCESS_H
+
+/// PROJECT
+#include <csapex/model/node.h>
+#include <csapex/model/model_fwd.h>
+#include <csapex/utility/fd_reactor.h>
+#include <csapex/csapex_export.h>
+
+/// SYSTEM
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+
+namespace csapex
+{
+
+/**
+ * @brief The AsyncProcess class lets an asynchronous Node::process wait for timers, futures
+ *        and file descriptors without occupying a thread of its ThreadGroup.
+ *
+ * Every wait returns immediately and the given Step is later executed as an ordinary task of the node.
+ * A Step may wait again, otherwise processing is finished when the Step returns.
+ * If the node is not run by a scheduler, the waiting thread executes the Step itself.
+ *
+ *   void process(NodeModifier& modifier, Parameterizable& parameters, Continuation continuation) override
+ *   {
+ *       AsyncProcess::make(modifier, parameters, continuation)->after(std::chrono::milliseconds(10),
+ *           [this](NodeModifier&, Parameterizable&, AsyncProcess&) {
+ *               msg::publish(out, 42);
+ *           });
+ *   }
+ */
+class CSAPEX_EXPORT AsyncProcess : public std::enable_shared_from_this<AsyncProcess>
+{
+public:
+    using Step = std::function<void(NodeModifier&, Parameterizable&, AsyncProcess&)>;
+    using Clock = std::chrono::steady_clock;
+
+    static AsyncProcessPtr make(NodeModifier& node_modifier, Parameterizable& parameters, Continuation continuation);
+
+    ~AsyncProcess();
+
+    /**
+     * @brief at executes step once the scheduler's delayed queue reaches time
+     */
+    void at(Clock::time_point time, Step step);
+    void after(Clock::duration delay, Step step);
+
+    /**
+     * @brief waitUntil executes step once ready returns true.
+     *        ready is polled by delayed tasks with increasing intervals, up to the maximum poll interval.
+     */
+    void waitUntil(std::function<bool()> ready, Step step);
+
+    template <typename T>
+    void whenReady(std::shared_future<T> future, Step step)
+    {
+        waitUntil([future]() {
+            return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }, step);
+    }
+    template <typename T>
+    void whenReady(std::future<T>&& future, Step step)
+    {
+        whenReady(future.share(), step);
+    }
+
+    /**
+     * @brief whenReadable executes step once fd is readable, the descriptor is watched by the FdReactor
+     */
+    void whenReadable(int fd, Step step);
+    void whenWritable(int fd, Step step);
+
+    /**
+     * @brief finish ends processing, after executing the optional function
+     */
+    void finish(ProcessingFunction function = ProcessingFunction());
+
+    bool isFinished() const;
+
+    void setMaxPollInterval(Clock::duration interval);
+    Clock::duration getMaxPollInterval() const;
+
+private:
+    AsyncProcess(NodeModifier& node_modifier, Parameterizable& parameters, Continuation continuation);
+
+    void await();
+    void resume(Step step);
+    void resumeLater(Step step);
+    void watch(int fd, FdReactor::Event event, Step step);
+    void execute(const Step& step);
+    void poll(std::function<bool()> ready, Step step, Clock::duration interval);
+
+private:
+    NodeModifier& node_modifier_;
+    Parameterizable& parameters_;
+    Continuation continuation_;
+    std::weak_ptr<NodeHandle> node_handle_;
+
+    std::atomic<bool> waiting_;
+    std::atomic<bool> finished_;
+
+    Clock::duration max_poll_interval_;
+};
+
+}
+
+#endif // ASYNC_PROCESS_H
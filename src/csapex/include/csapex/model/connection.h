@@ -16,6 +16,7 @@
 #include <deque>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
 
 namespace csapex
 {
@@ -36,6 +37,18 @@ public:
         DONE = NOT_INITIALIZED
     };
 
+    /**
+     * @brief The OverflowPolicy enum determines what happens when a token is sent to a full connection
+     *        BLOCK: the output waits until the connection has space again
+     *        KEEP_LATEST: every token the input has not read yet is replaced by the new one
+     *        DROP_OLDEST: the oldest token the input has not read yet is dropped
+     */
+    enum class OverflowPolicy {
+        BLOCK,
+        KEEP_LATEST,
+        DROP_OLDEST
+    };
+
 public:
     friend std::ostream& operator << (std::ostream& out, const Connection& c);
 
@@ -62,7 +75,7 @@ public:
     virtual void setToken(const TokenPtr &msg);
 
     TokenPtr getToken() const;
-    void setTokenProcessed();
+    virtual void setTokenProcessed();
 
     /**
      * @brief readMessage retrieves the current message and marks the Connection read
@@ -79,10 +92,51 @@ public:
     bool isSourceEnabled() const;
     bool isSinkEnabled() const;
 
+    /**
+     * @brief getState returns the state of the token that is presented to the input
+     */
     State getState() const;
     void setState(State s);
 
-    void reset();
+    /**
+     * @brief getSourceState returns the state as seen by the output,
+     *        DONE means that the connection can accept another token
+     */
+    virtual State getSourceState() const;
+
+    /**
+     * @brief getCapacity returns the number of tokens the connection can hold
+     */
+    virtual std::size_t getCapacity() const;
+    /**
+     * @brief getOccupancy returns the number of tokens the connection currently holds
+     */
+    virtual std::size_t getOccupancy() const;
+
+    void setOverflowPolicy(OverflowPolicy policy);
+    OverflowPolicy getOverflowPolicy() const;
+
+    /**
+     * @brief getDroppedCount returns the number of tokens that have been dropped because of the overflow policy
+     */
+    long getDroppedCount() const;
+
+    /**
+     * @brief recordTransfer is called by the consumer when it starts processing the current token
+     * @param numa_node the NUMA node the consumer runs on, -1 if unknown
+     */
+    void recordTransfer(int numa_node);
+
+    /**
+     * @brief getTransferCount returns the number of consumed tokens whose NUMA nodes are known
+     */
+    long getTransferCount() const;
+    /**
+     * @brief getCrossNodeTransferCount returns how many of those tokens were created for another NUMA node
+     */
+    long getCrossNodeTransferCount() const;
+
+    virtual void reset();
 
 public:
     slim_signal::Signal<void()> deleted;
@@ -127,6 +181,15 @@ protected:
     State state_;
     TokenPtr message_;
 
+    OverflowPolicy overflow_policy_;
+    long dropped_;
+
+    std::atomic<long> transfers_;
+    std::atomic<long> cross_node_transfers_;
+
+    // newest token that arrived while the input was processing, only used by non-blocking policies
+    TokenPtr latest_;
+
     static int next_connection_id_;
 
     mutable std::recursive_mutex sync;
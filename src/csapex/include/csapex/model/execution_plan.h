@@ -0,0 +1,139 @@
+#ifndef EXECUTION_PLAN_H
+#define EXECUTION_PLAN_H
+
+/// PROJECT
+#include <csapex/model/model_fwd.h>
+#include <csapex/scheduling/scheduling_fwd.h>
+#include <csapex/msg/msg_fwd.h>
+#include <csapex/utility/rate.h>
+#include <csapex/utility/uuid.h>
+#include <csapex/utility/slim_signal.hpp>
+#include <csapex/model/observer.h>
+#include <csapex/csapex_export.h>
+
+/// SYSTEM
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+namespace csapex
+{
+
+/**
+ * @brief The ExecutionPlan class compiles a frozen graph into a fixed schedule.
+ *        Every connected component is executed in lockstep in topological order,
+ *        tokens are passed from outputs to inputs directly, bypassing connections,
+ *        transitions and the node runners.
+ *        Only flat graphs of synchronous nodes without event connections can be compiled.
+ *        Any structural change of the graph invalidates the plan, a running plan is stopped.
+ */
+class CSAPEX_EXPORT ExecutionPlan : public Observer
+{
+public:
+    /**
+     * @brief ExecutionPlan compiles the current structure of the graph
+     * @throws std::runtime_error if the graph cannot be executed in lockstep
+     */
+    ExecutionPlan(GraphLocal& graph);
+    ~ExecutionPlan();
+
+    std::size_t getComponentCount() const;
+    std::vector<UUID> getSchedule(std::size_t component) const;
+
+    /**
+     * @brief iterate executes every node of a component exactly once
+     * @throws std::runtime_error if the plan has been invalidated
+     */
+    void iterate(std::size_t component);
+    long getIterations(std::size_t component) const;
+
+    /**
+     * @brief start takes the nodes away from their runners and executes each component
+     *        repeatedly in the thread group of its first node
+     */
+    void start(ThreadPool& thread_pool);
+
+    /**
+     * @brief stop returns the nodes to their runners, after the iterations in progress have finished
+     */
+    void stop();
+    bool isRunning() const;
+
+    /**
+     * @brief isValid
+     * @return false, iff nodes or connections have been added or removed since the graph was compiled
+     */
+    bool isValid() const;
+
+public:
+    slim_signal::Signal<void()> invalidated;
+
+private:
+    static const std::size_t NO_SLOT;
+
+    struct Binding
+    {
+        Input* input;
+        std::size_t slot;
+    };
+
+    struct Step
+    {
+        NodeHandle* node_handle;
+        NodeWorker* worker;
+        NodePtr node;
+        NodeRunnerPtr runner;
+
+        std::vector<Binding> inputs;
+        std::vector<std::pair<Output*, std::size_t>> outputs;
+    };
+
+    struct Component
+    {
+        Component();
+
+        void iterate();
+        bool iterateIfRunning();
+        void executeSteps();
+        void execute(Step& step, long sequence_number);
+        void scheduleNextIteration();
+        ThreadGroupPtr getGroup() const;
+
+        std::vector<Step> steps;
+        std::vector<TokenPtr> registers;
+        TokenPtr no_message;
+
+        std::mutex execution_mtx;
+        std::atomic<long> iterations;
+        std::atomic<bool> running;
+
+        Rate rate;
+        // groups can be deleted while the plan runs, the default group takes over then
+        ThreadGroupWeakPtr group;
+        ThreadGroupPtr default_group;
+        TaskPtr task;
+    };
+    typedef std::shared_ptr<Component> ComponentPtr;
+
+    struct Detached
+    {
+        NodeRunnerPtr runner;
+        ThreadGroupWeakPtr group;
+    };
+
+private:
+    void compile(GraphLocal& graph);
+    void invalidate();
+
+private:
+    std::vector<ComponentPtr> components_;
+    std::vector<Detached> detached_;
+    ThreadPool* thread_pool_;
+
+    std::atomic<bool> running_;
+    std::atomic<bool> valid_;
+};
+
+}
+
+#endif // EXECUTION_PLAN_H
@@ -4,6 +4,9 @@
 /// COMPONENT
 #include <csapex/model/graph.h>
 
+/// SYSTEM
+#include <mutex>
+
 namespace csapex
 {
 
@@ -55,6 +58,11 @@ public:
 
     void analyzeGraph() override;
 
+    /**
+     * @brief updateCriticalPaths reevaluates the critical paths with the latest profiling data
+     */
+    void updateCriticalPaths();
+
     void setNodeHandle(NodeHandle* nh);
 
     // iterators
@@ -69,6 +77,7 @@ private:
 
     void buildConnectedComponents();
     void calculateDepths();
+    void calculateCriticalPaths();
 
     std::set<graph::Vertex *> findVerticesThatNeedMessages();
     std::set<graph::Vertex *> findVerticesThatJoinStreams();
@@ -83,6 +92,9 @@ protected:
     std::set<graph::VertexPtr> sources_;
     std::set<graph::VertexPtr> sinks_;
 
+    // guards vertices and their adjacency against the periodic critical path update
+    std::recursive_mutex structure_mutex_;
+
     bool in_transaction_;
 
     NodeHandle* nh_;
@@ -24,7 +24,7 @@ public:
     typedef std::shared_ptr<GraphFacade> Ptr;
 
 public:
-    GraphFacade(ThreadPool& executor, GraphPtr graph, SubgraphNodePtr graph_node, NodeFacadePtr nh = nullptr, GraphFacade* parent = nullptr);
+    GraphFacade(Executor& executor, GraphPtr graph, SubgraphNodePtr graph_node, NodeFacadePtr nh = nullptr, GraphFacade* parent = nullptr);
     ~GraphFacade();
 
     AUUID getAbsoluteUUID() const;
@@ -34,6 +34,7 @@ public:
     NodeFacadePtr getNodeFacade();
     GraphFacade* getParent() const;
     GraphFacade* getSubGraph(const UUID& uuid);
+    Executor* getExecutor();
     ThreadPool* getThreadPool();
 
     void addNode(NodeFacadePtr node);
@@ -70,6 +71,11 @@ public:
     void clearBlock();
     void resetActivity();
 
+    /**
+     * @brief updateCriticalPaths reevaluates the critical paths of this graph and all subgraphs
+     */
+    void updateCriticalPaths();
+
     bool isPaused() const;
     void pauseRequest(bool pause);
 
@@ -106,7 +112,7 @@ private:
     GraphPtr graph_;
     SubgraphNodePtr graph_node_;
     NodeFacadePtr graph_handle_;
-    ThreadPool& executor_;
+    Executor& executor_;
 
     std::unordered_map<UUID, GraphFacadePtr, UUID::Hasher> children_;
 
@@ -27,6 +27,8 @@ FWD(NodeHandle);
 FWD(NodeConstructor);
 FWD(NodeStatistics);
 FWD(NodeRunner);
+FWD(ExecutionPlan);
+FWD(OperatorFusion);
 FWD(Connectable);
 FWD(ConnectableOwner);
 FWD(Memento);
@@ -41,6 +43,7 @@ FWD(Node);
 FWD(NodeState);
 FWD(NodeWorker);
 FWD(NodeModifier);
+FWD(AsyncProcess);
 FWD(Tag);
 FWD(NodeCharacteristics);
 FWD(ConnectorDescription);
@@ -241,6 +241,20 @@ public:
      */
     virtual bool isAsynchronous() const;
 
+    /**
+     * @brief isReentrant specifies whether Node::process can be called concurrently for different messages.
+     *
+     * A reentrant node must not modify any state of the node in Node::process, it may only read its
+     * inputs and parameters and write its outputs. When the node is executed in pipelining mode,
+     * multiple messages are then processed in parallel and the results are sent in the order of arrival.
+     * Asynchronous nodes are never executed concurrently, neither are nodes with connected parameter inputs,
+     * so that every message is processed with the parameter values that arrived with it.
+     * By default, the method returns false.
+     *
+     * @return <b>true</b>, iff Node::process may run concurrently.
+     */
+    virtual bool isReentrant() const;
+
     /**
      * @brief isIsolated specifies whether this node is node participating in the calculation graph.
      *
@@ -1,6 +1,9 @@
 #ifndef NODE_CHARACTERISTICS_H
 #define NODE_CHARACTERISTICS_H
 
+/// SYSTEM
+#include <atomic>
+
 namespace csapex
 {
 
@@ -8,6 +11,9 @@ class NodeCharacteristics
 {
 public:
     NodeCharacteristics();
+    NodeCharacteristics(const NodeCharacteristics& other);
+
+    NodeCharacteristics& operator = (const NodeCharacteristics& other);
 
 public:
     int depth;
@@ -22,6 +28,15 @@ public:
     bool is_leading_to_joining_vertex;
 
     bool is_leading_to_essential_vertex;
+
+    // the critical path is refreshed periodically while the node runners read it
+
+    // measured processing time in milliseconds
+    std::atomic<double> latency;
+    // latency of the longest path from any source over this node to any sink
+    std::atomic<double> critical_path_latency;
+    // ratio of critical_path_latency to the longest path in the component, 1 on the critical path
+    std::atomic<double> criticality;
 };
 
 }
@@ -75,6 +75,12 @@ public:
     virtual double getExecutionFrequency() const = 0;
     virtual double getMaximumFrequency() const = 0;
 
+    /**
+     * @brief getDeadlineMisses returns how often the node has exceeded its deadline, see NodeState::getDeadline
+     */
+    virtual double getDeadline() const = 0;
+    virtual long getDeadlineMisses() const = 0;
+
     // Parameterizable
     virtual std::vector<param::ParameterPtr> getParameters() const = 0;
     virtual param::ParameterPtr getParameter(const std::string& name) const = 0;
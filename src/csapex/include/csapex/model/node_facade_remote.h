@@ -64,6 +64,9 @@ public:
     double getExecutionFrequency() const override;
     double getMaximumFrequency() const override;
 
+    double getDeadline() const override;
+    long getDeadlineMisses() const override;
+
     // Parameterizable
     virtual std::vector<param::ParameterPtr> getParameters() const override;
     param::ParameterPtr getParameter(const std::string& name) const override;
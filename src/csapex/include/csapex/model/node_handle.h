@@ -15,6 +15,7 @@
 #include <csapex/model/connectable_vector.h>
 
 /// SYSTEM
+#include <chrono>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -171,6 +172,10 @@ public:
     slim_signal::Signal<void()> might_be_enabled;
 
     slim_signal::Signal<void(std::function<void()>)> execution_requested;
+    // tasks that may run concurrently to all other tasks of this node
+    slim_signal::Signal<void(std::function<void()>)> concurrent_execution_requested;
+    // tasks of this node that must not run before the given time
+    slim_signal::Signal<void(std::function<void()>, std::chrono::steady_clock::time_point)> delayed_execution_requested;
 
     void connectConnector(Connectable* c);
     void disconnectConnector(Connectable* c);
@@ -12,6 +12,7 @@
 #include <mutex>
 #include <atomic>
 #include <thread>
+#include <chrono>
 
 namespace csapex
 {
@@ -41,16 +42,38 @@ public:
 
     virtual void reset() override;
 
+    /**
+     * @brief setCriticalPathScheduling enables the priority policy,
+     *        that prefers nodes on the graph's critical path over the others
+     */
+    void setCriticalPathScheduling(bool enabled);
+    bool isCriticalPathScheduling() const;
+
+    /**
+     * @brief getDeadlineMisses returns how often the node has not been processed within its deadline
+     */
+    long getDeadlineMisses() const;
+    void resetDeadlineMisses();
+
+    /**
+     * @brief setFusedChain lets the node be executed inline by the other members of the chain
+     */
+    void setFusedChain(FusedChainPtr chain);
+    FusedChainPtr getFusedChain() const;
+
     void schedule(TaskPtr task);
-    void scheduleDelayed(TaskPtr task, std::chrono::system_clock::time_point time);
+    void scheduleDelayed(TaskPtr task, std::chrono::steady_clock::time_point time);
 
 private:
     void measureFrequency();
 
     void scheduleProcess();
+    long getCriticalPathPriority() const;
 
     void execute();
 
+    void checkDeadline();
+
 private:
     NodeWorkerPtr worker_;
     Scheduler* scheduler_;
@@ -65,15 +88,25 @@ private:
     TaskPtr check_parameters_;
     TaskPtr execute_;
 
+    FusedChainPtr fused_chain_;
+
     std::vector<TaskPtr> remaining_tasks_;
 
     long guard_;
     double max_frequency_;
 
+    std::atomic<bool> critical_path_scheduling_;
+
     bool waiting_for_execution_;
 
     bool waiting_for_step_;
     slim_signal::ScopedConnection wait_for_step_connection_;
+
+    std::atomic<double> deadline_;
+    std::chrono::steady_clock::time_point scheduled_at_;
+    std::chrono::steady_clock::time_point released_at_;
+    std::atomic<bool> released_;
+    std::atomic<long> deadline_misses_;
 };
 
 }
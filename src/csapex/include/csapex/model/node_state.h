@@ -34,6 +34,14 @@ public:
     void setMaximumFrequency(double f);
     Signal max_frequency_changed;
 
+    /**
+     * @brief getDeadline returns the time in seconds in which the node has to be processed after it is scheduled,
+     *        0 if the node has no deadline
+     */
+    double getDeadline() const;
+    void setDeadline(double seconds);
+    Signal deadline_changed;
+
     Point getPos() const;
     void setPos(const Point &value, bool quiet = false);
     Signal pos_changed;
@@ -116,6 +124,7 @@ private:
     mutable Memento::Ptr child_state_;
 
     double max_frequency_;
+    double deadline_;
 
     std::string label_;
     Point pos_;
@@ -29,6 +29,8 @@ namespace csapex {
 
 class Profiler;
 class Interval;
+class InvocationContext;
+typedef std::shared_ptr<InvocationContext> InvocationContextPtr;
 
 class CSAPEX_EXPORT NodeWorker : public ErrorState, public Observer, public Notifier
 {
@@ -83,6 +85,19 @@ public:
 
     void trySendEvents();
 
+    /**
+     * @brief setMaxConcurrentInvocations limits the number of messages a reentrant node processes at once,
+     *        including the results that wait to be sent. Values below 2 disable concurrent invocations.
+     */
+    void setMaxConcurrentInvocations(std::size_t max);
+    std::size_t getMaxConcurrentInvocations() const;
+
+    /**
+     * @brief isReentrantExecution checks if the node is currently executed with concurrent invocations.
+     *        Nodes with connected parameter inputs are always executed serially.
+     */
+    bool isReentrantExecution() const;
+
 public:
     bool startProcessingMessages();
     void forwardMessages(bool send_parameters);
@@ -135,6 +150,14 @@ private:
 
     bool hasActiveOutputConnection();
 
+    bool startInvocation();
+    void finishInvocation(const InvocationContextPtr& context, bool send, bool processed, long generation);
+    void requestSendingFinishedInvocations();
+    void sendFinishedInvocations();
+
+    int getConsumerNumaNode() const;
+    void recordTransfers();
+
 private:
     mutable std::recursive_mutex sync;
 
@@ -163,6 +186,26 @@ private:
     std::shared_ptr<Profiler> profiler_;
 
     long guard_;
+
+    // concurrent invocations of reentrant nodes
+    struct Invocation
+    {
+        InvocationContextPtr context;
+        bool send;
+        bool processed;
+    };
+    struct InvocationGuard;
+
+    std::shared_ptr<InvocationGuard> invocation_guard_;
+    std::map<long, Invocation> finished_invocations_;
+    long next_ticket_;
+    long next_ticket_to_send_;
+    long generation_;
+    bool sending_invocations_;
+    bool resend_invocations_;
+
+    std::atomic<std::size_t> pending_invocations_;
+    std::atomic<std::size_t> max_concurrent_invocations_;
 };
 
 }
@@ -0,0 +1,62 @@
+#ifndef OPERATOR_FUSION_H
+#define OPERATOR_FUSION_H
+
+/// PROJECT
+#include <csapex/model/model_fwd.h>
+#include <csapex/model/observer.h>
+#include <csapex/scheduling/scheduling_fwd.h>
+#include <csapex/utility/uuid.h>
+#include <csapex/csapex_export.h>
+
+/// SYSTEM
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace csapex
+{
+
+/**
+ * @brief The OperatorFusion class fuses linear chains of nodes in the same thread group.
+ *        A chain consists of synchronous nodes, where each node has a single output that is only
+ *        connected to the single input of the next node.
+ *        The members of a chain are executed one after another by the same task,
+ *        so that only the first node of a chain has to be scheduled.
+ *        Connections, transitions and profiling of the nodes are unchanged.
+ *        Any structural change of the graph releases the chains, the graph has to be fused again.
+ */
+class CSAPEX_EXPORT OperatorFusion : public Observer
+{
+public:
+    /**
+     * @brief OperatorFusion finds the chains in the current structure of the graph and fuses them
+     */
+    OperatorFusion(GraphLocal& graph, ThreadPool& thread_pool);
+    ~OperatorFusion();
+
+    std::size_t getChainCount() const;
+    std::vector<UUID> getChain(std::size_t chain) const;
+    long getFusedExecutions(std::size_t chain) const;
+
+    /**
+     * @brief release schedules every node on its own again
+     */
+    void release();
+
+    bool isValid() const;
+
+private:
+    void fuse(GraphLocal& graph, ThreadPool& thread_pool);
+    void invalidate();
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<FusedChainPtr> chains_;
+    std::vector<NodeRunnerPtr> runners_;
+
+    std::atomic<bool> valid_;
+};
+
+}
+
+#endif // OPERATOR_FUSION_H
@@ -15,9 +15,23 @@ class CSAPEX_EXPORT Token
 public:
     template <typename DataType>
     static TokenPtr makeEmpty() {
-        return std::make_shared<Token>(connection_types::makeEmpty<DataType>());
+        return make(connection_types::makeEmpty<DataType>());
     }
 
+    /**
+     * @brief makeShared creates a token whose payload is shared with all other tokens of this type,
+     *        only for payloads without state, like markers
+     */
+    template <typename DataType>
+    static TokenPtr makeShared() {
+        return make(connection_types::makeSharedEmpty<DataType>());
+    }
+
+    /**
+     * @brief make creates a token in the memory pool of the calling thread
+     */
+    static TokenPtr make(const TokenDataConstPtr& data);
+
 public:
     Token(const TokenDataConstPtr& token);
 
@@ -25,19 +39,36 @@ public:
     bool hasActivityModifier() const;
     ActivityModifier getActivityModifier() const;
 
+    /**
+     * @brief clone creates a deep copy of this token, including its payload
+     */
     TokenPtr clone() const;
 
+    /**
+     * @brief cloneShallow copies only the meta data of this token (activity modifier, sequence number).
+     *        The immutable payload is shared with the original token.
+     */
+    TokenPtr cloneShallow() const;
+
     TokenDataConstPtr getTokenData() const;
 
     int getSequenceNumber() const;
     void setSequenceNumber(int seq_no_) const;
 
+    /**
+     * @brief getNumaNode returns the NUMA node the payload was created for, -1 if it was not placed on a node
+     */
+    int getNumaNode() const;
+    void setNumaNode(int node);
+
 private:
     TokenDataConstPtr token_;
 
     ActivityModifier activity_modifier_;
 
     mutable int seq_no_;
+
+    int numa_node_;
 };
 
 }
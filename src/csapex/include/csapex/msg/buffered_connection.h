@@ -0,0 +1,50 @@
+#ifndef BUFFERED_CONNECTION_H
+#define BUFFERED_CONNECTION_H
+
+/// PROJECT
+#include <csapex/model/connection.h>
+
+/// SYSTEM
+#include <deque>
+
+namespace csapex
+{
+
+/**
+ * @brief The BufferedConnection class holds up to a fixed number of tokens.
+ *        The oldest token is presented to the input, the output can continue
+ *        to send tokens until the buffer is full.
+ */
+class CSAPEX_EXPORT BufferedConnection : public Connection
+{
+public:
+    static ConnectionPtr connect(OutputPtr from, InputPtr to, std::size_t capacity);
+    static ConnectionPtr connect(OutputPtr from, InputPtr to, int id, std::size_t capacity);
+
+public:
+    ~BufferedConnection();
+
+    virtual void setToken(const TokenPtr& msg) override;
+    virtual void setTokenProcessed() override;
+
+    virtual State getSourceState() const override;
+
+    virtual std::size_t getCapacity() const override;
+    virtual std::size_t getOccupancy() const override;
+
+    virtual void reset() override;
+
+protected:
+    BufferedConnection(OutputPtr from, InputPtr to, std::size_t capacity);
+    BufferedConnection(OutputPtr from, InputPtr to, int id, std::size_t capacity);
+
+private:
+    std::size_t capacity_;
+
+    // tokens that are waiting behind the one presented to the input
+    std::deque<TokenPtr> pending_;
+};
+
+}
+
+#endif // BUFFERED_CONNECTION_H
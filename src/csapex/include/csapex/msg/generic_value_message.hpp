@@ -5,6 +5,7 @@
 #include <csapex/msg/message.h>
 #include <csapex/utility/register_msg.h>
 #include <csapex/serialization/message_serializer.h>
+#include <csapex/serialization/serialization_buffer.h>
 
 namespace csapex {
 namespace connection_types {
@@ -16,7 +17,7 @@ struct GenericValueMessage : public Message
     typedef std::shared_ptr<GenericValueMessage<Type> const> ConstPtr;
 
     GenericValueMessage(const std::string& frame_id = "/", Message::Stamp stamp = 0)
-        : Message(type< GenericValueMessage<Type> >::name(), frame_id, stamp)
+        : Message(typeName(), frame_id, stamp)
     {
         static csapex::DirectMessageConstructorRegistered<connection_types::GenericValueMessage, Type> reg_c;
         static csapex::DirectMessageSerializerRegistered<connection_types::GenericValueMessage, Type> reg_s;
@@ -45,6 +46,13 @@ struct GenericValueMessage : public Message
         return value;
     }
 
+    static const std::string& typeName()
+    {
+        // the name is demangled once, messages are created for every publish
+        static const std::string name = type< GenericValueMessage<Type> >::name();
+        return name;
+    }
+
     Type value;
 };
 
@@ -70,6 +78,23 @@ struct MessageContainer<V, false>
     }
 };
 }
+
+/// BINARY
+namespace serial {
+template <typename T>
+struct BinarySerializer<connection_types::GenericValueMessage<T>, typename std::enable_if<is_binary_primitive<T>::value>::type>
+{
+    static bool encode(const connection_types::GenericValueMessage<T>& msg, SerializationBuffer& data)
+    {
+        data << msg.frame_id << msg.stamp_micro_seconds << msg.value;
+        return true;
+    }
+    static void decode(SerializationBuffer& data, connection_types::GenericValueMessage<T>& msg)
+    {
+        data >> msg.frame_id >> msg.stamp_micro_seconds >> msg.value;
+    }
+};
+}
 }
 
 /// YAML
@@ -10,6 +10,7 @@
 #include <csapex/msg/generic_value_message.hpp>
 #include <csapex/msg/generic_pointer_message.hpp>
 #include <csapex/serialization/yaml.h>
+#include <csapex/serialization/serialization_buffer.h>
 #include <csapex/utility/assert.h>
 
 /// SYSTEM
@@ -60,6 +61,16 @@ private:
 
         virtual void encode(YAML::Node& node) const = 0;
         virtual void decode(const YAML::Node& node) = 0;
+
+        /// @return false, if the entries can only be represented as YAML
+        virtual bool encodeBinary(SerializationBuffer& /*data*/) const
+        {
+            return false;
+        }
+        virtual void decodeBinary(SerializationBuffer& /*data*/)
+        {
+            throw std::runtime_error(std::string("cannot decode a binary vector of ") + descriptiveName());
+        }
     };
 
     template <typename T>
@@ -148,6 +159,36 @@ private:
             *value = node["values"].as< std::vector<Payload> >();
         }
 
+        bool encodeBinary(SerializationBuffer& data) const override
+        {
+            return encodeBinaryValues(data, serial::is_binary_primitive<Payload>());
+        }
+
+        void decodeBinary(SerializationBuffer& data) override
+        {
+            decodeBinaryValues(data, serial::is_binary_primitive<Payload>());
+        }
+
+        bool encodeBinaryValues(SerializationBuffer& data, std::true_type) const
+        {
+            data << type2name(typeid(T)) << *value;
+            return true;
+        }
+        bool encodeBinaryValues(SerializationBuffer& /*data*/, std::false_type) const
+        {
+            return false;
+        }
+
+        void decodeBinaryValues(SerializationBuffer& data, std::true_type)
+        {
+            value.reset(new std::vector<Payload>);
+            data >> *value;
+        }
+        void decodeBinaryValues(SerializationBuffer& data, std::false_type)
+        {
+            EntryInterface::decodeBinary(data);
+        }
+
         TokenData::Ptr nestedType() const override
         {
             return makeTypeSwitch(Tag<Payload>());
@@ -564,6 +605,21 @@ public:
         impl->decode(node);
     }
 
+    bool encodeBinary(SerializationBuffer& data) const
+    {
+        data << frame_id << stamp_micro_seconds;
+        return impl->encodeBinary(data);
+    }
+
+    void decodeBinary(SerializationBuffer& data)
+    {
+        std::string type;
+        data >> frame_id >> stamp_micro_seconds >> type;
+        impl = SupportedTypes::make(type);
+        assert(impl);
+        impl->decodeBinary(data);
+    }
+
 
     virtual TokenData::Ptr clone() const override;
     virtual TokenData::Ptr toType() const override;
@@ -631,6 +687,17 @@ struct GenericVectorRegistered
 };
 
 
+/// BINARY
+namespace csapex {
+namespace serial {
+template<>
+struct CSAPEX_EXPORT BinarySerializer<connection_types::GenericVectorMessage> {
+    static bool encode(const connection_types::GenericVectorMessage& msg, SerializationBuffer& data);
+    static void decode(SerializationBuffer& data, connection_types::GenericVectorMessage& msg);
+};
+}
+}
+
 /// YAML
 namespace YAML {
 template<>
@@ -0,0 +1,73 @@
+#ifndef INVOCATION_CONTEXT_H
+#define INVOCATION_CONTEXT_H
+
+/// PROJECT
+#include <csapex/model/model_fwd.h>
+#include <csapex/msg/msg_fwd.h>
+#include <csapex/csapex_export.h>
+
+/// SYSTEM
+#include <vector>
+#include <utility>
+
+namespace csapex
+{
+
+/**
+ * @brief The InvocationContext class holds the tokens of one call of Node::process for reentrant nodes.
+ *        While a context is active on a thread, the inputs it captures present its snapshot
+ *        instead of their current token and the outputs it captures buffer into the context,
+ *        so that multiple invocations of the same node can run concurrently.
+ */
+class CSAPEX_EXPORT InvocationContext
+{
+public:
+    /**
+     * @brief The Scope class activates a context on the current thread for its lifetime
+     */
+    class CSAPEX_EXPORT Scope
+    {
+    public:
+        Scope(InvocationContext* context);
+        ~Scope();
+
+    private:
+        Scope(const Scope&) = delete;
+        Scope& operator = (const Scope&) = delete;
+
+    private:
+        InvocationContext* previous_;
+    };
+
+    /**
+     * @brief current returns the context that is active on the calling thread, or nullptr
+     */
+    static InvocationContext* current();
+
+public:
+    InvocationContext(long ticket);
+
+    long getTicket() const;
+
+    void addInput(const Input* input, const TokenPtr& token);
+    bool captures(const Input* input) const;
+    TokenPtr getToken(const Input* input) const;
+
+    void addOutput(const Output* output);
+    bool captures(const Output* output) const;
+    TokenPtr getToken(const Output* output) const;
+    void setToken(const Output* output, const TokenPtr& token);
+
+private:
+    long ticket_;
+
+    // nodes have only a few ports, linear search is faster than a map here
+    std::vector<std::pair<const Input*, TokenPtr>> inputs_;
+    std::vector<std::pair<const Output*, TokenPtr>> outputs_;
+};
+
+typedef std::shared_ptr<InvocationContext> InvocationContextPtr;
+
+}
+
+#endif // INVOCATION_CONTEXT_H
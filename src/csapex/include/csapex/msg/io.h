@@ -6,6 +6,7 @@
 #include <csapex/msg/msg_fwd.h>
 #include <csapex/msg/token_traits.h>
 #include <csapex/utility/uuid.h>
+#include <csapex/utility/pool_allocator.hpp>
 
 namespace boost
 {
@@ -209,7 +210,7 @@ void publish(Output* output,
              T message,
              std::string frame_id = "/")
 {
-    typename connection_types::GenericValueMessage<T>::Ptr msg(new connection_types::GenericValueMessage<T>(frame_id));
+    typename connection_types::GenericValueMessage<T>::Ptr msg = makePooled<connection_types::GenericValueMessage<T>>(frame_id);
     msg->value = message;
     publish(output, message_cast<TokenData>(msg));
 }
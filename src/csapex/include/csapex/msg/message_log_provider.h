@@ -0,0 +1,75 @@
+#ifndef MESSAGE_LOG_PROVIDER_H
+#define MESSAGE_LOG_PROVIDER_H
+
+/// COMPONENT
+#include <csapex/msg/message_provider.h>
+#include <csapex/msg/message_log_reader.h>
+#include <csapex/csapex_export.h>
+
+/// SYSTEM
+#include <chrono>
+
+namespace csapex
+{
+
+/**
+ * @brief The MessageLogProvider class plays back a log written by a MessageLogWriter.
+ *        Every recorded output is provided in its own slot.
+ *        Playback happens either at the recorded rate or as fast as possible.
+ */
+class CSAPEX_EXPORT MessageLogProvider : public MessageProvider
+{
+public:
+    static std::shared_ptr<MessageProvider> make();
+
+    MessageLogProvider();
+
+public:
+    void load(const std::string& file) override;
+    void parameterChanged() override;
+
+    /**
+     * @brief hasNext returns false while the next record is not due yet, when playing back at the recorded rate
+     */
+    virtual bool hasNext() override;
+    virtual void prepareNext() override;
+
+    /**
+     * @return the prepared message, if it has been recorded from the output of the given slot, nullptr otherwise
+     */
+    virtual connection_types::Message::Ptr next(std::size_t slot) override;
+    virtual std::string getLabel(std::size_t slot) const override;
+
+    virtual void restart() override;
+
+    virtual std::vector<std::string> getExtensions() const override;
+
+    virtual Memento::Ptr getState() const override;
+    virtual void setParameterState(Memento::Ptr memento) override;
+
+    void seekIndex(std::size_t index);
+    void seekTime(std::chrono::microseconds time);
+
+    std::size_t getIndex() const;
+    MessageLogReaderPtr getReader() const;
+
+private:
+    std::chrono::steady_clock::time_point dueTime(std::size_t index) const;
+
+private:
+    MessageLogReaderPtr reader_;
+
+    std::size_t index_;
+    double start_time_;
+
+    std::chrono::steady_clock::time_point playback_start_;
+    std::size_t playback_start_index_;
+
+    bool prepared_;
+    std::size_t prepared_slot_;
+    connection_types::Message::Ptr prepared_message_;
+};
+
+}
+
+#endif // MESSAGE_LOG_PROVIDER_H
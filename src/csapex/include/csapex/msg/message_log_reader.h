@@ -0,0 +1,91 @@
+#ifndef MESSAGE_LOG_READER_H
+#define MESSAGE_LOG_READER_H
+
+/// PROJECT
+#include <csapex/model/model_fwd.h>
+#include <csapex/utility/uuid.h>
+#include <csapex/csapex_export.h>
+
+/// SYSTEM
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace csapex
+{
+
+class MessageLogReader;
+typedef std::shared_ptr<MessageLogReader> MessageLogReaderPtr;
+
+/**
+ * @brief The MessageLogReader class gives random access to a log written by a MessageLogWriter.
+ *        The file is mapped into memory, only the records that are read are decoded.
+ *        Logs without an index, e.g. when the recording process crashed, are indexed by scanning their chunks.
+ */
+class CSAPEX_EXPORT MessageLogReader
+{
+public:
+    struct Record
+    {
+        std::chrono::microseconds time;
+        uint64_t stamp;
+        UUID output;
+        TokenDataPtr message;
+    };
+
+public:
+    /**
+     * @throws std::runtime_error if the file cannot be mapped or is not a message log
+     */
+    MessageLogReader(const std::string& path);
+    ~MessageLogReader();
+
+    MessageLogReader(const MessageLogReader&) = delete;
+    MessageLogReader& operator = (const MessageLogReader&) = delete;
+
+    std::size_t size() const;
+    bool empty() const;
+
+    /**
+     * @brief isIndexed returns false, if the index had to be rebuilt
+     */
+    bool isIndexed() const;
+
+    std::vector<UUID> getOutputs() const;
+
+    std::chrono::microseconds getTime(std::size_t index) const;
+    std::size_t getOutput(std::size_t index) const;
+
+    /**
+     * @brief lowerBound finds the first record that was recorded at or after the given time
+     * @return size(), if there is no such record
+     */
+    std::size_t lowerBound(std::chrono::microseconds time) const;
+
+    Record read(std::size_t index) const;
+
+private:
+    const uint8_t* entry(std::size_t index) const;
+
+    void readIndex(uint64_t index_offset);
+    void rebuildIndex();
+
+private:
+    std::string path_;
+    int fd_;
+    const uint8_t* data_;
+    std::size_t size_;
+
+    std::vector<UUID> outputs_;
+
+    const uint8_t* entries_;
+    std::size_t count_;
+    std::vector<uint8_t> rebuilt_entries_;
+
+    bool indexed_;
+};
+
+}
+
+#endif // MESSAGE_LOG_READER_H
@@ -0,0 +1,101 @@
+#ifndef MESSAGE_LOG_WRITER_H
+#define MESSAGE_LOG_WRITER_H
+
+/// PROJECT
+#include <csapex/model/model_fwd.h>
+#include <csapex/serialization/serialization_buffer.h>
+#include <csapex/utility/uuid.h>
+#include <csapex/csapex_export.h>
+
+/// SYSTEM
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace csapex
+{
+
+class MessageLogWriter;
+typedef std::shared_ptr<MessageLogWriter> MessageLogWriterPtr;
+
+/**
+ * @brief The MessageLogWriter class records a stream of messages into a log file.
+ *
+ * Records are collected into chunks, which are appended to the file as a whole.
+ * Each record holds the time since the first record, the stamp of the message, the output it was sent by,
+ * and the message in its binary encoding (see MessageSerializer).
+ * When the log is closed, an index of all records is appended, which lets a MessageLogReader
+ * seek by time or position without reading the records.
+ */
+class CSAPEX_EXPORT MessageLogWriter
+{
+public:
+    static const uint64_t FILE_MAGIC;
+    static const uint64_t INDEX_MAGIC;
+    static const uint32_t CHUNK_MAGIC;
+    static const uint32_t VERSION;
+
+    static const std::size_t FILE_HEADER_LENGTH = 16;
+    static const std::size_t CHUNK_HEADER_LENGTH = 16;
+    static const std::size_t INDEX_ENTRY_LENGTH = 20;
+    static const std::size_t TRAILER_LENGTH = 16;
+
+public:
+    /**
+     * @throws std::runtime_error if the file cannot be created
+     */
+    MessageLogWriter(const std::string& path, std::size_t chunk_size = 1 << 20);
+    ~MessageLogWriter();
+
+    MessageLogWriter(const MessageLogWriter&) = delete;
+    MessageLogWriter& operator = (const MessageLogWriter&) = delete;
+
+    void write(const UUID& output, const TokenData& message);
+    void write(const UUID& output, const TokenData& message, std::chrono::microseconds time);
+
+    /**
+     * @brief flush appends the current chunk to the file
+     */
+    void flush();
+
+    /**
+     * @brief close appends the index, no more records can be written afterwards
+     */
+    void close();
+
+    std::string getPath() const;
+    std::size_t getRecordCount() const;
+
+private:
+    struct IndexEntry
+    {
+        uint64_t time;
+        uint64_t offset;
+        uint32_t output;
+    };
+
+    uint32_t getOutputId(const UUID& output);
+
+private:
+    std::string path_;
+    std::ofstream out_;
+    std::size_t chunk_size_;
+
+    bool started_;
+    std::chrono::steady_clock::time_point start_;
+
+    uint64_t file_offset_;
+    SerializationBuffer chunk_;
+    uint32_t chunk_records_;
+
+    std::vector<IndexEntry> index_;
+    std::vector<UUID> outputs_;
+    std::map<std::string, uint32_t> output_ids_;
+};
+
+}
+
+#endif // MESSAGE_LOG_WRITER_H
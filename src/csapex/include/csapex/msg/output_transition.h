@@ -41,8 +41,12 @@ public:
 public:
     slim_signal::Signal<void()> messages_processed;
 
+protected:
+    Connection::State connectionState(const Connection& connection) const override;
+
 private:
     void fillConnections();
+    bool canContinueWithoutConsumers(Output* output) const;
 
 private:
     std::unordered_map<Output*, std::vector<slim_signal::ScopedConnection>> output_signal_connections_;
@@ -0,0 +1,66 @@
+#ifndef SERIALIZED_TOKEN_CHANNEL_H
+#define SERIALIZED_TOKEN_CHANNEL_H
+
+/// PROJECT
+#include <csapex/model/model_fwd.h>
+#include <csapex/utility/shared_memory_ring.h>
+#include <csapex/serialization/serialization_buffer.h>
+#include <csapex/csapex_export.h>
+
+/// SYSTEM
+#include <chrono>
+#include <mutex>
+
+namespace csapex
+{
+
+class SerializedTokenChannel;
+typedef std::shared_ptr<SerializedTokenChannel> SerializedTokenChannelPtr;
+
+/**
+ * @brief The SerializedTokenChannel class copies serialized tokens between csapex processes on the same host.
+ *        The publishing process creates a channel, the receiving process opens it by name.
+ *        Tokens are encoded with the binary message converters where available, falling back to YAML.
+ *        Messages are identified by their type names, which have to be registered in the MessageFactory of both processes.
+ *
+ *        This is not a zero-copy path: every token is serialized into a buffer, copied into the ring,
+ *        copied out again and deserialized, because the message serializers only work on owning buffers.
+ *        Neither connections nor the remote session use the channel, the nodes on both sides publish and receive explicitly.
+ */
+class CSAPEX_EXPORT SerializedTokenChannel
+{
+public:
+    static SerializedTokenChannelPtr create(const std::string& channel, std::size_t capacity);
+    static SerializedTokenChannelPtr open(const std::string& channel);
+
+    /**
+     * @return false, if the receiver has not made enough room before the timeout
+     * @throws std::runtime_error if the message type cannot be serialized
+     * @throws std::length_error if the message does not fit into the channel
+     */
+    bool publish(const TokenConstPtr& token, std::chrono::milliseconds timeout);
+
+    /**
+     * @return the next token, or nullptr after the timeout
+     * @throws std::runtime_error if the message type is unknown in this process
+     */
+    TokenPtr receive(std::chrono::milliseconds timeout);
+
+    SharedMemoryRingPtr getRing() const;
+
+private:
+    SerializedTokenChannel(SharedMemoryRingPtr ring);
+
+private:
+    SharedMemoryRingPtr ring_;
+
+    std::mutex publish_mtx_;
+    SerializationBuffer publish_buffer_;
+
+    std::mutex receive_mtx_;
+    SerializationBuffer receive_buffer_;
+};
+
+}
+
+#endif // SERIALIZED_TOKEN_CHANNEL_H
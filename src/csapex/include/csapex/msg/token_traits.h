@@ -36,6 +36,17 @@ inline std::shared_ptr<TokenData> makeEmpty<TokenData>()
     return std::shared_ptr<TokenData>(new TokenData("empty"));
 }
 
+/**
+ * @brief makeSharedEmpty returns the same immutable instance on every call,
+ *        only for types without state, like markers
+ */
+template <typename T>
+std::shared_ptr<T const> makeSharedEmpty()
+{
+    static const std::shared_ptr<T const> instance = makeEmpty<T>();
+    return instance;
+}
+
 template <typename M, bool is_message>
 struct MessageContainer;
 
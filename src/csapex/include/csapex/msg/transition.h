@@ -52,6 +52,11 @@ protected:
 
     void trackConnection(Connection* connection, const slim_signal::Connection& c);
 
+    /**
+     * @brief connectionState returns the state of a connection as seen from this side
+     */
+    virtual Connection::State connectionState(const Connection& connection) const;
+
 protected:
     delegate::Delegate0<> activation_fn_;
 
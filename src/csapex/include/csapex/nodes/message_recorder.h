@@ -0,0 +1,42 @@
+#ifndef MESSAGE_RECORDER_H
+#define MESSAGE_RECORDER_H
+
+/// PROJECT
+#include <csapex/model/node.h>
+#include <csapex/model/variadic_io.h>
+#include <csapex/msg/message_log_writer.h>
+
+/// SYSTEM
+#include <mutex>
+
+namespace csapex
+{
+
+/**
+ * @brief The MessageRecorder class writes all messages it receives into a message log,
+ *        which can be played back by a MessageLogProvider.
+ *        Each message is recorded with the output it has been sent from.
+ */
+class CSAPEX_EXPORT MessageRecorder : public Node, public VariadicInputs
+{
+public:
+    void setup(csapex::NodeModifier& node_modifier) override;
+    void setupParameters(Parameterizable& parameters) override;
+    void process() override;
+    void tearDown() override;
+
+    Input* createVariadicInput(TokenDataConstPtr type, const std::string& label, bool optional) override;
+
+    std::size_t getRecordCount() const;
+
+private:
+    void openLog(const std::string& path);
+
+private:
+    mutable std::mutex writer_mutex_;
+    MessageLogWriterPtr writer_;
+};
+
+}
+
+#endif // MESSAGE_RECORDER_H
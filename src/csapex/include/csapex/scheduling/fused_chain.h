@@ -0,0 +1,84 @@
+#ifndef FUSED_CHAIN_H
+#define FUSED_CHAIN_H
+
+/// PROJECT
+#include <csapex/scheduling/scheduling_fwd.h>
+#include <csapex/utility/uuid.h>
+#include <csapex/csapex_export.h>
+
+/// SYSTEM
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace csapex
+{
+
+/**
+ * @brief The FusedChain class executes a chain of task generators as one task.
+ *        When a member becomes ready while another member is executed on the same scheduler,
+ *        its task is executed directly afterwards by the same thread,
+ *        instead of being queued and picked up by the next free worker.
+ *        Paused or stepping members are always scheduled, so that the scheduler decides when they run.
+ */
+class CSAPEX_EXPORT FusedChain
+{
+public:
+    FusedChain(const std::vector<UUID>& members);
+
+    std::vector<UUID> getMembers() const;
+
+    /**
+     * @brief run executes the execution of a member, followed by all tasks deferred during it
+     */
+    void run(TaskGenerator* generator, const std::function<void()>& execution);
+
+    /**
+     * @brief defer takes over a task that would otherwise be scheduled
+     * @return false, iff the task has to be scheduled, because no member of this chain
+     *         is executed by the calling thread on the generator's scheduler
+     */
+    bool defer(TaskGenerator* generator, const TaskPtr& task);
+
+    /**
+     * @brief getFusedExecutions returns how many tasks have been executed without being scheduled
+     */
+    long getFusedExecutions() const;
+
+    /**
+     * @brief invalidate stops fusing, tasks that are still deferred are scheduled
+     */
+    void invalidate();
+    bool isValid() const;
+
+private:
+    struct Pending
+    {
+        // the member might be removed from the graph while its task is deferred
+        std::weak_ptr<TaskGenerator> generator;
+        TaskPtr task;
+    };
+
+    struct Active
+    {
+        FusedChain* chain;
+        Scheduler* scheduler;
+        std::deque<Pending> pending;
+    };
+
+    void executeInline(Scheduler* scheduler, const Pending& pending);
+    void unlock(Scheduler* scheduler, TaskGenerator* generator);
+
+private:
+    static thread_local Active* active_;
+
+    std::vector<UUID> members_;
+    std::atomic<long> fused_executions_;
+    std::atomic<bool> valid_;
+};
+
+}
+
+#endif // FUSED_CHAIN_H
@@ -0,0 +1,68 @@
+#ifndef INLINE_EXECUTOR_H
+#define INLINE_EXECUTOR_H
+
+/// COMPONENT
+#include <csapex/scheduling/executor.h>
+#include <csapex/scheduling/inline_scheduler.h>
+#include <csapex/core/core_fwd.h>
+
+/// SYSTEM
+#include <chrono>
+
+namespace csapex
+{
+
+/**
+ * @brief The InlineExecutor class runs all task generators on the calling thread.
+ *        It starts no threads, neither for the nodes nor for delayed tasks, the caller drives it
+ *        with spinOnce, runUntilIdle or runFor. This is meant for threadless deployments
+ *        and benchmarks, where the graph should only cost as much as its nodes' computations.
+ */
+class CSAPEX_EXPORT InlineExecutor : public Executor
+{
+public:
+    InlineExecutor(ExceptionHandler& handler);
+    ~InlineExecutor();
+
+    void add(TaskGenerator* generator) override;
+    void remove(TaskGenerator* generator) override;
+
+    void start() override;
+    void stop() override;
+    void clear() override;
+
+    bool isRunning() const override;
+
+    InlineScheduler* getScheduler();
+
+    /**
+     * @brief spinOnce executes the next ready task
+     * @return false, iff no task was ready
+     */
+    bool spinOnce();
+
+    /**
+     * @brief runUntilIdle executes tasks until none is ready anymore
+     * @return the number of executed tasks
+     */
+    std::size_t runUntilIdle();
+
+    /**
+     * @brief runFor executes tasks for the given duration
+     */
+    void runFor(std::chrono::steady_clock::duration duration);
+
+protected:
+    void pauseChanged(bool pause) override;
+    void steppingChanged(bool performStep) override;
+    void performStep() override;
+
+    bool isStepDone() override;
+
+private:
+    InlineScheduler scheduler_;
+};
+
+}
+
+#endif // INLINE_EXECUTOR_H
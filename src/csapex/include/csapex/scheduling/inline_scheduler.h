@@ -0,0 +1,122 @@
+#ifndef INLINE_SCHEDULER_H
+#define INLINE_SCHEDULER_H
+
+/// PROJECT
+#include <csapex/scheduling/scheduler.h>
+#include <csapex/core/core_fwd.h>
+
+/// SYSTEM
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace csapex
+{
+
+/**
+ * @brief The InlineScheduler class executes its tasks on the thread that drives it, without any threads of its own.
+ *        Ready tasks are kept on a stack, so that the successors of a node run right after it (depth first).
+ *        Tasks scheduled by the driving thread are queued without locking, tasks from other threads
+ *        (e.g. the user interface) are handed over through a separate locked queue.
+ */
+class CSAPEX_EXPORT InlineScheduler : public Scheduler
+{
+public:
+    InlineScheduler(ExceptionHandler& handler, int id, const std::string& name);
+    ~InlineScheduler();
+
+    int id() const override;
+    std::string getName() const override;
+    void setName(const std::string& name) override;
+
+    void setPause(bool pause) override;
+    bool isPaused() const;
+
+    bool canStartStepping() const override;
+    void setSteppingMode(bool stepping) override;
+    bool isStepping() const override;
+    bool isStepDone() const override;
+    void step() override;
+
+    void start() override;
+    void stop() override;
+    void clear() override;
+    bool isRunning() const;
+
+    bool isEmpty() const override;
+
+    void add(TaskGeneratorPtr schedulable) override;
+    void add(TaskGeneratorPtr schedulable, const std::vector<TaskPtr>& initial_tasks) override;
+    std::vector<TaskPtr> remove(TaskGenerator* schedulable) override;
+
+    void schedule(TaskPtr schedulable) override;
+    void scheduleDelayed(TaskPtr schedulable, std::chrono::steady_clock::time_point time) override;
+
+    /**
+     * @brief spinOnce executes the next ready task on the calling thread,
+     *        which becomes the driving thread of this scheduler
+     * @return false, iff no task was ready
+     */
+    bool spinOnce();
+
+    /**
+     * @brief runUntilIdle executes tasks until none is ready anymore, delayed tasks are not waited for
+     * @return the number of executed tasks
+     */
+    std::size_t runUntilIdle();
+
+    /**
+     * @brief runFor executes tasks for the given duration and sleeps while none is ready
+     */
+    void runFor(std::chrono::steady_clock::duration duration);
+
+    /**
+     * @brief getNextDueTime returns when the earliest delayed task is due, or time_point::max() if there is none
+     */
+    std::chrono::steady_clock::time_point getNextDueTime() const;
+
+private:
+    bool isExecutingThread() const;
+    bool spinOnceLocked();
+    void takeForeignTasks();
+    void releaseDueTasks(std::chrono::steady_clock::time_point now);
+    void execute(const TaskPtr& task);
+    void checkIfStepIsDone();
+
+private:
+    ExceptionHandler& handler_;
+
+    int id_;
+    std::string name_;
+
+    std::vector<TaskGeneratorPtr> generators_;
+    std::map<TaskGenerator*, slim_signal::ScopedConnection> generator_connections_;
+
+    // held by the driving thread while it executes tasks, so that other threads can change the structure safely.
+    // it is recursive, because tasks may add or remove generators of this scheduler while they are executed
+    mutable std::recursive_mutex execution_mtx_;
+
+    // only accessed by the driving thread or with execution_mtx_ held
+    std::vector<TaskPtr> ready_;
+    std::multimap<std::chrono::steady_clock::time_point, TaskPtr> delayed_;
+
+    std::atomic<std::thread::id> driving_thread_;
+    // only written by the driving thread with execution_mtx_ held
+    bool executing_;
+
+    // tasks scheduled by other threads
+    mutable std::mutex foreign_mtx_;
+    std::vector<std::pair<std::chrono::steady_clock::time_point, TaskPtr>> foreign_;
+    std::atomic<bool> has_foreign_;
+
+    std::atomic<bool> running_;
+    std::atomic<bool> pause_;
+    std::atomic<bool> stepping_;
+};
+
+}
+
+#endif // INLINE_SCHEDULER_H
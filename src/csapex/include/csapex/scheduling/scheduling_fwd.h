@@ -15,6 +15,9 @@
 namespace csapex
 {
 FWD(Executor);
+FWD(FusedChain);
+FWD(InlineExecutor);
+FWD(InlineScheduler);
 FWD(Scheduler);
 FWD(TaskGenerator);
 FWD(ThreadPool);
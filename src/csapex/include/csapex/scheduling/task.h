@@ -7,6 +7,8 @@
 
 /// SYSTEM
 #include <functional>
+#include <atomic>
+#include <chrono>
 
 namespace csapex
 {
@@ -25,6 +27,38 @@ public:
     void setScheduled(bool scheduled);
     bool isScheduled() const;
 
+    /**
+     * @brief markScheduled atomically marks this task as scheduled
+     * @return true, iff the task was not scheduled before
+     */
+    bool markScheduled();
+
+    /**
+     * @brief setDeadline marks the task as time critical,
+     *        tasks with a deadline are executed before all others, earliest deadline first
+     */
+    void setDeadline(std::chrono::steady_clock::time_point deadline);
+    void clearDeadline();
+    bool hasDeadline() const;
+    std::chrono::steady_clock::time_point getDeadline() const;
+
+    /**
+     * @brief getScheduleTime, getStartTime and getFinishTime return when the task was last scheduled,
+     *        started and finished, or the epoch of the steady clock if that has not happened yet
+     */
+    std::chrono::steady_clock::time_point getScheduleTime() const;
+    std::chrono::steady_clock::time_point getStartTime() const;
+    std::chrono::steady_clock::time_point getFinishTime() const;
+
+    /**
+     * @brief getSchedulingDelay returns how long the last execution waited in a queue
+     */
+    std::chrono::nanoseconds getSchedulingDelay() const;
+    /**
+     * @brief getRunTime returns how long the last execution took
+     */
+    std::chrono::nanoseconds getRunTime() const;
+
     TaskGenerator* getParent() const;
     std::string getName() const;
 
@@ -33,8 +67,16 @@ private:
     std::string name_;
     std::function<void()> callback_;
 
-    long priority_;
-    bool scheduled_;
+    std::atomic<long> priority_;
+    std::atomic<bool> scheduled_;
+
+    // nanoseconds since the epoch of the steady clock, 0 if the task has no deadline
+    std::atomic<long long> deadline_;
+
+    // nanoseconds since the epoch of the steady clock
+    std::atomic<long long> scheduled_at_;
+    std::atomic<long long> started_at_;
+    std::atomic<long long> finished_at_;
 };
 
 }
@@ -8,6 +8,10 @@
 
 /// SYSTEM
 #include <csapex/utility/slim_signal.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
 
 namespace csapex
 {
@@ -15,6 +19,7 @@ namespace csapex
 class CSAPEX_EXPORT TaskGenerator : public std::enable_shared_from_this<TaskGenerator>
 {
 public:
+    TaskGenerator();
     virtual ~TaskGenerator();
 
     virtual void assignToScheduler(Scheduler* scheduler) = 0;
@@ -36,10 +41,41 @@ public:
 
     virtual void reset() = 0;
 
+    /**
+     * @brief tryLockExecution guarantees that at most one task of this generator is executed at a time
+     * @return true, iff no other task of this generator is currently being executed
+     */
+    bool tryLockExecution();
+
+    /**
+     * @brief lockExecution waits until the task currently being executed is done, no other task is started afterwards
+     */
+    void lockExecution();
+
+    /**
+     * @brief unlockExecution marks the end of the current task
+     * @return the tasks that have been held back during the execution
+     */
+    std::vector<TaskPtr> unlockExecution();
+
+    /**
+     * @brief holdBack defers a task until the currently executed task is done
+     * @return false, iff no task is being executed anymore
+     */
+    bool holdBack(const TaskPtr& task);
+    std::vector<TaskPtr> takeHeldBackTasks();
+
 public:
     slim_signal::Signal<void()> stepping_enabled;
     slim_signal::Signal<void()> begin_step;
     slim_signal::Signal<void()> end_step;
+
+private:
+    std::atomic<bool> executing_;
+
+    std::mutex held_back_mtx_;
+    std::condition_variable execution_unlocked_;
+    std::vector<TaskPtr> held_back_;
 };
 
 }
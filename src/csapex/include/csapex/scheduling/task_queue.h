@@ -0,0 +1,93 @@
+#ifndef TASK_QUEUE_H
+#define TASK_QUEUE_H
+
+/// PROJECT
+#include <csapex/scheduling/scheduling_fwd.h>
+#include <csapex/utility/mpmc_ring_buffer.hpp>
+#include <csapex/csapex_export.h>
+
+/// SYSTEM
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace csapex
+{
+
+/**
+ * @brief The TaskQueue class is a lock-free priority queue for tasks.
+ *        Every priority level is a bounded FIFO ring buffer, tasks that don't fit
+ *        into their ring are kept in a locked overflow list.
+ *        Tasks with a deadline are kept in a locked heap and popped before all others,
+ *        earliest deadline first.
+ */
+class CSAPEX_EXPORT TaskQueue
+{
+public:
+    enum {
+        MIN_PRIORITY = -4,
+        MAX_PRIORITY = 3,
+        PRIORITY_LEVELS = MAX_PRIORITY - MIN_PRIORITY + 1,
+
+        DEFAULT_CAPACITY = 256
+    };
+
+    static int levelOf(long priority);
+
+public:
+    TaskQueue(std::size_t capacity_per_level = DEFAULT_CAPACITY);
+    ~TaskQueue();
+
+    TaskQueue(const TaskQueue&) = delete;
+    TaskQueue& operator = (const TaskQueue&) = delete;
+
+    void push(const TaskPtr& task);
+
+    /**
+     * @brief pop removes the task with the earliest deadline, or the oldest task with the highest priority
+     * @return nullptr, iff the queue is empty
+     */
+    TaskPtr pop();
+
+    /**
+     * @brief drain removes all tasks, ordered by priority
+     */
+    std::vector<TaskPtr> drain();
+
+    std::size_t size() const;
+    bool empty() const;
+
+private:
+    typedef MpmcRingBuffer<TaskPtr> Ring;
+
+    Ring* getRing(int level);
+
+    struct DeadlineEntry
+    {
+        long long deadline;
+        unsigned long long order;
+        TaskPtr task;
+
+        bool operator < (const DeadlineEntry& other) const;
+    };
+
+private:
+    std::size_t capacity_;
+
+    std::atomic<Ring*> rings_[PRIORITY_LEVELS];
+    std::atomic<std::size_t> size_;
+
+    std::mutex overflow_mtx_;
+    std::deque<TaskPtr> overflow_[PRIORITY_LEVELS];
+    std::atomic<std::size_t> overflow_size_;
+
+    std::mutex deadline_mtx_;
+    std::vector<DeadlineEntry> deadline_heap_;
+    unsigned long long deadline_order_;
+    std::atomic<std::size_t> deadline_size_;
+};
+
+}
+
+#endif // TASK_QUEUE_H
@@ -4,8 +4,10 @@
 /// PROJECT
 #include <csapex/scheduling/scheduler.h>
 #include <csapex/scheduling/task.h>
+#include <csapex/scheduling/task_queue.h>
 #include <csapex/core/core_fwd.h>
 #include <csapex/utility/utility_fwd.h>
+#include <csapex/utility/histogram.h>
 
 /// SYSTEM
 #include <string>
@@ -13,8 +15,9 @@
 #include <vector>
 #include <atomic>
 #include <condition_variable>
-#include <deque>
-#include <set>
+#include <map>
+#include <memory>
+#include <chrono>
 
 namespace YAML
 {
@@ -33,6 +36,92 @@ public:
         DEFAULT_GROUP_ID = 1,
         MINIMUM_THREAD_ID = 2
     };
+    enum {
+        MAX_WORKERS = 64
+    };
+
+    /**
+     * @brief The WaitPolicy enum determines how idle workers wait for new tasks
+     *        BLOCK: sleep on a condition variable until a task is scheduled
+     *        SPIN_THEN_PARK: poll for the spin duration, then sleep
+     *        BUSY_POLL: never sleep, only for groups on isolated cores
+     */
+    enum class WaitPolicy {
+        BLOCK,
+        SPIN_THEN_PARK,
+        BUSY_POLL
+    };
+
+    /**
+     * @brief The WakeLatency struct summarizes the time between scheduling a task
+     *        in an idle group and a worker picking it up
+     */
+    struct WakeLatency
+    {
+        std::size_t wake_ups;
+        std::chrono::nanoseconds mean;
+        std::chrono::nanoseconds max;
+    };
+
+    /**
+     * @brief The RealtimePolicy enum selects the kernel scheduling class of the workers
+     *        NONE: normal time sharing
+     *        FIFO: SCHED_FIFO with a fixed priority
+     *        DEADLINE: SCHED_DEADLINE with a runtime budget per period
+     */
+    enum class RealtimePolicy {
+        NONE,
+        FIFO,
+        DEADLINE
+    };
+
+    /**
+     * @brief The Load struct summarizes how busy the workers of a group are
+     */
+    struct Load
+    {
+        std::size_t running_workers;
+        std::size_t queued_tasks;
+        // fraction of the running workers' time spent executing tasks since the last reset
+        double utilization;
+        std::size_t started_workers;
+        std::size_t released_workers;
+    };
+
+    /**
+     * @brief The Telemetry struct contains histograms of the group's scheduling behavior
+     */
+    struct Telemetry
+    {
+        Telemetry();
+
+        // queued tasks of the group, sampled whenever a task is scheduled
+        Histogram queue_depth;
+        // nanoseconds between scheduling a task and starting it
+        Histogram scheduling_delay;
+        // nanoseconds of task execution
+        Histogram run_time;
+        // percent of the running workers' time spent executing tasks, per UTILIZATION_WINDOW
+        Histogram utilization;
+    };
+
+    static const std::chrono::milliseconds UTILIZATION_WINDOW;
+
+    struct RealtimeParameters
+    {
+        RealtimeParameters();
+
+        RealtimePolicy policy;
+
+        // only used by FIFO
+        int priority;
+
+        // only used by DEADLINE
+        std::chrono::microseconds runtime;
+        std::chrono::microseconds deadline;
+        std::chrono::microseconds period;
+    };
+
 public:
     static int nextId();
 
@@ -48,7 +137,80 @@ public:
 
     CpuAffinityPtr getCpuAffinity() const;
 
-    const std::thread &thread() const;
+    /**
+     * @brief setNumaNode restricts the workers to the cpus of one NUMA node
+     */
+    void setNumaNode(int node);
+    /**
+     * @brief getNumaNode returns the NUMA node of the workers, or -1 if their affinity spans multiple nodes
+     */
+    int getNumaNode() const;
+
+    /**
+     * @brief setLocalPayloads makes the producers of this group's nodes allocate large payloads on the group's NUMA node
+     */
+    void setLocalPayloads(bool local);
+    bool hasLocalPayloads() const;
+
+    /**
+     * @brief setWorkerCount changes the number of threads that execute the tasks of this group.
+     *        Tasks of the same generator are never executed concurrently.
+     *        When called by one of the group's own workers, the change is applied asynchronously.
+     * @param workers number of worker threads, between 1 and MAX_WORKERS
+     */
+    void setWorkerCount(std::size_t workers);
+    std::size_t getWorkerCount() const;
+
+    /**
+     * @brief setElastic makes the group start workers only on demand and release them when they are idle.
+     *        getWorkerCount() is then the maximum number of running workers.
+     */
+    void setElastic(bool elastic);
+    bool isElastic() const;
+
+    /**
+     * @brief setIdleTimeout sets how long an elastic worker sleeps without tasks before its thread is released
+     */
+    void setIdleTimeout(std::chrono::milliseconds timeout);
+    std::chrono::milliseconds getIdleTimeout() const;
+
+    /**
+     * @brief setGrowThreshold sets how many tasks may be queued per running worker before an elastic group starts another one
+     */
+    void setGrowThreshold(std::size_t tasks_per_worker);
+    std::size_t getGrowThreshold() const;
+
+    Load getLoad() const;
+    void resetLoad();
+
+    Telemetry getTelemetry() const;
+    void resetTelemetry();
+    void saveTelemetry(YAML::Node& node) const;
+
+    void setWaitPolicy(WaitPolicy policy);
+    WaitPolicy getWaitPolicy() const;
+
+    /**
+     * @brief setSpinDuration sets how long workers poll before sleeping with WaitPolicy::SPIN_THEN_PARK
+     */
+    void setSpinDuration(std::chrono::microseconds duration);
+    std::chrono::microseconds getSpinDuration() const;
+
+    WakeLatency getWakeLatency() const;
+    void resetWakeLatency();
+
+    /**
+     * @brief setRealtimeParameters changes the kernel scheduling policy of all workers.
+     *        Real time policies usually require CAP_SYS_NICE, failures are reported on stderr.
+     */
+    void setRealtimeParameters(const RealtimeParameters& parameters);
+    RealtimeParameters getRealtimeParameters() const;
+
+    static std::string realtimePolicyToString(RealtimePolicy policy);
+    static RealtimePolicy realtimePolicyFromString(const std::string& policy);
+
+    static std::string waitPolicyToString(WaitPolicy policy);
+    static WaitPolicy waitPolicyFromString(const std::string& policy);
 
     std::size_t size() const;
     virtual bool isEmpty() const override;
@@ -73,7 +235,7 @@ public:
     virtual std::vector<TaskPtr> remove(TaskGenerator* generator) override;
 
     virtual void schedule(TaskPtr schedulable) override;    
-    virtual void scheduleDelayed(TaskPtr schedulable, std::chrono::system_clock::time_point time) override;
+    virtual void scheduleDelayed(TaskPtr schedulable, std::chrono::steady_clock::time_point time) override;
 
     std::vector<TaskGeneratorPtr>::iterator begin();
     std::vector<TaskGeneratorPtr>::const_iterator begin() const;
@@ -87,16 +249,65 @@ public:
     slim_signal::Signal<void (TaskGeneratorPtr)> generator_added;
     slim_signal::Signal<void (TaskGeneratorPtr)> generator_removed;
 
+private:
+    struct Worker
+    {
+        Worker(ThreadGroup* group, std::size_t index);
+
+        ThreadGroup* group;
+        std::size_t index;
+
+        std::thread thread;
+        // kernel thread id, needed for SCHED_DEADLINE
+        std::atomic<long> tid;
+
+        TaskQueue tasks;
+
+        std::recursive_mutex execution_mtx;
+
+        // false for workers of an elastic group that have been released or not started yet
+        std::atomic<bool> live;
+        std::atomic<long long> live_since;
+    };
+
+    enum class WaitResult {
+        TASKS_AVAILABLE,
+        STOPPED,
+        RELEASED
+    };
+
 private:
     void setup();
-    void schedulingLoop();
+    void schedulingLoop(Worker* worker);
     void updateAffinity();
+    void applyAffinity(Worker* worker);
+    void updateRealtimeParameters();
+    void applyRealtimeParameters(Worker* worker, std::thread::native_handle_type handle);
+
+    void applyWorkerCount(std::size_t workers);
+    void deferWorkerCount(std::size_t workers);
+
+    void createWorkers(std::size_t count);
+    void startWorkers();
+    void startWorker(Worker* worker);
+    void stopWorkers();
+    void growIfNeeded();
+    void releaseWorker(Worker* worker);
+
+    std::vector<std::unique_lock<std::recursive_mutex>> lockExecution() const;
+
+    Worker* selectWorker();
+    void enqueue(Worker* worker, const TaskPtr& task);
+    TaskPtr takeNextTask(Worker* worker);
+    std::vector<TaskPtr> drainTasks();
 
-    bool waitForTasks();
+    WaitResult waitForTasks(Worker* worker);
+    void recordWakeUp();
     void handlePause();
-    bool executeNextTask();
+    bool executeNextTask(Worker* worker);
 
-    void executeTask(const TaskPtr& task);
+    void executeTask(Worker* worker, const TaskPtr& task);
+    void recordExecution(const TaskPtr& task, std::chrono::steady_clock::time_point scheduled);
 
     void checkIfStepIsDone();
 
@@ -111,10 +322,26 @@ private:
     std::string name_;
 
     CpuAffinityPtr cpu_affinity_;
+    std::atomic<int> numa_node_;
+    std::atomic<bool> local_payloads_;
 
     TimedQueuePtr timed_queue_;
 
-    std::thread scheduler_thread_;
+    // workers are never deallocated before the group is destroyed,
+    // so that schedule() can access them without locking
+    std::unique_ptr<Worker> workers_[MAX_WORKERS];
+    std::atomic<std::size_t> allocated_workers_;
+    std::atomic<std::size_t> active_workers_;
+    std::atomic<std::size_t> next_worker_;
+    std::atomic<std::size_t> live_workers_;
+
+    static thread_local Worker* current_worker_;
+
+    // tasks with a deadline are shared by all workers, so that the group executes them earliest deadline first
+    TaskQueue deadline_tasks_;
+
+    mutable std::mutex realtime_mtx_;
+    RealtimeParameters realtime_;
 
     std::vector<TaskGeneratorPtr> generators_;
     std::map<TaskGenerator*, std::vector<slim_signal::ScopedConnection>> generator_connections_;
@@ -122,23 +349,49 @@ private:
     std::condition_variable_any work_available_;
     std::condition_variable_any pause_changed_;
 
-    std::recursive_mutex tasks_mtx_;
-    struct greater
-    {
-        bool operator () (const TaskPtr& a, const TaskPtr& b) {
-            return a->getPriority() > b->getPriority();
-        }
-    };
+    // only used for sleeping and for structural changes, scheduling is lock-free
+    mutable std::recursive_mutex tasks_mtx_;
+    std::atomic<std::size_t> queued_tasks_;
+    std::atomic<int> sleeping_workers_;
+
+    std::atomic<bool> elastic_;
+    std::atomic<long> idle_timeout_ms_;
+    std::atomic<std::size_t> grow_threshold_;
 
-    std::multiset<TaskPtr, greater> tasks_;
+    // steady clock times in ns, accumulated since load_reset_at_
+    std::atomic<long long> load_reset_at_;
+    std::atomic<long long> busy_ns_;
+    std::atomic<long long> live_ns_;
+    std::atomic<std::size_t> started_workers_;
+    std::atomic<std::size_t> released_workers_;
+
+    Telemetry telemetry_;
+    std::atomic<long long> utilization_window_start_;
+    std::atomic<long long> utilization_window_busy_ns_;
+
+    std::atomic<WaitPolicy> wait_policy_;
+    std::atomic<long> spin_duration_us_;
+
+    // steady clock time in ns at which a task was last scheduled in an empty group, 0 after a wake up
+    std::atomic<long long> wake_requested_at_;
+    std::atomic<long long> wake_ups_;
+    std::atomic<long long> wake_latency_sum_;
+    std::atomic<long long> wake_latency_max_;
+
+    // worker count changes requested by the group's own workers
+    std::mutex resize_mtx_;
+    std::thread resize_thread_;
+    std::size_t pending_worker_count_;
+    bool resizing_;
+
+    // serializes the code that rebuilds workers_: resizes, start() and stop()
+    std::mutex workers_mtx_;
 
     std::recursive_mutex state_mtx_;
     std::atomic<bool> running_;
     std::atomic<bool> pause_;
     std::atomic<bool> stepping_;
 
-    mutable std::recursive_mutex execution_mtx_;
-
 };
 
 }
@@ -60,12 +60,50 @@ public:
 
     void useDefaultThreadFor(TaskGenerator *task);
 
+    /**
+     * @brief partition distributes weighted tasks onto a number of groups.
+     *        Every group gets roughly the same total cost, while connected tasks
+     *        are kept in the same group where possible.
+     * @param costs the measured execution cost of each task
+     * @param edges pairs of indices into costs, connecting two tasks
+     * @param groups the number of groups to create
+     * @return the group index in [0, groups) for each task
+     */
+    static std::vector<std::size_t> partition(const std::vector<double>& costs,
+                                              const std::vector<std::pair<std::size_t, std::size_t>>& edges,
+                                              std::size_t groups);
+
+    /**
+     * @brief placeOnNumaNodes assigns thread groups to NUMA nodes, so that connected groups share a node.
+     *        Every node gets a load proportional to its number of cpus, connected groups are only
+     *        split up if they do not fit onto one node together.
+     * @param loads the load of each group, e.g. the profiled execution time of its nodes
+     * @param edges pairs of indices into loads, connecting two groups that exchange messages
+     * @param node_cpus the number of cpus of each NUMA node
+     * @return the index into node_cpus for each group
+     */
+    static std::vector<std::size_t> placeOnNumaNodes(const std::vector<double>& loads,
+                                                     const std::vector<std::pair<std::size_t, std::size_t>>& edges,
+                                                     const std::vector<std::size_t>& node_cpus);
+
     void saveSettings(YAML::Node&);
     void loadSettings(YAML::Node&);
 
+    /**
+     * @brief saveTelemetry writes the load and scheduling histograms of every group
+     */
+    void saveTelemetry(YAML::Node& node);
+    void resetTelemetry();
+
     void setPrivateThreadGroupCpuAffinity(const std::vector<bool>& affinity);
     std::vector<bool> getPrivateThreadGroupCpuAffinity() const;
 
+    /**
+     * @brief setPrivateThreadGroupsElastic lets the threads of private groups be released while their node is idle
+     */
+    void setPrivateThreadGroupsElastic(bool elastic);
+    bool arePrivateThreadGroupsElastic() const;
+
 public:
     slim_signal::Signal<void (ThreadGroupPtr)> group_created;
     slim_signal::Signal<void (ThreadGroupPtr)> group_removed;
@@ -84,6 +122,7 @@ protected:
 private:
     void setup();
     void assignGeneratorToGroup(TaskGenerator* task, ThreadGroup* group);
+    void forgetAssignmentsTo(ThreadGroup* group);
 
     bool isInPrivateThread(TaskGenerator* task) const;
     bool isInGroup(TaskGenerator* task, int id) const;
@@ -106,6 +145,7 @@ private:
     std::map<TaskGenerator*, slim_signal::ScopedConnection> group_connection_;
 
     CpuAffinityPtr private_group_cpu_affinity_;
+    bool private_groups_elastic_;
     std::map<ThreadGroup*, std::vector<slim_signal::ScopedConnection>> private_group_connections_;
 };
 
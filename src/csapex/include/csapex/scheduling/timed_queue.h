@@ -3,18 +3,48 @@
 
 /// COMPONENT
 #include <csapex/scheduling/scheduling_fwd.h>
+#include <csapex/csapex_export.h>
 
 /// SYSTEM
+#include <atomic>
+#include <memory>
 #include <thread>
+#include <mutex>
 #include <condition_variable>
 #include <chrono>
-#include <set>
+#include <cstdint>
+#include <map>
+#include <vector>
 
 namespace csapex
 {
 
-class TimedQueue
+/**
+ * @brief The TimedQueue class schedules tasks at a given point in time.
+ *        Pending tasks are kept in a hierarchical timing wheel on the monotonic clock,
+ *        a single thread sleeps until the next absolute deadline and then releases
+ *        all expired tasks at once.
+ */
+class CSAPEX_EXPORT TimedQueue
 {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief The Lateness struct describes how late a task was released
+     */
+    struct Lateness
+    {
+        Lateness();
+
+        std::chrono::nanoseconds mean() const;
+
+        std::size_t releases;
+        std::chrono::nanoseconds last;
+        std::chrono::nanoseconds max;
+        std::chrono::nanoseconds total;
+    };
+
 public:
     TimedQueue();
     ~TimedQueue();
@@ -22,40 +52,75 @@ public:
     void start();
     void stop();
 
-    void schedule(SchedulerPtr scheduler, TaskPtr schedulable, std::chrono::system_clock::time_point time);
+    void schedule(SchedulerPtr scheduler, TaskPtr schedulable, Clock::time_point time);
 
-private:
-    void loop();
-    void sleep();
+    std::size_t size() const;
+
+    Lateness getLateness(const TaskPtr& task) const;
 
 private:
-    std::thread scheduling_thread_;
-    std::thread sleeping_thread_;
+    enum {
+        SLOT_BITS = 6,
+        SLOTS = 1 << SLOT_BITS,
+        LEVELS = 5
+    };
+
+    // the wheel works on ticks of one microsecond
+    typedef std::chrono::microseconds Resolution;
 
-    bool scheduling_running_;
-    bool sleeping_running_;
+    static const uint64_t NO_TICK;
 
     struct Unit {
         SchedulerPtr scheduler;
         TaskPtr schedulable;
-        std::chrono::system_clock::time_point time;
+        Clock::time_point time;
+        uint64_t tick;
     };
 
-    struct UnitCompare
-    {
-        bool operator() (const Unit& a, const Unit& b) const
-        {
-            return a.time < b.time;
-        }
+    struct LatenessRecord {
+        TaskWeakPtr task;
+        Lateness lateness;
     };
 
-    std::mutex task_mtx_;
-    std::condition_variable tasks_changed_;
-    std::set<Unit, UnitCompare> tasks_;
+private:
+    void loop();
+
+    void insert(Unit&& unit);
+    void advance(uint64_t tick);
+    uint64_t nextEventTick() const;
+
+    void release(std::vector<Unit>& units);
+
+    void sleepUntil(uint64_t tick, std::unique_lock<std::mutex>& lock);
+    void wakeUp();
+
+    static uint64_t toTick(Clock::time_point time);
+    static Clock::time_point fromTick(uint64_t tick);
+
+private:
+    std::thread timer_thread_;
+    bool running_;
+
+    // the released tasks may hold the last reference to this queue, then it is destroyed by the timer thread
+    std::shared_ptr<std::atomic<bool>> alive_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable wake_up_;
+    int timer_fd_;
+    int wake_up_fd_;
+
+    std::vector<Unit> wheel_[LEVELS][SLOTS];
+    uint64_t occupied_[LEVELS];
+    std::vector<Unit> overflow_;
+    std::vector<Unit> expired_;
+
+    uint64_t current_tick_;
+    uint64_t wake_up_tick_;
+    std::size_t size_;
 
-    std::mutex sleep_mtx_;
-    std::condition_variable next_wake_up_changed_;
-    std::chrono::system_clock::time_point next_wake_up_;
+    mutable std::mutex lateness_mtx_;
+    std::map<const Task*, LatenessRecord> lateness_;
+    std::size_t releases_;
 };
 
 }
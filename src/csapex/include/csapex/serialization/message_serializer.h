@@ -4,6 +4,7 @@
 /// PROJECT
 #include <csapex/model/token_data.h>
 #include <csapex/msg/token_traits.h>
+#include <csapex/serialization/serialization_fwd.h>
 #include <csapex/utility/singleton.hpp>
 #include <csapex/utility/tmp.hpp>
 #include <csapex/utility/type.h>
@@ -14,6 +15,7 @@
 #include <functional>
 
 HAS_MEM_FUNC(encode, has_yaml_implementation);
+HAS_MEM_FUNC(encode, has_binary_implementation);
 
 namespace csapex
 {
@@ -31,6 +33,25 @@ static bool decode(const YAML::Node& node, Message& msg) {
 };
 
 
+/**
+ * @brief BinarySerializer can be specialized to transmit a message type without YAML.
+ *        encode returns false if the message at hand can only be represented as YAML.
+ */
+template <typename Message, typename Selector = void>
+struct BinarySerializer
+{
+};
+
+/// types that SerializationBuffer can write directly
+template <typename T>
+struct is_binary_primitive : public std::integral_constant < bool,
+        std::is_integral<T>::value ||
+        std::is_same<T, float>::value || std::is_same<T, double>::value ||
+        std::is_same<T, std::string>::value
+>
+{};
+
+
 template <typename Message>
 YAML::Node encodeMessage(const csapex::TokenData& msg) {
     return serial::Serializer<Message>::encode(dynamic_cast<const Message&>(msg));
@@ -40,6 +61,15 @@ bool decodeMessage(const YAML::Node& node, csapex::TokenData& msg) {
     return serial::Serializer<Message>::decode(node, dynamic_cast<Message&>(msg));
 }
 
+template <typename Message>
+bool encodeBinaryMessage(const csapex::TokenData& msg, SerializationBuffer& data) {
+    return serial::BinarySerializer<Message>::encode(dynamic_cast<const Message&>(msg), data);
+}
+template <typename Message>
+void decodeBinaryMessage(SerializationBuffer& data, csapex::TokenData& msg) {
+    serial::BinarySerializer<Message>::decode(data, dynamic_cast<Message&>(msg));
+}
+
 }
 
 class CSAPEX_EXPORT MessageSerializer : public Singleton<MessageSerializer>
@@ -60,6 +90,19 @@ public:
         Decoder decoder;
     };
 
+    struct BinaryConverter
+    {
+        typedef std::function<bool(const csapex::TokenData&, SerializationBuffer&)> Encoder;
+        typedef std::function<void(SerializationBuffer&, csapex::TokenData&)> Decoder;
+
+        BinaryConverter(Encoder encode, Decoder decode)
+            : encoder(encode), decoder(decode)
+        {}
+
+        Encoder encoder;
+        Decoder decoder;
+    };
+
     typedef std::runtime_error SerializationError;
     typedef std::runtime_error DeserializationError;
 
@@ -69,6 +112,14 @@ public:
 
     static TokenData::Ptr readYaml(const YAML::Node& node);
 
+    /**
+     * @brief serializeMessage writes a message with its binary converter, if there is one, and as YAML otherwise
+     */
+    static void serializeMessage(const TokenData& msg, SerializationBuffer& data);
+    static TokenData::Ptr deserializeMessage(SerializationBuffer& data);
+
+    static bool hasBinaryConverter(const std::string& type);
+
     void shutdown() override;
 
 public:
@@ -83,6 +134,7 @@ public:
         MessageSerializer::instance().registerMessage(connection_types::serializationName<M>(),
                                                    Converter(std::bind(&serial::encodeMessage<M>, std::placeholders::_1),
                                                              std::bind(&serial::decodeMessage<M>, std::placeholders::_1, std::placeholders::_2)));
+        registerBinaryMessage<M>();
     }
 
 private:
@@ -93,13 +145,31 @@ private:
     >
     {};
 
+    template <typename M>
+    struct HasBinary : public std::integral_constant < bool,
+            has_binary_implementation< serial::BinarySerializer<M>, bool(*)(const M&, SerializationBuffer&) >::value
+    >
+    {};
+
+    template <typename M>
+    static void registerBinaryMessage(typename std::enable_if< HasBinary<M>::value >::type* = 0)
+    {
+        MessageSerializer::instance().registerBinaryMessage(connection_types::serializationName<M>(),
+                                                            BinaryConverter(&serial::encodeBinaryMessage<M>,
+                                                                            &serial::decodeBinaryMessage<M>));
+    }
+    template <typename M>
+    static void registerBinaryMessage(typename std::enable_if< !HasBinary<M>::value >::type* = 0)
+    {
+    }
+
     template <template <typename> class Wrapper, typename M>
     static void registerDirectMessageImpl(typename std::enable_if< !HasYaml<Wrapper,M>::type::value >::type* = 0)
     {
         MessageSerializer::instance().registerMessage(connection_types::serializationName< Wrapper<M> >(),
                                                    Converter(std::bind(&serial::encodeMessage<Wrapper<M>>, std::placeholders::_1),
                                                              std::bind(&serial::decodeMessage<Wrapper<M>>, std::placeholders::_1, std::placeholders::_2)));
-
+        registerBinaryMessage<Wrapper<M>>();
     }
     template <template <typename> class Wrapper, typename M>
     static void registerDirectMessageImpl(typename std::enable_if< HasYaml<Wrapper,M>::type::value >::type* = 0)
@@ -107,6 +177,7 @@ private:
         MessageSerializer::instance().registerMessage(connection_types::serializationName< Wrapper<M> >(),
                                                    Converter(std::bind(&MessageSerializer::encodeDirectMessage<Wrapper, M>, std::placeholders::_1),
                                                              std::bind(&MessageSerializer::decodeDirectMessage<Wrapper, M>, std::placeholders::_1, std::placeholders::_2)));
+        registerBinaryMessage<Wrapper<M>>();
     }
 
 
@@ -130,9 +201,11 @@ private:
 	~MessageSerializer();
 
     static void registerMessage(std::string type, Converter converter);
+    static void registerBinaryMessage(std::string type, BinaryConverter converter);
 
 private:
     std::map<std::string, Converter> type_to_converter;
+    std::map<std::string, BinaryConverter> type_to_binary_converter;
 };
 
 
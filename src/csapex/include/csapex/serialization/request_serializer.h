@@ -17,10 +17,10 @@ public:
     virtual ~RequestSerializerInterface();
 
     virtual void serializeRequest(const RequestConstPtr& packet, SerializationBuffer &data) = 0;
-    virtual RequestPtr deserializeRequest(SerializationBuffer& data, uint8_t request_id) = 0;
+    virtual RequestPtr deserializeRequest(SerializationBuffer& data, uint32_t request_id) = 0;
 
     virtual void serializeResponse(const ResponseConstPtr& packet, SerializationBuffer &data) = 0;
-    virtual ResponsePtr deserializeResponse(SerializationBuffer& data, uint8_t request_id) = 0;
+    virtual ResponsePtr deserializeResponse(SerializationBuffer& data, uint32_t request_id) = 0;
 };
 
 
@@ -58,7 +58,7 @@ struct RequestSerializerRegistered
         { \
             packet->serialize(data); \
         } \
-        virtual RequestPtr deserializeRequest(SerializationBuffer& data, uint8_t request_id) override \
+        virtual RequestPtr deserializeRequest(SerializationBuffer& data, uint32_t request_id) override \
         { \
             auto result = std::make_shared<typename Name::RequestT>(request_id); \
             result->deserialize(data); \
@@ -68,7 +68,7 @@ struct RequestSerializerRegistered
         { \
             packet->serialize(data); \
         } \
-        virtual ResponsePtr deserializeResponse(SerializationBuffer& data, uint8_t request_id) override \
+        virtual ResponsePtr deserializeResponse(SerializationBuffer& data, uint32_t request_id) override \
         { \
             auto result = std::make_shared<typename Name::ResponseT>(request_id); \
             result->deserialize(data); \
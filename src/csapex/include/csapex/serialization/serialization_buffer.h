@@ -9,6 +9,8 @@
 /// SYSTEM
 #include <vector>
 #include <inttypes.h>
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include <sstream>
 #include <limits>
@@ -24,6 +26,8 @@ namespace csapex
 
 /**
  * @brief SerializationBuffer
+ *        All values are stored little-endian, lengths of strings and vectors are stored as varints.
+ *        The first 4 bytes are reserved for the length of the whole buffer, see finalize().
  */
 class SerializationBuffer : public std::vector<uint8_t>
 {
@@ -39,14 +43,9 @@ public:
 
     void finalize()
     {
-        uint32_t length = size();
-        apex_assert_lte_hard(length, std::numeric_limits<uint32_t>::max());
-
-        std::size_t nbytes = sizeof(uint32_t);
-        for(std::size_t byte = 0; byte < nbytes; ++byte) {
-            uint8_t part = (length >> (byte * 8)) & 0xFF;
-            at(byte) = part;
-        }
+        apex_assert_lte_hard(size(), std::numeric_limits<uint32_t>::max());
+        uint32_t length = littleEndian(static_cast<uint32_t>(size()));
+        std::memcpy(data(), &length, HEADER_LENGTH);
     }
 
     void seek(uint32_t p)
@@ -54,6 +53,23 @@ public:
         pos = p;
     }
 
+    // SPANS
+    void appendBytes(const void* bytes, std::size_t length)
+    {
+        const uint8_t* begin = static_cast<const uint8_t*>(bytes);
+        insert(end(), begin, begin + length);
+    }
+    void readBytes(void* bytes, std::size_t length)
+    {
+        apex_assert_lte_hard(length, size() - pos);
+        std::memcpy(bytes, data() + pos, length);
+        pos += length;
+    }
+
+    // LENGTHS
+    void writeLength(uint64_t length);
+    uint64_t readLength();
+
     std::string toString() const
     {
         std::stringstream res;
@@ -101,11 +117,8 @@ public:
                                       int>::type = 0>
     SerializationBuffer& operator << (T i)
     {
-        std::size_t nbytes = sizeof(T);
-        for(std::size_t byte = 0; byte < nbytes; ++byte) {
-            uint8_t part = (i >> (byte * 8)) & 0xFF;
-            push_back(part);
-        }
+        T value = littleEndian(i);
+        appendBytes(&value, sizeof(T));
         return *this;
     }
     template <typename T,
@@ -113,13 +126,22 @@ public:
                                       int>::type = 0>
     SerializationBuffer& operator >> (T& i)
     {
-        std::size_t nbytes = sizeof(T);
-        T res = 0;
-        for(std::size_t byte = 0; byte < nbytes; ++byte) {
-            uint8_t part = static_cast<T>(at(pos++));
-            res |= (part << (byte * 8));
-        }
-        i = res;
+        T value;
+        readBytes(&value, sizeof(T));
+        i = littleEndian(value);
+        return *this;
+    }
+
+    // BOOLS
+    SerializationBuffer& operator << (bool b)
+    {
+        push_back(b ? 1 : 0);
+        return *this;
+    }
+    SerializationBuffer& operator >> (bool& b)
+    {
+        apex_assert_lt_hard(pos, size());
+        b = at(pos++) != 0;
         return *this;
     }
 
@@ -190,25 +212,16 @@ public:
     template <typename S>
     SerializationBuffer& operator << (const std::vector<S>& s)
     {
-        apex_assert_lt_hard(s.size(), std::numeric_limits<uint8_t>::max());
-        operator << (static_cast<uint8_t>(s.size()));
-        for(const auto& elem : s) {
-            operator << (elem);
-        }
+        writeLength(s.size());
+        writeElements(s, std::integral_constant<bool, isBulkCopyable<S>()>());
         return *this;
     }
 
     template <typename S>
     SerializationBuffer& operator >> (std::vector<S>& s)
     {
-        uint8_t len;
-        operator >> (len);
-        s.reserve(len);
-        for(uint8_t i = 0; i < len; ++i) {
-            S elem;
-            operator >> (elem);
-            s.push_back(elem);
-        }
+        uint64_t len = readLength();
+        readElements(s, len, std::integral_constant<bool, isBulkCopyable<S>()>());
         return *this;
     }
 
@@ -217,6 +230,61 @@ public:
     SerializationBuffer& operator << (const YAML::Node& node);
     SerializationBuffer& operator >> (YAML::Node& node);
 
+private:
+    template <typename T>
+    static T littleEndian(T value)
+    {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        uint8_t* bytes = reinterpret_cast<uint8_t*>(&value);
+        std::reverse(bytes, bytes + sizeof(T));
+#endif
+        return value;
+    }
+
+    /// arrays of numbers are copied as a whole if their memory layout is the wire format
+    template <typename S>
+    static constexpr bool isBulkCopyable()
+    {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return std::is_arithmetic<S>::value && !std::is_same<S, bool>::value && sizeof(S) == 1;
+#else
+        return std::is_arithmetic<S>::value && !std::is_same<S, bool>::value;
+#endif
+    }
+
+    template <typename S>
+    void writeElements(const std::vector<S>& s, std::true_type /*bulk*/)
+    {
+        appendBytes(s.data(), s.size() * sizeof(S));
+    }
+    template <typename S>
+    void writeElements(const std::vector<S>& s, std::false_type /*bulk*/)
+    {
+        for(const auto& elem : s) {
+            operator << (elem);
+        }
+    }
+
+    template <typename S>
+    void readElements(std::vector<S>& s, uint64_t len, std::true_type /*bulk*/)
+    {
+        apex_assert_lte_hard(len, (size() - pos) / sizeof(S));
+        std::size_t offset = s.size();
+        s.resize(offset + len);
+        readBytes(s.data() + offset, len * sizeof(S));
+    }
+    template <typename S>
+    void readElements(std::vector<S>& s, uint64_t len, std::false_type /*bulk*/)
+    {
+        // every element takes at least one byte, a corrupt length must not allocate more
+        s.reserve(s.size() + std::min<uint64_t>(len, size() - pos));
+        for(uint64_t i = 0; i < len; ++i) {
+            S elem;
+            operator >> (elem);
+            s.push_back(elem);
+        }
+    }
+
 private:
     std::size_t pos;
 };
@@ -44,9 +44,10 @@ inline std::string universal_to_string(const V& value)
 }
 }
 
-#define apex_assert_msg(assertion,msg)       _apex_assert(static_cast<bool>(assertion),      msg, #assertion, __FILE__, __LINE__, APEX_FUNCTION_SIGNATURE())
-#define apex_assert_hard_msg(assertion,msg)  _apex_assert_hard(static_cast<bool>(assertion), msg, #assertion, __FILE__, __LINE__, APEX_FUNCTION_SIGNATURE())
-#define apex_assert_soft_msg(assertion,msg)  _apex_assert_soft(static_cast<bool>(assertion), msg, #assertion, __FILE__, __LINE__, APEX_FUNCTION_SIGNATURE())
+// the message strings are only constructed if the assertion fails, asserts are used on hot paths
+#define apex_assert_msg(assertion,msg)       (static_cast<bool>(assertion) ? (void) 0 : _apex_assert(false,      msg, #assertion, __FILE__, __LINE__, APEX_FUNCTION_SIGNATURE()))
+#define apex_assert_hard_msg(assertion,msg)  (static_cast<bool>(assertion) ? (void) 0 : _apex_assert_hard(false, msg, #assertion, __FILE__, __LINE__, APEX_FUNCTION_SIGNATURE()))
+#define apex_assert_soft_msg(assertion,msg)  (static_cast<bool>(assertion) ? (void) 0 : _apex_assert_soft(false, msg, #assertion, __FILE__, __LINE__, APEX_FUNCTION_SIGNATURE()))
 
 #define apex_assert_eq(a,b)       apex_assert_msg(((a) == (b)), assert::universal_to_string(a) + " is not equal to " + assert::universal_to_string(b))
 #define apex_assert_eq_hard(a,b)  apex_assert_hard_msg(((a) == (b)), assert::universal_to_string(a) + " is not equal to " + assert::universal_to_string(b))
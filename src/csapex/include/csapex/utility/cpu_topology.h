@@ -0,0 +1,90 @@
+#ifndef CPU_TOPOLOGY_H
+#define CPU_TOPOLOGY_H
+
+/// PROJECT
+#include <csapex/csapex_util_export.h>
+
+/// SYSTEM
+#include <string>
+#include <vector>
+
+namespace csapex
+{
+
+/**
+ * @brief The CpuTopology class describes how the cpus of the machine are grouped
+ *        into sockets, NUMA nodes and shared L3 caches, as reported by sysfs.
+ *        Without sysfs every cpu is assumed to be on the same socket and node.
+ */
+class CSAPEX_UTILS_EXPORT CpuTopology
+{
+public:
+    /**
+     * @brief instance returns the topology of this machine, read once on first use
+     */
+    static const CpuTopology& instance();
+
+    /**
+     * @brief currentNumaNode returns the NUMA node of the calling thread's cpu,
+     *        or -1 if the machine has only one node
+     */
+    static int currentNumaNode();
+
+    /**
+     * @brief parseCpuList parses the sysfs list format, e.g. "0-3,8,10-11"
+     */
+    static std::vector<unsigned> parseCpuList(const std::string& list);
+
+public:
+    /**
+     * @param sysfs_root the directory containing "cpu" and "node", usually /sys/devices/system
+     */
+    CpuTopology(const std::string& sysfs_root);
+
+    unsigned getNumCpus() const;
+    unsigned getNumSockets() const;
+    unsigned getNumNumaNodes() const;
+    unsigned getNumL3Domains() const;
+
+    /**
+     * @brief getNumaNodes returns the ids of all NUMA nodes that contain cpus
+     */
+    std::vector<int> getNumaNodes() const;
+
+    int getSocket(unsigned cpu) const;
+    int getNumaNode(unsigned cpu) const;
+    int getL3Domain(unsigned cpu) const;
+
+    /**
+     * @brief getNumaNodeCpus returns an affinity mask that contains exactly the cpus of the given node
+     */
+    std::vector<bool> getNumaNodeCpus(int node) const;
+
+    /**
+     * @brief getNumaNodeOf returns the node that contains all cpus of the affinity mask,
+     *        or -1 if the mask spans multiple nodes
+     */
+    int getNumaNodeOf(const std::vector<bool>& affinity) const;
+
+private:
+    void read(const std::string& sysfs_root);
+    void setToDefault(unsigned cpus);
+
+private:
+    struct Cpu
+    {
+        int socket;
+        int numa_node;
+        int l3_domain;
+    };
+
+    std::vector<Cpu> cpus_;
+
+    unsigned sockets_;
+    unsigned numa_nodes_;
+    unsigned l3_domains_;
+};
+
+}
+
+#endif // CPU_TOPOLOGY_H
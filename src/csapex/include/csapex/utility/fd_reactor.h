@@ -0,0 +1,73 @@
+#ifndef FD_REACTOR_H
+#define FD_REACTOR_H
+
+/// PROJECT
+#include <csapex/utility/singleton.hpp>
+#include <csapex/csapex_util_export.h>
+
+/// SYSTEM
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace csapex
+{
+
+/**
+ * @brief The FdReactor class waits for file descriptors on a single thread, using epoll.
+ *        Callbacks are called once on the reactor thread, when the descriptor becomes ready.
+ *        Errors and hang ups count as ready, so that the callback can handle them.
+ */
+class CSAPEX_UTILS_EXPORT FdReactor : public Singleton<FdReactor>
+{
+    friend class Singleton<FdReactor>;
+
+public:
+    enum class Event
+    {
+        READABLE,
+        WRITABLE
+    };
+
+    using Callback = std::function<void()>;
+
+    /**
+     * @brief watch calls callback once fd is ready for event.
+     *        Descriptors that cannot be watched (e.g. regular files) are always ready,
+     *        their callback is called right away on the calling thread.
+     * @return false, iff file descriptors cannot be watched on this platform, the callback is not called then
+     */
+    bool watch(int fd, Event event, Callback callback);
+
+    void shutdown() override;
+
+private:
+    FdReactor();
+    ~FdReactor();
+
+    void start();
+    void run();
+    void rearm(int fd);
+
+private:
+    struct Watch
+    {
+        std::vector<Callback> readable;
+        std::vector<Callback> writable;
+    };
+
+    std::mutex mutex_;
+    std::map<int, Watch> watches_;
+
+    std::thread thread_;
+    bool running_;
+
+    int epoll_fd_;
+    int wake_fd_;
+};
+
+}
+
+#endif // FD_REACTOR_H
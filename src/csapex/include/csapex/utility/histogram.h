@@ -0,0 +1,80 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+/// PROJECT
+#include <csapex/csapex_util_export.h>
+
+/// SYSTEM
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace YAML
+{
+class Node;
+}
+
+namespace csapex
+{
+
+/**
+ * @brief The Histogram class counts samples in fixed buckets.
+ *        Recording is lock-free, so that it can be done on hot paths by many threads at once.
+ *        Copies are snapshots of the counters.
+ */
+class CSAPEX_UTILS_EXPORT Histogram
+{
+public:
+    /**
+     * @brief exponential creates buckets [0, 1), [1, 2), [2, 4), ... up to 2^(buckets - 2)
+     */
+    static Histogram exponential(std::size_t buckets = 64);
+    /**
+     * @brief linear creates buckets of equal width, starting at 0
+     */
+    static Histogram linear(uint64_t width, std::size_t buckets);
+
+    /**
+     * @param upper_bounds the exclusive upper bound of every bucket but the last, in ascending order.
+     *        The last bucket counts all larger values.
+     */
+    explicit Histogram(const std::vector<uint64_t>& upper_bounds);
+
+    Histogram(const Histogram& other);
+    Histogram& operator = (const Histogram& other);
+
+    void record(uint64_t value);
+    void reset();
+
+    std::size_t getBucketCount() const;
+    uint64_t getCount(std::size_t bucket) const;
+    /**
+     * @brief getLowerBound returns the smallest value counted in the given bucket
+     */
+    uint64_t getLowerBound(std::size_t bucket) const;
+
+    uint64_t getCount() const;
+    uint64_t getMax() const;
+    double getMean() const;
+
+    /**
+     * @brief getPercentile returns the lower bound of the bucket that contains the given percentile
+     * @param percentile in [0, 1]
+     */
+    uint64_t getPercentile(double percentile) const;
+
+    void save(YAML::Node& node) const;
+
+private:
+    std::vector<uint64_t> upper_bounds_;
+    std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> max_;
+};
+
+}
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,166 @@
+#ifndef MPMC_RING_BUFFER_HPP
+#define MPMC_RING_BUFFER_HPP
+
+/// SYSTEM
+#include <atomic>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <cstdlib>
+
+namespace csapex
+{
+
+/**
+ * @brief The MpmcRingBuffer class is a bounded, lock-free FIFO queue that supports
+ *        multiple producers and multiple consumers.
+ *        Every cell carries a sequence number that tells producers and consumers
+ *        whether the cell can be written or read in the current lap.
+ */
+template <typename T>
+class MpmcRingBuffer
+{
+public:
+    /**
+     * @brief MpmcRingBuffer
+     * @param capacity is rounded up to the next power of two
+     */
+    MpmcRingBuffer(std::size_t capacity)
+        : capacity_(roundUp(capacity)), mask_(capacity_ - 1),
+          buffer_(new Cell[capacity_]),
+          enqueue_pos_(0), dequeue_pos_(0)
+    {
+        for(std::size_t i = 0; i < capacity_; ++i) {
+            buffer_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRingBuffer(const MpmcRingBuffer&) = delete;
+    MpmcRingBuffer& operator = (const MpmcRingBuffer&) = delete;
+
+    /**
+     * @brief operator new respects the cache line alignment of the positions,
+     *        which the global operator new does not guarantee before C++17
+     */
+    static void* operator new(std::size_t size)
+    {
+        void* memory = nullptr;
+        if(posix_memalign(&memory, CACHE_LINE_SIZE, size) != 0) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+
+    static void operator delete(void* memory)
+    {
+        std::free(memory);
+    }
+
+    /**
+     * @brief push appends a value
+     * @return false, iff the buffer is full
+     */
+    bool push(const T& value)
+    {
+        Cell* cell;
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while(true) {
+            cell = &buffer_[pos & mask_];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = (std::ptrdiff_t) seq - (std::ptrdiff_t) pos;
+            if(diff == 0) {
+                if(enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if(diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief pop removes the oldest value
+     * @return false, iff the buffer is empty
+     */
+    bool pop(T& value)
+    {
+        Cell* cell;
+        std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        while(true) {
+            cell = &buffer_[pos & mask_];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = (std::ptrdiff_t) seq - (std::ptrdiff_t) (pos + 1);
+            if(diff == 0) {
+                if(dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if(diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(cell->data);
+        cell->data = T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief size is only a snapshot when other threads access the buffer
+     */
+    std::size_t size() const
+    {
+        std::size_t enq = enqueue_pos_.load(std::memory_order_relaxed);
+        std::size_t deq = dequeue_pos_.load(std::memory_order_relaxed);
+        return enq > deq ? enq - deq : 0;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    std::size_t capacity() const
+    {
+        return capacity_;
+    }
+
+private:
+    static std::size_t roundUp(std::size_t n)
+    {
+        std::size_t c = 2;
+        while(c < n) {
+            c <<= 1;
+        }
+        return c;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T data;
+    };
+
+    enum { CACHE_LINE_SIZE = 64 };
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> buffer_;
+
+    // keep the producer and consumer positions on separate cache lines
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> enqueue_pos_;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> dequeue_pos_;
+};
+
+}
+
+#endif // MPMC_RING_BUFFER_HPP
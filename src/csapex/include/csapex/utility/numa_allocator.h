@@ -0,0 +1,107 @@
+#ifndef NUMA_ALLOCATOR_H
+#define NUMA_ALLOCATOR_H
+
+/// PROJECT
+#include <csapex/csapex_util_export.h>
+
+/// SYSTEM
+#include <cstddef>
+
+namespace csapex
+{
+
+/**
+ * @brief The NumaAllocation class places large message payloads on a chosen NUMA node.
+ *        While a node processes, its worker sets the NUMA node of the consuming thread group
+ *        as the preferred node. Large blocks allocated in that time are bound to this node,
+ *        so the consumer reads them from local memory, even though the producer touches them first.
+ */
+class CSAPEX_UTILS_EXPORT NumaAllocation
+{
+public:
+    enum { LARGE_PAYLOAD = 64 * 1024 };
+
+    /**
+     * @brief The PreferredNode class sets the preferred node of the calling thread for its lifetime,
+     *        -1 means no preference
+     */
+    class CSAPEX_UTILS_EXPORT PreferredNode
+    {
+    public:
+        PreferredNode(int node);
+        ~PreferredNode();
+
+    private:
+        PreferredNode(const PreferredNode&) = delete;
+        PreferredNode& operator = (const PreferredNode&) = delete;
+
+    private:
+        int previous_;
+    };
+
+public:
+    static int getPreferredNode();
+
+    /**
+     * @brief getPayloadNode returns the node that payloads created by the calling thread are placed on,
+     *        or -1 if the thread does not place its payloads on a node
+     */
+    static int getPayloadNode();
+
+    /**
+     * @brief allocate maps blocks of at least LARGE_PAYLOAD bytes separately and binds them to the preferred node,
+     *        smaller blocks come from the heap
+     */
+    static void* allocate(std::size_t bytes);
+    static void deallocate(void* p, std::size_t bytes);
+};
+
+/**
+ * @brief The NumaAllocator class can be used for the buffers of large payloads,
+ *        e.g. std::vector<float, NumaAllocator<float>>
+ */
+template <typename T>
+class NumaAllocator
+{
+public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef NumaAllocator<U> other;
+    };
+
+public:
+    NumaAllocator() = default;
+
+    template <typename U>
+    NumaAllocator(const NumaAllocator<U>&)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(NumaAllocation::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        NumaAllocation::deallocate(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator == (const NumaAllocator<U>&) const
+    {
+        return true;
+    }
+    template <typename U>
+    bool operator != (const NumaAllocator<U>&) const
+    {
+        return false;
+    }
+};
+
+}
+
+#endif // NUMA_ALLOCATOR_H
@@ -0,0 +1,261 @@
+#ifndef POOL_ALLOCATOR_HPP
+#define POOL_ALLOCATOR_HPP
+
+/// SYSTEM
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <memory>
+#include <utility>
+
+namespace csapex
+{
+
+/**
+ * @brief The BlockPool class keeps freed memory blocks of one size per thread.
+ *        Blocks are taken from the pool of the allocating thread and always return to it:
+ *        the owning thread reuses its blocks without any synchronization, blocks freed
+ *        by other threads are pushed onto a lock-free return list of the owning pool.
+ *        Every pool caches at most MAX_BLOCKS blocks.
+ */
+template <std::size_t BlockSize>
+class BlockPool
+{
+public:
+    enum { MAX_BLOCKS = 1024 };
+
+    static void* allocate()
+    {
+        BlockPool* pool = local();
+
+        Header* header = pool ? pool->take() : nullptr;
+        if(!header) {
+            header = static_cast<Header*>(::operator new(sizeof(Header) + BlockSize));
+        }
+
+        header->owner = pool ? pool->control_ : nullptr;
+        if(header->owner) {
+            header->owner->acquire();
+        }
+        return header + 1;
+    }
+
+    static void deallocate(void* p)
+    {
+        Header* header = static_cast<Header*>(p) - 1;
+
+        Control* owner = header->owner;
+        if(!owner) {
+            ::operator delete(header);
+            return;
+        }
+
+        BlockPool* pool = local();
+        if(pool && pool->control_ == owner) {
+            pool->put(header);
+        } else {
+            owner->giveBack(header);
+        }
+        owner->release();
+    }
+
+private:
+    struct Control;
+
+    struct alignas(std::max_align_t) Header
+    {
+        union {
+            // set while the block is in use
+            Control* owner;
+            // set while the block is in a free list
+            Header* next;
+        };
+    };
+
+    static void deleteAll(Header* list)
+    {
+        while(list) {
+            Header* header = list;
+            list = header->next;
+            ::operator delete(header);
+        }
+    }
+
+    /**
+     * @brief The Control struct outlives its pool as long as blocks of the pool are in use
+     */
+    struct Control
+    {
+        Control()
+            : refs(1), returned(nullptr)
+        {
+        }
+
+        void acquire()
+        {
+            refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void release()
+        {
+            if(refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                // the pool is gone and this was its last block
+                deleteAll(takeReturned());
+                delete this;
+            }
+        }
+
+        void giveBack(Header* header)
+        {
+            Header* head = returned.load(std::memory_order_relaxed);
+            do {
+                header->next = head;
+            } while(!returned.compare_exchange_weak(head, header, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        Header* takeReturned()
+        {
+            return returned.exchange(nullptr, std::memory_order_acquire);
+        }
+
+        std::atomic<std::size_t> refs;
+        std::atomic<Header*> returned;
+    };
+
+private:
+    static BlockPool* local()
+    {
+        // objects destroyed by thread local destructors after the pool bypass it
+        if(destroyed_) {
+            return nullptr;
+        }
+        static thread_local BlockPool pool;
+        return &pool;
+    }
+
+    BlockPool()
+        : head_(nullptr), size_(0), control_(new Control)
+    {
+    }
+
+    ~BlockPool()
+    {
+        destroyed_ = true;
+
+        deleteAll(head_);
+        deleteAll(control_->takeReturned());
+        control_->release();
+    }
+
+    BlockPool(const BlockPool&) = delete;
+    BlockPool& operator = (const BlockPool&) = delete;
+
+    Header* take()
+    {
+        if(!head_) {
+            head_ = control_->takeReturned();
+            for(Header* header = head_; header; header = header->next) {
+                ++size_;
+            }
+            if(!head_) {
+                return nullptr;
+            }
+        }
+
+        Header* header = head_;
+        head_ = header->next;
+        --size_;
+        return header;
+    }
+
+    void put(Header* header)
+    {
+        if(size_ >= MAX_BLOCKS) {
+            ::operator delete(header);
+            return;
+        }
+        header->next = head_;
+        head_ = header;
+        ++size_;
+    }
+
+private:
+    static thread_local bool destroyed_;
+
+    Header* head_;
+    std::size_t size_;
+
+    Control* control_;
+};
+
+template <std::size_t BlockSize>
+thread_local bool BlockPool<BlockSize>::destroyed_ = false;
+
+/**
+ * @brief The PoolAllocator class allocates single objects from the per-thread BlockPool
+ *        of their size class. It is meant for std::allocate_shared, which allocates
+ *        the object together with its reference counts.
+ */
+template <typename T>
+class PoolAllocator
+{
+public:
+    typedef T value_type;
+
+    enum { BLOCK_SIZE = (sizeof(T) + 15) / 16 * 16 };
+
+    template <typename U>
+    struct rebind
+    {
+        typedef PoolAllocator<U> other;
+    };
+
+public:
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        if(n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(BlockPool<BLOCK_SIZE>::allocate());
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        if(n != 1) {
+            ::operator delete(p);
+            return;
+        }
+        BlockPool<BLOCK_SIZE>::deallocate(p);
+    }
+
+    template <typename U>
+    bool operator == (const PoolAllocator<U>&) const
+    {
+        return true;
+    }
+    template <typename U>
+    bool operator != (const PoolAllocator<U>&) const
+    {
+        return false;
+    }
+};
+
+/**
+ * @brief makePooled creates a shared object in the memory pool of the calling thread
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> makePooled(Args&&... args)
+{
+    return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+}
+
+#endif // POOL_ALLOCATOR_HPP
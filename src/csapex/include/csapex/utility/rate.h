@@ -29,15 +29,18 @@ public:
     void keepUp();
 
     void startCycle();
-    std::chrono::system_clock::time_point endOfCycle() const;
+    std::chrono::steady_clock::time_point endOfCycle() const;
+
+private:
+    std::chrono::steady_clock::duration getInterval() const;
 
 public:
     double frequency_;
     bool immediate_;
 
-    std::chrono::system_clock::time_point last_scheduled_tick_;
-    std::chrono::system_clock::time_point last_tick_;
-    std::deque<std::chrono::system_clock::time_point> real_ticks_;
+    std::chrono::steady_clock::time_point last_scheduled_tick_;
+    std::chrono::steady_clock::time_point last_tick_;
+    std::deque<std::chrono::steady_clock::time_point> real_ticks_;
 };
 
 }
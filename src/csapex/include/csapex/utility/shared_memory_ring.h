@@ -0,0 +1,97 @@
+#ifndef SHARED_MEMORY_RING_H
+#define SHARED_MEMORY_RING_H
+
+/// PROJECT
+#include <csapex/csapex_util_export.h>
+
+/// SYSTEM
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace csapex
+{
+
+class SharedMemoryRing;
+typedef std::shared_ptr<SharedMemoryRing> SharedMemoryRingPtr;
+
+/**
+ * @brief The SharedMemoryRing class is a ring buffer of variable sized records in POSIX shared memory.
+ *        It connects one writing and one reading process on the same host.
+ *        Records are contiguous in the mapping, so they can be written and read in place.
+ *        Waiting for data or free space is done with futexes.
+ */
+class CSAPEX_UTILS_EXPORT SharedMemoryRing
+{
+public:
+    /**
+     * @brief create creates a new segment, which is removed again when the creator is destroyed
+     * @throws std::runtime_error if the segment cannot be created
+     */
+    static SharedMemoryRingPtr create(const std::string& name, std::size_t capacity);
+    /**
+     * @brief open maps a segment created by another process
+     * @throws std::runtime_error if there is no valid segment with the given name
+     */
+    static SharedMemoryRingPtr open(const std::string& name);
+
+    ~SharedMemoryRing();
+
+    SharedMemoryRing(const SharedMemoryRing&) = delete;
+    SharedMemoryRing& operator = (const SharedMemoryRing&) = delete;
+
+    std::string getName() const;
+    std::size_t getCapacity() const;
+    std::size_t getMaximumRecordSize() const;
+
+    /**
+     * @brief reserve waits until a record of the given length fits into the ring
+     * @return the memory of the record, which is published by commit, or nullptr after the timeout
+     * @throws std::length_error if the record can never fit
+     */
+    uint8_t* reserve(std::size_t length, std::chrono::milliseconds timeout);
+    void commit();
+
+    /**
+     * @brief write copies a record into the ring
+     * @return false, if there was not enough space before the timeout
+     */
+    bool write(const void* data, std::size_t length, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief read passes the next record to the reader, without copying it out of the ring.
+     *        The record is released when the reader returns.
+     * @return false, if there was no record before the timeout
+     */
+    bool read(const std::function<void(const uint8_t* data, std::size_t length)>& reader, std::chrono::milliseconds timeout);
+
+    bool empty() const;
+
+private:
+    struct Header;
+
+    SharedMemoryRing(const std::string& name, int fd, void* mapping, std::size_t mapping_size, bool owner);
+
+    static void wait(std::atomic<uint32_t>& word, uint32_t value, std::chrono::steady_clock::time_point until);
+    static void wake(std::atomic<uint32_t>& word, std::atomic<uint32_t>& waiting);
+
+private:
+    std::string name_;
+    int fd_;
+    void* mapping_;
+    std::size_t mapping_size_;
+    bool owner_;
+
+    Header* header_;
+    uint8_t* data_;
+
+    uint64_t reserved_at_;
+    uint64_t reserved_end_;
+};
+
+}
+
+#endif // SHARED_MEMORY_RING_H
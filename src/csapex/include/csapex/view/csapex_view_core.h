@@ -60,6 +60,12 @@ public:
 
     virtual ThreadPoolPtr getThreadPool() = 0;
 
+    /**
+     * @brief getSchedulerTelemetry returns the load and scheduling histograms of all thread groups
+     */
+    virtual YAML::Node getSchedulerTelemetry() = 0;
+    virtual void resetSchedulerTelemetry() = 0;
+
     virtual CommandExecutorPtr getCommandDispatcher() = 0;
 
     virtual PluginLocatorPtr getPluginLocator() const = 0;
@@ -35,6 +35,9 @@ public:
     void clearBlock() override;
     void resetActivity() override;
 
+    YAML::Node getSchedulerTelemetry() override;
+    void resetSchedulerTelemetry() override;
+
     ThreadPoolPtr getThreadPool() override;
 
     CommandExecutorPtr getCommandDispatcher() override;
@@ -47,6 +47,9 @@ public:
     void clearBlock() override;
     void resetActivity() override;
 
+    YAML::Node getSchedulerTelemetry() override;
+    void resetSchedulerTelemetry() override;
+
     // TODO: add proxies or remove
     GraphFacadePtr getRoot() override;
 
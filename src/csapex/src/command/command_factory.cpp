@@ -15,6 +15,8 @@
 #include <csapex/command/set_logger_level.h>
 #include <csapex/command/switch_thread.h>
 #include <csapex/command/delete_thread.h>
+#include <csapex/command/create_thread.h>
+#include <csapex/command/modify_thread.h>
 #include <csapex/msg/any_message.h>
 #include <csapex/msg/input.h>
 #include <csapex/msg/output.h>
@@ -31,7 +33,16 @@
 #include <csapex/model/node_state.h>
 #include <csapex/scheduling/scheduler.h>
 #include <csapex/scheduling/thread_group.h>
+#include <csapex/scheduling/thread_pool.h>
 #include <csapex/model/node_runner.h>
+#include <csapex/model/graph/graph_local.h>
+#include <csapex/model/graph/vertex.h>
+#include <csapex/utility/cpu_affinity.h>
+#include <csapex/utility/cpu_topology.h>
+
+/// SYSTEM
+#include <sstream>
+#include <algorithm>
 
 using namespace csapex;
 using namespace csapex::command;
@@ -175,6 +186,11 @@ Command::Ptr CommandFactory::setConnectionActive(int connection, bool active)
     return Command::Ptr(new ModifyConnection(graph_uuid, connection, active));
 }
 
+Command::Ptr CommandFactory::setConnectionOverflowPolicy(int connection, Connection::OverflowPolicy policy)
+{
+    return Command::Ptr(new ModifyConnection(graph_uuid, connection, policy));
+}
+
 Command::Ptr CommandFactory::clearCommand()
 {
     Meta::Ptr clear(new Meta(graph_uuid, "Clear graph_", true));
@@ -432,3 +448,186 @@ CommandPtr CommandFactory::deleteThreadGroup(ThreadGroup* group)
 
     return cmd;
 }
+
+CommandPtr CommandFactory::partitionThreads(std::size_t groups)
+{
+    command::Meta::Ptr cmd(new command::Meta(graph_uuid, "partition threads"));
+
+    // without a thread pool (e.g. --threadless), there are no groups to partition into
+    ThreadPool* thread_pool = root_->getThreadPool();
+    if(!thread_pool) {
+        return cmd;
+    }
+
+    // collect all nodes with their profiled cost
+    std::vector<std::pair<GraphFacade*, NodeHandle*>> nodes;
+    std::map<graph::Vertex*, std::size_t> index;
+    std::vector<double> costs;
+    std::set<GraphFacade*> analyzed;
+
+    std::vector<UUID> node_uuids;
+    for(NodeHandle* nh : root_->getGraph()->getAllNodeHandles()) {
+        node_uuids.push_back(nh->getUUID());
+    }
+    foreachNode(root_, node_uuids, [&](GraphFacade* graph_facade, NodeHandle* nh) {
+        if(!nh->getNodeRunner()) {
+            return;
+        }
+        if(analyzed.insert(graph_facade).second) {
+            if(GraphLocalPtr graph = std::dynamic_pointer_cast<GraphLocal>(graph_facade->getGraph())) {
+                graph->updateCriticalPaths();
+            }
+        }
+
+        graph::VertexPtr vertex = nh->getVertex();
+        index[vertex.get()] = nodes.size();
+        nodes.push_back(std::make_pair(graph_facade, nh));
+        costs.push_back(vertex->getNodeCharacteristics().latency);
+    });
+
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    for(const auto& pair : index) {
+        for(const graph::VertexPtr& child : pair.first->getChildren()) {
+            auto pos = index.find(child.get());
+            if(pos != index.end()) {
+                edges.push_back(std::make_pair(pair.second, pos->second));
+            }
+        }
+    }
+
+    std::vector<std::size_t> assignment = ThreadPool::partition(costs, edges, groups);
+
+    auto partitionName = [](std::size_t group) {
+        std::stringstream name;
+        name << "Partition " << (group + 1);
+        return name.str();
+    };
+
+    // groups of an earlier partitioning are reused, so that repeated partitioning does not pile up groups
+    std::map<std::string, ThreadGroup*> previous_groups;
+    for(const ThreadGroupPtr& group : thread_pool->getGroups()) {
+        if(group->getName().find("Partition ") == 0) {
+            previous_groups[group->getName()] = group.get();
+        }
+    }
+
+    // create the missing groups with known ids, so that the nodes can be switched to them
+    std::set<std::size_t> used_groups(assignment.begin(), assignment.end());
+    std::map<std::size_t, int> group_ids;
+    int next_id = ThreadGroup::nextId();
+    for(std::size_t group : used_groups) {
+        std::string name = partitionName(group);
+        auto previous = previous_groups.find(name);
+        if(previous != previous_groups.end()) {
+            group_ids[group] = previous->second->id();
+            previous_groups.erase(previous);
+            continue;
+        }
+
+        int id = next_id++;
+        group_ids[group] = id;
+        cmd->add(std::make_shared<command::CreateThread>(graph_uuid, UUID::NONE, name, id));
+    }
+
+    std::set<UUID> moved;
+    for(std::size_t i = 0; i < nodes.size(); ++i) {
+        GraphFacade* graph_facade = nodes[i].first;
+        NodeHandle* nh = nodes[i].second;
+        cmd->add(std::make_shared<command::SwitchThread>(graph_facade->getAbsoluteUUID(), nh->getUUID(), group_ids[assignment[i]]));
+        moved.insert(nh->getUUID());
+    }
+
+    // earlier partition groups that are left over are deleted, once all their nodes have been moved
+    for(const auto& pair : previous_groups) {
+        ThreadGroup* group = pair.second;
+        bool empty_afterwards = std::all_of(group->begin(), group->end(), [&moved](const TaskGeneratorPtr& generator) {
+            return moved.find(generator->getUUID()) != moved.end();
+        });
+        if(empty_afterwards) {
+            cmd->add(std::make_shared<command::DeleteThread>(group->id()));
+        }
+    }
+
+    return cmd;
+}
+
+CommandPtr CommandFactory::placeThreadsOnNumaNodes()
+{
+    command::Meta::Ptr cmd(new command::Meta(graph_uuid, "place threads on NUMA nodes"));
+
+    const CpuTopology& topology = CpuTopology::instance();
+    std::vector<int> numa_nodes = topology.getNumaNodes();
+    if(numa_nodes.size() <= 1) {
+        return cmd;
+    }
+
+    std::vector<std::size_t> node_cpus;
+    for(int node : numa_nodes) {
+        std::vector<bool> cpus = topology.getNumaNodeCpus(node);
+        node_cpus.push_back(std::count(cpus.begin(), cpus.end(), true));
+    }
+
+    // sum up the profiled cost of the nodes of every group, private groups cannot be moved individually
+    std::vector<ThreadGroup*> groups;
+    std::map<ThreadGroup*, std::size_t> group_index;
+    std::vector<double> loads;
+    std::map<graph::Vertex*, std::size_t> vertex_group;
+    std::set<GraphFacade*> analyzed;
+
+    std::vector<UUID> node_uuids;
+    for(NodeHandle* nh : root_->getGraph()->getAllNodeHandles()) {
+        node_uuids.push_back(nh->getUUID());
+    }
+    foreachNode(root_, node_uuids, [&](GraphFacade* graph_facade, NodeHandle* nh) {
+        NodeRunnerPtr runner = nh->getNodeRunner();
+        if(!runner) {
+            return;
+        }
+        ThreadGroup* group = dynamic_cast<ThreadGroup*>(runner->getScheduler());
+        if(!group || group->id() == ThreadGroup::PRIVATE_THREAD) {
+            return;
+        }
+        if(analyzed.insert(graph_facade).second) {
+            if(GraphLocalPtr graph = std::dynamic_pointer_cast<GraphLocal>(graph_facade->getGraph())) {
+                graph->updateCriticalPaths();
+            }
+        }
+
+        auto pos = group_index.find(group);
+        if(pos == group_index.end()) {
+            pos = group_index.emplace(group, groups.size()).first;
+            groups.push_back(group);
+            loads.push_back(0.0);
+        }
+
+        graph::VertexPtr vertex = nh->getVertex();
+        vertex_group[vertex.get()] = pos->second;
+        loads[pos->second] += vertex->getNodeCharacteristics().latency;
+    });
+
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    for(const auto& pair : vertex_group) {
+        for(const graph::VertexPtr& child : pair.first->getChildren()) {
+            auto pos = vertex_group.find(child.get());
+            if(pos != vertex_group.end() && pos->second != pair.second) {
+                edges.push_back(std::make_pair(pair.second, pos->second));
+            }
+        }
+    }
+
+    std::vector<std::size_t> placement = ThreadPool::placeOnNumaNodes(loads, edges, node_cpus);
+
+    for(std::size_t i = 0; i < groups.size(); ++i) {
+        ThreadGroup* group = groups[i];
+        int node = numa_nodes[placement[i]];
+        if(group->getNumaNode() == node) {
+            continue;
+        }
+
+        std::vector<bool> affinity = topology.getNumaNodeCpus(node);
+        affinity.resize(group->getCpuAffinity()->getNumCpus(), false);
+        cmd->add(std::make_shared<command::ModifyThread>(group->id(), "", affinity));
+    }
+
+    return cmd;
+}
@@ -25,8 +25,8 @@ using namespace csapex::command;
 CSAPEX_REGISTER_COMMAND_SERIALIZER(CreateThread)
 
 
-CreateThread::CreateThread(const AUUID& parent_uuid, const UUID &node, const std::string& name)
-    : CommandImplementation(parent_uuid), uuid(node), name(name), old_id(-1), new_id(-1)
+CreateThread::CreateThread(const AUUID& parent_uuid, const UUID &node, const std::string& name, int id)
+    : CommandImplementation(parent_uuid), uuid(node), name(name), old_id(-1), new_id(id)
 {
 }
 
@@ -47,7 +47,8 @@ bool CreateThread::doExecute()
     if(uuid.empty()) {
         ThreadPool* thread_pool = getRootThreadPool();
 
-        new_id = thread_pool->createGroup(name)->id();
+        // the id can be given in advance, so that other commands can refer to the group
+        new_id = thread_pool->createGroup(name, new_id)->id();
 
     } else {
         TaskGenerator* tg = getGraphFacade()->getTaskGenerator(uuid);
@@ -18,28 +18,51 @@ using namespace csapex::command;
 CSAPEX_REGISTER_COMMAND_SERIALIZER(ModifyConnection)
 
 ModifyConnection::ModifyConnection(const AUUID& parent_uuid, int connection_id, bool active)
-    : CommandImplementation(parent_uuid), connection_id(connection_id), active(active)
+    : CommandImplementation(parent_uuid), connection_id(connection_id), property(Property::ACTIVE),
+      was_active(active), active(active),
+      previous_policy(Connection::OverflowPolicy::BLOCK), policy(Connection::OverflowPolicy::BLOCK)
+{
+}
+
+ModifyConnection::ModifyConnection(const AUUID& parent_uuid, int connection_id, Connection::OverflowPolicy policy)
+    : CommandImplementation(parent_uuid), connection_id(connection_id), property(Property::OVERFLOW_POLICY),
+      was_active(false), active(false),
+      previous_policy(policy), policy(policy)
 {
 }
 
 std::string ModifyConnection::getDescription() const
 {
     std::stringstream ss;
-    ss << "modified connection " << connection_id << " -> set active: " << active << " (was " << was_active <<  ")";
+    if(property == Property::ACTIVE) {
+        ss << "modified connection " << connection_id << " -> set active: " << active << " (was " << was_active <<  ")";
+    } else {
+        ss << "modified connection " << connection_id << " -> set overflow policy: " << (int) policy << " (was " << (int) previous_policy <<  ")";
+    }
     return ss.str();
 }
 
 bool ModifyConnection::doExecute()
 {
     auto c = getGraph()->getConnectionWithId(connection_id);
-    was_active = c->isActive();
-    c->setActive(active);
+    if(property == Property::ACTIVE) {
+        was_active = c->isActive();
+        c->setActive(active);
+    } else {
+        previous_policy = c->getOverflowPolicy();
+        c->setOverflowPolicy(policy);
+    }
     return true;
 }
 
 bool ModifyConnection::doUndo()
 {
-    getGraph()->getConnectionWithId(connection_id)->setActive(was_active);
+    auto c = getGraph()->getConnectionWithId(connection_id);
+    if(property == Property::ACTIVE) {
+        c->setActive(was_active);
+    } else {
+        c->setOverflowPolicy(previous_policy);
+    }
     return true;
 }
 
@@ -55,8 +78,11 @@ void ModifyConnection::serialize(SerializationBuffer &data) const
     Command::serialize(data);
 
     data << connection_id;
+    data << static_cast<int>(property);
     data << active;
     data << was_active;
+    data << static_cast<int>(policy);
+    data << static_cast<int>(previous_policy);
 }
 
 void ModifyConnection::deserialize(SerializationBuffer& data)
@@ -64,6 +90,16 @@ void ModifyConnection::deserialize(SerializationBuffer& data)
     Command::deserialize(data);
 
     data >> connection_id;
+
+    int p;
+    data >> p;
+    property = static_cast<Property>(p);
+
     data >> active;
     data >> was_active;
+
+    data >> p;
+    policy = static_cast<Connection::OverflowPolicy>(p);
+    data >> p;
+    previous_policy = static_cast<Connection::OverflowPolicy>(p);
 }
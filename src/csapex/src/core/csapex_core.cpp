@@ -10,6 +10,9 @@
 #include <csapex/factory/node_factory.h>
 #include <csapex/factory/snippet_factory.h>
 #include <csapex/info.h>
+#include <csapex/model/execution_plan.h>
+#include <csapex/model/operator_fusion.h>
+#include <csapex/model/graph/graph_local.h>
 #include <csapex/manager/message_provider_manager.h>
 #include <csapex/model/graph_facade.h>
 #include <csapex/model/node_facade_local.h>
@@ -24,7 +27,9 @@
 #include <csapex/plugin/plugin_locator.h>
 #include <csapex/plugin/plugin_manager.hpp>
 #include <csapex/profiling/profiler.h>
+#include <csapex/scheduling/thread_group.h>
 #include <csapex/scheduling/thread_pool.h>
+#include <csapex/scheduling/inline_executor.h>
 #include <csapex/serialization/snippet.h>
 #include <csapex/utility/assert.h>
 #include <csapex/utility/error_handling.h>
@@ -48,6 +53,7 @@ CsApexCore::CsApexCore(Settings &settings, ExceptionHandler& handler, csapex::Pl
       plugin_locator_(plugin_locator),
       exception_handler_(handler),
       node_factory_(nullptr),
+      executor_(nullptr),
       root_uuid_provider_(std::make_shared<UUIDProvider>()),
       dispatcher_(std::make_shared<CommandDispatcher>(*this)),
       profiler_(std::make_shared<Profiler>()),
@@ -58,6 +64,19 @@ CsApexCore::CsApexCore(Settings &settings, ExceptionHandler& handler, csapex::Pl
 
     thread_pool_ = std::make_shared<ThreadPool>(exception_handler_, !settings_.get<bool>("threadless"), settings_.get<bool>("thread_grouping"));
     thread_pool_->setPause(settings_.get<bool>("initially_paused"));
+    if(settings_.getTemporary<bool>("elastic_threads", false)) {
+        thread_pool_->getDefaultGroup()->setElastic(true);
+        thread_pool_->setPrivateThreadGroupsElastic(true);
+    }
+
+    if(settings_.get<bool>("threadless")) {
+        // nodes are executed by the main loop, the thread pool only forwards pausing and stepping
+        inline_executor_ = std::make_shared<InlineExecutor>(exception_handler_);
+        thread_pool_->addChild(inline_executor_.get());
+        executor_ = inline_executor_.get();
+    } else {
+        executor_ = thread_pool_.get();
+    }
 
     observe(thread_pool_->paused, paused);
 
@@ -123,6 +142,9 @@ CsApexCore::CsApexCore(Settings& settings, ExceptionHandler &handler, PluginLoca
 
 CsApexCore::~CsApexCore()
 {
+    stopCompiledExecution();
+    stopOperatorFusion();
+
     root_->stop();
 
     std::unique_lock<std::mutex> lock(running_mutex_);
@@ -132,6 +154,7 @@ CsApexCore::~CsApexCore()
         }
         plugin_locator_->shutdown();
         SingletonInterface::shutdownAll();
+        executor_->clear();
         thread_pool_->clear();
     }
 
@@ -252,12 +275,25 @@ void CsApexCore::init()
 
         root_worker_ = root_handle_->getNodeWorker();
 
-        root_ = std::make_shared<GraphFacade>(*thread_pool_, graph->getGraph(), graph, root_handle_);
+        root_ = std::make_shared<GraphFacade>(*executor_, graph->getGraph(), graph, root_handle_);
         root_->notification.connect(notification);
 
+        observe(root_->getGraph()->state_changed, [this]() {
+            // an edit invalidates the execution plan, it is compiled again once the edit is complete
+            if(!inline_executor_ && executor_->isRunning() && settings_.getTemporary<bool>("compiled_execution", false)) {
+                stopCompiledExecution();
+                startCompiledExecution();
+            }
+            // the same holds for the fused chains
+            if(operator_fusion_ && !operator_fusion_->isValid()) {
+                stopOperatorFusion();
+                startOperatorFusion();
+            }
+        });
+
 
         root_scheduler_ = std::make_shared<NodeRunner>(root_worker_);
-        thread_pool_->add(root_scheduler_.get());
+        executor_->add(root_scheduler_.get());
 
         root_->getSubgraphNode()->createInternalSlot(connection_types::makeEmpty<connection_types::AnyMessage>(),
                                                      root_->getGraph()->makeUUID("slot_save"), "save",
@@ -397,11 +433,37 @@ void CsApexCore::startMainLoop()
 
         root_->getSubgraphNode()->activation();
         thread_pool_->start();
+        if(inline_executor_) {
+            inline_executor_->start();
+        }
+
+        if(settings_.getTemporary<bool>("compiled_execution", false)) {
+            startCompiledExecution();
+        }
+        if(!execution_plan_ && settings_.getTemporary<bool>("operator_fusion", false)) {
+            startOperatorFusion();
+        }
+
+        // priorities follow the critical path, which changes with the measured processing times
+        bool critical_path_scheduling = settings_.getTemporary<bool>("critical_path_scheduling", false);
+        std::chrono::milliseconds critical_path_interval(settings_.getTemporary<int>("critical_path_update_interval", 1000));
+        std::chrono::steady_clock::time_point next_critical_path_update = std::chrono::steady_clock::now() + critical_path_interval;
 
         while(running_) {
             getCommandDispatcher()->executeLater();
 
-            running_changed_.wait_for(lock, std::chrono::milliseconds(10));
+            if(critical_path_scheduling && std::chrono::steady_clock::now() >= next_critical_path_update) {
+                root_->updateCriticalPaths();
+                next_critical_path_update = std::chrono::steady_clock::now() + critical_path_interval;
+            }
+
+            if(inline_executor_) {
+                lock.unlock();
+                inline_executor_->runFor(std::chrono::milliseconds(10));
+                lock.lock();
+            } else {
+                running_changed_.wait_for(lock, std::chrono::milliseconds(10));
+            }
         }
 
         shutdown_requested();
@@ -415,8 +477,57 @@ void CsApexCore::shutdown()
     running_changed_.notify_all();
 }
 
+void CsApexCore::startCompiledExecution()
+{
+    if(inline_executor_) {
+        sendNotification("compiled execution requires threads, using inline scheduling",
+                         ErrorState::ErrorLevel::WARNING);
+        return;
+    }
+
+    GraphLocalPtr graph = std::dynamic_pointer_cast<GraphLocal>(root_->getGraph());
+    apex_assert_hard(graph);
+
+    try {
+        execution_plan_ = std::make_shared<ExecutionPlan>(*graph);
+        execution_plan_->start(*thread_pool_);
+
+    } catch(const std::runtime_error& e) {
+        execution_plan_.reset();
+        sendNotification(std::string("cannot compile the graph, using dynamic scheduling: ") + e.what(),
+                         ErrorState::ErrorLevel::WARNING);
+    }
+}
+
+void CsApexCore::stopCompiledExecution()
+{
+    if(execution_plan_) {
+        execution_plan_->stop();
+        execution_plan_.reset();
+    }
+}
+
+void CsApexCore::startOperatorFusion()
+{
+    GraphLocalPtr graph = std::dynamic_pointer_cast<GraphLocal>(root_->getGraph());
+    apex_assert_hard(graph);
+
+    operator_fusion_ = std::make_shared<OperatorFusion>(*graph, *thread_pool_);
+}
+
+void CsApexCore::stopOperatorFusion()
+{
+    if(operator_fusion_) {
+        operator_fusion_->release();
+        operator_fusion_.reset();
+    }
+}
+
 void CsApexCore::reset()
 {
+    stopCompiledExecution();
+    stopOperatorFusion();
+
     reset_requested();
 
     root_->clear();
@@ -521,9 +632,12 @@ void CsApexCore::load(const std::string &file)
 {
     settings_.set("config", file);
 
-    bool running = thread_pool_->isRunning();
+    bool running = executor_->isRunning();
     if(running) {
         thread_pool_->stop();
+        if(inline_executor_) {
+            inline_executor_->stop();
+        }
     }
 
     if(load_needs_reset_) {
@@ -559,5 +673,16 @@ void CsApexCore::load(const std::string &file)
 
     if(running) {
         thread_pool_->start();
+        if(inline_executor_) {
+            inline_executor_->start();
+        }
+
+        // the reset has stopped the execution plan and the fused chains of the previous graph
+        if(settings_.getTemporary<bool>("compiled_execution", false)) {
+            startCompiledExecution();
+        }
+        if(!execution_plan_ && settings_.getTemporary<bool>("operator_fusion", false)) {
+            startOperatorFusion();
+        }
     }
 }
@@ -8,6 +8,7 @@
 #include <csapex/model/node_worker.h>
 #include <csapex/factory/node_factory.h>
 #include <csapex/msg/direct_connection.h>
+#include <csapex/msg/buffered_connection.h>
 #include <csapex/model/graph_facade.h>
 #include <csapex/model/subgraph_node.h>
 #include <csapex/msg/input.h>
@@ -300,9 +301,40 @@ void GraphIO::saveConnections(YAML::Node &yaml)
     saveConnections(yaml, graph_->getGraph()->getConnections());
 }
 
+std::string GraphIO::overflowPolicyToString(Connection::OverflowPolicy policy)
+{
+    switch(policy) {
+    case Connection::OverflowPolicy::KEEP_LATEST:
+        return "keep_latest";
+    case Connection::OverflowPolicy::DROP_OLDEST:
+        return "drop_oldest";
+    default:
+        return "block";
+    }
+}
+
+Connection::OverflowPolicy GraphIO::overflowPolicyFromString(const std::string& policy)
+{
+    if(policy == "keep_latest") {
+        return Connection::OverflowPolicy::KEEP_LATEST;
+    } else if(policy == "drop_oldest") {
+        return Connection::OverflowPolicy::DROP_OLDEST;
+    } else if(policy == "block") {
+        return Connection::OverflowPolicy::BLOCK;
+    }
+    throw std::runtime_error(std::string("unknown overflow policy ") + policy);
+}
+
 void GraphIO::saveConnections(YAML::Node &yaml, const std::vector<ConnectionPtr>& connections)
 {
-    std::unordered_map<UUID, std::vector<std::pair<UUID, std::string>>, UUID::Hasher> connection_map;
+    struct Target
+    {
+        UUID uuid;
+        std::string type;
+        std::size_t capacity;
+        Connection::OverflowPolicy policy;
+    };
+    std::unordered_map<UUID, std::vector<Target>, UUID::Hasher> connection_map;
 
     for(const ConnectionPtr& connection : connections) {
         if(ignore_forwarding_connections_) {
@@ -316,7 +348,7 @@ void GraphIO::saveConnections(YAML::Node &yaml, const std::vector<ConnectionPtr>
 
         std::string type = connection->isActive() ? "active" : "default";
 
-        connection_map[connection->from()->getUUID()].push_back(std::make_pair(connection->to()->getUUID(), type));
+        connection_map[connection->from()->getUUID()].push_back(Target { connection->to()->getUUID(), type, connection->getCapacity(), connection->getOverflowPolicy() });
 
         if(connection->getFulcrumCount() > 0) {
             YAML::Node fulcrum;
@@ -329,9 +361,23 @@ void GraphIO::saveConnections(YAML::Node &yaml, const std::vector<ConnectionPtr>
     for(const auto& pair : connection_map) {
         YAML::Node entry(YAML::NodeType::Map);
         entry["uuid"] = pair.first.getFullName();
+        bool buffered = false;
+        bool non_blocking = false;
         for(const auto& info : pair.second) {
-            entry["targets"].push_back(info.first.getFullName());
-            entry["types"].push_back(info.second);
+            entry["targets"].push_back(info.uuid.getFullName());
+            entry["types"].push_back(info.type);
+            buffered |= info.capacity > 1;
+            non_blocking |= info.policy != Connection::OverflowPolicy::BLOCK;
+        }
+        if(buffered) {
+            for(const auto& info : pair.second) {
+                entry["buffers"].push_back(info.capacity);
+            }
+        }
+        if(non_blocking) {
+            for(const auto& info : pair.second) {
+                entry["overflow"].push_back(overflowPolicyToString(info.policy));
+            }
         }
         yaml["connections"].push_back(entry);
     }
@@ -383,6 +429,12 @@ void GraphIO::loadConnection(const YAML::Node& connection)
     const YAML::Node& types = connection["types"];
     apex_assert_hard(!types.IsDefined() || (types.Type() == YAML::NodeType::Sequence && targets.size() == types.size()));
 
+    const YAML::Node& buffers = connection["buffers"];
+    apex_assert_hard(!buffers.IsDefined() || (buffers.Type() == YAML::NodeType::Sequence && targets.size() == buffers.size()));
+
+    const YAML::Node& overflow = connection["overflow"];
+    apex_assert_hard(!overflow.IsDefined() || (overflow.Type() == YAML::NodeType::Sequence && targets.size() == overflow.size()));
+
     for(unsigned j=0; j<targets.size(); ++j) {
         UUID to_uuid = readConnectorUUID(graph_->getGraph()->shared_from_this(), targets[j]);
 
@@ -393,9 +445,19 @@ void GraphIO::loadConnection(const YAML::Node& connection)
             connection_type = types[j].as<std::string>();
         }
 
+        std::size_t capacity = 1;
+        if(buffers.IsDefined()) {
+            capacity = buffers[j].as<std::size_t>();
+        }
+
+        Connection::OverflowPolicy policy = Connection::OverflowPolicy::BLOCK;
+        if(overflow.IsDefined()) {
+            policy = overflowPolicyFromString(overflow[j].as<std::string>());
+        }
+
         ConnectablePtr from = graph_->getGraph()->findConnectorNoThrow(from_uuid);
         if(from) {
-            loadConnection(from, to_uuid, connection_type);
+            loadConnection(from, to_uuid, connection_type, capacity, policy);
         } else {
             sendNotificationStreamGraphio("cannot load connection from '" << from_uuid << "' to '" << to_uuid <<
                                           "', '" << from_uuid << "' doesn't exist.");
@@ -491,7 +553,8 @@ void GraphIO::loadFulcrum(const YAML::Node& fulcrum)
 }
 
 
-void GraphIO::loadConnection(ConnectablePtr from, const UUID& to_uuid, const std::string& connection_type)
+void GraphIO::loadConnection(ConnectablePtr from, const UUID& to_uuid, const std::string& connection_type,
+                             std::size_t capacity, Connection::OverflowPolicy policy)
 {
     try {
         NodeHandle* target = graph_->getGraph()->findNodeHandleForConnector(to_uuid);
@@ -506,10 +569,12 @@ void GraphIO::loadConnection(ConnectablePtr from, const UUID& to_uuid, const std
 
         if(out && in) {
             // TODO: make connection factory
-            ConnectionPtr c = DirectConnection::connect(out, in);
+            ConnectionPtr c = capacity > 1 ? BufferedConnection::connect(out, in, capacity)
+                                           : DirectConnection::connect(out, in);
             if(connection_type == "active") {
                 c->setActive(true);
             }
+            c->setOverflowPolicy(policy);
             graph_->getGraph()->addConnection(c);
         }
 
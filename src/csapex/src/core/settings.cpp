@@ -32,6 +32,7 @@ const std::string Settings::config_extension = ".apex";
 const std::string Settings::template_extension = ".apexs";
 const std::string Settings::message_extension = ".apexm";
 const std::string Settings::message_extension_compressed = ".apexm.gz";
+const std::string Settings::message_log_extension = ".apexlog";
 const std::string Settings::default_config = Settings::defaultConfigFile();
 const std::string Settings::config_selector = "Configs(*" + Settings::config_extension + ");;LegacyConfigs(*.vecfg)";
 
@@ -261,6 +261,10 @@ int main(int argc, char** argv)
             ("threadless", "run without threading")
             ("fatal_exceptions", "abort execution on exception")
             ("disable_thread_grouping", "by default create one thread per node")
+            ("elastic_threads", "release the threads of idle nodes and restart them on demand")
+            ("critical_path_scheduling", "prioritize nodes on the longest path through the graph")
+            ("compiled", "execute the loaded graph with a precompiled schedule (headless only)")
+            ("fuse", "execute linear chains of nodes of the loaded graph as single tasks")
             ("input", "config file to load")
             ;
 
@@ -376,6 +380,10 @@ int main(int argc, char** argv)
     settings.set("headless", headless);
     settings.set("threadless", vm.count("threadless") > 0);
     settings.set("thread_grouping", vm.count("disable_thread_grouping") == 0);
+    settings.set("elastic_threads", vm.count("elastic_threads") > 0);
+    settings.set("critical_path_scheduling", vm.count("critical_path_scheduling") > 0);
+    settings.set("compiled_execution", headless && vm.count("compiled") > 0);
+    settings.set("operator_fusion", vm.count("fuse") > 0);
     settings.set("additional_args", additional_args);
     settings.set("initially_paused", vm.count("paused") > 0);
 
@@ -14,6 +14,7 @@
 #include <csapex/plugin/plugin_manager.hpp>
 #include <csapex/model/subgraph_node.h>
 #include <csapex/nodes/note.h>
+#include <csapex/nodes/message_recorder.h>
 #include <csapex/param/string_list_parameter.h>
 #include <csapex/model/graph/graph_local.h>
 
@@ -50,6 +51,12 @@ NodeFactory::NodeFactory(Settings& settings, PluginLocator* locator)
     note->setDescription("A sticky note to keep information.");
     registerNodeType(note, true);
 
+    NodeConstructorPtr recorder = std::make_shared<NodeConstructor>("csapex::MessageRecorder", []{
+        return std::make_shared<MessageRecorder>();
+    });
+    recorder->setDescription("Records all incoming messages into a log file, which can be played back with a file importer.");
+    registerNodeType(recorder, true);
+
     node_manager_->manifest_loaded.connect(manifest_loaded);
 }
 
@@ -297,6 +304,7 @@ NodeFacadeLocalPtr NodeFactory::makeNodeLocal(const std::string& target_type, co
 
         NodeWorkerPtr nw = std::make_shared<NodeWorker>(nh);
         NodeRunnerPtr runner = std::make_shared<NodeRunner>(nw);
+        runner->setCriticalPathScheduling(settings_.getTemporary<bool>("critical_path_scheduling", false));
         NodeFacadeLocalPtr result = std::make_shared<NodeFacadeLocal>(nh, nw, runner);
 
         if(state) {
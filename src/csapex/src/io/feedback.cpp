@@ -12,7 +12,7 @@ Feedback::Feedback(const std::string &message)
 
 }
 
-Feedback::Feedback(const std::string &message, uint8_t request_id)
+Feedback::Feedback(const std::string &message, uint32_t request_id)
     : Response(request_id), message_(message)
 {
 
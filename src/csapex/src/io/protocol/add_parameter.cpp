@@ -26,7 +26,7 @@ AddParameter::ParameterRequest::ParameterRequest(const AUUID &id, const std::str
     apex_assert_hard(!name_.empty());
 }
 
-AddParameter::ParameterRequest::ParameterRequest(uint8_t request_id)
+AddParameter::ParameterRequest::ParameterRequest(uint32_t request_id)
     : RequestImplementation(request_id)
 {
 
@@ -72,12 +72,12 @@ void AddParameter::ParameterRequest::deserialize(SerializationBuffer& data)
 /// RESPONSE
 ///
 
-AddParameter::ParameterResponse::ParameterResponse(const param::ParameterConstPtr &parameter, uint8_t request_id)
+AddParameter::ParameterResponse::ParameterResponse(const param::ParameterConstPtr &parameter, uint32_t request_id)
     : ResponseImplementation(request_id), param_(parameter)
 {
 
 }
-AddParameter::ParameterResponse::ParameterResponse(uint8_t request_id)
+AddParameter::ParameterResponse::ParameterResponse(uint32_t request_id)
     : ResponseImplementation(request_id)
 {
 
@@ -27,12 +27,25 @@ CommandRequests::CommandRequest::CommandRequest(CommandRequestType request_type)
 
 }
 
-CommandRequests::CommandRequest::CommandRequest(uint8_t request_id)
+CommandRequests::CommandRequest::CommandRequest(uint32_t request_id)
     : RequestImplementation(request_id)
 {
 
 }
 
+bool CommandRequests::CommandRequest::isReadOnly() const
+{
+    switch(request_type_)
+    {
+    case CommandRequestType::IsDirty:
+    case CommandRequestType::CanUndo:
+    case CommandRequestType::CanRedo:
+        return true;
+    default:
+        return false;
+    }
+}
+
 ResponsePtr CommandRequests::CommandRequest::execute(CsApexCore &core) const
 {
     CommandDispatcherPtr dispatcher = core.getCommandDispatcher();
@@ -92,21 +105,21 @@ void CommandRequests::CommandRequest::deserialize(SerializationBuffer& data)
 /// RESPONSE
 ///
 
-CommandRequests::CommandResponse::CommandResponse(CommandRequestType request_type, uint8_t request_id)
+CommandRequests::CommandResponse::CommandResponse(CommandRequestType request_type, uint32_t request_id)
     : ResponseImplementation(request_id),
       request_type_(request_type),
       result_(false)
 {
 
 }
-CommandRequests::CommandResponse::CommandResponse(CommandRequestType request_type, bool result, uint8_t request_id)
+CommandRequests::CommandResponse::CommandResponse(CommandRequestType request_type, bool result, uint32_t request_id)
     : ResponseImplementation(request_id),
       request_type_(request_type),
       result_(result)
 {
 
 }
-CommandRequests::CommandResponse::CommandResponse(uint8_t request_id)
+CommandRequests::CommandResponse::CommandResponse(uint32_t request_id)
     : ResponseImplementation(request_id),
       result_(false)
 {
@@ -8,9 +8,11 @@
 #include <csapex/utility/uuid_provider.h>
 #include <csapex/model/graph_facade.h>
 #include <csapex/serialization/parameter_serializer.h>
+#include <csapex/scheduling/thread_pool.h>
 
 /// SYSTEM
 #include <iostream>
+#include <yaml-cpp/yaml.h>
 
 CSAPEX_REGISTER_REQUEST_SERIALIZER(CoreRequests)
 
@@ -26,12 +28,25 @@ CoreRequests::CoreRequest::CoreRequest(CoreRequestType request_type)
 
 }
 
-CoreRequests::CoreRequest::CoreRequest(uint8_t request_id)
+CoreRequests::CoreRequest::CoreRequest(uint32_t request_id)
     : RequestImplementation(request_id)
 {
 
 }
 
+bool CoreRequests::CoreRequest::isReadOnly() const
+{
+    switch(request_type_)
+    {
+    case CoreRequestType::CoreGetPause:
+    case CoreRequestType::CoreGetSteppingMode:
+    case CoreRequestType::CoreGetSchedulerTelemetry:
+        return true;
+    default:
+        return false;
+    }
+}
+
 ResponsePtr CoreRequests::CoreRequest::execute(CsApexCore &core) const
 {
     switch(request_type_)
@@ -93,6 +108,15 @@ ResponsePtr CoreRequests::CoreRequest::execute(CsApexCore &core) const
         return std::make_shared<CoreResponse>(request_type_, core.isSteppingMode(), getRequestID());
     case CoreRequestType::CoreGetPause:
         return std::make_shared<CoreResponse>(request_type_, core.isPaused(), getRequestID());
+    case CoreRequestType::CoreGetSchedulerTelemetry:
+    {
+        YAML::Node telemetry;
+        core.getThreadPool()->saveTelemetry(telemetry);
+        return std::make_shared<CoreResponse>(request_type_, std::string(YAML::Dump(telemetry)), getRequestID());
+    }
+    case CoreRequestType::CoreResetSchedulerTelemetry:
+        core.getThreadPool()->resetTelemetry();
+        break;
 
     default:
         return std::make_shared<Feedback>(std::string("unknown core request type ") + std::to_string((int)request_type_),
@@ -118,20 +142,20 @@ void CoreRequests::CoreRequest::deserialize(SerializationBuffer& data)
 /// RESPONSE
 ///
 
-CoreRequests::CoreResponse::CoreResponse(CoreRequestType request_type, uint8_t request_id)
+CoreRequests::CoreResponse::CoreResponse(CoreRequestType request_type, uint32_t request_id)
     : ResponseImplementation(request_id),
       request_type_(request_type)
 {
 
 }
-CoreRequests::CoreResponse::CoreResponse(CoreRequestType request_type, boost::any result, uint8_t request_id)
+CoreRequests::CoreResponse::CoreResponse(CoreRequestType request_type, boost::any result, uint32_t request_id)
     : ResponseImplementation(request_id),
       request_type_(request_type),
       result_(result)
 {
 
 }
-CoreRequests::CoreResponse::CoreResponse(uint8_t request_id)
+CoreRequests::CoreResponse::CoreResponse(uint32_t request_id)
     : ResponseImplementation(request_id)
 {
 
@@ -23,12 +23,17 @@ RequestParameter::ParameterRequest::ParameterRequest(const AUUID &id)
 
 }
 
-RequestParameter::ParameterRequest::ParameterRequest(uint8_t request_id)
+RequestParameter::ParameterRequest::ParameterRequest(uint32_t request_id)
     : RequestImplementation(request_id)
 {
 
 }
 
+bool RequestParameter::ParameterRequest::isReadOnly() const
+{
+    return true;
+}
+
 ResponsePtr RequestParameter::ParameterRequest::execute(CsApexCore &core) const
 {
     std::shared_ptr<ParameterResponse> response;
@@ -58,12 +63,12 @@ void RequestParameter::ParameterRequest::deserialize(SerializationBuffer& data)
 /// RESPONSE
 ///
 
-RequestParameter::ParameterResponse::ParameterResponse(const param::ParameterConstPtr &parameter, uint8_t request_id)
+RequestParameter::ParameterResponse::ParameterResponse(const param::ParameterConstPtr &parameter, uint32_t request_id)
     : ResponseImplementation(request_id), param_(parameter)
 {
 
 }
-RequestParameter::ParameterResponse::ParameterResponse(uint8_t request_id)
+RequestParameter::ParameterResponse::ParameterResponse(uint32_t request_id)
     : ResponseImplementation(request_id)
 {
 
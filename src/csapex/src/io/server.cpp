@@ -97,6 +97,11 @@ void Server::do_accept()
                     handlePacket(session, packet);
                 }
             });
+            session->setRequestHandler([this, w_session](const RequestConstPtr& request){
+                if(SessionPtr session = w_session.lock()) {
+                    handlePacket(session, request);
+                }
+            });
 
             session->start();
 
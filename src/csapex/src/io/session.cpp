@@ -13,14 +13,41 @@
 
 /// SYSTEM
 #include <csapex/utility/error_handling.h>
+#include <algorithm>
 #include <iostream>
 
 using namespace csapex;
 using boost::asio::ip::tcp;
 
-Session::Session(tcp::socket socket)
-    : socket_(std::move(socket)),
+namespace
+{
+bool isReadOnlyRequest(const SerializableConstPtr& packet)
+{
+    RequestConstPtr request = std::dynamic_pointer_cast<Request const>(packet);
+    return request && request->isReadOnly();
+}
+}
+
+Session::Session(tcp::socket socket, std::size_t handler_threads)
+    : handler_thread_count_(std::max<std::size_t>(1, handler_threads)),
+      socket_(std::move(socket)),
       next_request_id_(1),
+      request_timeout_ms_(0),
+      active_requests_(0),
+      ordered_packet_active_(false),
+#if (BOOST_VERSION / 100) >= 1066
+      linger_timer_(socket_.get_executor()),
+#else
+      linger_timer_(socket_.get_io_service()),
+#endif
+      queued_bytes_(0),
+      writing_(false),
+      lingering_(false),
+      flush_threshold_(64 * 1024),
+      linger_(0),
+      bytes_written_(0),
+      packets_written_(0),
+      write_syscalls_(0),
       running_(false),
       live_(false)
 {
@@ -34,12 +61,44 @@ Session::~Session()
             stop();
         }
 
-        apex_assert_hard(!packet_handler_thread_.joinable());
+        apex_assert_hard(packet_handler_threads_.empty());
     }
 
     socket_.close();
 }
 
+void Session::setRequestTimeout(std::chrono::milliseconds timeout)
+{
+    request_timeout_ms_ = timeout.count();
+}
+
+std::chrono::milliseconds Session::getRequestTimeout() const
+{
+    return std::chrono::milliseconds(request_timeout_ms_.load());
+}
+
+void Session::setWriteCoalescing(std::size_t flush_threshold, std::chrono::microseconds linger)
+{
+    std::unique_lock<std::recursive_mutex> lock(write_mutex_);
+    flush_threshold_ = std::max<std::size_t>(1, flush_threshold);
+    linger_ = linger;
+}
+
+Session::WriteStatistics Session::getWriteStatistics() const
+{
+    WriteStatistics stats;
+    stats.bytes = bytes_written_;
+    stats.packets = packets_written_;
+    stats.syscalls = write_syscalls_;
+    return stats;
+}
+
+void Session::setRequestHandler(std::function<void(const RequestConstPtr&)> handler)
+{
+    apex_assert_hard(!running_);
+    request_handler_ = handler;
+}
+
 void Session::start()
 {
     {
@@ -49,49 +108,126 @@ void Session::start()
     }
     started();
 
-    packet_handler_thread_ = std::thread([this](){
-        live_ = true;
+    live_ = true;
+    for(std::size_t i = 0; i < handler_thread_count_; ++i) {
+        packet_handler_threads_.emplace_back([this](){
+            handlePackets();
+        });
+    }
 
-        while(running_) {
-            std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
-            while(running_ && packets_.empty()) {
-                packets_available_.wait_for(packet_lock, std::chrono::milliseconds(100));
+    read_async();
+}
+
+void Session::handlePackets()
+{
+    std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
+    while(running_) {
+        // read only requests may run alongside each other, every other packet has to wait for all of its predecessors
+        auto can_dispatch = [this]() {
+            if(packets_.empty() || ordered_packet_active_) {
+                return false;
             }
+            return active_requests_ == 0 || isReadOnlyRequest(packets_.front());
+        };
+        while(running_ && !can_dispatch()) {
+            packets_available_.wait_for(packet_lock, std::chrono::milliseconds(100));
+        }
+        if(!running_) {
+            break;
+        }
+
+        SerializableConstPtr packet = packets_.front();
+        packets_.pop_front();
+
+        bool ordered = !isReadOnlyRequest(packet);
+        if(ordered) {
+            ordered_packet_active_ = true;
+        } else {
+            ++active_requests_;
+            // the next read only request can be picked up by another handler right away
+            packets_available_.notify_all();
+        }
+
+        packet_lock.unlock();
+        if(std::dynamic_pointer_cast<Request const>(packet)) {
+            dispatchRequest(packet);
+        } else {
+            dispatchPacket(packet);
+        }
+        packet_lock.lock();
+
+        if(ordered) {
+            ordered_packet_active_ = false;
+        } else {
+            --active_requests_;
+        }
+        packets_available_.notify_all();
+    }
+}
+
+void Session::dispatchPacket(const SerializableConstPtr& packet)
+{
+    try {
 
-            while(running_ && !packets_.empty()) {
-                SerializableConstPtr packet = packets_.front();
-                packets_.pop_front();
-                packet_lock.unlock();
-
-                try {
-
-                    switch(packet->getPacketType()) {
-                    case BroadcastMessage::PACKET_TYPE_ID:
-                        if(BroadcastMessageConstPtr broadcast = std::dynamic_pointer_cast<BroadcastMessage const>(packet)) {
-                            broadcast_received(broadcast);
-                            break;
-                        }
-                    default:
-                        packet_received(packet);
-                        break;
-                    }
-
-                } catch(...) {
-                    // silent death
-                }
-
-                packet_lock.lock();
+        switch(packet->getPacketType()) {
+        case BroadcastMessage::PACKET_TYPE_ID:
+            if(BroadcastMessageConstPtr broadcast = std::dynamic_pointer_cast<BroadcastMessage const>(packet)) {
+                broadcast_received(broadcast);
+                break;
             }
+        default:
+            packet_received(packet);
+            break;
+        }
+
+    } catch(...) {
+        // silent death
+    }
+}
+
+void Session::dispatchRequest(const SerializableConstPtr& packet)
+{
+    if(!request_handler_) {
+        dispatchPacket(packet);
+        return;
+    }
+
+    try {
+        request_handler_(std::dynamic_pointer_cast<Request const>(packet));
+
+    } catch(...) {
+        // silent death
+    }
+}
+
+void Session::stop_async()
+{
+    // stop() joins the handler threads, so they must not call it themselves
+    SessionPtr self = shared_from_this();
+#if (BOOST_VERSION / 100) >= 1066
+    boost::asio::post(socket_.get_executor(), [self]() {
+#else
+    socket_.get_io_service().post([self]() {
+#endif
+        if(self->running_) {
+            self->stop();
         }
-        live_ = false;
     });
+}
 
-    read_async();
+bool Session::isHandlerThread() const
+{
+    for(const std::thread& thread : packet_handler_threads_) {
+        if(thread.get_id() == std::this_thread::get_id()) {
+            return true;
+        }
+    }
+    return false;
 }
 
 void Session::stop()
 {
-    apex_assert_hard(packet_handler_thread_.get_id() != std::this_thread::get_id());
+    apex_assert_hard(!isHandlerThread());
 
     std::unique_lock<std::recursive_mutex> running_lock(running_mutex_);
 
@@ -100,40 +236,72 @@ void Session::stop()
 //    }
     running_ = false;
 
-    std::unique_lock<std::recursive_mutex> lock(open_requests_mutex_);
-    for(auto pair : open_requests_) {
-        std::promise<ResponseConstPtr>* open_requests = pair.second;
-        open_requests->set_value(nullptr);
+    {
+        std::unique_lock<std::recursive_mutex> lock(open_requests_mutex_);
+        for(auto pair : open_requests_) {
+            std::promise<ResponseConstPtr>* promise = pair.second.promise;
+            promise->set_value(nullptr);
+        }
+        open_requests_.clear();
     }
 
     running_lock.unlock();
 
     stopped();
 
-    if(live_) {
-        packet_handler_thread_.join();
+    packets_available_.notify_all();
+    for(std::thread& thread : packet_handler_threads_) {
+        if(thread.joinable()) {
+            thread.join();
+        }
     }
-    apex_assert_hard(!live_);
+    packet_handler_threads_.clear();
+    live_ = false;
 }
 
 
 ResponseConstPtr Session::sendRequest(RequestConstPtr request)
 {
     if(live_) {
-        request->overwriteRequestID(next_request_id_++);
+        // id 0 marks feedback that belongs to no request
+        uint32_t id = next_request_id_++;
+        if(id == 0) {
+            id = next_request_id_++;
+        }
+        request->overwriteRequestID(id);
 
         std::promise<ResponseConstPtr> promise;
+        std::future<ResponseConstPtr> future = promise.get_future();
 
+        std::chrono::milliseconds timeout = getRequestTimeout();
+        bool wait_indefinitely = timeout.count() <= 0;
+
+        OpenRequest open_request;
+        open_request.promise = &promise;
+        open_request.deadline = wait_indefinitely ? std::chrono::steady_clock::time_point::max()
+                                                  : std::chrono::steady_clock::now() + timeout;
         {
             std::unique_lock<std::recursive_mutex> lock(open_requests_mutex_);
-            open_requests_[request->getRequestID()] = &promise;
+            if(!running_) {
+                return nullptr;
+            }
+            open_requests_[id] = open_request;
         }
 
         write(request);
 
-        std::future<ResponseConstPtr> future = promise.get_future();
+        if(wait_indefinitely) {
+            future.wait();
 
-        future.wait();
+        } else if(future.wait_until(open_request.deadline) == std::future_status::timeout) {
+            std::unique_lock<std::recursive_mutex> lock(open_requests_mutex_);
+            // the response may have arrived while the lock was not held
+            if(future.wait_for(std::chrono::seconds(0)) == std::future_status::timeout) {
+                open_requests_.erase(id);
+                std::cerr << "request #" << id << " has timed out" << std::endl;
+                return nullptr;
+            }
+        }
 
         if(ResponseConstPtr response = future.get()) {
             return response;
@@ -164,76 +332,112 @@ void Session::read_async()
         }
     }
 
+    // pending operations keep the session alive, so that their handlers never outlive it
+    SessionPtr self = shared_from_this();
     std::shared_ptr<SerializationBuffer> message_data = std::make_shared<SerializationBuffer>();
     boost::asio::async_read(socket_, boost::asio::buffer(&message_data->at(0), SerializationBuffer::HEADER_LENGTH),
-                            [this, message_data](boost::system::error_code ec, std::size_t reply_length){
-        if ((ec  == boost::asio::error::eof) || (ec == boost::asio::error::connection_reset)) {
+                            [this, self, message_data](boost::system::error_code ec, std::size_t reply_length){
+        if(ec == boost::asio::error::operation_aborted || !running_) {
+            // the socket has been closed or the session has been stopped
+            return;
+
+        } else if ((ec  == boost::asio::error::eof) || (ec == boost::asio::error::connection_reset)) {
             // disconnect
             stop();
+            return;
+
+        } else if(ec) {
+            std::cerr << "cannot read packet header: " << ec.message() << std::endl;
+            stop();
+            return;
+
+        } else if(reply_length == SerializationBuffer::HEADER_LENGTH) {
+            message_data->seek(0);
+            uint32_t message_length;
+            *message_data >> message_length;
 
-        } else if(reply_length > 0) {
-            // payload received
-            if(reply_length == SerializationBuffer::HEADER_LENGTH) {
-                message_data->seek(0);
-                uint32_t message_length;
-                *message_data >> message_length;
-
-                if(message_length <= SerializationBuffer::HEADER_LENGTH) {
-                    std::cerr << "got illegal message of length " << (int) message_length << std::endl;
-
-                } else {
-                    message_data->resize(message_length, ' ');
-                    reply_length = boost::asio::read(socket_, boost::asio::buffer(&message_data->at(SerializationBuffer::HEADER_LENGTH), message_length - SerializationBuffer::HEADER_LENGTH));
-                    apex_assert_equal_hard((int) reply_length, ((int) (message_length - SerializationBuffer::HEADER_LENGTH)));
-
-                    SerializablePtr serial = PacketSerializer::deserializePacket(*message_data);
-
-                    if(serial) {
-                        if(FeedbackConstPtr feedback = std::dynamic_pointer_cast<Feedback const>(serial)) {
-                            std::cerr << feedback->getMessage() << std::endl;
-                            if(feedback->getRequestID() != 0) {
-                                std::unique_lock<std::recursive_mutex> lock(open_requests_mutex_);
-                                auto it = open_requests_.find(feedback->getRequestID());
-                                if(it != open_requests_.end()) {
-                                    std::promise<ResponseConstPtr>* promise = it->second;
-                                    promise->set_value(nullptr);
-                                    open_requests_.erase(it);
-
-                                } else {
-                                    std::cerr << "got feedback for unknown request " << (int) feedback->getRequestID() << std::endl;
-                                }
-                            }
-
-                        } else if(ResponseConstPtr response = std::dynamic_pointer_cast<Response const>(serial)) {
-                            std::cerr << "got response #" << (int) response->getRequestID() << std::endl;
-
-                            std::unique_lock<std::recursive_mutex> lock(open_requests_mutex_);
-                            auto it = open_requests_.find(response->getRequestID());
-                            if(it != open_requests_.end()) {
-                                std::promise<ResponseConstPtr>* promise = it->second;
-                                promise->set_value(response);
-                                open_requests_.erase(it);
-
-                            } else {
-                                std::cerr << "got response for unknown request " << (int) response->getRequestID() << std::endl;
-                            }
-
-                        } else {
-                            std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
-                            packets_.push_back(serial);
-                            packets_available_.notify_all();
-                        }
-                    }
-                }
+            if(message_length <= SerializationBuffer::HEADER_LENGTH) {
+                std::cerr << "got illegal message of length " << (int) message_length << std::endl;
 
             } else {
-                std::cerr << "got illegal header of length " << (int) reply_length << std::endl;
+                message_data->resize(message_length, ' ');
+                // the next header is only read once the body is complete
+                read_body_async(message_data);
+                return;
             }
+
+        } else {
+            std::cerr << "got illegal header of length " << (int) reply_length << std::endl;
         }
         read_async();
     });
 }
 
+void Session::read_body_async(const std::shared_ptr<SerializationBuffer>& message_data)
+{
+    SessionPtr self = shared_from_this();
+    std::size_t body_length = message_data->size() - SerializationBuffer::HEADER_LENGTH;
+    boost::asio::async_read(socket_, boost::asio::buffer(&message_data->at(SerializationBuffer::HEADER_LENGTH), body_length),
+                            [this, self, message_data, body_length](boost::system::error_code ec, std::size_t reply_length){
+        if(ec == boost::asio::error::operation_aborted || !running_) {
+            // the socket has been closed or the session has been stopped
+            return;
+
+        } else if ((ec  == boost::asio::error::eof) || (ec == boost::asio::error::connection_reset)) {
+            // disconnect
+            stop();
+            return;
+
+        } else if(ec) {
+            std::cerr << "cannot read packet body: " << ec.message() << std::endl;
+            stop();
+            return;
+
+        } else {
+            apex_assert_equal_hard((int) reply_length, (int) body_length);
+
+            handleReceivedPacket(PacketSerializer::deserializePacket(*message_data));
+        }
+        read_async();
+    });
+}
+
+void Session::handleReceivedPacket(const SerializablePtr& serial)
+{
+    if(!serial) {
+        return;
+    }
+
+    if(FeedbackConstPtr feedback = std::dynamic_pointer_cast<Feedback const>(serial)) {
+        std::cerr << feedback->getMessage() << std::endl;
+        if(feedback->getRequestID() != 0) {
+            resolveRequest(feedback->getRequestID(), nullptr);
+        }
+
+    } else if(ResponseConstPtr response = std::dynamic_pointer_cast<Response const>(serial)) {
+        resolveRequest(response->getRequestID(), response);
+
+    } else {
+        std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
+        packets_.push_back(serial);
+        packets_available_.notify_all();
+    }
+}
+
+void Session::resolveRequest(uint32_t request_id, const ResponseConstPtr& response)
+{
+    std::unique_lock<std::recursive_mutex> lock(open_requests_mutex_);
+    auto it = open_requests_.find(request_id);
+    if(it != open_requests_.end()) {
+        std::promise<ResponseConstPtr>* promise = it->second.promise;
+        promise->set_value(response);
+        open_requests_.erase(it);
+
+    } else {
+        std::cerr << "got response for unknown or timed out request " << request_id << std::endl;
+    }
+}
+
 void Session::write_packet(SerializationBuffer &buffer)
 {
     try {
@@ -243,14 +447,100 @@ void Session::write_packet(SerializationBuffer &buffer)
 
 //                std::cerr << "sending:\n" << buffer.toString() << std::endl;
 
-        boost::asio::async_write(socket_, boost::asio::buffer(buffer, buffer.size()),
-                                 [](boost::system::error_code /*ec*/, std::size_t /*length*/){});
+        // packets are written by many threads, but only one write may be pending on the socket
+        std::unique_lock<std::recursive_mutex> lock(write_mutex_);
+        queued_bytes_ += buffer.size();
+        write_queue_.push_back(std::make_shared<SerializationBuffer>(std::move(buffer)));
+
+        if(!writing_) {
+            if(linger_.count() == 0 || queued_bytes_ >= flush_threshold_) {
+                flush_writes();
+            } else if(!lingering_) {
+                linger();
+            }
+        }
 
     } catch(const std::exception& e) {
         std::cerr << "the session has thrown an exception: " << e.what() << std::endl;
-        stop();
+        stop_async();
     } catch(...) {
         std::cerr << "the session has crashed with an unknown cause." << std::endl;
-        stop();
+        stop_async();
     }
 }
+
+void Session::linger()
+{
+    lingering_ = true;
+    linger_timer_.expires_from_now(linger_);
+    SessionPtr self = shared_from_this();
+    linger_timer_.async_wait([this, self](const boost::system::error_code& ec) {
+        if(ec == boost::asio::error::operation_aborted) {
+            return;
+        }
+
+        std::unique_lock<std::recursive_mutex> lock(write_mutex_);
+        lingering_ = false;
+        if(!writing_ && !write_queue_.empty()) {
+            flush_writes();
+        }
+    });
+}
+
+void Session::flush_writes()
+{
+    if(lingering_) {
+        linger_timer_.cancel();
+        lingering_ = false;
+    }
+
+    // the batch owns its packets until the write has completed
+    auto batch = std::make_shared<std::vector<std::shared_ptr<SerializationBuffer>>>();
+    std::vector<boost::asio::const_buffer> buffers;
+    std::size_t batch_bytes = 0;
+    while(!write_queue_.empty() && (batch->empty() || batch_bytes < flush_threshold_)) {
+        std::shared_ptr<SerializationBuffer> packet = write_queue_.front();
+        write_queue_.pop_front();
+
+        buffers.push_back(boost::asio::buffer(*packet, packet->size()));
+        batch_bytes += packet->size();
+        batch->push_back(packet);
+    }
+    queued_bytes_ -= batch_bytes;
+    writing_ = true;
+
+    // the completion condition is consulted before every write_some, which lets us count them
+    auto count_syscalls = [this](const boost::system::error_code& ec, std::size_t transferred) -> std::size_t {
+        std::size_t next = boost::asio::transfer_all()(ec, transferred);
+        if(next > 0) {
+            ++write_syscalls_;
+        }
+        return next;
+    };
+
+    SessionPtr self = shared_from_this();
+    boost::asio::async_write(socket_, buffers, count_syscalls,
+                             [this, self, batch](boost::system::error_code ec, std::size_t length){
+        if(ec == boost::asio::error::operation_aborted) {
+            // the socket has been closed, nothing is written anymore
+            return;
+        }
+
+        std::unique_lock<std::recursive_mutex> lock(write_mutex_);
+        writing_ = false;
+
+        if(ec) {
+            write_queue_.clear();
+            queued_bytes_ = 0;
+            return;
+        }
+
+        bytes_written_ += length;
+        packets_written_ += batch->size();
+
+        // packets that were written in the meantime have waited long enough
+        if(!write_queue_.empty()) {
+            flush_writes();
+        }
+    });
+}
@@ -5,6 +5,7 @@
 #include <csapex/plugin/plugin_manager.hpp>
 #include <csapex/core/settings.h>
 #include <csapex/msg/apex_message_provider.h>
+#include <csapex/msg/message_log_provider.h>
 
 /// SYSTEM
 #include <boost/filesystem.hpp>
@@ -45,6 +46,9 @@ void MessageProviderManager::loadPlugins()
     registerMessageProvider(Settings::message_extension, std::bind(&ApexMessageProvider::make));
     registerMessageProvider(Settings::message_extension_compressed, std::bind(&ApexMessageProvider::make));
 
+    supported_types_ += std::string("*") + Settings::message_log_extension + " ";
+    registerMessageProvider(Settings::message_log_extension, std::bind(&MessageLogProvider::make));
+
     for(const auto& pair : manager_->getConstructors()) {
         try {
             MessageProvider::Ptr prov(pair.second());
@@ -0,0 +1,217 @@
+/// HEADER
+#include <csapex/model/async_process.h>
+
+/// PROJECT
+#include <csapex/model/node_handle.h>
+#include <csapex/model/node_worker.h>
+#include <csapex/utility/assert.h>
+#include <csapex/utility/fd_reactor.h>
+
+/// SYSTEM
+#include <poll.h>
+#include <thread>
+
+using namespace csapex;
+
+namespace
+{
+const AsyncProcess::Clock::duration MIN_POLL_INTERVAL = std::chrono::microseconds(100);
+
+bool isReady(int fd, short events)
+{
+    pollfd request;
+    request.fd = fd;
+    request.events = events;
+    request.revents = 0;
+    // errors and hang ups count as ready, so that the step can handle them
+    return ::poll(&request, 1, 0) != 0;
+}
+}
+
+AsyncProcessPtr AsyncProcess::make(NodeModifier& node_modifier, Parameterizable& parameters, Continuation continuation)
+{
+    return AsyncProcessPtr(new AsyncProcess(node_modifier, parameters, continuation));
+}
+
+AsyncProcess::AsyncProcess(NodeModifier& node_modifier, Parameterizable& parameters, Continuation continuation)
+    : node_modifier_(node_modifier), parameters_(parameters), continuation_(continuation),
+      waiting_(false), finished_(false),
+      max_poll_interval_(std::chrono::milliseconds(10))
+{
+    NodeWorker* worker = node_modifier_.getNodeWorker();
+    apex_assert_hard(worker);
+    node_handle_ = worker->getNodeHandle();
+}
+
+AsyncProcess::~AsyncProcess()
+{
+}
+
+void AsyncProcess::at(Clock::time_point time, Step step)
+{
+    await();
+
+    NodeHandlePtr handle = node_handle_.lock();
+    if(!handle) {
+        return;
+    }
+
+    if(handle->delayed_execution_requested.isConnected()) {
+        AsyncProcessPtr self = shared_from_this();
+        handle->delayed_execution_requested([self, step]() {
+            self->resume(step);
+        }, time);
+
+    } else {
+        // without a scheduler, the calling thread has to wait
+        std::this_thread::sleep_until(time);
+        resume(step);
+    }
+}
+
+void AsyncProcess::after(Clock::duration delay, Step step)
+{
+    at(Clock::now() + delay, step);
+}
+
+void AsyncProcess::waitUntil(std::function<bool()> ready, Step step)
+{
+    await();
+    poll(ready, step, Clock::duration::zero());
+}
+
+void AsyncProcess::whenReadable(int fd, Step step)
+{
+    watch(fd, FdReactor::Event::READABLE, step);
+}
+
+void AsyncProcess::whenWritable(int fd, Step step)
+{
+    watch(fd, FdReactor::Event::WRITABLE, step);
+}
+
+void AsyncProcess::watch(int fd, FdReactor::Event event, Step step)
+{
+    await();
+
+    AsyncProcessPtr self = shared_from_this();
+    bool watched = FdReactor::instance().watch(fd, event, [self, step]() {
+        self->resumeLater(step);
+    });
+
+    if(!watched) {
+        short events = event == FdReactor::Event::READABLE ? POLLIN : POLLOUT;
+        poll([fd, events]() {
+            return isReady(fd, events);
+        }, step, Clock::duration::zero());
+    }
+}
+
+void AsyncProcess::finish(ProcessingFunction function)
+{
+    if(finished_.exchange(true)) {
+        return;
+    }
+    waiting_ = false;
+    continuation_(function);
+}
+
+bool AsyncProcess::isFinished() const
+{
+    return finished_;
+}
+
+void AsyncProcess::setMaxPollInterval(Clock::duration interval)
+{
+    max_poll_interval_ = std::max(interval, MIN_POLL_INTERVAL);
+}
+
+AsyncProcess::Clock::duration AsyncProcess::getMaxPollInterval() const
+{
+    return max_poll_interval_;
+}
+
+void AsyncProcess::await()
+{
+    apex_assert_hard(!finished_);
+    bool was_waiting = waiting_.exchange(true);
+    apex_assert_hard_msg(!was_waiting, "an asynchronous process can only wait for one thing at a time");
+}
+
+void AsyncProcess::resume(Step step)
+{
+    if(finished_ || node_handle_.expired()) {
+        return;
+    }
+    waiting_ = false;
+    execute(step);
+}
+
+void AsyncProcess::resumeLater(Step step)
+{
+    NodeHandlePtr handle = node_handle_.lock();
+    if(!handle) {
+        return;
+    }
+
+    // the step is serialized with the other tasks of the node
+    if(handle->execution_requested.isConnected()) {
+        AsyncProcessPtr self = shared_from_this();
+        handle->execution_requested([self, step]() {
+            self->resume(step);
+        });
+    } else {
+        resume(step);
+    }
+}
+
+void AsyncProcess::execute(const Step& step)
+{
+    try {
+        step(node_modifier_, parameters_, *this);
+
+    } catch(const std::exception& e) {
+        node_modifier_.setError(e.what());
+        finish();
+        return;
+
+    } catch(...) {
+        finish();
+        throw;
+    }
+
+    if(!waiting_) {
+        finish();
+    }
+}
+
+void AsyncProcess::poll(std::function<bool()> ready, Step step, Clock::duration interval)
+{
+    NodeHandlePtr handle = node_handle_.lock();
+    if(!handle) {
+        return;
+    }
+
+    if(ready()) {
+        resumeLater(step);
+        return;
+    }
+
+    Clock::duration next = std::min(std::max(2 * interval, MIN_POLL_INTERVAL), max_poll_interval_);
+    if(handle->delayed_execution_requested.isConnected()) {
+        AsyncProcessPtr self = shared_from_this();
+        handle->delayed_execution_requested([self, ready, step, next]() {
+            if(!self->finished_) {
+                self->poll(ready, step, next);
+            }
+        }, Clock::now() + next);
+
+    } else {
+        // without a scheduler, the calling thread has to wait
+        while(!ready()) {
+            std::this_thread::sleep_for(next);
+            next = std::min(2 * next, max_poll_interval_);
+        }
+        resume(step);
+    }
+}
@@ -30,7 +30,11 @@ Connection::Connection(OutputPtr from, InputPtr to, int id)
     : from_(from), to_(to), id_(id),
       active_(false),
       detached_(false),
-      state_(State::NOT_INITIALIZED)
+      state_(State::NOT_INITIALIZED),
+      overflow_policy_(OverflowPolicy::BLOCK),
+      dropped_(0),
+      transfers_(0),
+      cross_node_transfers_(0)
 {
     from->enabled_changed.connect(source_enable_changed);
     to->enabled_changed.connect(sink_enabled_changed);
@@ -73,6 +77,10 @@ void Connection::reset()
     std::unique_lock<std::recursive_mutex> lock(sync);
     state_ = Connection::State::NOT_INITIALIZED;
     message_.reset();
+    latest_.reset();
+    dropped_ = 0;
+    transfers_ = 0;
+    cross_node_transfers_ = 0;
 }
 
 TokenPtr Connection::getToken() const
@@ -96,29 +104,65 @@ bool Connection::holdsActiveToken() const
 
 void Connection::setTokenProcessed()
 {
+    bool has_next = false;
+    bool blocking = true;
     {
         std::unique_lock<std::recursive_mutex> lock(sync);
         setState(State::DONE);
+
+        if(latest_) {
+            message_ = latest_;
+            latest_.reset();
+            setState(State::UNREAD);
+            has_next = true;
+        }
+        blocking = overflow_policy_ == OverflowPolicy::BLOCK;
+    }
+
+    if(has_next) {
+        notifyMessageSet();
     }
 
     //TRACE std::cout << *this << " is done" << std::endl;
-    notifyMessageProcessed();
+    if(blocking) {
+        notifyMessageProcessed();
+    }
 }
 
 void Connection::setToken(const TokenPtr &token)
 {
     {
-        TokenPtr msg = token->clone();
+        // the payload is immutable and thus shared between all connections,
+        // only the per-connection meta data (activity, sequence number) is copied.
+        // consumers that need a mutable message have to use msg::getClonedMessage
+        TokenPtr msg = token->cloneShallow();
 
         std::unique_lock<std::recursive_mutex> lock(sync);
         apex_assert_hard(msg != nullptr);
-        apex_assert_hard(state_ == State::NOT_INITIALIZED);
 
         if(!isActive() && msg->hasActivityModifier()) {
             // remove active flag if the connection is inactive
             msg->setActivityModifier(ActivityModifier::NONE);
         }
 
+        if(state_ != State::NOT_INITIALIZED) {
+            // a single slot is full, both non-blocking policies keep the newest token
+            apex_assert_hard(overflow_policy_ != OverflowPolicy::BLOCK);
+            if(state_ == State::UNREAD) {
+                // the input has not read the old token yet
+                message_ = msg;
+                ++dropped_;
+
+            } else {
+                // the input is processing, the newest token is presented afterwards
+                if(latest_) {
+                    ++dropped_;
+                }
+                latest_ = msg;
+            }
+            return;
+        }
+
         message_ = msg;
         setState(State::UNREAD);
     }
@@ -178,6 +222,89 @@ Connection::State Connection::getState() const
     return state_;
 }
 
+Connection::State Connection::getSourceState() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    if(overflow_policy_ != OverflowPolicy::BLOCK) {
+        return State::DONE;
+    }
+    return state_;
+}
+
+std::size_t Connection::getCapacity() const
+{
+    return 1;
+}
+
+std::size_t Connection::getOccupancy() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return (state_ == State::NOT_INITIALIZED ? 0 : 1) + (latest_ ? 1 : 0);
+}
+
+void Connection::setOverflowPolicy(OverflowPolicy policy)
+{
+    bool release_source = false;
+    {
+        std::unique_lock<std::recursive_mutex> lock(sync);
+        // an output waiting for this connection is only notified as long as the policy is BLOCK
+        if(overflow_policy_ == OverflowPolicy::BLOCK && policy != OverflowPolicy::BLOCK) {
+            State source_state = getSourceState();
+            release_source = source_state != State::DONE && source_state != State::NOT_INITIALIZED;
+        }
+        overflow_policy_ = policy;
+    }
+
+    if(release_source) {
+        notifyMessageProcessed();
+    }
+}
+
+Connection::OverflowPolicy Connection::getOverflowPolicy() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return overflow_policy_;
+}
+
+long Connection::getDroppedCount() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return dropped_;
+}
+
+void Connection::recordTransfer(int numa_node)
+{
+    if(numa_node < 0) {
+        return;
+    }
+
+    int source_node = -1;
+    {
+        std::unique_lock<std::recursive_mutex> lock(sync);
+        if(!message_) {
+            return;
+        }
+        source_node = message_->getNumaNode();
+    }
+
+    if(source_node >= 0) {
+        ++transfers_;
+        if(source_node != numa_node) {
+            ++cross_node_transfers_;
+        }
+    }
+}
+
+long Connection::getTransferCount() const
+{
+    return transfers_;
+}
+
+long Connection::getCrossNodeTransferCount() const
+{
+    return cross_node_transfers_;
+}
+
 void Connection::setState(State s)
 {
     std::unique_lock<std::recursive_mutex> lock(sync);
@@ -0,0 +1,488 @@
+/// HEADER
+#include <csapex/model/execution_plan.h>
+
+/// PROJECT
+#include <csapex/model/graph/graph_local.h>
+#include <csapex/model/graph/vertex.h>
+#include <csapex/model/node_facade.h>
+#include <csapex/model/node_handle.h>
+#include <csapex/model/node_worker.h>
+#include <csapex/model/node_runner.h>
+#include <csapex/model/node_state.h>
+#include <csapex/model/node.h>
+#include <csapex/model/connection.h>
+#include <csapex/model/token.h>
+#include <csapex/msg/input.h>
+#include <csapex/msg/output.h>
+#include <csapex/signal/event.h>
+#include <csapex/signal/slot.h>
+#include <csapex/msg/io.h>
+#include <csapex/msg/no_message.h>
+#include <csapex/scheduling/thread_pool.h>
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/scheduling/task.h>
+
+/// SYSTEM
+#include <map>
+#include <deque>
+#include <limits>
+
+using namespace csapex;
+
+const std::size_t ExecutionPlan::NO_SLOT = std::numeric_limits<std::size_t>::max();
+
+namespace
+{
+ThreadGroupPtr groupFor(ThreadPool& thread_pool, TaskGenerator* generator)
+{
+    try {
+        if(ThreadGroup* group = thread_pool.getGroupFor(generator)) {
+            return group->shared_from_this();
+        }
+    } catch(const std::runtime_error&) {
+        // the generator is not assigned to any group
+    }
+    return nullptr;
+}
+}
+
+ExecutionPlan::Component::Component()
+    : no_message(Token::makeShared<connection_types::NoMessage>()),
+      iterations(0), running(false)
+{
+}
+
+ExecutionPlan::ExecutionPlan(GraphLocal& graph)
+    : thread_pool_(nullptr), running_(false), valid_(true)
+{
+    compile(graph);
+
+    // the steps refer to nodes and connectors of the graph, they must not outlive a change
+    observe(graph.vertex_added, [this](graph::VertexPtr) {
+        invalidate();
+    });
+    observe(graph.vertex_removed, [this](graph::VertexPtr) {
+        invalidate();
+    });
+    observe(graph.connection_added, [this](Connection*) {
+        invalidate();
+    });
+    observe(graph.connection_removed, [this](Connection*) {
+        invalidate();
+    });
+}
+
+ExecutionPlan::~ExecutionPlan()
+{
+    stopObserving();
+    stop();
+}
+
+void ExecutionPlan::invalidate()
+{
+    if(!valid_.exchange(false)) {
+        return;
+    }
+
+    stop();
+    invalidated();
+}
+
+bool ExecutionPlan::isValid() const
+{
+    return valid_;
+}
+
+void ExecutionPlan::compile(GraphLocal& graph)
+{
+    std::map<NodeHandle*, graph::Vertex*> vertices;
+    for(auto it = graph.begin(); it != graph.end(); ++it) {
+        const graph::VertexPtr& vertex = *it;
+        NodeFacadePtr facade = vertex->getNodeFacade();
+        NodeHandlePtr nh = facade->getNodeHandle();
+        if(!nh) {
+            throw std::runtime_error(std::string("cannot compile remote node ") + facade->getUUID().getFullName());
+        }
+        if(facade->isGraph()) {
+            throw std::runtime_error(std::string("cannot compile subgraph ") + facade->getUUID().getFullName());
+        }
+        NodePtr node = nh->getNode().lock();
+        if(!node || node->isAsynchronous()) {
+            throw std::runtime_error(std::string("cannot compile asynchronous node ") + facade->getUUID().getFullName());
+        }
+        for(const EventPtr& event : nh->getExternalEvents()) {
+            if(event->isConnected()) {
+                throw std::runtime_error(std::string("cannot compile event connection of ") + event->getUUID().getFullName());
+            }
+        }
+        for(const SlotPtr& slot : nh->getExternalSlots()) {
+            if(slot->isConnected()) {
+                throw std::runtime_error(std::string("cannot compile slot connection of ") + slot->getUUID().getFullName());
+            }
+        }
+        vertices[nh.get()] = vertex.get();
+    }
+
+    // order the nodes of each component topologically, following the message connections
+    std::map<NodeHandle*, int> in_degree;
+    std::map<NodeHandle*, std::vector<NodeHandle*>> children;
+    for(const auto& pair : vertices) {
+        NodeHandle* nh = pair.first;
+        in_degree[nh];
+
+        for(const InputPtr& input : nh->getExternalInputs()) {
+            std::vector<ConnectionPtr> connections = input->getConnections();
+            if(connections.empty()) {
+                if(!input->isOptional()) {
+                    throw std::runtime_error(std::string("mandatory input ") + input->getUUID().getFullName() + " is not connected");
+                }
+                continue;
+            }
+
+            for(const ConnectionPtr& connection : connections) {
+                OutputPtr output = connection->from();
+                NodeHandle* parent = graph.findNodeHandleForConnectorNoThrow(output->getUUID());
+                if(!parent || vertices.find(parent) == vertices.end()) {
+                    throw std::runtime_error(std::string("input ") + input->getUUID().getFullName() + " is connected outside of the graph");
+                }
+                children[parent].push_back(nh);
+                ++in_degree[nh];
+            }
+        }
+    }
+
+    std::vector<NodeHandle*> order;
+    std::deque<NodeHandle*> Q;
+    for(const auto& pair : in_degree) {
+        if(pair.second == 0) {
+            Q.push_back(pair.first);
+        }
+    }
+    while(!Q.empty()) {
+        NodeHandle* top = Q.front();
+        Q.pop_front();
+        order.push_back(top);
+
+        for(NodeHandle* child : children[top]) {
+            if(--in_degree[child] == 0) {
+                Q.push_back(child);
+            }
+        }
+    }
+    if(order.size() != vertices.size()) {
+        throw std::runtime_error("cannot compile a graph with cycles");
+    }
+
+    // weakly connected components, numbered in the order of their first node
+    std::map<NodeHandle*, std::vector<NodeHandle*>> neighbours;
+    for(const auto& pair : children) {
+        for(NodeHandle* child : pair.second) {
+            neighbours[pair.first].push_back(child);
+            neighbours[child].push_back(pair.first);
+        }
+    }
+    std::map<NodeHandle*, std::size_t> component_of;
+    for(NodeHandle* nh : order) {
+        if(component_of.find(nh) != component_of.end()) {
+            continue;
+        }
+        std::size_t c = components_.size();
+        components_.push_back(std::make_shared<Component>());
+
+        component_of[nh] = c;
+        Q.push_back(nh);
+        while(!Q.empty()) {
+            NodeHandle* top = Q.front();
+            Q.pop_front();
+            for(NodeHandle* next : neighbours[top]) {
+                if(component_of.insert(std::make_pair(next, c)).second) {
+                    Q.push_back(next);
+                }
+            }
+        }
+    }
+
+    // every output gets a register in its component, inputs read from the register of their source
+    std::map<Output*, std::size_t> slots;
+
+    for(NodeHandle* nh : order) {
+        graph::Vertex* vertex = vertices[nh];
+        Component& component = *components_[component_of[nh]];
+
+        NodeFacadePtr facade = vertex->getNodeFacade();
+
+        Step step;
+        step.node_handle = nh;
+        step.worker = facade->getNodeWorker().get();
+        step.node = nh->getNode().lock();
+        step.runner = facade->getNodeRunner();
+
+        for(const InputPtr& input : nh->getExternalInputs()) {
+            Binding binding;
+            binding.input = input.get();
+            binding.slot = NO_SLOT;
+            for(const ConnectionPtr& connection : input->getConnections()) {
+                // parents are ordered first, so their outputs already have a register
+                binding.slot = slots.at(connection->from().get());
+            }
+            step.inputs.push_back(binding);
+        }
+
+        for(const OutputPtr& output : nh->getExternalOutputs()) {
+            std::size_t slot = component.registers.size();
+            component.registers.push_back(component.no_message);
+            slots[output.get()] = slot;
+            step.outputs.push_back(std::make_pair(output.get(), slot));
+        }
+
+        // the fastest allowed source determines the pace of the component
+        if(nh->isSource()) {
+            double f = nh->getNodeState()->getMaximumFrequency();
+            if(f > 0.0 && (component.rate.getFrequency() <= 0.0 || f < component.rate.getFrequency())) {
+                component.rate.setFrequency(f);
+            }
+        }
+
+        component.steps.push_back(step);
+    }
+}
+
+std::size_t ExecutionPlan::getComponentCount() const
+{
+    return components_.size();
+}
+
+std::vector<UUID> ExecutionPlan::getSchedule(std::size_t component) const
+{
+    std::vector<UUID> schedule;
+    for(const Step& step : components_.at(component)->steps) {
+        schedule.push_back(step.node_handle->getUUID());
+    }
+    return schedule;
+}
+
+void ExecutionPlan::iterate(std::size_t component)
+{
+    if(!valid_) {
+        throw std::runtime_error("the graph has changed since it was compiled");
+    }
+    components_.at(component)->iterate();
+}
+
+long ExecutionPlan::getIterations(std::size_t component) const
+{
+    return components_.at(component)->iterations;
+}
+
+void ExecutionPlan::Component::iterate()
+{
+    std::unique_lock<std::mutex> lock(execution_mtx);
+    executeSteps();
+}
+
+bool ExecutionPlan::Component::iterateIfRunning()
+{
+    // running is checked under the lock, stop() relies on no iteration starting after it has taken the lock
+    std::unique_lock<std::mutex> lock(execution_mtx);
+    if(!running) {
+        return false;
+    }
+
+    rate.startCycle();
+    executeSteps();
+    return true;
+}
+
+void ExecutionPlan::Component::executeSteps()
+{
+    long sequence_number = iterations;
+    for(Step& step : steps) {
+        execute(step, sequence_number);
+    }
+    ++iterations;
+}
+
+void ExecutionPlan::Component::execute(Step& step, long sequence_number)
+{
+    NodeHandle* nh = step.node_handle;
+
+    bool all_inputs_are_present = true;
+    TokenPtr marker;
+
+    for(const Binding& binding : step.inputs) {
+        if(binding.slot == NO_SLOT) {
+            binding.input->free();
+            continue;
+        }
+
+        const TokenPtr& token = registers[binding.slot];
+        binding.input->setToken(token);
+
+        if(!binding.input->isOptional() && !msg::hasMessage(binding.input)) {
+            all_inputs_are_present = false;
+        }
+        if(std::dynamic_pointer_cast<connection_types::MarkerMessage const>(token->getTokenData()) &&
+                !std::dynamic_pointer_cast<connection_types::NoMessage const>(token->getTokenData())) {
+            marker = token;
+        }
+    }
+
+    bool change = false;
+    for(auto pair : nh->paramToInputMap()) {
+        InputPtr cin = pair.second.lock();
+        if(cin && msg::hasMessage(cin.get())) {
+            nh->updateParameterValue(cin.get());
+            change = true;
+        }
+    }
+    if(change) {
+        step.worker->checkParameters();
+    }
+
+    if(marker) {
+        // markers are passed through the graph without processing
+        auto m = std::dynamic_pointer_cast<connection_types::MarkerMessage const>(marker->getTokenData());
+        step.node->processMarker(m);
+        for(const auto& output : step.outputs) {
+            output.first->clearBuffer();
+            registers[output.second] = marker;
+        }
+        return;
+    }
+
+    if(all_inputs_are_present && step.worker->isProcessingEnabled() && step.node->canProcess()) {
+        try {
+            step.node->process(*nh, *step.node);
+        } catch(const std::exception& e) {
+            step.worker->triggerError(true, e.what());
+        }
+    }
+
+    for(const auto& output : step.outputs) {
+        TokenPtr token = output.first->getAddedToken();
+        if(token) {
+            output.first->clearBuffer();
+            token->setSequenceNumber(sequence_number);
+            registers[output.second] = token;
+        } else {
+            registers[output.second] = no_message;
+        }
+    }
+}
+
+void ExecutionPlan::Component::scheduleNextIteration()
+{
+    if(!running) {
+        return;
+    }
+
+    if(rate.getFrequency() > 0.0) {
+        getGroup()->scheduleDelayed(task, rate.endOfCycle());
+    } else {
+        getGroup()->schedule(task);
+    }
+}
+
+ThreadGroupPtr ExecutionPlan::Component::getGroup() const
+{
+    if(ThreadGroupPtr g = group.lock()) {
+        return g;
+    }
+    return default_group;
+}
+
+void ExecutionPlan::start(ThreadPool& thread_pool)
+{
+    if(running_) {
+        return;
+    }
+    if(!valid_) {
+        throw std::runtime_error("the graph has changed since it was compiled");
+    }
+    running_ = true;
+
+    thread_pool_ = &thread_pool;
+    ThreadGroupPtr default_group = thread_pool.getDefaultGroup()->shared_from_this();
+
+    for(const ComponentPtr& component : components_) {
+        component->default_group = default_group;
+        ThreadGroupPtr component_group;
+
+        for(Step& step : component->steps) {
+            if(!step.runner) {
+                continue;
+            }
+
+            ThreadGroupPtr group = groupFor(thread_pool, step.runner.get());
+            if(!group) {
+                group = default_group;
+            }
+
+            Detached detached;
+            detached.runner = step.runner;
+            detached.group = group;
+            detached_.push_back(detached);
+
+            // the runner keeps its tasks until it is reattached, a task currently executed has to finish first
+            step.runner->detach();
+            step.runner->lockExecution();
+
+            if(!component_group) {
+                component_group = group;
+            }
+        }
+        component->group = component_group ? component_group : default_group;
+
+        std::weak_ptr<Component> weak_component = component;
+        component->task = std::make_shared<Task>("compiled component", [weak_component]() {
+            if(ComponentPtr c = weak_component.lock()) {
+                if(c->iterateIfRunning()) {
+                    c->scheduleNextIteration();
+                }
+            }
+        });
+
+        component->running = true;
+        component->getGroup()->schedule(component->task);
+    }
+}
+
+void ExecutionPlan::stop()
+{
+    if(!running_) {
+        return;
+    }
+    running_ = false;
+
+    for(const ComponentPtr& component : components_) {
+        // no iteration starts after this, the one in progress is drained before the runners take over again
+        std::unique_lock<std::mutex> lock(component->execution_mtx);
+        component->running = false;
+    }
+
+    for(const Detached& detached : detached_) {
+        std::vector<TaskPtr> held_back = detached.runner->unlockExecution();
+
+        ThreadGroupPtr group = detached.group.lock();
+        if(group && groupFor(*thread_pool_, detached.runner.get()) == group) {
+            detached.runner->assignToScheduler(group.get());
+        } else {
+            // the group has been deleted in the meantime, like its other nodes the runner moves to the default group
+            thread_pool_->useDefaultThreadFor(detached.runner.get());
+            group = thread_pool_->getDefaultGroup()->shared_from_this();
+        }
+
+        for(const TaskPtr& task : held_back) {
+            // held back tasks have been taken from the queue, but are still marked as scheduled
+            task->setScheduled(false);
+            group->schedule(task);
+        }
+    }
+    detached_.clear();
+    thread_pool_ = nullptr;
+}
+
+bool ExecutionPlan::isRunning() const
+{
+    return running_;
+}
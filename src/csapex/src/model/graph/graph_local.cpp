@@ -18,6 +18,7 @@
 #include <csapex/model/graph/edge.h>
 #include <csapex/model/node.h>
 #include <csapex/model/subgraph_node.h>
+#include <csapex/profiling/profiler.h>
 
 using namespace csapex;
 
@@ -83,12 +84,15 @@ void GraphLocal::addNode(NodeFacadePtr nf)
     apex_assert_hard_msg(nf->getNodeRunner(), "NodeRunner added is not null");
     apex_assert_hard_msg(nf->getNodeWorker(), "NodeWorker added is not null");
     graph::VertexPtr vertex = std::make_shared<graph::Vertex>(nf);
-    vertices_.push_back(vertex);
+    {
+        std::unique_lock<std::recursive_mutex> lock(structure_mutex_);
+        vertices_.push_back(vertex);
 
-    nf->getNodeHandle()->setVertex(vertex);
+        nf->getNodeHandle()->setVertex(vertex);
 
-    sources_.insert(vertex);
-    sinks_.insert(vertex);
+        sources_.insert(vertex);
+        sinks_.insert(vertex);
+    }
 
     vertex_added(vertex);
     if(!in_transaction_) {
@@ -110,6 +114,7 @@ void GraphLocal::deleteNode(const UUID& uuid)
 
     graph::VertexPtr removed;
 
+    std::unique_lock<std::recursive_mutex> lock(structure_mutex_);
     for(auto it = vertices_.begin(); it != vertices_.end();) {
         NodeFacadePtr node = (*it)->getNodeFacade();
         if(node->getUUID() == uuid) {
@@ -138,6 +143,7 @@ void GraphLocal::deleteNode(const UUID& uuid)
     for(const graph::VertexPtr& remaining : vertices_) {
         apex_assert_neq(remaining, removed);
     }
+    lock.unlock();
 
     //        if(NodePtr node = removed->getNode().lock()) {
     //            if(GraphPtr child = std::dynamic_pointer_cast<Graph>(node)) {
@@ -179,6 +185,7 @@ bool GraphLocal::addConnection(ConnectionPtr connection)
             graph::VertexPtr v_to = n_to->getVertex();
 
             if(v_from && v_to) {
+                std::unique_lock<std::recursive_mutex> lock(structure_mutex_);
                 v_from->addChild(v_to);
                 v_to->addParent(v_from);
 
@@ -217,6 +224,8 @@ void GraphLocal::deleteConnection(ConnectionPtr connection)
 
     for(std::vector<ConnectionPtr>::iterator c = edges_.begin(); c != edges_.end();) {
         if(*connection == **c) {
+            std::unique_lock<std::recursive_mutex> lock(structure_mutex_);
+
             ConnectablePtr to = connection->to();
             to->setError(false);
 
@@ -274,6 +283,7 @@ void GraphLocal::deleteConnection(ConnectionPtr connection)
             }
 
             edges_.erase(c);
+            lock.unlock();
 
             connection_removed(connection.get());
             if(!in_transaction_) {
@@ -312,9 +322,16 @@ void GraphLocal::analyzeGraph()
 
     calculateDepths();
 
+    calculateCriticalPaths();
+
     state_changed();
 }
 
+void GraphLocal::updateCriticalPaths()
+{
+    calculateCriticalPaths();
+}
+
 void GraphLocal::buildConnectedComponents()
 {
     /* Find all connected sub components of this graph */
@@ -578,6 +595,98 @@ void GraphLocal::calculateDepths()
     }
 }
 
+void GraphLocal::calculateCriticalPaths()
+{
+    // the critical paths are refreshed from the main loop, while graph edits can come from other threads
+    std::unique_lock<std::recursive_mutex> lock(structure_mutex_);
+
+    // every vertex is weighted with its mean processing time from the profiler history,
+    // a small constant per vertex makes unprofiled graphs prefer the paths with most vertices
+    const double hop_weight = 1e-3;
+
+    // node runners read the results concurrently, they are only published once complete
+    std::map<graph::Vertex*, double> latency;
+    std::map<graph::Vertex*, int> in_degree;
+    for(const graph::VertexPtr& vertex : vertices_) {
+        double mean = 0.0;
+        if(NodeWorkerPtr worker = vertex->getNodeFacade()->getNodeWorker()) {
+            const Profile& profile = worker->getProfiler()->getProfile(vertex->getNodeFacade()->getUUID().getFullName());
+            std::size_t samples = 0;
+            for(std::size_t i = 0, n = profile.size(); i < n; ++i) {
+                if(Interval::Ptr interval = profile.getInterval(i)) {
+                    mean += interval->lengthMs();
+                    ++samples;
+                }
+            }
+            if(samples > 0) {
+                mean /= samples;
+            }
+        }
+        latency[vertex.get()] = mean + hop_weight;
+
+        in_degree[vertex.get()] = vertex->getParents().size();
+    }
+
+    // topological order, vertices in cycles are left out
+    std::vector<graph::Vertex*> order;
+    std::deque<graph::Vertex*> Q;
+    for(const auto& pair : in_degree) {
+        if(pair.second == 0) {
+            Q.push_back(pair.first);
+        }
+    }
+    while(!Q.empty()) {
+        graph::Vertex* top = Q.front();
+        Q.pop_front();
+        order.push_back(top);
+
+        for(auto child : top->getChildren()) {
+            auto pos = in_degree.find(child.get());
+            if(pos != in_degree.end() && --pos->second == 0) {
+                Q.push_back(child.get());
+            }
+        }
+    }
+
+    // longest path from any source to the end of a vertex, and from its start to any sink
+    std::map<graph::Vertex*, double> upstream;
+    std::map<graph::Vertex*, double> downstream;
+    for(graph::Vertex* vertex : order) {
+        double longest = 0.0;
+        for(auto parent : vertex->getParents()) {
+            longest = std::max(longest, upstream[parent.get()]);
+        }
+        upstream[vertex] = longest + latency[vertex];
+    }
+    for(auto it = order.rbegin(); it != order.rend(); ++it) {
+        graph::Vertex* vertex = *it;
+        double longest = 0.0;
+        for(auto child : vertex->getChildren()) {
+            longest = std::max(longest, downstream[child.get()]);
+        }
+        downstream[vertex] = longest + latency[vertex];
+    }
+
+    std::map<graph::Vertex*, double> path_latency;
+    std::map<int, double> longest_path;
+    for(graph::Vertex* vertex : order) {
+        double path = upstream[vertex] + downstream[vertex] - latency[vertex];
+        path_latency[vertex] = path;
+
+        double& longest = longest_path[vertex->getNodeCharacteristics().component];
+        longest = std::max(longest, path);
+    }
+
+    for(const graph::VertexPtr& vertex : vertices_) {
+        NodeCharacteristics& characteristics = vertex->getNodeCharacteristics();
+        double path = path_latency[vertex.get()];
+        double longest = longest_path[characteristics.component];
+
+        characteristics.latency = latency[vertex.get()];
+        characteristics.critical_path_latency = path;
+        characteristics.criticality = longest > 0.0 ? path / longest : 0.0;
+    }
+}
 
 void GraphLocal::checkNodeState(NodeHandle *nh)
 {
@@ -3,6 +3,7 @@
 
 /// COMPONENT
 #include <csapex/model/graph.h>
+#include <csapex/model/graph/graph_local.h>
 #include <csapex/model/subgraph_node.h>
 #include <csapex/model/node.h>
 #include <csapex/model/node_handle.h>
@@ -27,7 +28,7 @@
 
 using namespace csapex;
 
-GraphFacade::GraphFacade(ThreadPool &executor, GraphPtr graph, SubgraphNodePtr graph_node, NodeFacadePtr nh, GraphFacade *parent)
+GraphFacade::GraphFacade(Executor &executor, GraphPtr graph, SubgraphNodePtr graph_node, NodeFacadePtr nh, GraphFacade *parent)
     : parent_(parent), absolute_uuid_(graph_node->getUUID()), graph_(graph), graph_node_(graph_node), graph_handle_(nh), executor_(executor)
 {
     observe(graph->vertex_added, delegate::Delegate<void(graph::VertexPtr)>(this, &GraphFacade::nodeAddedHandler));
@@ -73,8 +74,9 @@ void GraphFacade::nodeAddedHandler(graph::VertexPtr vertex)
     generators_[facade->getUUID()] = runner;
 
     int thread_id = facade->getNodeState()->getThreadId();
-    if(thread_id >= 0) {
-        executor_.addToGroup(runner.get(), thread_id);
+    ThreadPool* thread_pool = getThreadPool();
+    if(thread_id >= 0 && thread_pool) {
+        thread_pool->addToGroup(runner.get(), thread_id);
     } else {
         executor_.add(runner.get());
     }
@@ -149,11 +151,16 @@ SubgraphNodePtr GraphFacade::getSubgraphNode()
     return std::dynamic_pointer_cast<SubgraphNode>(graph_node_);
 }
 
-ThreadPool* GraphFacade::getThreadPool()
+Executor* GraphFacade::getExecutor()
 {
     return &executor_;
 }
 
+ThreadPool* GraphFacade::getThreadPool()
+{
+    return dynamic_cast<ThreadPool*>(&executor_);
+}
+
 NodeHandle* GraphFacade::getNodeHandle()
 {
     return graph_handle_->getNodeHandle().get();
@@ -513,3 +520,15 @@ void GraphFacade::resetActivity()
 
     pauseRequest(pause);
 }
+
+void GraphFacade::updateCriticalPaths()
+{
+    if(GraphLocalPtr graph = std::dynamic_pointer_cast<GraphLocal>(graph_)) {
+        graph->updateCriticalPaths();
+    }
+
+    for(auto pair: children_) {
+        GraphFacadePtr child = pair.second;
+        child->updateCriticalPaths();
+    }
+}
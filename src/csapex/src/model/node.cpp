@@ -85,6 +85,10 @@ bool Node::isAsynchronous() const
 {
     return false;
 }
+bool Node::isReentrant() const
+{
+    return false;
+}
 bool Node::isIsolated() const
 {
     return false;
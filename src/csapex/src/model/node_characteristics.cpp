@@ -13,7 +13,39 @@ NodeCharacteristics::NodeCharacteristics()
       is_combined_by_joining_vertex(false),
       is_leading_to_joining_vertex(false),
 
-      is_leading_to_essential_vertex(false)
+      is_leading_to_essential_vertex(false),
+
+      latency(0.0),
+      critical_path_latency(0.0),
+      criticality(0.0)
+{
+
+}
+
+NodeCharacteristics::NodeCharacteristics(const NodeCharacteristics& other)
+    : latency(0.0),
+      critical_path_latency(0.0),
+      criticality(0.0)
 {
+    *this = other;
+}
+
+NodeCharacteristics& NodeCharacteristics::operator = (const NodeCharacteristics& other)
+{
+    depth = other.depth;
+    component = other.component;
+
+    is_vertex_separator = other.is_vertex_separator;
+    is_joining_vertex = other.is_joining_vertex;
+    is_joining_vertex_counterpart = other.is_joining_vertex_counterpart;
+    is_combined_by_joining_vertex = other.is_combined_by_joining_vertex;
+    is_leading_to_joining_vertex = other.is_leading_to_joining_vertex;
+
+    is_leading_to_essential_vertex = other.is_leading_to_essential_vertex;
+
+    latency = other.latency.load();
+    critical_path_latency = other.critical_path_latency.load();
+    criticality = other.criticality.load();
 
+    return *this;
 }
@@ -4,6 +4,7 @@
 /// PROJECT
 #include <csapex/model/node_handle.h>
 #include <csapex/model/node_worker.h>
+#include <csapex/model/node_runner.h>
 #include <csapex/model/node_state.h>
 #include <csapex/msg/input_transition.h>
 #include <csapex/msg/output_transition.h>
@@ -281,6 +282,16 @@ double NodeFacadeLocal::getMaximumFrequency() const
     return nh_->getNodeState()->getMaximumFrequency();
 }
 
+double NodeFacadeLocal::getDeadline() const
+{
+    return nh_->getNodeState()->getDeadline();
+}
+
+long NodeFacadeLocal::getDeadlineMisses() const
+{
+    return nr_ ? nr_->getDeadlineMisses() : 0;
+}
+
 NodeHandlePtr NodeFacadeLocal::getNodeHandle() const
 {
     return nh_;
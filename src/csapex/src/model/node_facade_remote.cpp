@@ -4,6 +4,7 @@
 /// PROJECT
 #include <csapex/model/node_handle.h>
 #include <csapex/model/node_worker.h>
+#include <csapex/model/node_runner.h>
 #include <csapex/model/node_state.h>
 #include <csapex/msg/input_transition.h>
 #include <csapex/msg/output_transition.h>
@@ -277,6 +278,16 @@ double NodeFacadeRemote::getMaximumFrequency() const
     return nh_->getNodeState()->getMaximumFrequency();
 }
 
+double NodeFacadeRemote::getDeadline() const
+{
+    return nh_->getNodeState()->getDeadline();
+}
+
+long NodeFacadeRemote::getDeadlineMisses() const
+{
+    return nr_ ? nr_->getDeadlineMisses() : 0;
+}
+
 NodeHandlePtr NodeFacadeRemote::getNodeHandle() const
 {
     return nh_;
@@ -6,7 +6,10 @@
 #include <csapex/model/node_worker.h>
 #include <csapex/model/node.h>
 #include <csapex/scheduling/scheduler.h>
+#include <csapex/scheduling/fused_chain.h>
 #include <csapex/scheduling/task.h>
+#include <csapex/scheduling/task_queue.h>
+#include <csapex/model/graph/vertex.h>
 #include <csapex/utility/assert.h>
 #include <csapex/model/node_state.h>
 #include <csapex/utility/thread.h>
@@ -15,6 +18,7 @@
 /// SYSTEM
 #include <memory>
 #include <iostream>
+#include <cmath>
 
 using namespace csapex;
 
@@ -22,8 +26,12 @@ NodeRunner::NodeRunner(NodeWorkerPtr worker)
     : worker_(worker), scheduler_(nullptr),
       paused_(false), stepping_(false), can_step_(0), step_done_(false),
       guard_(-1),
+      critical_path_scheduling_(false),
       waiting_for_execution_(false),
-      waiting_for_step_(false)
+      waiting_for_step_(false),
+      deadline_(0.0),
+      released_(false),
+      deadline_misses_(0)
 {
     NodeHandlePtr handle = worker_->getNodeHandle();
 
@@ -40,6 +48,11 @@ NodeRunner::NodeRunner(NodeWorkerPtr worker)
     max_frequency_ = handle->getNodeState()->getMaximumFrequency();
     handle->getRate().setFrequency(max_frequency_);
 
+    handle->getNodeState()->deadline_changed->connect([this](){
+        deadline_ = worker_->getNodeHandle()->getNodeState()->getDeadline();
+    });
+    deadline_ = handle->getNodeState()->getDeadline();
+
     check_parameters_ = std::make_shared<Task>(std::string("check parameters for ") + handle->getUUID().getFullName(),
                                                std::bind(&NodeWorker::checkParameters, worker),
                                                0,
@@ -47,7 +60,14 @@ NodeRunner::NodeRunner(NodeWorkerPtr worker)
     execute_ = std::make_shared<Task>(std::string("check ") + handle->getUUID().getFullName(),
                                       [this]()
     {
-        execute();
+        FusedChainPtr chain = std::atomic_load(&fused_chain_);
+        if(chain) {
+            chain->run(this, [this]() {
+                execute();
+            });
+        } else {
+            execute();
+        }
     }, 0, this);
 }
 
@@ -104,6 +124,7 @@ void NodeRunner::assignToScheduler(Scheduler *scheduler)
 
     observe(worker_->messages_processed, [this](){
         measureFrequency();
+        checkDeadline();
         step_done_ = true;
         //TRACE worker_->getNode()->ainfo << "end step" << std::endl;
         end_step();
@@ -128,6 +149,15 @@ void NodeRunner::assignToScheduler(Scheduler *scheduler)
     observe(worker_->getNodeHandle()->execution_requested, [this](std::function<void()> cb) {
         schedule(std::make_shared<Task>("anonymous", cb, 0, this));
     });
+
+    // invocations of reentrant nodes have no parent, so that the thread group can run them in parallel
+    observe(worker_->getNodeHandle()->concurrent_execution_requested, [this](std::function<void()> cb) {
+        schedule(std::make_shared<Task>("invocation", cb, 0, nullptr));
+    });
+
+    observe(worker_->getNodeHandle()->delayed_execution_requested, [this](std::function<void()> cb, std::chrono::steady_clock::time_point time) {
+        scheduleDelayed(std::make_shared<Task>("delayed", cb, 0, this), time);
+    });
 }
 
 
@@ -145,13 +175,64 @@ void NodeRunner::scheduleProcess()
             //execute_->setPriority(std::max<long>(0, worker_->getSequenceNumber()));
             //if(worker_->canExecute()) {
                 if(!waiting_for_execution_) {
-                    schedule(execute_);
+                    if(critical_path_scheduling_) {
+                        execute_->setPriority(getCriticalPathPriority());
+                    }
+                    if(!execute_->isScheduled()) {
+                        // the deadline is relative to the time the node becomes ready
+                        scheduled_at_ = std::chrono::steady_clock::now();
+                        double deadline = deadline_;
+                        if(deadline > 0.0) {
+                            execute_->setDeadline(scheduled_at_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(deadline)));
+                        } else {
+                            execute_->clearDeadline();
+                        }
+                    }
+                    FusedChainPtr chain = std::atomic_load(&fused_chain_);
+                    if(!chain || !chain->defer(this, execute_)) {
+                        schedule(execute_);
+                    }
                 }
             //}
         }
     }
 }
 
+void NodeRunner::setCriticalPathScheduling(bool enabled)
+{
+    critical_path_scheduling_ = enabled;
+    if(!enabled) {
+        execute_->setPriority(0);
+    }
+}
+
+bool NodeRunner::isCriticalPathScheduling() const
+{
+    return critical_path_scheduling_;
+}
+
+void NodeRunner::setFusedChain(FusedChainPtr chain)
+{
+    std::atomic_store(&fused_chain_, chain);
+}
+
+FusedChainPtr NodeRunner::getFusedChain() const
+{
+    return std::atomic_load(&fused_chain_);
+}
+
+long NodeRunner::getCriticalPathPriority() const
+{
+    graph::VertexPtr vertex = worker_->getNodeHandle()->getVertex();
+    if(!vertex) {
+        return 0;
+    }
+
+    // nodes on the critical path get the highest priority, the others are scaled down to the default
+    double criticality = vertex->getNodeCharacteristics().criticality;
+    return static_cast<long>(std::floor(criticality * TaskQueue::MAX_PRIORITY + 1e-6));
+}
+
 void NodeRunner::execute()
 {
     if(stepping_ && can_step_ <= 0) {
@@ -166,9 +247,11 @@ void NodeRunner::execute()
             if(f > max_frequency_) {
                 auto next_process = rate.endOfCycle();
 
-                auto now = std::chrono::system_clock::now();
+                auto now = std::chrono::steady_clock::now();
 
                 if(next_process > now) {
+                    // throttling is intended, the deadline starts with the next cycle
+                    scheduled_at_ = next_process;
                     scheduleDelayed(execute_, next_process);
                     waiting_for_execution_ = true;
                     return;
@@ -185,9 +268,13 @@ void NodeRunner::execute()
         }
         can_step_--;
 
+        released_at_ = scheduled_at_;
+        released_ = true;
+
         if(!worker_->execute()) {
             //TRACE worker_->getNode()->ainfo << "execute failed" << std::endl;
             can_step_++;
+            released_ = false;
         }
     } else {
         can_step_++;
@@ -195,6 +282,32 @@ void NodeRunner::execute()
     }
 }
 
+void NodeRunner::checkDeadline()
+{
+    if(!released_) {
+        return;
+    }
+    released_ = false;
+
+    double deadline = deadline_;
+    if(deadline > 0.0) {
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - released_at_;
+        if(duration.count() > deadline) {
+            ++deadline_misses_;
+        }
+    }
+}
+
+long NodeRunner::getDeadlineMisses() const
+{
+    return deadline_misses_;
+}
+
+void NodeRunner::resetDeadlineMisses()
+{
+    deadline_misses_ = 0;
+}
+
 void NodeRunner::schedule(TaskPtr task)
 {
     std::unique_lock<std::recursive_mutex> lock(mutex_);
@@ -208,7 +321,7 @@ void NodeRunner::schedule(TaskPtr task)
     }
 }
 
-void NodeRunner::scheduleDelayed(TaskPtr task, std::chrono::system_clock::time_point time)
+void NodeRunner::scheduleDelayed(TaskPtr task, std::chrono::steady_clock::time_point time)
 {
     std::unique_lock<std::recursive_mutex> lock(mutex_);
     scheduler_->scheduleDelayed(task, time);
@@ -14,6 +14,7 @@ using namespace csapex;
 
 NodeState::NodeState(const NodeHandle *parent)
     : max_frequency_changed(new SignalImpl),
+      deadline_changed(new SignalImpl),
       pos_changed(new SignalImpl),
       z_changed(new SignalImpl),
       color_changed(new SignalImpl),
@@ -29,7 +30,7 @@ NodeState::NodeState(const NodeHandle *parent)
       parent_changed(new SignalImpl),
       parent_(parent),
 
-      max_frequency_(0.0), z_(0), minimized_(false), muted_(false), enabled_(true), active_(false), flipped_(false),
+      max_frequency_(0.0), deadline_(0.0), z_(0), minimized_(false), muted_(false), enabled_(true), active_(false), flipped_(false),
       logger_level_(1), thread_id_(-1),
       r_(-1), g_(-1), b_(-1), exec_mode_(ExecutionMode::SEQUENTIAL)
 {
@@ -46,6 +47,7 @@ NodeState& NodeState::operator = (const NodeState& rhs)
 {
     // first change all values
     max_frequency_ = rhs.max_frequency_;
+    deadline_ = rhs.deadline_;
     pos_ = rhs.pos_;
     enabled_ = rhs.enabled_;
     active_ = rhs.active_;
@@ -66,6 +68,7 @@ NodeState& NodeState::operator = (const NodeState& rhs)
 
     // then trigger the signals
     (*max_frequency_changed)();
+    (*deadline_changed)();
     (*pos_changed)();
     (*enabled_changed)();
     (*active_changed)();
@@ -95,6 +98,19 @@ double NodeState::getMaximumFrequency() const
     return max_frequency_;
 }
 
+void NodeState::setDeadline(double seconds)
+{
+    if(deadline_ != seconds) {
+        deadline_ = seconds;
+        (*deadline_changed)();
+    }
+}
+
+double NodeState::getDeadline() const
+{
+    return deadline_;
+}
+
 Point NodeState::getPos() const
 {
     return pos_;
@@ -295,6 +311,9 @@ void NodeState::writeYaml(YAML::Node &out) const
         out["uuid"] = parent_->getUUID().getFullName();
     }
     out["max_frequency"] = max_frequency_;
+    if(deadline_ > 0.0) {
+        out["deadline"] = deadline_;
+    }
     out["label"] = label_;
     out["pos"][0] = pos_.x;
     out["pos"][1] = pos_.y;
@@ -368,6 +387,10 @@ void NodeState::readYaml(const YAML::Node &node)
         setMaximumFrequency(node["max_frequency"].as<double>());
     }
 
+    if(node["deadline"].IsDefined()) {
+        setDeadline(node["deadline"].as<double>());
+    }
+
     if(node["minimized"].IsDefined()) {
         setMinimized(node["minimized"].as<bool>());
     }
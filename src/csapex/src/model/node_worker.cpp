@@ -29,19 +29,65 @@
 #include <csapex/utility/exceptions.h>
 #include <csapex/profiling/profiler.h>
 #include <csapex/utility/debug.h>
+#include <csapex/msg/invocation_context.h>
+#include <csapex/model/node_runner.h>
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/utility/cpu_topology.h>
+#include <csapex/utility/numa_allocator.h>
 
 /// SYSTEM
 #include <thread>
 #include <iostream>
+#include <condition_variable>
 
 using namespace csapex;
 
+/**
+ * @brief The InvocationGuard struct keeps concurrent invocations from running after the worker is destroyed
+ */
+struct NodeWorker::InvocationGuard
+{
+    std::mutex mutex;
+    std::condition_variable done;
+    bool alive = true;
+    int running = 0;
+
+    bool enter()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if(!alive) {
+            return false;
+        }
+        ++running;
+        return true;
+    }
+
+    void leave()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        --running;
+        done.notify_all();
+    }
+
+    void close()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        alive = false;
+        done.wait(lock, [this]() { return running == 0; });
+    }
+};
+
 NodeWorker::NodeWorker(NodeHandlePtr node_handle)
     : node_handle_(node_handle),
       is_setup_(false),
       state_(ExecutionState::IDLE), is_processing_(false),
       trigger_process_done_(nullptr),
-      guard_(-1)
+      guard_(-1),
+      invocation_guard_(std::make_shared<InvocationGuard>()),
+      next_ticket_(0), next_ticket_to_send_(0), generation_(0),
+      sending_invocations_(false), resend_invocations_(false),
+      pending_invocations_(0),
+      max_concurrent_invocations_(std::max(1u, std::thread::hardware_concurrency()))
 {
     node_handle->setNodeWorker(this);
 
@@ -144,6 +190,9 @@ NodeWorker::NodeWorker(NodeHandlePtr node_handle)
 
 NodeWorker::~NodeWorker()
 {
+    // running invocations need the lock to finish
+    invocation_guard_->close();
+
     std::unique_lock<std::recursive_mutex> lock(sync);
 
     destroyed();
@@ -207,7 +256,7 @@ bool NodeWorker::isIdle() const
 bool NodeWorker::isProcessing() const
 {
     std::unique_lock<std::recursive_mutex> lock(state_mutex_);
-    return is_processing_;
+    return is_processing_ || pending_invocations_ > 0;
 }
 bool NodeWorker::isFired() const
 {
@@ -244,6 +293,12 @@ void NodeWorker::setProcessingEnabled(bool e)
 
 bool NodeWorker::canProcess() const
 {
+    if(isReentrantExecution()) {
+        // results are buffered until the outputs are free, only the number of invocations is limited
+        return !is_processing_ && pending_invocations_ < max_concurrent_invocations_ &&
+                getNode()->canProcess() && canReceive();
+    }
+
     if(isProcessing()) {
         return false;
     }
@@ -337,6 +392,16 @@ void NodeWorker::reset()
     setState(ExecutionState::IDLE);
     is_processing_ = false;
 
+    {
+        std::unique_lock<std::recursive_mutex> lock(sync);
+        // invocations that are still running belong to an old generation and are discarded
+        ++generation_;
+        finished_invocations_.clear();
+        next_ticket_ = 0;
+        next_ticket_to_send_ = 0;
+        pending_invocations_ = 0;
+    }
+
     node_handle_->getOutputTransition()->reset();
     node_handle_->getInputTransition()->reset();
 
@@ -380,6 +445,8 @@ bool NodeWorker::startProcessingMessages()
 
     apex_assert_hard(node_handle_->getInputTransition()->areMessagesComplete());
 
+    recordTransfers();
+
     apex_assert_hard(node_handle_->getOutputTransition()->canStartSendingMessages());
     for(EventPtr e : node_handle_->getEvents()) {
         for(ConnectionPtr c : e->getConnections()) {
@@ -553,6 +620,7 @@ bool NodeWorker::startProcessingMessages()
             apex_assert_hard(node->getNodeHandle());
             if(sync) {
                 //TRACE node->ainfo << "process sync" << std::endl;
+                NumaAllocation::PreferredNode numa_node(getConsumerNumaNode());
                 node->process(*node_handle_, *node);
 
             } else {
@@ -736,6 +804,10 @@ void NodeWorker::outgoingMessagesProcessed()
             //            current_exec_mode_.reset();
         }
 
+        if(pending_invocations_ > 0) {
+            requestSendingFinishedInvocations();
+        }
+
         APEX_DEBUG_TRACE getNode()->ainfo << "notify, try process" << std::endl;
         triggerTryProcess();
 
@@ -756,6 +828,11 @@ void NodeWorker::updateState()
 
 bool NodeWorker::canExecute()
 {
+    if(isReentrantExecution()) {
+        // the outputs do not have to be free to start another invocation
+        return node_handle_->getInputTransition()->isEnabled() && canProcess();
+    }
+
     if(isEnabled() && canProcess()) {
         return true;
     } else {
@@ -769,11 +846,331 @@ bool NodeWorker::execute()
         return false;
     }
 
+    if(isReentrantExecution()) {
+        return startInvocation();
+    }
+
     apex_assert_hard(node_handle_->getOutputTransition()->canStartSendingMessages());
 
     return startProcessingMessages();
 }
 
+void NodeWorker::setMaxConcurrentInvocations(std::size_t max)
+{
+    max_concurrent_invocations_ = std::max<std::size_t>(1, max);
+    triggerTryProcess();
+}
+
+std::size_t NodeWorker::getMaxConcurrentInvocations() const
+{
+    return max_concurrent_invocations_;
+}
+
+bool NodeWorker::isReentrantExecution() const
+{
+    if(max_concurrent_invocations_ < 2) {
+        return false;
+    }
+    NodePtr node = getNode();
+    if(!node || !node->isReentrant() || node->isAsynchronous()) {
+        return false;
+    }
+    // connected parameter inputs update the parameters, which a running invocation would see changing
+    for(const auto& pair : node_handle_->paramToInputMap()) {
+        InputPtr cin = pair.second.lock();
+        if(cin && cin->isConnected()) {
+            return false;
+        }
+    }
+    // sequential execution waits for the successors anyway
+    return node_handle_->getNodeState()->getExecutionMode() == ExecutionMode::PIPELINING;
+}
+
+bool NodeWorker::startInvocation()
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+
+    NodePtr node = node_handle_->getNode().lock();
+    if(!node) {
+        return false;
+    }
+
+    node_handle_->getInputTransition()->forwardMessages();
+    apex_assert_hard(node_handle_->getInputTransition()->areMessagesComplete());
+    recordTransfers();
+
+    {
+        std::unique_lock<std::recursive_mutex> lock(current_exec_mode_mutex_);
+        current_exec_mode_ = getNodeHandle()->getNodeState()->getExecutionMode();
+        apex_assert_hard(current_exec_mode_);
+    }
+
+    // the invocation works on a snapshot of the inputs, so that the next messages can be received right away
+    InvocationContextPtr context = std::make_shared<InvocationContext>(next_ticket_++);
+    long generation = generation_;
+    ++pending_invocations_;
+
+    for(InputPtr cin : node_handle_->getExternalInputs()) {
+        context->addInput(cin.get(), cin->getToken());
+    }
+    for(OutputPtr out : node_handle_->getExternalOutputs()) {
+        context->addOutput(out.get());
+    }
+
+    std::vector<ActivityModifier> activity_modifiers;
+    for(auto input : node_handle_->getExternalInputs()) {
+        for(const ConnectionPtr& c : input->getConnections()) {
+            if(c->holdsActiveToken()) {
+                activity_modifiers.push_back(c->getToken()->getActivityModifier());
+            }
+        }
+    }
+
+    bool all_inputs_are_present = true;
+    connection_types::MarkerMessageConstPtr marker;
+
+    for(InputPtr cin : node_handle_->getExternalInputs()) {
+        if(!cin->isOptional() && !msg::hasMessage(cin.get())) {
+            all_inputs_are_present = false;
+        }
+
+        if(cin->hasReceived()) {
+            if(auto m = std::dynamic_pointer_cast<connection_types::MarkerMessage const>(cin->getToken()->getTokenData())) {
+                if(cin->isConnected()) {
+                    marker = m;
+                }
+                if(!std::dynamic_pointer_cast<connection_types::NoMessage const>(m)) {
+                    all_inputs_are_present = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    // parameters are not updated here: nodes with connected parameter inputs are executed serially
+
+    if(!activity_modifiers.empty()) {
+        bool activate = false;
+        bool deactivate = false;
+        for(ActivityModifier& modifier : activity_modifiers) {
+            activate |= modifier == ActivityModifier::ACTIVATE;
+            deactivate |= modifier == ActivityModifier::DEACTIVATE;
+        }
+
+        if(!node_handle_->isActive() && activate) {
+            node_handle_->setActive(true);
+        } else if(node_handle_->isActive() && deactivate) {
+            node_handle_->setActive(false);
+        }
+    }
+
+    lock.unlock();
+
+    // release the inputs, the predecessors can send the next messages while this one is processed
+    node_handle_->getInputTransition()->notifyMessageRead();
+    node_handle_->getInputTransition()->notifyMessageProcessed();
+
+    if(marker) {
+        if(!std::dynamic_pointer_cast<connection_types::NoMessage const>(marker)) {
+            node->processMarker(marker);
+            for(OutputPtr out : node_handle_->getExternalOutputs()) {
+                context->setToken(out.get(), Token::make(marker));
+            }
+
+        } else {
+            if(node->processMessageMarkers()) {
+                node->processMarker(marker);
+            }
+            marker.reset();
+        }
+    }
+
+    if(marker || !all_inputs_are_present) {
+        bool send = true;
+        if(!marker) {
+            const auto& characteristics = node_handle_->getVertex()->getNodeCharacteristics();
+            bool can_drop_marker = characteristics.is_vertex_separator && !characteristics.is_leading_to_essential_vertex;
+            send = !can_drop_marker;
+        }
+        finishInvocation(context, send, false, generation);
+        return false;
+    }
+
+    std::shared_ptr<InvocationGuard> guard = invocation_guard_;
+    auto invocation = [this, node, context, generation, guard]() {
+        if(!guard->enter()) {
+            return;
+        }
+
+        struct Leave
+        {
+            InvocationGuard& guard;
+            ~Leave() { guard.leave(); }
+        } leave { *guard };
+
+        bool processed = isProcessingEnabled();
+        try {
+            if(processed) {
+                InvocationContext::Scope scope(context.get());
+                NumaAllocation::PreferredNode numa_node(getConsumerNumaNode());
+                node->process(*node_handle_, *node);
+            }
+
+        } catch(const std::exception& e) {
+            setError(true, e.what());
+
+        } catch(...) {
+            finishInvocation(context, true, processed, generation);
+            throw;
+        }
+
+        finishInvocation(context, true, processed, generation);
+    };
+
+    if(node_handle_->concurrent_execution_requested.isConnected()) {
+        node_handle_->concurrent_execution_requested(invocation);
+    } else {
+        invocation();
+    }
+
+    return true;
+}
+
+void NodeWorker::finishInvocation(const InvocationContextPtr& context, bool send, bool processed, long generation)
+{
+    {
+        std::unique_lock<std::recursive_mutex> lock(sync);
+        if(generation != generation_) {
+            // the worker has been reset in the meantime
+            return;
+        }
+        finished_invocations_[context->getTicket()] = Invocation { context, send, processed };
+    }
+
+    requestSendingFinishedInvocations();
+    triggerTryProcess();
+}
+
+void NodeWorker::requestSendingFinishedInvocations()
+{
+    // sending is serialized with the other tasks of the node
+    if(node_handle_->execution_requested.isConnected()) {
+        node_handle_->execution_requested([this]() {
+            sendFinishedInvocations();
+        });
+    } else {
+        sendFinishedInvocations();
+    }
+}
+
+void NodeWorker::sendFinishedInvocations()
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+
+    if(sending_invocations_) {
+        // called while the outputs were sending, the caller continues with the next invocation
+        resend_invocations_ = true;
+        return;
+    }
+    sending_invocations_ = true;
+
+    do {
+        resend_invocations_ = false;
+
+        // results are only sent in the order in which the messages were received
+        auto it = finished_invocations_.find(next_ticket_to_send_);
+        while(it != finished_invocations_.end()) {
+            Invocation invocation = it->second;
+            if(invocation.send && !node_handle_->getOutputTransition()->canStartSendingMessages()) {
+                break;
+            }
+
+            finished_invocations_.erase(it);
+            ++next_ticket_to_send_;
+
+            if(invocation.send) {
+                for(OutputPtr out : node_handle_->getExternalOutputs()) {
+                    if(TokenPtr token = invocation.context->getToken(out.get())) {
+                        out->addMessage(token);
+                    }
+                }
+
+                if(invocation.processed && !node_handle_->isSink()) {
+                    for(auto pair : node_handle_->outputToParamMap()) {
+                        publishParameterOn(*pair.second, node_handle_->getOutput(pair.first).get());
+                    }
+                }
+
+                bool active = node_handle_->isActive();
+
+                lock.unlock();
+                bool has_sent_activator_message = node_handle_->getOutputTransition()->sendMessages(active);
+                lock.lock();
+
+                sendEvents(active);
+                if(active && has_sent_activator_message) {
+                    node_handle_->setActive(false);
+                }
+
+                if(invocation.processed && trigger_process_done_->isConnected()) {
+                    msg::trigger(trigger_process_done_);
+                }
+            }
+
+            --pending_invocations_;
+
+            lock.unlock();
+            messages_processed();
+            lock.lock();
+
+            it = finished_invocations_.find(next_ticket_to_send_);
+        }
+    } while(resend_invocations_);
+
+    sending_invocations_ = false;
+}
+
+int NodeWorker::getConsumerNumaNode() const
+{
+    if(CpuTopology::instance().getNumNumaNodes() <= 1) {
+        return -1;
+    }
+
+    // only consumers that asked for local payloads count, and only if they agree on one node
+    int numa_node = -1;
+    for(const OutputPtr& out : node_handle_->getExternalOutputs()) {
+        for(const ConnectionPtr& c : out->getConnections()) {
+            InputPtr input = c->to();
+            NodeHandlePtr consumer = input ? std::dynamic_pointer_cast<NodeHandle>(input->getOwner()) : nullptr;
+            NodeRunnerPtr runner = consumer ? consumer->getNodeRunner() : nullptr;
+            ThreadGroup* group = runner ? dynamic_cast<ThreadGroup*>(runner->getScheduler()) : nullptr;
+            if(!group || !group->hasLocalPayloads() || group->getNumaNode() < 0) {
+                continue;
+            }
+
+            if(numa_node == -1) {
+                numa_node = group->getNumaNode();
+            } else if(numa_node != group->getNumaNode()) {
+                return -1;
+            }
+        }
+    }
+    return numa_node;
+}
+
+void NodeWorker::recordTransfers()
+{
+    int numa_node = CpuTopology::currentNumaNode();
+    if(numa_node < 0) {
+        return;
+    }
+    for(const InputPtr& input : node_handle_->getExternalInputs()) {
+        for(const ConnectionPtr& c : input->getConnections()) {
+            c->recordTransfer(numa_node);
+        }
+    }
+}
+
 void NodeWorker::publishParameterOn(const csapex::param::Parameter& p, Output* out)
 {
     if(out->isConnected()) {
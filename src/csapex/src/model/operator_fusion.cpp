@@ -0,0 +1,172 @@
+/// HEADER
+#include <csapex/model/operator_fusion.h>
+
+/// PROJECT
+#include <csapex/model/graph/graph_local.h>
+#include <csapex/model/graph/vertex.h>
+#include <csapex/model/node_facade.h>
+#include <csapex/model/node_handle.h>
+#include <csapex/model/node_runner.h>
+#include <csapex/model/node.h>
+#include <csapex/model/connection.h>
+#include <csapex/msg/input.h>
+#include <csapex/msg/output.h>
+#include <csapex/scheduling/fused_chain.h>
+#include <csapex/scheduling/thread_pool.h>
+
+/// SYSTEM
+#include <map>
+
+using namespace csapex;
+
+OperatorFusion::OperatorFusion(GraphLocal& graph, ThreadPool& thread_pool)
+    : valid_(true)
+{
+    fuse(graph, thread_pool);
+
+    // the chains are only correct for the structure they have been found in
+    observe(graph.vertex_added, [this](graph::VertexPtr) {
+        invalidate();
+    });
+    observe(graph.vertex_removed, [this](graph::VertexPtr) {
+        invalidate();
+    });
+    observe(graph.connection_added, [this](Connection*) {
+        invalidate();
+    });
+    observe(graph.connection_removed, [this](Connection*) {
+        invalidate();
+    });
+}
+
+OperatorFusion::~OperatorFusion()
+{
+    stopObserving();
+    release();
+}
+
+void OperatorFusion::invalidate()
+{
+    if(!valid_.exchange(false)) {
+        return;
+    }
+
+    release();
+}
+
+bool OperatorFusion::isValid() const
+{
+    return valid_;
+}
+
+void OperatorFusion::fuse(GraphLocal& graph, ThreadPool& thread_pool)
+{
+    // only nodes that are processed sequentially by their runner can be fused
+    std::map<NodeHandle*, NodeRunnerPtr> candidates;
+    for(auto it = graph.begin(); it != graph.end(); ++it) {
+        NodeFacadePtr facade = (*it)->getNodeFacade();
+        NodeHandlePtr nh = facade->getNodeHandle();
+        if(!nh || facade->isGraph()) {
+            continue;
+        }
+        NodePtr node = nh->getNode().lock();
+        if(!node || node->isAsynchronous() || node->isReentrant()) {
+            continue;
+        }
+        NodeRunnerPtr runner = facade->getNodeRunner();
+        if(runner) {
+            candidates[nh.get()] = runner;
+        }
+    }
+
+    std::map<NodeHandle*, NodeHandle*> next;
+    std::map<NodeHandle*, NodeHandle*> previous;
+    for(const auto& pair : candidates) {
+        NodeHandle* nh = pair.first;
+
+        std::vector<OutputPtr> outputs = nh->getExternalOutputs();
+        if(outputs.size() != 1) {
+            continue;
+        }
+        std::vector<ConnectionPtr> connections = outputs.front()->getConnections();
+        if(connections.size() != 1) {
+            continue;
+        }
+
+        InputPtr input = connections.front()->to();
+        NodeHandle* child = graph.findNodeHandleForConnectorNoThrow(input->getUUID());
+        if(!child || child == nh || candidates.find(child) == candidates.end()) {
+            continue;
+        }
+        std::vector<InputPtr> inputs = child->getExternalInputs();
+        if(inputs.size() != 1 || inputs.front()->getConnections().size() != 1) {
+            continue;
+        }
+
+        if(thread_pool.getGroupFor(pair.second.get()) != thread_pool.getGroupFor(candidates[child].get())) {
+            continue;
+        }
+
+        next[nh] = child;
+        previous[child] = nh;
+    }
+
+    // every chain starts at a node without predecessor, so cycles are never fused
+    for(const auto& pair : next) {
+        NodeHandle* head = pair.first;
+        if(previous.find(head) != previous.end()) {
+            continue;
+        }
+
+        std::vector<NodeHandle*> members;
+        for(NodeHandle* nh = head; nh; ) {
+            members.push_back(nh);
+            auto pos = next.find(nh);
+            nh = pos != next.end() ? pos->second : nullptr;
+        }
+
+        std::vector<UUID> uuids;
+        for(NodeHandle* nh : members) {
+            uuids.push_back(nh->getUUID());
+        }
+        FusedChainPtr chain = std::make_shared<FusedChain>(uuids);
+        for(NodeHandle* nh : members) {
+            NodeRunnerPtr runner = candidates[nh];
+            runner->setFusedChain(chain);
+            runners_.push_back(runner);
+        }
+        chains_.push_back(chain);
+    }
+}
+
+std::size_t OperatorFusion::getChainCount() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return chains_.size();
+}
+
+std::vector<UUID> OperatorFusion::getChain(std::size_t chain) const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return chains_.at(chain)->getMembers();
+}
+
+long OperatorFusion::getFusedExecutions(std::size_t chain) const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return chains_.at(chain)->getFusedExecutions();
+}
+
+void OperatorFusion::release()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for(const NodeRunnerPtr& runner : runners_) {
+        runner->setFusedChain(nullptr);
+    }
+    runners_.clear();
+
+    // tasks that are deferred by a running chain are scheduled instead
+    for(const FusedChainPtr& chain : chains_) {
+        chain->invalidate();
+    }
+}
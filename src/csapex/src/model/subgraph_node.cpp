@@ -130,8 +130,7 @@ void SubgraphNode::setup(NodeModifier &modifier)
 void SubgraphNode::activation()
 {
     if(activation_event_) {
-        TokenDataConstPtr data(new connection_types::AnyMessage);
-        TokenPtr token = std::make_shared<Token>(data);
+        TokenPtr token = Token::makeShared<connection_types::AnyMessage>();
         token->setActivityModifier(ActivityModifier::ACTIVATE);
         activation_event_->triggerWith(token);
     }
@@ -140,8 +139,7 @@ void SubgraphNode::activation()
 void SubgraphNode::deactivation()
 {
     if(deactivation_event_) {
-        TokenDataConstPtr data(new connection_types::AnyMessage);
-        TokenPtr token = std::make_shared<Token>(data);
+        TokenPtr token = Token::makeShared<connection_types::AnyMessage>();
         token->setActivityModifier(ActivityModifier::DEACTIVATE);
         deactivation_event_->triggerWith(token);
     }
@@ -1,10 +1,20 @@
 /// HEADER
 #include <csapex/model/token.h>
 
+/// PROJECT
+#include <csapex/utility/pool_allocator.hpp>
+#include <csapex/utility/numa_allocator.h>
+
 using namespace csapex;
 
+TokenPtr Token::make(const TokenDataConstPtr &data)
+{
+    return makePooled<Token>(data);
+}
+
 Token::Token(const TokenDataConstPtr &token)
-    : token_(token), activity_modifier_(ActivityModifier::NONE), seq_no_(-1)
+    : token_(token), activity_modifier_(ActivityModifier::NONE), seq_no_(-1),
+      numa_node_(NumaAllocation::getPayloadNode())
 {
 
 }
@@ -40,9 +50,24 @@ void Token::setSequenceNumber(int seq_no) const
     seq_no_ = seq_no;
 }
 
+int Token::getNumaNode() const
+{
+    return numa_node_;
+}
+
+void Token::setNumaNode(int node)
+{
+    numa_node_ = node;
+}
+
 TokenPtr Token::clone() const
 {
-    TokenPtr token = std::make_shared<Token>(*this);
+    TokenPtr token = makePooled<Token>(*this);
     token->token_ = token_->clone();
     return token;
 }
+
+TokenPtr Token::cloneShallow() const
+{
+    return makePooled<Token>(*this);
+}
@@ -0,0 +1,154 @@
+/// HEADER
+#include <csapex/msg/buffered_connection.h>
+
+/// PROJECT
+#include <csapex/msg/output.h>
+#include <csapex/msg/input.h>
+#include <csapex/utility/assert.h>
+
+using namespace csapex;
+
+ConnectionPtr BufferedConnection::connect(OutputPtr from, InputPtr to, std::size_t capacity)
+{
+    apex_assert_hard(from);
+    apex_assert_hard(to);
+    apex_assert_hard(from->isConnectionPossible(to.get()));
+    ConnectionPtr r(new BufferedConnection(from, to, capacity));
+    from->addConnection(r);
+    to->addConnection(r);
+    return r;
+}
+
+ConnectionPtr BufferedConnection::connect(OutputPtr from, InputPtr to, int id, std::size_t capacity)
+{
+    apex_assert_hard(from);
+    apex_assert_hard(to);
+    apex_assert_hard(from->isConnectionPossible(to.get()));
+    ConnectionPtr r(new BufferedConnection(from, to, id, capacity));
+    from->addConnection(r);
+    to->addConnection(r);
+    return r;
+}
+
+BufferedConnection::BufferedConnection(OutputPtr from, InputPtr to, std::size_t capacity)
+    : Connection(from, to), capacity_(capacity)
+{
+    apex_assert_hard(capacity_ > 0);
+}
+
+BufferedConnection::BufferedConnection(OutputPtr from, InputPtr to, int id, std::size_t capacity)
+    : Connection(from, to, id), capacity_(capacity)
+{
+    apex_assert_hard(capacity_ > 0);
+}
+
+BufferedConnection::~BufferedConnection()
+{
+}
+
+void BufferedConnection::setToken(const TokenPtr &token)
+{
+    TokenPtr msg = token->cloneShallow();
+    apex_assert_hard(msg != nullptr);
+
+    {
+        std::unique_lock<std::recursive_mutex> lock(sync);
+
+        if(!isActive() && msg->hasActivityModifier()) {
+            // remove active flag if the connection is inactive
+            msg->setActivityModifier(ActivityModifier::NONE);
+        }
+
+        if(state_ != State::NOT_INITIALIZED && overflow_policy_ == OverflowPolicy::KEEP_LATEST) {
+            // everything the input has not read yet is outdated
+            dropped_ += pending_.size();
+            pending_.clear();
+            if(state_ == State::UNREAD) {
+                message_ = msg;
+                ++dropped_;
+                return;
+            }
+
+        } else if(state_ != State::NOT_INITIALIZED && getOccupancy() >= capacity_) {
+            apex_assert_hard(overflow_policy_ == OverflowPolicy::DROP_OLDEST);
+            if(!pending_.empty()) {
+                pending_.pop_front();
+                ++dropped_;
+
+            } else if(state_ == State::UNREAD) {
+                message_ = msg;
+                ++dropped_;
+                return;
+            }
+            // otherwise the input is processing the only token, the new one is queued behind it
+        }
+
+        if(state_ != State::NOT_INITIALIZED) {
+            // the input is still busy with an older token
+            pending_.push_back(msg);
+            return;
+        }
+
+        message_ = msg;
+        setState(State::UNREAD);
+    }
+
+    notifyMessageSet();
+}
+
+void BufferedConnection::setTokenProcessed()
+{
+    bool was_full = false;
+    bool has_next = false;
+    {
+        std::unique_lock<std::recursive_mutex> lock(sync);
+        if(state_ == State::DONE) {
+            return;
+        }
+        was_full = getOccupancy() >= capacity_ && overflow_policy_ == OverflowPolicy::BLOCK;
+
+        setState(State::DONE);
+
+        if(!pending_.empty()) {
+            message_ = pending_.front();
+            pending_.pop_front();
+            setState(State::UNREAD);
+            has_next = true;
+        }
+    }
+
+    if(has_next) {
+        notifyMessageSet();
+    }
+    if(was_full) {
+        // the output has been waiting for free space
+        notifyMessageProcessed();
+    }
+}
+
+Connection::State BufferedConnection::getSourceState() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    if(overflow_policy_ != OverflowPolicy::BLOCK) {
+        return State::DONE;
+    }
+    return getOccupancy() < capacity_ ? State::DONE : State::UNREAD;
+}
+
+std::size_t BufferedConnection::getCapacity() const
+{
+    return capacity_;
+}
+
+std::size_t BufferedConnection::getOccupancy() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return pending_.size() + (state_ == State::NOT_INITIALIZED ? 0 : 1);
+}
+
+void BufferedConnection::reset()
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    pending_.clear();
+    Connection::reset();
+}
@@ -181,6 +181,21 @@ std::size_t GenericVectorMessage::InstancedImplementation::nestedValueCount() co
     return value.size();
 }
 
+/// BINARY
+namespace csapex {
+namespace serial {
+bool BinarySerializer<GenericVectorMessage>::encode(const GenericVectorMessage& msg, SerializationBuffer& data)
+{
+    return msg.encodeBinary(data);
+}
+
+void BinarySerializer<GenericVectorMessage>::decode(SerializationBuffer& data, GenericVectorMessage& msg)
+{
+    msg.decodeBinary(data);
+}
+}
+}
+
 /// YAML
 namespace YAML {
 Node convert<csapex::connection_types::GenericVectorMessage>::encode(const csapex::connection_types::GenericVectorMessage& rhs)
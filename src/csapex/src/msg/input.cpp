@@ -7,6 +7,7 @@
 #include <csapex/msg/input_transition.h>
 #include <csapex/msg/marker_message.h>
 #include <csapex/msg/output.h>
+#include <csapex/msg/invocation_context.h>
 
 /// SYSTEM
 #include <iostream>
@@ -63,18 +64,17 @@ bool Input::isOptional() const
 
 bool Input::hasReceived() const
 {
-    std::unique_lock<std::mutex> lock(message_mutex_);
-    return isConnected() && message_ != nullptr;
+    return isConnected() && getToken() != nullptr;
 }
 
 bool Input::hasMessage() const
 {
-    if(!hasReceived()) {
+    if(!isConnected()) {
         return false;
     }
 
-    std::unique_lock<std::mutex> lock(message_mutex_);
-    return !std::dynamic_pointer_cast<connection_types::MarkerMessage const>(message_->getTokenData());
+    TokenPtr token = getToken();
+    return token && !std::dynamic_pointer_cast<connection_types::MarkerMessage const>(token->getTokenData());
 }
 
 void Input::stop()
@@ -157,6 +157,13 @@ OutputPtr Input::getSource() const
 
 TokenPtr Input::getToken() const
 {
+    // concurrent invocations of reentrant nodes see their own snapshot
+    if(const InvocationContext* context = InvocationContext::current()) {
+        if(context->captures(this)) {
+            return context->getToken(this);
+        }
+    }
+
     std::unique_lock<std::mutex> lock(message_mutex_);
     return message_;
 }
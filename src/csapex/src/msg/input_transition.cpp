@@ -119,7 +119,7 @@ void InputTransition::connectionAdded(Connection *connection)
     bool needs_message = has_read_or_unread && connection->getState() == Connection::State::NOT_INITIALIZED;
 
     if(needs_message) {
-        connection->setToken(Token::makeEmpty<connection_types::NoMessage>());
+        connection->setToken(Token::makeShared<connection_types::NoMessage>());
         if(!unread) {
             connection->setState(Connection::State::READ);
         }
@@ -279,7 +279,7 @@ void InputTransition::forwardMessages()
                 apex_assert_hard(token != nullptr);
                 input->setToken(token);
             } else {
-                input->setToken(Token::makeEmpty<connection_types::NoMessage>());
+                input->setToken(Token::makeShared<connection_types::NoMessage>());
             }
         }
 
@@ -0,0 +1,99 @@
+/// HEADER
+#include <csapex/msg/invocation_context.h>
+
+/// COMPONENT
+#include <csapex/utility/assert.h>
+
+using namespace csapex;
+
+namespace
+{
+thread_local InvocationContext* current_context = nullptr;
+}
+
+InvocationContext::Scope::Scope(InvocationContext* context)
+    : previous_(current_context)
+{
+    current_context = context;
+}
+
+InvocationContext::Scope::~Scope()
+{
+    current_context = previous_;
+}
+
+InvocationContext* InvocationContext::current()
+{
+    return current_context;
+}
+
+InvocationContext::InvocationContext(long ticket)
+    : ticket_(ticket)
+{
+}
+
+long InvocationContext::getTicket() const
+{
+    return ticket_;
+}
+
+void InvocationContext::addInput(const Input* input, const TokenPtr& token)
+{
+    inputs_.emplace_back(input, token);
+}
+
+bool InvocationContext::captures(const Input* input) const
+{
+    for(const auto& pair : inputs_) {
+        if(pair.first == input) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TokenPtr InvocationContext::getToken(const Input* input) const
+{
+    for(const auto& pair : inputs_) {
+        if(pair.first == input) {
+            return pair.second;
+        }
+    }
+    return nullptr;
+}
+
+void InvocationContext::addOutput(const Output* output)
+{
+    outputs_.emplace_back(output, nullptr);
+}
+
+bool InvocationContext::captures(const Output* output) const
+{
+    for(const auto& pair : outputs_) {
+        if(pair.first == output) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TokenPtr InvocationContext::getToken(const Output* output) const
+{
+    for(const auto& pair : outputs_) {
+        if(pair.first == output) {
+            return pair.second;
+        }
+    }
+    return nullptr;
+}
+
+void InvocationContext::setToken(const Output* output, const TokenPtr& token)
+{
+    for(auto& pair : outputs_) {
+        if(pair.first == output) {
+            pair.second = token;
+            return;
+        }
+    }
+    apex_assert_hard_msg(false, "output is not captured by the invocation");
+}
@@ -93,7 +93,7 @@ void csapex::msg::throwError(const TokenDataConstPtr &msg, const std::type_info
 
 void csapex::msg::publish(Output *output, TokenDataConstPtr message)
 {
-    output->addMessage(std::make_shared<Token>(message));
+    output->addMessage(Token::make(message));
 }
 
 void csapex::msg::trigger(Event *event)
@@ -0,0 +1,153 @@
+/// HEADER
+#include <csapex/msg/message_log_provider.h>
+
+/// COMPONENT
+#include <csapex/core/settings.h>
+#include <csapex/param/parameter_factory.h>
+
+using namespace csapex;
+
+std::shared_ptr<MessageProvider> MessageLogProvider::make()
+{
+    return std::shared_ptr<MessageProvider> (new MessageLogProvider);
+}
+
+MessageLogProvider::MessageLogProvider()
+    : index_(0), start_time_(0.0), playback_start_index_(0), prepared_(false), prepared_slot_(0)
+{
+    state.addParameter(csapex::param::ParameterFactory::declareBool("playback/realtime", true));
+    state.addParameter(csapex::param::ParameterFactory::declareValue<double>("playback/start_time", 0.0));
+}
+
+void MessageLogProvider::load(const std::string& file)
+{
+    reader_ = std::make_shared<MessageLogReader>(file);
+
+    setSlotCount(std::max<std::size_t>(1, reader_->getOutputs().size()));
+
+    restart();
+}
+
+MessageLogReaderPtr MessageLogProvider::getReader() const
+{
+    return reader_;
+}
+
+void MessageLogProvider::parameterChanged()
+{
+    double start_time = state.readParameter<double>("playback/start_time");
+    if(start_time != start_time_) {
+        start_time_ = start_time;
+        if(reader_) {
+            restart();
+        }
+    }
+}
+
+void MessageLogProvider::restart()
+{
+    seekTime(std::chrono::microseconds(static_cast<int64_t>(start_time_ * 1e6)));
+}
+
+void MessageLogProvider::seekIndex(std::size_t index)
+{
+    index_ = reader_ ? std::min(index, reader_->size()) : 0;
+
+    playback_start_ = std::chrono::steady_clock::now();
+    playback_start_index_ = index_;
+
+    prepared_ = false;
+    prepared_message_.reset();
+}
+
+void MessageLogProvider::seekTime(std::chrono::microseconds time)
+{
+    seekIndex(reader_ ? reader_->lowerBound(time) : 0);
+}
+
+std::size_t MessageLogProvider::getIndex() const
+{
+    return index_;
+}
+
+std::chrono::steady_clock::time_point MessageLogProvider::dueTime(std::size_t index) const
+{
+    return playback_start_ + (reader_->getTime(index) - reader_->getTime(playback_start_index_));
+}
+
+bool MessageLogProvider::hasNext()
+{
+    if(!reader_ || reader_->empty()) {
+        return false;
+    }
+
+    if(index_ >= reader_->size()) {
+        if(!state.readParameter<bool>("playback/resend")) {
+            return false;
+        }
+        restart();
+        if(index_ >= reader_->size()) {
+            return false;
+        }
+    }
+
+    if(state.readParameter<bool>("playback/realtime")) {
+        return std::chrono::steady_clock::now() >= dueTime(index_);
+    }
+    return true;
+}
+
+void MessageLogProvider::prepareNext()
+{
+    if(!reader_ || index_ >= reader_->size()) {
+        prepared_ = false;
+        prepared_message_.reset();
+        return;
+    }
+
+    MessageLogReader::Record record = reader_->read(index_);
+    prepared_slot_ = reader_->getOutput(index_);
+    prepared_message_ = std::dynamic_pointer_cast<connection_types::Message>(record.message);
+    prepared_ = true;
+
+    ++index_;
+}
+
+connection_types::Message::Ptr MessageLogProvider::next(std::size_t slot)
+{
+    if(!prepared_ || slot != prepared_slot_) {
+        return nullptr;
+    }
+
+    connection_types::Message::Ptr msg = prepared_message_;
+    prepared_ = false;
+    prepared_message_.reset();
+    return msg;
+}
+
+std::string MessageLogProvider::getLabel(std::size_t slot) const
+{
+    if(!reader_) {
+        return "";
+    }
+    std::vector<UUID> outputs = reader_->getOutputs();
+    return slot < outputs.size() ? outputs[slot].getFullName() : "";
+}
+
+std::vector<std::string> MessageLogProvider::getExtensions() const
+{
+    return { Settings::message_log_extension };
+}
+
+Memento::Ptr MessageLogProvider::getState() const
+{
+    return state.clone();
+}
+
+void MessageLogProvider::setParameterState(Memento::Ptr memento)
+{
+    if(GenericState::Ptr s = std::dynamic_pointer_cast<GenericState>(memento)) {
+        state.setFrom(*s);
+        parameterChanged();
+    }
+}
@@ -0,0 +1,299 @@
+/// HEADER
+#include <csapex/msg/message_log_reader.h>
+
+/// PROJECT
+#include <csapex/model/token_data.h>
+#include <csapex/msg/message.h>
+#include <csapex/msg/message_log_writer.h>
+#include <csapex/serialization/message_serializer.h>
+#include <csapex/serialization/serialization_buffer.h>
+#include <csapex/utility/uuid_provider.h>
+
+/// SYSTEM
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace csapex;
+
+namespace
+{
+template <typename T>
+T load(const uint8_t* data)
+{
+    T value = 0;
+    for(std::size_t byte = 0; byte < sizeof(T); ++byte) {
+        value |= static_cast<T>(data[byte]) << (byte * 8);
+    }
+    return value;
+}
+
+/// reads a string with a varint length prefix, as written by SerializationBuffer
+bool loadString(const uint8_t*& data, const uint8_t* end, std::string& str)
+{
+    uint64_t length = 0;
+    for(std::size_t shift = 0; ; shift += 7) {
+        if(data == end || shift >= 64) {
+            return false;
+        }
+        uint8_t byte = *data++;
+        length |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if((byte & 0x80) == 0) {
+            break;
+        }
+    }
+    if(length > static_cast<uint64_t>(end - data)) {
+        return false;
+    }
+    str.assign(reinterpret_cast<const char*>(data), length);
+    data += length;
+    return true;
+}
+
+// time, offset and output of an index entry
+const std::size_t ENTRY_TIME = 0;
+const std::size_t ENTRY_OFFSET = 8;
+const std::size_t ENTRY_OUTPUT = 16;
+
+// time and stamp precede the output in every record
+const std::size_t RECORD_OUTPUT = 16;
+}
+
+MessageLogReader::MessageLogReader(const std::string& path)
+    : path_(path), fd_(-1), data_(nullptr), size_(0), entries_(nullptr), count_(0), indexed_(false)
+{
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if(fd_ < 0) {
+        throw std::runtime_error(std::string("cannot open message log ") + path + ": " + std::strerror(errno));
+    }
+
+    struct stat info;
+    if(::fstat(fd_, &info) != 0 || info.st_size < (off_t) MessageLogWriter::FILE_HEADER_LENGTH) {
+        ::close(fd_);
+        throw std::runtime_error(std::string("file ") + path + " is not a message log");
+    }
+    size_ = info.st_size;
+
+    void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if(mapping == MAP_FAILED) {
+        std::string error = std::strerror(errno);
+        ::close(fd_);
+        throw std::runtime_error(std::string("cannot map message log ") + path + ": " + error);
+    }
+    data_ = static_cast<const uint8_t*>(mapping);
+
+    try {
+        if(load<uint64_t>(data_) != MessageLogWriter::FILE_MAGIC) {
+            throw std::runtime_error(std::string("file ") + path + " is not a message log");
+        }
+        if(load<uint32_t>(data_ + 8) != MessageLogWriter::VERSION) {
+            throw std::runtime_error(std::string("message log ") + path + " has an unsupported version");
+        }
+
+        const uint8_t* trailer = data_ + size_ - MessageLogWriter::TRAILER_LENGTH;
+        if(size_ >= MessageLogWriter::FILE_HEADER_LENGTH + MessageLogWriter::TRAILER_LENGTH &&
+                load<uint64_t>(trailer + 8) == MessageLogWriter::INDEX_MAGIC) {
+            readIndex(load<uint64_t>(trailer));
+            indexed_ = true;
+        } else {
+            rebuildIndex();
+        }
+
+    } catch(...) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+        ::close(fd_);
+        throw;
+    }
+}
+
+MessageLogReader::~MessageLogReader()
+{
+    ::munmap(const_cast<uint8_t*>(data_), size_);
+    ::close(fd_);
+}
+
+void MessageLogReader::readIndex(uint64_t index_offset)
+{
+    const uint8_t* end = data_ + size_ - MessageLogWriter::TRAILER_LENGTH;
+    if(index_offset < MessageLogWriter::FILE_HEADER_LENGTH || index_offset + sizeof(uint64_t) > (uint64_t) (end - data_)) {
+        throw std::runtime_error(std::string("message log ") + path_ + " has a corrupt index");
+    }
+
+    const uint8_t* pos = data_ + index_offset;
+    uint64_t output_count = load<uint64_t>(pos);
+    pos += sizeof(uint64_t);
+
+    for(uint64_t i = 0; i < output_count; ++i) {
+        std::string name;
+        if(!loadString(pos, end, name)) {
+            throw std::runtime_error(std::string("message log ") + path_ + " has a corrupt index");
+        }
+        outputs_.push_back(UUIDProvider::makeUUID_without_parent(name));
+    }
+
+    if(end - pos < (std::ptrdiff_t) sizeof(uint64_t)) {
+        throw std::runtime_error(std::string("message log ") + path_ + " has a corrupt index");
+    }
+    count_ = load<uint64_t>(pos);
+    pos += sizeof(uint64_t);
+
+    if(count_ > (uint64_t) (end - pos) / MessageLogWriter::INDEX_ENTRY_LENGTH) {
+        throw std::runtime_error(std::string("message log ") + path_ + " has a corrupt index");
+    }
+    entries_ = pos;
+}
+
+void MessageLogReader::rebuildIndex()
+{
+    std::map<std::string, uint32_t> output_ids;
+
+    const uint8_t* end = data_ + size_;
+    const uint8_t* chunk = data_ + MessageLogWriter::FILE_HEADER_LENGTH;
+
+    // a chunk is only written as a whole, a truncated chunk ends the log
+    while(end - chunk >= (std::ptrdiff_t) MessageLogWriter::CHUNK_HEADER_LENGTH &&
+          load<uint32_t>(chunk) == MessageLogWriter::CHUNK_MAGIC) {
+        uint32_t records = load<uint32_t>(chunk + 4);
+        uint64_t length = load<uint64_t>(chunk + 8);
+
+        const uint8_t* record = chunk + MessageLogWriter::CHUNK_HEADER_LENGTH;
+        if(length > (uint64_t) (end - record)) {
+            break;
+        }
+        const uint8_t* chunk_end = record + length;
+
+        for(uint32_t i = 0; i < records; ++i) {
+            if(chunk_end - record < (std::ptrdiff_t) (sizeof(uint32_t) + RECORD_OUTPUT)) {
+                throw std::runtime_error(std::string("message log ") + path_ + " has a corrupt chunk");
+            }
+            uint32_t record_length = load<uint32_t>(record);
+            const uint8_t* content = record + sizeof(uint32_t);
+            const uint8_t* next = content + record_length;
+
+            std::string name;
+            const uint8_t* output = content + RECORD_OUTPUT;
+            if(record_length > (uint64_t) (chunk_end - content) || !loadString(output, next, name)) {
+                throw std::runtime_error(std::string("message log ") + path_ + " has a corrupt chunk");
+            }
+
+            uint32_t id;
+            auto pos = output_ids.find(name);
+            if(pos == output_ids.end()) {
+                id = outputs_.size();
+                output_ids[name] = id;
+                outputs_.push_back(UUIDProvider::makeUUID_without_parent(name));
+            } else {
+                id = pos->second;
+            }
+
+            uint64_t time = load<uint64_t>(content);
+            uint64_t offset = record - data_;
+
+            uint8_t entry[MessageLogWriter::INDEX_ENTRY_LENGTH];
+            for(std::size_t byte = 0; byte < 8; ++byte) {
+                entry[ENTRY_TIME + byte] = (time >> (byte * 8)) & 0xFF;
+                entry[ENTRY_OFFSET + byte] = (offset >> (byte * 8)) & 0xFF;
+            }
+            for(std::size_t byte = 0; byte < 4; ++byte) {
+                entry[ENTRY_OUTPUT + byte] = (id >> (byte * 8)) & 0xFF;
+            }
+            rebuilt_entries_.insert(rebuilt_entries_.end(), entry, entry + MessageLogWriter::INDEX_ENTRY_LENGTH);
+
+            record = next;
+        }
+
+        chunk = chunk_end;
+    }
+
+    count_ = rebuilt_entries_.size() / MessageLogWriter::INDEX_ENTRY_LENGTH;
+    entries_ = rebuilt_entries_.data();
+}
+
+std::size_t MessageLogReader::size() const
+{
+    return count_;
+}
+
+bool MessageLogReader::empty() const
+{
+    return count_ == 0;
+}
+
+bool MessageLogReader::isIndexed() const
+{
+    return indexed_;
+}
+
+std::vector<UUID> MessageLogReader::getOutputs() const
+{
+    return outputs_;
+}
+
+const uint8_t* MessageLogReader::entry(std::size_t index) const
+{
+    if(index >= count_) {
+        throw std::out_of_range(std::string("message log ") + path_ + " has no record #" + std::to_string(index));
+    }
+    return entries_ + index * MessageLogWriter::INDEX_ENTRY_LENGTH;
+}
+
+std::chrono::microseconds MessageLogReader::getTime(std::size_t index) const
+{
+    return std::chrono::microseconds(load<uint64_t>(entry(index) + ENTRY_TIME));
+}
+
+std::size_t MessageLogReader::getOutput(std::size_t index) const
+{
+    return load<uint32_t>(entry(index) + ENTRY_OUTPUT);
+}
+
+std::size_t MessageLogReader::lowerBound(std::chrono::microseconds time) const
+{
+    // records are appended in the order they are recorded, so the index is sorted by time
+    std::size_t first = 0;
+    std::size_t count = count_;
+    while(count > 0) {
+        std::size_t step = count / 2;
+        std::size_t mid = first + step;
+        if(getTime(mid) < time) {
+            first = mid + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+MessageLogReader::Record MessageLogReader::read(std::size_t index) const
+{
+    uint64_t offset = load<uint64_t>(entry(index) + ENTRY_OFFSET);
+    if(offset + sizeof(uint32_t) > size_) {
+        throw std::runtime_error(std::string("message log ") + path_ + " has a corrupt index");
+    }
+    uint32_t length = load<uint32_t>(data_ + offset);
+    if(offset + sizeof(uint32_t) + length > size_) {
+        throw std::runtime_error(std::string("message log ") + path_ + " has a truncated record");
+    }
+
+    SerializationBuffer buffer;
+    buffer.appendBytes(data_ + offset + sizeof(uint32_t), length);
+
+    Record record;
+    uint64_t time;
+    buffer >> time >> record.stamp >> record.output;
+    record.time = std::chrono::microseconds(time);
+    record.message = MessageSerializer::deserializeMessage(buffer);
+
+    // not every encoding of a message includes its stamp
+    if(connection_types::Message* msg = dynamic_cast<connection_types::Message*>(record.message.get())) {
+        msg->stamp_micro_seconds = record.stamp;
+    }
+
+    return record;
+}
@@ -0,0 +1,167 @@
+/// HEADER
+#include <csapex/msg/message_log_writer.h>
+
+/// PROJECT
+#include <csapex/model/token_data.h>
+#include <csapex/msg/message.h>
+#include <csapex/serialization/message_serializer.h>
+
+/// SYSTEM
+#include <iostream>
+
+using namespace csapex;
+
+const uint64_t MessageLogWriter::FILE_MAGIC = 0x31474F4C58534321; // "!CSXLOG1"
+const uint64_t MessageLogWriter::INDEX_MAGIC = 0x3158444958534321; // "!CSXIDX1"
+const uint32_t MessageLogWriter::CHUNK_MAGIC = 0x4B4E4843; // "CHNK"
+const uint32_t MessageLogWriter::VERSION = 1;
+
+const std::size_t MessageLogWriter::FILE_HEADER_LENGTH;
+const std::size_t MessageLogWriter::CHUNK_HEADER_LENGTH;
+const std::size_t MessageLogWriter::INDEX_ENTRY_LENGTH;
+const std::size_t MessageLogWriter::TRAILER_LENGTH;
+
+MessageLogWriter::MessageLogWriter(const std::string& path, std::size_t chunk_size)
+    : path_(path), out_(path.c_str(), std::ios::binary | std::ios::trunc), chunk_size_(chunk_size),
+      started_(false), file_offset_(0), chunk_records_(0)
+{
+    if(!out_) {
+        throw std::runtime_error(std::string("cannot create message log ") + path);
+    }
+
+    SerializationBuffer header;
+    header << FILE_MAGIC << VERSION << (uint32_t) 0;
+    out_.write(reinterpret_cast<const char*>(header.data() + SerializationBuffer::HEADER_LENGTH), FILE_HEADER_LENGTH);
+    file_offset_ = FILE_HEADER_LENGTH;
+
+    chunk_.reserve(chunk_size_ + SerializationBuffer::HEADER_LENGTH);
+}
+
+MessageLogWriter::~MessageLogWriter()
+{
+    try {
+        close();
+    } catch(const std::exception& e) {
+        std::cerr << "cannot close message log " << path_ << ": " << e.what() << std::endl;
+    }
+}
+
+std::string MessageLogWriter::getPath() const
+{
+    return path_;
+}
+
+std::size_t MessageLogWriter::getRecordCount() const
+{
+    return index_.size();
+}
+
+void MessageLogWriter::write(const UUID& output, const TokenData& message)
+{
+    auto now = std::chrono::steady_clock::now();
+    if(!started_) {
+        start_ = now;
+        started_ = true;
+    }
+    write(output, message, std::chrono::duration_cast<std::chrono::microseconds>(now - start_));
+}
+
+void MessageLogWriter::write(const UUID& output, const TokenData& message, std::chrono::microseconds time)
+{
+    if(!out_.is_open()) {
+        throw std::runtime_error(std::string("message log ") + path_ + " is already closed");
+    }
+
+    uint64_t stamp = 0;
+    if(const connection_types::Message* msg = dynamic_cast<const connection_types::Message*>(&message)) {
+        stamp = msg->stamp_micro_seconds;
+    }
+
+    // records are serialized directly into the chunk, the length is filled in afterwards
+    std::size_t start = chunk_.size();
+    chunk_ << (uint32_t) 0;
+    chunk_ << (uint64_t) time.count() << stamp << output;
+    MessageSerializer::serializeMessage(message, chunk_);
+
+    uint32_t length = chunk_.size() - start - sizeof(uint32_t);
+    for(std::size_t byte = 0; byte < sizeof(uint32_t); ++byte) {
+        chunk_[start + byte] = (length >> (byte * 8)) & 0xFF;
+    }
+
+    IndexEntry entry;
+    entry.time = time.count();
+    entry.offset = file_offset_ + CHUNK_HEADER_LENGTH + (start - SerializationBuffer::HEADER_LENGTH);
+    entry.output = getOutputId(output);
+    index_.push_back(entry);
+
+    ++chunk_records_;
+
+    if(chunk_.size() - SerializationBuffer::HEADER_LENGTH >= chunk_size_) {
+        flush();
+    }
+}
+
+uint32_t MessageLogWriter::getOutputId(const UUID& output)
+{
+    const std::string& name = output.getFullName();
+    auto pos = output_ids_.find(name);
+    if(pos != output_ids_.end()) {
+        return pos->second;
+    }
+
+    uint32_t id = outputs_.size();
+    outputs_.push_back(output);
+    output_ids_[name] = id;
+    return id;
+}
+
+void MessageLogWriter::flush()
+{
+    if(chunk_records_ == 0) {
+        return;
+    }
+
+    uint64_t length = chunk_.size() - SerializationBuffer::HEADER_LENGTH;
+
+    SerializationBuffer header;
+    header << CHUNK_MAGIC << chunk_records_ << length;
+    out_.write(reinterpret_cast<const char*>(header.data() + SerializationBuffer::HEADER_LENGTH), CHUNK_HEADER_LENGTH);
+    out_.write(reinterpret_cast<const char*>(chunk_.data() + SerializationBuffer::HEADER_LENGTH), length);
+    out_.flush();
+
+    if(!out_) {
+        throw std::runtime_error(std::string("cannot write message log ") + path_);
+    }
+
+    file_offset_ += CHUNK_HEADER_LENGTH + length;
+    chunk_.resize(SerializationBuffer::HEADER_LENGTH);
+    chunk_records_ = 0;
+}
+
+void MessageLogWriter::close()
+{
+    if(!out_.is_open()) {
+        return;
+    }
+
+    flush();
+
+    SerializationBuffer index;
+    index << (uint64_t) outputs_.size();
+    for(const UUID& output : outputs_) {
+        index << output;
+    }
+    index << (uint64_t) index_.size();
+    for(const IndexEntry& entry : index_) {
+        index << entry.time << entry.offset << entry.output;
+    }
+    index << file_offset_ << INDEX_MAGIC;
+
+    out_.write(reinterpret_cast<const char*>(index.data() + SerializationBuffer::HEADER_LENGTH),
+               index.size() - SerializationBuffer::HEADER_LENGTH);
+    out_.close();
+
+    if(!out_) {
+        throw std::runtime_error(std::string("cannot write the index of message log ") + path_);
+    }
+}
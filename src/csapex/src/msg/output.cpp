@@ -52,7 +52,7 @@ void Output::notifyMessageProcessed()
 void Output::notifyMessageProcessed(Connection* connection)
 {
     for(auto connection : connections_) {
-        if(connection->getState() != Connection::State::DONE) {
+        if(connection->getSourceState() != Connection::State::DONE) {
             return;
         }
     }
@@ -164,7 +164,7 @@ void Output::validateConnections()
 bool Output::canReceiveToken() const
 {
     for(const ConnectionPtr& connection : connections_) {
-        if(connection->getState() != Connection::State::NOT_INITIALIZED) {
+        if(connection->getSourceState() != Connection::State::NOT_INITIALIZED) {
             return false;
         }
     }
@@ -174,7 +174,7 @@ bool Output::canReceiveToken() const
 bool Output::canSendMessages() const
 {
     for(const ConnectionPtr& connection : connections_) {
-        if(connection->getState() == Connection::State::NOT_INITIALIZED) {
+        if(connection->getSourceState() == Connection::State::NOT_INITIALIZED) {
             return false;
         }
     }
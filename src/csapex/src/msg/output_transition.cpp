@@ -231,13 +231,35 @@ void OutputTransition::fillConnections()
         OutputPtr out = pair.second;
         apex_assert_hard(out);
         if(out->isEnabled()) {
-            if(!out->isConnected()) {
+            if(!out->isConnected() || canContinueWithoutConsumers(out.get())) {
                 out->notifyMessageProcessed();
             }
         }
     }
 }
 
+Connection::State OutputTransition::connectionState(const Connection& connection) const
+{
+    return connection.getSourceState();
+}
+
+bool OutputTransition::canContinueWithoutConsumers(Output* output) const
+{
+    // buffered and non-blocking connections accept the next token without waiting for the consumer,
+    // the notification of a blocking single-token connection is sent when its token is processed
+    bool has_enabled_connection = false;
+    for(const ConnectionPtr& connection : output->getConnections()) {
+        if(connection->isEnabled()) {
+            bool single_slot = connection->getCapacity() <= 1 && connection->getOverflowPolicy() == Connection::OverflowPolicy::BLOCK;
+            if(single_slot || connection->getSourceState() != Connection::State::DONE) {
+                return false;
+            }
+            has_enabled_connection = true;
+        }
+    }
+    return has_enabled_connection;
+}
+
 void OutputTransition::clearBuffer()
 {
     std::unique_lock<std::recursive_mutex> lock(sync);
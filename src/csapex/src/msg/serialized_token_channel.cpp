@@ -0,0 +1,72 @@
+/// HEADER
+#include <csapex/msg/serialized_token_channel.h>
+
+/// PROJECT
+#include <csapex/model/token.h>
+#include <csapex/model/token_data.h>
+#include <csapex/serialization/message_serializer.h>
+
+using namespace csapex;
+
+SerializedTokenChannelPtr SerializedTokenChannel::create(const std::string& channel, std::size_t capacity)
+{
+    return SerializedTokenChannelPtr(new SerializedTokenChannel(SharedMemoryRing::create(channel, capacity)));
+}
+
+SerializedTokenChannelPtr SerializedTokenChannel::open(const std::string& channel)
+{
+    return SerializedTokenChannelPtr(new SerializedTokenChannel(SharedMemoryRing::open(channel)));
+}
+
+SerializedTokenChannel::SerializedTokenChannel(SharedMemoryRingPtr ring)
+    : ring_(ring)
+{
+}
+
+SharedMemoryRingPtr SerializedTokenChannel::getRing() const
+{
+    return ring_;
+}
+
+bool SerializedTokenChannel::publish(const TokenConstPtr& token, std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(publish_mtx_);
+
+    // the buffer keeps its capacity, so encoding does not allocate once it is large enough
+    publish_buffer_.resize(SerializationBuffer::HEADER_LENGTH);
+    publish_buffer_ << static_cast<int32_t>(token->getSequenceNumber());
+    publish_buffer_ << static_cast<uint8_t>(token->getActivityModifier());
+    MessageSerializer::serializeMessage(*token->getTokenData(), publish_buffer_);
+
+    // the length header of the buffer is not needed, the ring stores the length of each record
+    const uint8_t* record = publish_buffer_.data() + SerializationBuffer::HEADER_LENGTH;
+    std::size_t length = publish_buffer_.size() - SerializationBuffer::HEADER_LENGTH;
+
+    return ring_->write(record, length, timeout);
+}
+
+TokenPtr SerializedTokenChannel::receive(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(receive_mtx_);
+
+    // the decoders read from a SerializationBuffer, so the record is copied once, into a reused buffer
+    SerializationBuffer& buffer = receive_buffer_;
+    bool received = ring_->read([&buffer](const uint8_t* record, std::size_t length) {
+        buffer.resize(SerializationBuffer::HEADER_LENGTH);
+        buffer.appendBytes(record, length);
+        buffer.seek(SerializationBuffer::HEADER_LENGTH);
+    }, timeout);
+
+    if(!received) {
+        return nullptr;
+    }
+
+    int32_t sequence_number;
+    uint8_t activity;
+    buffer >> sequence_number >> activity;
+
+    TokenPtr token = Token::make(MessageSerializer::deserializeMessage(buffer));
+    token->setSequenceNumber(sequence_number);
+    token->setActivityModifier(static_cast<ActivityModifier>(activity));
+    return token;
+}
@@ -8,6 +8,8 @@
 #include <csapex/utility/assert.h>
 #include <csapex/msg/output_transition.h>
 #include <csapex/msg/no_message.h>
+#include <csapex/msg/any_message.h>
+#include <csapex/msg/invocation_context.h>
 
 /// SYSTEM
 #include <iostream>
@@ -23,9 +25,23 @@ StaticOutput::StaticOutput(const UUID &uuid, ConnectableOwnerWeakPtr owner)
 void StaticOutput::addMessage(TokenPtr message)
 {
     apex_assert_hard(message);
+
+    // concurrent invocations of reentrant nodes buffer their results until they are sent in order
+    if(InvocationContext* context = InvocationContext::current()) {
+        if(context->captures(this)) {
+            context->setToken(this, message);
+            return;
+        }
+    }
+
     const auto& data = message->getTokenData();
     if(!std::dynamic_pointer_cast<connection_types::MarkerMessage const>(data)) {
-        setType(data->toType());
+        // only create a new type if it changes, this is called for every published message
+        TokenDataConstPtr current = getType();
+        if(!current || !current->canConnectTo(data.get()) || !data->canConnectTo(current.get()) ||
+                std::dynamic_pointer_cast<connection_types::AnyMessage const>(current)) {
+            setType(data->toType());
+        }
     }
 
     // update buffer
@@ -37,18 +53,29 @@ void StaticOutput::addMessage(TokenPtr message)
 
 bool StaticOutput::hasMessage()
 {
+    return (bool) getAddedToken();
+}
+
+TokenPtr StaticOutput::getAddedToken()
+{
+    if(const InvocationContext* context = InvocationContext::current()) {
+        if(context->captures(this)) {
+            return context->getToken(this);
+        }
+    }
+
     std::unique_lock<std::recursive_mutex> lock(message_mutex_);
-    return (bool) message_to_send_;
+    return message_to_send_;
 }
 
 
 bool StaticOutput::hasMarkerMessage()
 {
-    std::unique_lock<std::recursive_mutex> lock(message_mutex_);
-    if(!message_to_send_) {
+    TokenPtr message = getAddedToken();
+    if(!message) {
         return false;
     }
-    if(auto m = std::dynamic_pointer_cast<connection_types::MarkerMessage const>(message_to_send_->getTokenData())) {
+    if(auto m = std::dynamic_pointer_cast<connection_types::MarkerMessage const>(message->getTokenData())) {
         if(!std::dynamic_pointer_cast<connection_types::NoMessage const>(m)) {
             return true;
         }
@@ -63,7 +90,7 @@ TokenPtr StaticOutput::getToken() const
     std::unique_lock<std::recursive_mutex> lock(message_mutex_);
 
     if(!committed_message_) {
-        return Token::makeEmpty<connection_types::NoMessage>();
+        return Token::makeShared<connection_types::NoMessage>();
     } else {
         return committed_message_;
     }
@@ -98,7 +125,7 @@ bool StaticOutput::commitMessages(bool is_activated)
             if(!connections_.empty()) {
                 //            std::cout << getUUID() << " sends empty message" << std::endl;
             }
-            committed_message_ = Token::makeEmpty<connection_types::NoMessage>();
+            committed_message_ = Token::makeShared<connection_types::NoMessage>();
         }
 
         ++seq_no_;
@@ -145,11 +172,6 @@ TokenPtr StaticOutput::getToken()
     std::unique_lock<std::recursive_mutex> lock(message_mutex_);
     return committed_message_;
 }
-TokenPtr StaticOutput::getAddedToken()
-{
-    std::unique_lock<std::recursive_mutex> lock(message_mutex_);
-    return message_to_send_;
-}
 
 void StaticOutput::clearBuffer()
 {
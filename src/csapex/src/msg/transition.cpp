@@ -73,7 +73,7 @@ bool Transition::areAllConnections(Connection::State state) const
 {
     std::unique_lock<std::recursive_mutex> lock(sync);
     for(ConnectionPtr connection : connections_) {
-        if(connection->isEnabled() && connection->getState() != state) {
+        if(connection->isEnabled() && connectionState(*connection) != state) {
             return false;
         }
     }
@@ -84,7 +84,7 @@ bool Transition::areAllConnections(Connection::State a, Connection::State b) con
 {
     std::unique_lock<std::recursive_mutex> lock(sync);
     for(ConnectionPtr connection : connections_) {
-        auto s = connection->getState();
+        auto s = connectionState(*connection);
         if(connection->isEnabled() && s != a && s != b) {
             return false;
         }
@@ -96,7 +96,7 @@ bool Transition::areAllConnections(Connection::State a, Connection::State b, Con
 {
     std::unique_lock<std::recursive_mutex> lock(sync);
     for(ConnectionPtr connection : connections_) {
-        auto s = connection->getState();
+        auto s = connectionState(*connection);
         if(connection->isEnabled() && s != a && s != b && s != c) {
             return false;
         }
@@ -108,7 +108,7 @@ bool Transition::isOneConnection(Connection::State state) const
 {
     std::unique_lock<std::recursive_mutex> lock(sync);
     for(ConnectionPtr connection : connections_) {
-        if(connection->isEnabled() && connection->getState() == state) {
+        if(connection->isEnabled() && connectionState(*connection) == state) {
             return true;
         }
     }
@@ -151,6 +151,11 @@ bool Transition::hasActiveConnection() const
 }
 
 
+Connection::State Transition::connectionState(const Connection& connection) const
+{
+    return connection.getState();
+}
+
 void Transition::connectionAdded(Connection */*connection*/)
 {
 
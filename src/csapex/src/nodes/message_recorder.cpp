@@ -0,0 +1,75 @@
+/// HEADER
+#include <csapex/nodes/message_recorder.h>
+
+/// PROJECT
+#include <csapex/core/settings.h>
+#include <csapex/msg/input.h>
+#include <csapex/msg/output.h>
+#include <csapex/msg/io.h>
+#include <csapex/param/parameter_factory.h>
+
+using namespace csapex;
+
+void MessageRecorder::setup(NodeModifier& node_modifier)
+{
+    setupVariadic(node_modifier);
+}
+
+void MessageRecorder::setupParameters(Parameterizable& parameters)
+{
+    setupVariadicParameters(parameters);
+
+    parameters.addParameter(param::ParameterFactory::declareFileOutputPath("file",
+                                                                           param::ParameterDescription("Log file to record into, an existing file is replaced."),
+                                                                           "", std::string("*") + Settings::message_log_extension),
+                            [this](param::Parameter* p) {
+        openLog(p->as<std::string>());
+    });
+}
+
+Input* MessageRecorder::createVariadicInput(TokenDataConstPtr type, const std::string& label, bool /*optional*/)
+{
+    // outputs are recorded independently, a recording must not wait for all of them
+    return VariadicInputs::createVariadicInput(type, label, true);
+}
+
+void MessageRecorder::openLog(const std::string& path)
+{
+    std::unique_lock<std::mutex> lock(writer_mutex_);
+    if(writer_ && writer_->getPath() == path) {
+        return;
+    }
+
+    writer_.reset();
+    if(!path.empty()) {
+        writer_ = std::make_shared<MessageLogWriter>(path);
+    }
+}
+
+void MessageRecorder::process()
+{
+    std::unique_lock<std::mutex> lock(writer_mutex_);
+    if(!writer_) {
+        return;
+    }
+
+    for(const InputPtr& input : variadic_inputs_) {
+        if(msg::hasMessage(input.get())) {
+            TokenDataConstPtr message = msg::getMessage(input.get());
+            OutputPtr source = input->getSource();
+            writer_->write(source ? source->getUUID() : input->getUUID(), *message);
+        }
+    }
+}
+
+void MessageRecorder::tearDown()
+{
+    std::unique_lock<std::mutex> lock(writer_mutex_);
+    writer_.reset();
+}
+
+std::size_t MessageRecorder::getRecordCount() const
+{
+    std::unique_lock<std::mutex> lock(writer_mutex_);
+    return writer_ ? writer_->getRecordCount() : 0;
+}
@@ -1,6 +1,9 @@
 /// HEADER
 #include <csapex/profiling/profile.h>
 
+/// SYSTEM
+#include <memory>
+
 using namespace csapex;
 
 
@@ -51,7 +54,7 @@ const std::vector<Interval::Ptr>& Profile::getIntervals() const
 
 Interval::Ptr Profile::getInterval(const std::size_t index) const
 {
-    return timer_history_.at(index);
+    return std::atomic_load(&timer_history_.at(index));
 }
 
 ProfilerStats Profile::getStats(const std::string& name) const
@@ -1,6 +1,9 @@
 /// HEADER
 #include <csapex/profiling/profiler.h>
 
+/// SYSTEM
+#include <memory>
+
 using namespace csapex;
 
 Profiler::Profiler(bool enabled, int history)
@@ -25,7 +28,8 @@ const Profile& Profiler::getProfile(const std::string& key)
         profile.timer->finished.connect([this](Interval::Ptr) { updated(); });
 
         observe(profile.timer->finished, [this, &profile](Interval::Ptr interval){
-            profile.timer_history_[profile.timer_history_pos_] = interval;
+            // the history is read concurrently, e.g. by the critical path analysis
+            std::atomic_store(&profile.timer_history_[profile.timer_history_pos_], interval);
 
             if(++profile.timer_history_pos_ >= (int) profile.timer_history_.size()) {
                 profile.timer_history_pos_ = 0;
@@ -0,0 +1,137 @@
+/// HEADER
+#include <csapex/scheduling/fused_chain.h>
+
+/// PROJECT
+#include <csapex/scheduling/scheduler.h>
+#include <csapex/scheduling/task.h>
+#include <csapex/scheduling/task_generator.h>
+
+/// SYSTEM
+#include <algorithm>
+
+using namespace csapex;
+
+thread_local FusedChain::Active* FusedChain::active_ = nullptr;
+
+FusedChain::FusedChain(const std::vector<UUID>& members)
+    : members_(members), fused_executions_(0), valid_(true)
+{
+}
+
+std::vector<UUID> FusedChain::getMembers() const
+{
+    return members_;
+}
+
+long FusedChain::getFusedExecutions() const
+{
+    return fused_executions_;
+}
+
+void FusedChain::invalidate()
+{
+    valid_ = false;
+}
+
+bool FusedChain::isValid() const
+{
+    return valid_;
+}
+
+void FusedChain::run(TaskGenerator* generator, const std::function<void()>& execution)
+{
+    if(active_) {
+        // executed inline by this or another chain, which also takes care of the deferred tasks
+        execution();
+        return;
+    }
+
+    Active active;
+    active.chain = this;
+    active.scheduler = generator->getScheduler();
+
+    struct Guard
+    {
+        Guard(Active* active) { active_ = active; }
+        ~Guard() { active_ = nullptr; }
+    } guard(&active);
+
+    execution();
+
+    while(!active.pending.empty()) {
+        Pending next = active.pending.front();
+        active.pending.pop_front();
+        executeInline(active.scheduler, next);
+    }
+}
+
+bool FusedChain::defer(TaskGenerator* generator, const TaskPtr& task)
+{
+    if(!active_ || active_->chain != this || !valid_) {
+        return false;
+    }
+
+    Scheduler* scheduler = generator->getScheduler();
+    if(!scheduler || scheduler != active_->scheduler || task->isScheduled()) {
+        return false;
+    }
+
+    auto pos = std::find_if(active_->pending.begin(), active_->pending.end(), [&task](const Pending& p) {
+        return p.task == task;
+    });
+    if(pos == active_->pending.end()) {
+        active_->pending.push_back(Pending { generator->shared_from_this(), task });
+    }
+    return true;
+}
+
+void FusedChain::executeInline(Scheduler* scheduler, const Pending& pending)
+{
+    TaskGeneratorPtr generator = pending.generator.lock();
+    if(!generator) {
+        // the member has been removed
+        return;
+    }
+    Scheduler* current = generator->getScheduler();
+    if(current != scheduler) {
+        // the member has been moved to another scheduler in the meantime
+        if(current) {
+            current->schedule(pending.task);
+        }
+        return;
+    }
+
+    // the state might have changed since the task was deferred, the scheduler handles pausing and stepping
+    if(!valid_ || generator->isPaused() || generator->isStepping()) {
+        scheduler->schedule(pending.task);
+        return;
+    }
+
+    if(!generator->tryLockExecution()) {
+        // the member is executed elsewhere, the scheduler serializes the task after it
+        scheduler->schedule(pending.task);
+        return;
+    }
+
+    ++fused_executions_;
+
+    try {
+        pending.task->execute();
+    } catch(const std::exception& e) {
+        generator->setError(e.what());
+    } catch(...) {
+        unlock(scheduler, generator.get());
+        throw;
+    }
+
+    unlock(scheduler, generator.get());
+}
+
+void FusedChain::unlock(Scheduler* scheduler, TaskGenerator* generator)
+{
+    for(const TaskPtr& held_back : generator->unlockExecution()) {
+        // held back tasks have been taken from the queue, but are still marked as scheduled
+        held_back->setScheduled(false);
+        scheduler->schedule(held_back);
+    }
+}
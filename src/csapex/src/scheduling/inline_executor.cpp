@@ -0,0 +1,97 @@
+/// HEADER
+#include <csapex/scheduling/inline_executor.h>
+
+/// PROJECT
+#include <csapex/scheduling/task_generator.h>
+#include <csapex/scheduling/thread_group.h>
+
+using namespace csapex;
+
+InlineExecutor::InlineExecutor(ExceptionHandler& handler)
+    : scheduler_(handler, ThreadGroup::DEFAULT_GROUP_ID, "inline")
+{
+    scheduler_.end_step.connect([this]() {
+        checkIfStepIsDone();
+    });
+
+    setPause(false);
+    setSteppingMode(false);
+}
+
+InlineExecutor::~InlineExecutor()
+{
+}
+
+void InlineExecutor::add(TaskGenerator* generator)
+{
+    generator->detach();
+    generator->assignToScheduler(&scheduler_);
+}
+
+void InlineExecutor::remove(TaskGenerator* generator)
+{
+    generator->detach();
+}
+
+void InlineExecutor::start()
+{
+    scheduler_.start();
+}
+
+void InlineExecutor::stop()
+{
+    scheduler_.stop();
+}
+
+void InlineExecutor::clear()
+{
+    bool p = isPaused();
+    setPause(true);
+    scheduler_.clear();
+    setPause(p);
+}
+
+bool InlineExecutor::isRunning() const
+{
+    return scheduler_.isRunning();
+}
+
+InlineScheduler* InlineExecutor::getScheduler()
+{
+    return &scheduler_;
+}
+
+bool InlineExecutor::spinOnce()
+{
+    return scheduler_.spinOnce();
+}
+
+std::size_t InlineExecutor::runUntilIdle()
+{
+    return scheduler_.runUntilIdle();
+}
+
+void InlineExecutor::runFor(std::chrono::steady_clock::duration duration)
+{
+    scheduler_.runFor(duration);
+}
+
+void InlineExecutor::pauseChanged(bool pause)
+{
+    scheduler_.setPause(pause);
+}
+
+void InlineExecutor::steppingChanged(bool step)
+{
+    scheduler_.setSteppingMode(step);
+}
+
+void InlineExecutor::performStep()
+{
+    scheduler_.step();
+}
+
+bool InlineExecutor::isStepDone()
+{
+    return scheduler_.isStepDone();
+}
@@ -0,0 +1,410 @@
+/// HEADER
+#include <csapex/scheduling/inline_scheduler.h>
+
+/// PROJECT
+#include <csapex/scheduling/task.h>
+#include <csapex/scheduling/task_generator.h>
+#include <csapex/utility/assert.h>
+#include <csapex/utility/exceptions.h>
+#include <csapex/core/exception_handler.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <iostream>
+
+using namespace csapex;
+
+namespace
+{
+// idle drivers poll for tasks of other threads in this interval
+const std::chrono::milliseconds IDLE_POLL_INTERVAL(1);
+}
+
+InlineScheduler::InlineScheduler(ExceptionHandler& handler, int id, const std::string& name)
+    : handler_(handler), id_(id), name_(name),
+      executing_(false), has_foreign_(false),
+      running_(false), pause_(false), stepping_(false)
+{
+}
+
+InlineScheduler::~InlineScheduler()
+{
+    std::vector<TaskGeneratorPtr> generators_copy = generators_;
+    for(TaskGeneratorPtr tg : generators_copy) {
+        tg->detach();
+    }
+}
+
+int InlineScheduler::id() const
+{
+    return id_;
+}
+
+std::string InlineScheduler::getName() const
+{
+    return name_;
+}
+
+void InlineScheduler::setName(const std::string& name)
+{
+    name_ = name;
+    scheduler_changed();
+}
+
+void InlineScheduler::setPause(bool pause)
+{
+    if(pause != pause_) {
+        pause_ = pause;
+
+        std::unique_lock<std::recursive_mutex> lock(execution_mtx_);
+        for(auto generator : generators_) {
+            generator->setPause(pause);
+        }
+    }
+}
+
+bool InlineScheduler::isPaused() const
+{
+    return pause_;
+}
+
+bool InlineScheduler::canStartStepping() const
+{
+    std::unique_lock<std::recursive_mutex> lock(execution_mtx_);
+    for(auto generator : generators_) {
+        if(!generator->canStartStepping()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void InlineScheduler::setSteppingMode(bool stepping)
+{
+    stepping_ = stepping;
+
+    std::unique_lock<std::recursive_mutex> lock(execution_mtx_);
+    for(auto generator : generators_) {
+        generator->setSteppingMode(stepping);
+    }
+}
+
+bool InlineScheduler::isStepping() const
+{
+    std::unique_lock<std::recursive_mutex> lock(execution_mtx_);
+    for(auto generator : generators_) {
+        if(generator->isStepping()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool InlineScheduler::isStepDone() const
+{
+    std::unique_lock<std::recursive_mutex> lock(execution_mtx_);
+    for(auto generator : generators_) {
+        if(!generator->isStepDone()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void InlineScheduler::step()
+{
+    begin_step();
+
+    std::unique_lock<std::recursive_mutex> lock(execution_mtx_);
+    for(auto generator : generators_) {
+        generator->step();
+    }
+}
+
+void InlineScheduler::checkIfStepIsDone()
+{
+    if(isStepDone()) {
+        end_step();
+    }
+}
+
+void InlineScheduler::start()
+{
+    running_ = true;
+}
+
+void InlineScheduler::stop()
+{
+    running_ = false;
+    pause_ = false;
+
+    std::unique_lock<std::recursive_mutex> lock(execution_mtx_);
+
+    auto generators = generators_;
+    for(TaskGeneratorPtr tg : generators) {
+        tg->detach();
+    }
+    apex_assert_hard(generators_.empty());
+
+    generator_connections_.clear();
+
+    clear();
+}
+
+bool InlineScheduler::isRunning() const
+{
+    return running_;
+}
+
+void InlineScheduler::clear()
+{
+    std::unique_lock<std::recursive_mutex> lock(execution_mtx_);
+
+    takeForeignTasks();
+    for(const TaskPtr& task : ready_) {
+        task->setScheduled(false);
+    }
+    ready_.clear();
+    delayed_.clear();
+
+    for(auto generator : generators_) {
+        generator->reset();
+    }
+}
+
+bool InlineScheduler::isEmpty() const
+{
+    std::unique_lock<std::recursive_mutex> lock(execution_mtx_);
+    return generators_.empty();
+}
+
+void InlineScheduler::add(TaskGeneratorPtr generator)
+{
+    generator->setPause(pause_);
+    generator->setSteppingMode(stepping_);
+
+    std::unique_lock<std::recursive_mutex> lock(execution_mtx_);
+    generators_.push_back(generator);
+
+    generator_connections_[generator.get()] = generator->end_step.connect([this]() { checkIfStepIsDone(); });
+}
+
+void InlineScheduler::add(TaskGeneratorPtr generator, const std::vector<TaskPtr>& initial_tasks)
+{
+    add(generator);
+
+    for(const TaskPtr& task : initial_tasks) {
+        schedule(task);
+    }
+}
+
+std::vector<TaskPtr> InlineScheduler::remove(TaskGenerator* generator)
+{
+    std::vector<TaskPtr> remaining_tasks;
+
+    std::unique_lock<std::recursive_mutex> lock(execution_mtx_);
+
+    takeForeignTasks();
+    auto owned = [generator](const TaskPtr& task) {
+        return task->getParent() == generator;
+    };
+    for(const TaskPtr& task : ready_) {
+        if(owned(task)) {
+            // the remaining tasks are handed over to the next scheduler
+            task->setScheduled(false);
+            remaining_tasks.push_back(task);
+        }
+    }
+    ready_.erase(std::remove_if(ready_.begin(), ready_.end(), owned), ready_.end());
+
+    for(auto it = delayed_.begin(); it != delayed_.end();) {
+        if(owned(it->second)) {
+            // delayed tasks are executed right away by the next scheduler
+            remaining_tasks.push_back(it->second);
+            it = delayed_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    generators_.erase(std::remove_if(generators_.begin(), generators_.end(), [generator](const TaskGeneratorPtr& g) {
+        return g.get() == generator;
+    }), generators_.end());
+    generator_connections_.erase(generator);
+
+    return remaining_tasks;
+}
+
+bool InlineScheduler::isExecutingThread() const
+{
+    // executing_ is only meaningful for the driving thread itself
+    return driving_thread_.load() == std::this_thread::get_id() && executing_;
+}
+
+void InlineScheduler::schedule(TaskPtr task)
+{
+    if(!task->markScheduled()) {
+        // the task is already queued
+        return;
+    }
+
+    if(isExecutingThread()) {
+        ready_.push_back(task);
+
+    } else {
+        std::unique_lock<std::mutex> lock(foreign_mtx_);
+        foreign_.emplace_back(std::chrono::steady_clock::time_point::min(), task);
+        has_foreign_ = true;
+    }
+}
+
+void InlineScheduler::scheduleDelayed(TaskPtr task, std::chrono::steady_clock::time_point time)
+{
+    if(isExecutingThread()) {
+        delayed_.emplace(time, task);
+
+    } else {
+        std::unique_lock<std::mutex> lock(foreign_mtx_);
+        foreign_.emplace_back(time, task);
+        has_foreign_ = true;
+    }
+}
+
+void InlineScheduler::takeForeignTasks()
+{
+    if(!has_foreign_) {
+        return;
+    }
+
+    std::vector<std::pair<std::chrono::steady_clock::time_point, TaskPtr>> foreign;
+    {
+        std::unique_lock<std::mutex> lock(foreign_mtx_);
+        foreign.swap(foreign_);
+        has_foreign_ = false;
+    }
+
+    for(auto& entry : foreign) {
+        if(entry.first == std::chrono::steady_clock::time_point::min()) {
+            ready_.push_back(std::move(entry.second));
+        } else {
+            delayed_.emplace(entry.first, std::move(entry.second));
+        }
+    }
+}
+
+void InlineScheduler::releaseDueTasks(std::chrono::steady_clock::time_point now)
+{
+    while(!delayed_.empty() && delayed_.begin()->first <= now) {
+        TaskPtr task = delayed_.begin()->second;
+        delayed_.erase(delayed_.begin());
+        if(task->markScheduled()) {
+            ready_.push_back(task);
+        }
+    }
+}
+
+std::chrono::steady_clock::time_point InlineScheduler::getNextDueTime() const
+{
+    std::unique_lock<std::recursive_mutex> lock(execution_mtx_);
+    return delayed_.empty() ? std::chrono::steady_clock::time_point::max() : delayed_.begin()->first;
+}
+
+bool InlineScheduler::spinOnce()
+{
+    // other threads (e.g. the user interface) add, remove and stop generators,
+    // which changes ready_ and delayed_, so a single step has to exclude them
+    std::unique_lock<std::recursive_mutex> lock(execution_mtx_);
+    return spinOnceLocked();
+}
+
+bool InlineScheduler::spinOnceLocked()
+{
+    driving_thread_ = std::this_thread::get_id();
+
+    takeForeignTasks();
+    if(!delayed_.empty()) {
+        releaseDueTasks(std::chrono::steady_clock::now());
+    }
+
+    if(!running_ || pause_ || ready_.empty()) {
+        return false;
+    }
+
+    // last in, first out: the successors of the previous node run next
+    TaskPtr task = std::move(ready_.back());
+    ready_.pop_back();
+
+    task->setScheduled(false);
+
+    // tasks scheduled during the execution are queued directly
+    bool was_executing = executing_;
+    executing_ = true;
+    execute(task);
+    executing_ = was_executing;
+
+    return true;
+}
+
+std::size_t InlineScheduler::runUntilIdle()
+{
+    // the lock is taken once for the whole run instead of once per task
+    std::unique_lock<std::recursive_mutex> lock(execution_mtx_);
+
+    std::size_t executed = 0;
+    while(spinOnceLocked()) {
+        ++executed;
+    }
+    return executed;
+}
+
+void InlineScheduler::runFor(std::chrono::steady_clock::duration duration)
+{
+    auto end = std::chrono::steady_clock::now() + duration;
+
+    while(true) {
+        {
+            // the lock is held for a burst of ready tasks and released while idle,
+            // so that other threads can change the structure in between
+            std::unique_lock<std::recursive_mutex> lock(execution_mtx_);
+            while(spinOnceLocked()) {
+                if(std::chrono::steady_clock::now() >= end) {
+                    return;
+                }
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if(now >= end) {
+            return;
+        }
+
+        // nothing is ready, sleep until the next delayed task or until other threads might have scheduled something
+        auto wake_up = std::min(end, now + IDLE_POLL_INTERVAL);
+        if(running_ && !pause_) {
+            wake_up = std::min(wake_up, getNextDueTime());
+        }
+        std::this_thread::sleep_until(wake_up);
+    }
+}
+
+void InlineScheduler::execute(const TaskPtr& task)
+{
+    try {
+        task->execute();
+
+    } catch(const std::exception& e) {
+        TaskGenerator* gen = task->getParent();
+        if(gen) {
+            gen->setError(e.what());
+        }
+    } catch(const std::string& s) {
+        std::cerr << "Uncaught exception (string) exception: " << s << std::endl;
+
+    } catch(const csapex::Failure& assertion) {
+        handler_.handleAssertionFailure(assertion);
+
+    } catch(...) {
+        std::cerr << "Uncaught exception of unknown type and origin in execution of task " << task->getName() << "!" << std::endl;
+        throw;
+    }
+}
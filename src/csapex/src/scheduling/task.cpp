@@ -4,10 +4,27 @@
 /// PROJECT
 #include <csapex/utility/assert.h>
 
+/// SYSTEM
+#include <algorithm>
+
 using namespace csapex;
 
+namespace
+{
+long long nowInNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::chrono::steady_clock::time_point toTimePoint(long long ns)
+{
+    return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(ns)));
+}
+}
+
 Task::Task(const std::string& name, std::function<void ()> callback, long priority, TaskGenerator *parent)
-    : parent_(parent), name_(name), callback_(callback), priority_(priority), scheduled_(false)
+    : parent_(parent), name_(name), callback_(callback), priority_(priority), scheduled_(false), deadline_(0),
+      scheduled_at_(0), started_at_(0), finished_at_(0)
 {
 
 }
@@ -18,7 +35,14 @@ Task::~Task()
 
 void Task::execute()
 {
-    callback_();
+    started_at_ = nowInNanoseconds();
+    try {
+        callback_();
+    } catch(...) {
+        finished_at_ = nowInNanoseconds();
+        throw;
+    }
+    finished_at_ = nowInNanoseconds();
 }
 
 TaskGenerator* Task::getParent() const
@@ -48,5 +72,67 @@ bool Task::isScheduled() const
 
 void Task::setScheduled(bool scheduled)
 {
+    if(scheduled) {
+        scheduled_at_ = nowInNanoseconds();
+    }
     scheduled_ = scheduled;
 }
+
+bool Task::markScheduled()
+{
+    bool expected = false;
+    if(scheduled_.compare_exchange_strong(expected, true)) {
+        scheduled_at_ = nowInNanoseconds();
+        return true;
+    }
+    return false;
+}
+
+void Task::setDeadline(std::chrono::steady_clock::time_point deadline)
+{
+    deadline_ = std::max<long long>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count());
+}
+
+void Task::clearDeadline()
+{
+    deadline_ = 0;
+}
+
+bool Task::hasDeadline() const
+{
+    return deadline_ != 0;
+}
+
+std::chrono::steady_clock::time_point Task::getDeadline() const
+{
+    return toTimePoint(deadline_);
+}
+
+std::chrono::steady_clock::time_point Task::getScheduleTime() const
+{
+    return toTimePoint(scheduled_at_);
+}
+
+std::chrono::steady_clock::time_point Task::getStartTime() const
+{
+    return toTimePoint(started_at_);
+}
+
+std::chrono::steady_clock::time_point Task::getFinishTime() const
+{
+    return toTimePoint(finished_at_);
+}
+
+std::chrono::nanoseconds Task::getSchedulingDelay() const
+{
+    long long scheduled = scheduled_at_;
+    long long started = started_at_;
+    return std::chrono::nanoseconds(scheduled > 0 && started > scheduled ? started - scheduled : 0);
+}
+
+std::chrono::nanoseconds Task::getRunTime() const
+{
+    long long started = started_at_;
+    long long finished = finished_at_;
+    return std::chrono::nanoseconds(started > 0 && finished > started ? finished - started : 0);
+}
@@ -3,7 +3,58 @@
 
 using namespace csapex;
 
+TaskGenerator::TaskGenerator()
+    : executing_(false)
+{
+
+}
+
 TaskGenerator::~TaskGenerator()
 {
 
 }
+
+bool TaskGenerator::tryLockExecution()
+{
+    bool expected = false;
+    return executing_.compare_exchange_strong(expected, true);
+}
+
+void TaskGenerator::lockExecution()
+{
+    // executing_ is only reset with held_back_mtx_ held, so the notification cannot be missed
+    std::unique_lock<std::mutex> lock(held_back_mtx_);
+    execution_unlocked_.wait(lock, [this]() {
+        return tryLockExecution();
+    });
+}
+
+std::vector<TaskPtr> TaskGenerator::unlockExecution()
+{
+    std::unique_lock<std::mutex> lock(held_back_mtx_);
+    executing_ = false;
+    execution_unlocked_.notify_all();
+
+    std::vector<TaskPtr> held_back;
+    held_back.swap(held_back_);
+    return held_back;
+}
+
+bool TaskGenerator::holdBack(const TaskPtr& task)
+{
+    std::unique_lock<std::mutex> lock(held_back_mtx_);
+    if(!executing_) {
+        return false;
+    }
+
+    held_back_.push_back(task);
+    return true;
+}
+
+std::vector<TaskPtr> TaskGenerator::takeHeldBackTasks()
+{
+    std::unique_lock<std::mutex> lock(held_back_mtx_);
+    std::vector<TaskPtr> held_back;
+    held_back.swap(held_back_);
+    return held_back;
+}
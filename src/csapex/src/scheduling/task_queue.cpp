@@ -0,0 +1,159 @@
+/// HEADER
+#include <csapex/scheduling/task_queue.h>
+
+/// PROJECT
+#include <csapex/scheduling/task.h>
+
+/// SYSTEM
+#include <algorithm>
+
+using namespace csapex;
+
+int TaskQueue::levelOf(long priority)
+{
+    return (int) (std::max<long>(MIN_PRIORITY, std::min<long>(MAX_PRIORITY, priority)) - MIN_PRIORITY);
+}
+
+TaskQueue::TaskQueue(std::size_t capacity_per_level)
+    : capacity_(capacity_per_level), size_(0), overflow_size_(0),
+      deadline_order_(0), deadline_size_(0)
+{
+    for(int level = 0; level < PRIORITY_LEVELS; ++level) {
+        rings_[level].store(nullptr);
+    }
+}
+
+TaskQueue::~TaskQueue()
+{
+    for(int level = 0; level < PRIORITY_LEVELS; ++level) {
+        delete rings_[level].load();
+    }
+}
+
+TaskQueue::Ring* TaskQueue::getRing(int level)
+{
+    // rings are only allocated for priority levels that are actually used
+    Ring* ring = rings_[level].load(std::memory_order_acquire);
+    if(!ring) {
+        Ring* new_ring = new Ring(capacity_);
+        if(rings_[level].compare_exchange_strong(ring, new_ring, std::memory_order_acq_rel)) {
+            ring = new_ring;
+        } else {
+            delete new_ring;
+        }
+    }
+    return ring;
+}
+
+bool TaskQueue::DeadlineEntry::operator < (const DeadlineEntry& other) const
+{
+    // std::push_heap builds a max heap, the earliest deadline has to compare greatest
+    if(deadline != other.deadline) {
+        return deadline > other.deadline;
+    }
+    return order > other.order;
+}
+
+void TaskQueue::push(const TaskPtr& task)
+{
+    if(task->hasDeadline()) {
+        // the key is copied, so that the deadline of a queued task can be changed safely
+        long long deadline = std::chrono::duration_cast<std::chrono::nanoseconds>(task->getDeadline().time_since_epoch()).count();
+
+        std::unique_lock<std::mutex> lock(deadline_mtx_);
+        deadline_heap_.push_back(DeadlineEntry { deadline, deadline_order_++, task });
+        std::push_heap(deadline_heap_.begin(), deadline_heap_.end());
+        ++deadline_size_;
+        ++size_;
+        return;
+    }
+
+    int level = levelOf(task->getPriority());
+
+    ++size_;
+    Ring* ring = getRing(level);
+    if(overflow_size_ == 0 && ring->push(task)) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(overflow_mtx_);
+    // the spill state is only changed under this lock: as long as no task of this level
+    // has spilled, the ring may have space again and the task can stay lock-free
+    if(overflow_[level].empty() && ring->push(task)) {
+        return;
+    }
+    overflow_[level].push_back(task);
+    ++overflow_size_;
+}
+
+TaskPtr TaskQueue::pop()
+{
+    if(size_ == 0) {
+        return nullptr;
+    }
+
+    TaskPtr task;
+
+    if(deadline_size_ > 0) {
+        std::unique_lock<std::mutex> lock(deadline_mtx_);
+        if(!deadline_heap_.empty()) {
+            std::pop_heap(deadline_heap_.begin(), deadline_heap_.end());
+            task = std::move(deadline_heap_.back().task);
+            deadline_heap_.pop_back();
+            --deadline_size_;
+            --size_;
+            return task;
+        }
+    }
+
+    if(overflow_size_ == 0) {
+        for(int level = PRIORITY_LEVELS - 1; level >= 0; --level) {
+            Ring* ring = rings_[level].load(std::memory_order_acquire);
+            if(ring && ring->pop(task)) {
+                break;
+            }
+        }
+    }
+
+    if(!task) {
+        // either tasks have spilled, or a push is spilling right now:
+        // decide under the lock, the overflow lists are only consistent there
+        std::unique_lock<std::mutex> lock(overflow_mtx_);
+        for(int level = PRIORITY_LEVELS - 1; level >= 0; --level) {
+            Ring* ring = rings_[level].load(std::memory_order_acquire);
+            if(ring && ring->pop(task)) {
+                break;
+            }
+            if(!overflow_[level].empty()) {
+                task = overflow_[level].front();
+                overflow_[level].pop_front();
+                --overflow_size_;
+                break;
+            }
+        }
+    }
+
+    if(task) {
+        --size_;
+    }
+    return task;
+}
+
+std::vector<TaskPtr> TaskQueue::drain()
+{
+    std::vector<TaskPtr> tasks;
+    while(TaskPtr task = pop()) {
+        tasks.push_back(task);
+    }
+    return tasks;
+}
+
+std::size_t TaskQueue::size() const
+{
+    return size_;
+}
+
+bool TaskQueue::empty() const
+{
+    return size_ == 0;
+}
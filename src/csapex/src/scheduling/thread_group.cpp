@@ -7,23 +7,101 @@
 #include <csapex/scheduling/task_generator.h>
 #include <csapex/utility/assert.h>
 #include <csapex/utility/cpu_affinity.h>
+#include <csapex/utility/cpu_topology.h>
 #include <csapex/utility/exceptions.h>
 #include <csapex/core/exception_handler.h>
 #include <csapex/scheduling/timed_queue.h>
 
 /// SYSTEM
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
 #include <yaml-cpp/yaml.h>
+#ifndef WIN32
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
 
 using namespace csapex;
 
+namespace
+{
+const long DEFAULT_SPIN_US = 50;
+const long DEFAULT_IDLE_TIMEOUT_MS = 10000;
+const std::size_t DEFAULT_GROW_THRESHOLD = 2;
+
+long long nowInNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#ifndef WIN32
+const int SCHED_DEADLINE_POLICY = 6;
+
+// glibc has no wrapper for sched_setattr
+struct SchedAttr
+{
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;
+    uint64_t sched_deadline;
+    uint64_t sched_period;
+};
+#endif
+
+void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+}
+
 int ThreadGroup::next_id_ = ThreadGroup::MINIMUM_THREAD_ID;
+const std::chrono::milliseconds ThreadGroup::UTILIZATION_WINDOW(100);
+thread_local ThreadGroup::Worker* ThreadGroup::current_worker_ = nullptr;
+
+ThreadGroup::Worker::Worker(ThreadGroup *group, std::size_t index)
+    : group(group), index(index), tid(0), live(false), live_since(0)
+{
+}
+
+ThreadGroup::Telemetry::Telemetry()
+    : queue_depth(Histogram::exponential(32)),
+      scheduling_delay(Histogram::exponential()),
+      run_time(Histogram::exponential()),
+      utilization(Histogram::linear(10, 11))
+{
+}
+
+ThreadGroup::RealtimeParameters::RealtimeParameters()
+    : policy(RealtimePolicy::NONE), priority(0),
+      runtime(0), deadline(0), period(0)
+{
+}
 
 ThreadGroup::ThreadGroup(TimedQueuePtr timed_queue, ExceptionHandler& handler, int id, std::string name)
     : handler_(handler), destroyed_(false),
       id_(id), name_(name),
       cpu_affinity_(new CpuAffinity),
+      numa_node_(-1), local_payloads_(false),
       timed_queue_(timed_queue),
+      allocated_workers_(0), active_workers_(0), next_worker_(0), live_workers_(0),
+      queued_tasks_(0), sleeping_workers_(0),
+      elastic_(false), idle_timeout_ms_(DEFAULT_IDLE_TIMEOUT_MS), grow_threshold_(DEFAULT_GROW_THRESHOLD),
+      load_reset_at_(nowInNanoseconds()), busy_ns_(0), live_ns_(0), started_workers_(0), released_workers_(0),
+      utilization_window_start_(nowInNanoseconds()), utilization_window_busy_ns_(0),
+      wait_policy_(WaitPolicy::BLOCK), spin_duration_us_(DEFAULT_SPIN_US),
+      wake_requested_at_(0), wake_ups_(0), wake_latency_sum_(0), wake_latency_max_(0),
+      pending_worker_count_(0), resizing_(false),
       running_(false), pause_(false), stepping_(false)
 {
     next_id_ = std::max(next_id_, id + 1);
@@ -33,7 +111,16 @@ ThreadGroup::ThreadGroup(TimedQueuePtr timed_queue, ExceptionHandler &handler, s
     : handler_(handler), destroyed_(false),
       id_(next_id_++), name_(name),
       cpu_affinity_(new CpuAffinity),
+      numa_node_(-1), local_payloads_(false),
       timed_queue_(timed_queue),
+      allocated_workers_(0), active_workers_(0), next_worker_(0), live_workers_(0),
+      queued_tasks_(0), sleeping_workers_(0),
+      elastic_(false), idle_timeout_ms_(DEFAULT_IDLE_TIMEOUT_MS), grow_threshold_(DEFAULT_GROW_THRESHOLD),
+      load_reset_at_(nowInNanoseconds()), busy_ns_(0), live_ns_(0), started_workers_(0), released_workers_(0),
+      utilization_window_start_(nowInNanoseconds()), utilization_window_busy_ns_(0),
+      wait_policy_(WaitPolicy::BLOCK), spin_duration_us_(DEFAULT_SPIN_US),
+      wake_requested_at_(0), wake_ups_(0), wake_latency_sum_(0), wake_latency_max_(0),
+      pending_worker_count_(0), resizing_(false),
       running_(false), pause_(false), stepping_(false)
 {
     setup();
@@ -41,13 +128,15 @@ ThreadGroup::ThreadGroup(TimedQueuePtr timed_queue, ExceptionHandler &handler, s
 
 ThreadGroup::~ThreadGroup()
 {
+    if(resize_thread_.joinable()) {
+        resize_thread_.join();
+    }
+
     std::vector<TaskGeneratorPtr> generators_copy = generators_;
     for(TaskGeneratorPtr tg : generators_copy) {
         tg->detach();
     }
-    if(running_ || scheduler_thread_.joinable()) {
-        stop();
-    }
+    stop();
     destroyed_ = true;
 }
 
@@ -56,17 +145,30 @@ void ThreadGroup::setup()
     cpu_affinity_->affinity_changed.connect([this](const CpuAffinity*){
         updateAffinity();
     });
+    numa_node_ = CpuTopology::instance().getNumaNodeOf(getCpuAffinity()->get());
+
+    createWorkers(1);
 }
 
 void ThreadGroup::updateAffinity()
 {
-    if(!scheduler_thread_.joinable()) {
-        return;
+    numa_node_ = CpuTopology::instance().getNumaNodeOf(getCpuAffinity()->get());
+
+    std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+    for(std::size_t i = 0, n = allocated_workers_; i < n; ++i) {
+        applyAffinity(workers_[i].get());
     }
+}
 
+void ThreadGroup::applyAffinity(Worker* worker)
+{
 #if WIN32
     // TODO: implement for other platforms
 #else
+    if(!worker->live || !worker->thread.joinable()) {
+        return;
+    }
+
     cpu_set_t cpuset;
     CPU_ZERO(&cpuset);
     const std::vector<bool>& cpus = getCpuAffinity()->get();
@@ -75,13 +177,64 @@ void ThreadGroup::updateAffinity()
             CPU_SET(cpu, &cpuset);
         }
     }
-    int rc = pthread_setaffinity_np(scheduler_thread_.native_handle(), sizeof(cpu_set_t), &cpuset);
+
+    int rc = pthread_setaffinity_np(worker->thread.native_handle(), sizeof(cpu_set_t), &cpuset);
     if(rc != 0) {
         std::cerr << "failed to set cpu affinity in thread " << name_ << std::endl;
     }
 #endif
 }
 
+void ThreadGroup::updateRealtimeParameters()
+{
+    std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+    for(std::size_t i = 0, n = allocated_workers_; i < n; ++i) {
+        const auto& worker = workers_[i];
+        if(!worker->live || !worker->thread.joinable()) {
+            continue;
+        }
+        applyRealtimeParameters(worker.get(), worker->thread.native_handle());
+    }
+}
+
+void ThreadGroup::applyRealtimeParameters(Worker* worker, std::thread::native_handle_type handle)
+{
+#if WIN32
+    // TODO: implement for other platforms
+#else
+    RealtimeParameters parameters = getRealtimeParameters();
+
+    if(parameters.policy == RealtimePolicy::DEADLINE) {
+#ifdef SYS_sched_setattr
+        if(worker->tid == 0) {
+            // the worker applies the parameters itself when it is started
+            return;
+        }
+        SchedAttr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.sched_policy = SCHED_DEADLINE_POLICY;
+        attr.sched_runtime = std::chrono::duration_cast<std::chrono::nanoseconds>(parameters.runtime).count();
+        attr.sched_deadline = std::chrono::duration_cast<std::chrono::nanoseconds>(parameters.deadline).count();
+        attr.sched_period = std::chrono::duration_cast<std::chrono::nanoseconds>(parameters.period).count();
+        if(syscall(SYS_sched_setattr, worker->tid.load(), &attr, 0) != 0) {
+            std::cerr << "failed to set deadline scheduling in thread " << name_ << ": " << std::strerror(errno) << std::endl;
+        }
+#else
+        std::cerr << "deadline scheduling is not supported on this platform" << std::endl;
+#endif
+
+    } else {
+        sched_param param;
+        param.sched_priority = parameters.policy == RealtimePolicy::FIFO ? parameters.priority : 0;
+        int rc = pthread_setschedparam(handle, parameters.policy == RealtimePolicy::FIFO ? SCHED_FIFO : SCHED_OTHER, &param);
+        if(rc != 0) {
+            std::cerr << "failed to set scheduling policy in thread " << name_ << ": " << std::strerror(rc) << std::endl;
+        }
+    }
+#endif
+}
+
 int ThreadGroup::nextId()
 {
     return next_id_;
@@ -109,9 +262,462 @@ CpuAffinityPtr ThreadGroup::getCpuAffinity() const
     return cpu_affinity_;
 }
 
-const std::thread& ThreadGroup::thread() const
+void ThreadGroup::setNumaNode(int node)
+{
+    std::vector<bool> cpus = CpuTopology::instance().getNumaNodeCpus(node);
+    cpus.resize(cpu_affinity_->getNumCpus(), false);
+    cpu_affinity_->set(cpus);
+}
+
+int ThreadGroup::getNumaNode() const
+{
+    return numa_node_;
+}
+
+void ThreadGroup::setLocalPayloads(bool local)
+{
+    local_payloads_ = local;
+}
+
+bool ThreadGroup::hasLocalPayloads() const
+{
+    return local_payloads_;
+}
+
+void ThreadGroup::setWorkerCount(std::size_t workers)
+{
+    workers = std::max<std::size_t>(1, std::min<std::size_t>(MAX_WORKERS, workers));
+
+    if(current_worker_ && current_worker_->group == this) {
+        // a worker cannot join itself, the change is applied once its task has finished
+        deferWorkerCount(workers);
+        return;
+    }
+
+    applyWorkerCount(workers);
+}
+
+void ThreadGroup::deferWorkerCount(std::size_t workers)
+{
+    std::unique_lock<std::mutex> lock(resize_mtx_);
+    pending_worker_count_ = workers;
+    if(resizing_) {
+        // the running resize thread picks up the new count
+        return;
+    }
+    resizing_ = true;
+
+    if(resize_thread_.joinable()) {
+        // the previous resize thread has already finished
+        resize_thread_.join();
+    }
+    resize_thread_ = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(resize_mtx_);
+        while(pending_worker_count_ != 0) {
+            std::size_t count = pending_worker_count_;
+            pending_worker_count_ = 0;
+
+            lock.unlock();
+            applyWorkerCount(count);
+            lock.lock();
+        }
+        resizing_ = false;
+    });
+}
+
+void ThreadGroup::applyWorkerCount(std::size_t workers)
+{
+    // resizes are requested by external threads and by the resize thread, stop() must not interleave with them
+    std::unique_lock<std::mutex> workers_lock(workers_mtx_);
+    if(workers == active_workers_) {
+        return;
+    }
+
+    bool was_running;
+    {
+        std::unique_lock<std::recursive_mutex> lock(state_mtx_);
+        was_running = running_;
+    }
+    if(was_running) {
+        stopWorkers();
+    }
+
+    createWorkers(workers);
+
+    if(was_running) {
+        startWorkers();
+    }
+
+    scheduler_changed();
+}
+
+std::size_t ThreadGroup::getWorkerCount() const
+{
+    return active_workers_;
+}
+
+void ThreadGroup::setElastic(bool elastic)
+{
+    if(elastic == elastic_) {
+        return;
+    }
+    elastic_ = elastic;
+
+    std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+    if(elastic) {
+        // idle workers are released after the timeout
+        work_available_.notify_all();
+
+    } else if(running_) {
+        for(std::size_t i = 0, n = active_workers_; i < n; ++i) {
+            if(!workers_[i]->live) {
+                startWorker(workers_[i].get());
+            }
+        }
+    }
+
+    scheduler_changed();
+}
+
+bool ThreadGroup::isElastic() const
+{
+    return elastic_;
+}
+
+void ThreadGroup::setIdleTimeout(std::chrono::milliseconds timeout)
+{
+    idle_timeout_ms_ = std::max<long>(0, timeout.count());
+
+    std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+    work_available_.notify_all();
+}
+
+std::chrono::milliseconds ThreadGroup::getIdleTimeout() const
+{
+    return std::chrono::milliseconds(idle_timeout_ms_.load());
+}
+
+void ThreadGroup::setGrowThreshold(std::size_t tasks_per_worker)
+{
+    grow_threshold_ = tasks_per_worker;
+}
+
+std::size_t ThreadGroup::getGrowThreshold() const
+{
+    return grow_threshold_;
+}
+
+ThreadGroup::Load ThreadGroup::getLoad() const
+{
+    long long now = nowInNanoseconds();
+    long long since = load_reset_at_;
+
+    long long live_ns = live_ns_;
+    for(std::size_t i = 0, n = allocated_workers_; i < n; ++i) {
+        const auto& worker = workers_[i];
+        if(worker->live) {
+            live_ns += now - std::max(since, worker->live_since.load());
+        }
+    }
+
+    Load load;
+    load.running_workers = live_workers_;
+    load.queued_tasks = queued_tasks_;
+    load.utilization = live_ns > 0 ? std::min(1.0, busy_ns_ / (double) live_ns) : 0.0;
+    load.started_workers = started_workers_;
+    load.released_workers = released_workers_;
+    return load;
+}
+
+void ThreadGroup::resetLoad()
+{
+    load_reset_at_ = nowInNanoseconds();
+    busy_ns_ = 0;
+    live_ns_ = 0;
+    started_workers_ = 0;
+    released_workers_ = 0;
+}
+
+ThreadGroup::Telemetry ThreadGroup::getTelemetry() const
+{
+    return telemetry_;
+}
+
+void ThreadGroup::resetTelemetry()
+{
+    telemetry_.queue_depth.reset();
+    telemetry_.scheduling_delay.reset();
+    telemetry_.run_time.reset();
+    telemetry_.utilization.reset();
+
+    utilization_window_start_ = nowInNanoseconds();
+    utilization_window_busy_ns_ = 0;
+}
+
+void ThreadGroup::saveTelemetry(YAML::Node& node) const
+{
+    Load load = getLoad();
+    node["running_workers"] = load.running_workers;
+    node["queued_tasks"] = load.queued_tasks;
+    node["utilization"] = load.utilization;
+
+    Telemetry telemetry = getTelemetry();
+    YAML::Node queue_depth;
+    telemetry.queue_depth.save(queue_depth);
+    node["queue_depth"] = queue_depth;
+
+    YAML::Node scheduling_delay;
+    telemetry.scheduling_delay.save(scheduling_delay);
+    node["scheduling_delay_ns"] = scheduling_delay;
+
+    YAML::Node run_time;
+    telemetry.run_time.save(run_time);
+    node["run_time_ns"] = run_time;
+
+    YAML::Node utilization;
+    telemetry.utilization.save(utilization);
+    node["utilization_percent"] = utilization;
+}
+
+void ThreadGroup::setWaitPolicy(WaitPolicy policy)
+{
+    wait_policy_ = policy;
+
+    // sleeping workers start polling with the next task
+    std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+    work_available_.notify_all();
+}
+
+ThreadGroup::WaitPolicy ThreadGroup::getWaitPolicy() const
+{
+    return wait_policy_;
+}
+
+void ThreadGroup::setSpinDuration(std::chrono::microseconds duration)
+{
+    spin_duration_us_ = std::max<long>(0, duration.count());
+}
+
+std::chrono::microseconds ThreadGroup::getSpinDuration() const
+{
+    return std::chrono::microseconds(spin_duration_us_.load());
+}
+
+void ThreadGroup::setRealtimeParameters(const RealtimeParameters& parameters)
+{
+    {
+        std::unique_lock<std::mutex> lock(realtime_mtx_);
+        realtime_ = parameters;
+    }
+    updateRealtimeParameters();
+}
+
+ThreadGroup::RealtimeParameters ThreadGroup::getRealtimeParameters() const
+{
+    std::unique_lock<std::mutex> lock(realtime_mtx_);
+    return realtime_;
+}
+
+std::string ThreadGroup::realtimePolicyToString(RealtimePolicy policy)
+{
+    switch(policy) {
+    case RealtimePolicy::FIFO:
+        return "fifo";
+    case RealtimePolicy::DEADLINE:
+        return "deadline";
+    default:
+        return "none";
+    }
+}
+
+ThreadGroup::RealtimePolicy ThreadGroup::realtimePolicyFromString(const std::string& policy)
+{
+    if(policy == "fifo") {
+        return RealtimePolicy::FIFO;
+    } else if(policy == "deadline") {
+        return RealtimePolicy::DEADLINE;
+    } else if(policy == "none") {
+        return RealtimePolicy::NONE;
+    }
+    throw std::runtime_error(std::string("unknown real time policy: ") + policy);
+}
+
+ThreadGroup::WakeLatency ThreadGroup::getWakeLatency() const
+{
+    WakeLatency latency;
+    latency.wake_ups = wake_ups_;
+    latency.mean = std::chrono::nanoseconds(latency.wake_ups > 0 ? wake_latency_sum_ / (long long) latency.wake_ups : 0);
+    latency.max = std::chrono::nanoseconds(wake_latency_max_.load());
+    return latency;
+}
+
+void ThreadGroup::resetWakeLatency()
+{
+    wake_ups_ = 0;
+    wake_latency_sum_ = 0;
+    wake_latency_max_ = 0;
+}
+
+std::string ThreadGroup::waitPolicyToString(WaitPolicy policy)
+{
+    switch(policy) {
+    case WaitPolicy::SPIN_THEN_PARK:
+        return "spin_then_park";
+    case WaitPolicy::BUSY_POLL:
+        return "busy_poll";
+    default:
+        return "block";
+    }
+}
+
+ThreadGroup::WaitPolicy ThreadGroup::waitPolicyFromString(const std::string& policy)
+{
+    if(policy == "spin_then_park") {
+        return WaitPolicy::SPIN_THEN_PARK;
+    } else if(policy == "busy_poll") {
+        return WaitPolicy::BUSY_POLL;
+    } else if(policy == "block") {
+        return WaitPolicy::BLOCK;
+    }
+    throw std::runtime_error(std::string("unknown wait policy: ") + policy);
+}
+
+void ThreadGroup::createWorkers(std::size_t count)
+{
+    std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+
+    std::vector<TaskPtr> queued = drainTasks();
+
+    for(std::size_t i = allocated_workers_; i < count; ++i) {
+        workers_[i].reset(new Worker(this, i));
+        ++allocated_workers_;
+    }
+    active_workers_ = count;
+
+    // redistribute the tasks that were queued before
+    for(const TaskPtr& task : queued) {
+        enqueue(selectWorker(), task);
+    }
+}
+
+void ThreadGroup::startWorkers()
+{
+    std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+
+    running_ = true;
+
+    // elastic groups start with one worker and grow with their queue
+    std::size_t n = elastic_ ? std::min<std::size_t>(1, active_workers_) : active_workers_.load();
+    for(std::size_t i = 0; i < n; ++i) {
+        startWorker(workers_[i].get());
+    }
+
+    growIfNeeded();
+}
+
+void ThreadGroup::startWorker(Worker* w)
+{
+    if(w->thread.joinable()) {
+        // the thread of a released worker has already left its scheduling loop
+        w->thread.join();
+    }
+
+    w->live_since = nowInNanoseconds();
+    w->live = true;
+    ++live_workers_;
+    ++started_workers_;
+
+    w->thread = std::thread ([this, w]() {
+        csapex::thread::set_name((name_).c_str());
+
+#ifndef WIN32
+        w->tid = syscall(SYS_gettid);
+        if(getRealtimeParameters().policy != RealtimePolicy::NONE) {
+            applyRealtimeParameters(w, pthread_self());
+        }
+#endif
+
+        schedulingLoop(w);
+    });
+
+    applyAffinity(w);
+}
+
+void ThreadGroup::growIfNeeded()
+{
+    if(!elastic_ || !running_ || sleeping_workers_ > 0) {
+        return;
+    }
+
+    std::size_t live = live_workers_;
+    if(live >= active_workers_ || (live > 0 && queued_tasks_ <= grow_threshold_ * live)) {
+        return;
+    }
+
+    std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+
+    // check again, another thread might have started a worker in the meantime
+    live = live_workers_;
+    if(!running_ || live >= active_workers_ || (live > 0 && queued_tasks_ <= grow_threshold_ * live)) {
+        return;
+    }
+
+    for(std::size_t i = 0, n = active_workers_; i < n; ++i) {
+        if(!workers_[i]->live) {
+            startWorker(workers_[i].get());
+            return;
+        }
+    }
+}
+
+void ThreadGroup::releaseWorker(Worker* w)
 {
-    return scheduler_thread_;
+    // called by the worker itself with tasks_mtx_ held
+    live_ns_ += nowInNanoseconds() - std::max(load_reset_at_.load(), w->live_since.load());
+    w->live = false;
+    --live_workers_;
+    ++released_workers_;
+}
+
+void ThreadGroup::stopWorkers()
+{
+    running_ = false;
+    {
+        std::unique_lock<std::recursive_mutex> lock(state_mtx_);
+        pause_changed_.notify_all();
+    }
+    {
+        std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+        work_available_.notify_all();
+    }
+
+    // no worker can be started anymore, since running_ was checked with tasks_mtx_ held
+    for(std::size_t i = 0, n = allocated_workers_; i < n; ++i) {
+        Worker* w = workers_[i].get();
+        if(w->thread.joinable()) {
+            w->thread.join();
+        }
+    }
+
+    std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+    for(std::size_t i = 0, n = allocated_workers_; i < n; ++i) {
+        Worker* w = workers_[i].get();
+        if(w->live) {
+            releaseWorker(w);
+            // stopped workers are not counted as released by the elastic policy
+            --released_workers_;
+        }
+    }
+}
+
+std::vector<std::unique_lock<std::recursive_mutex>> ThreadGroup::lockExecution() const
+{
+    // always lock in the same order to prevent dead locks between workers
+    std::vector<std::unique_lock<std::recursive_mutex>> locks;
+    for(std::size_t i = 0, n = allocated_workers_; i < n; ++i) {
+        locks.emplace_back(workers_[i]->execution_mtx);
+    }
+    return locks;
 }
 
 std::size_t ThreadGroup::size() const
@@ -164,7 +770,7 @@ void ThreadGroup::step()
 {
     begin_step();
 
-    std::unique_lock<std::recursive_mutex> state_lock(execution_mtx_);
+    auto execution_locks = lockExecution();
     for(auto generator : generators_) {
         generator->step();
     }
@@ -208,27 +814,14 @@ bool ThreadGroup::isStepDone() const
 
 void ThreadGroup::start()
 {
-    std::unique_lock<std::recursive_mutex> lock(state_mtx_);
-    if(scheduler_thread_.joinable()) {
-        running_ = false;
-        pause_changed_.notify_all();
-        lock.unlock();
-
-        scheduler_thread_.join();
-    }
-
-    running_ = true;
-
-    scheduler_thread_ = std::thread ([this]() {
-        csapex::thread::set_name((name_).c_str());
-        updateAffinity();
-
-        schedulingLoop();
-    });
+    std::unique_lock<std::mutex> workers_lock(workers_mtx_);
+    stopWorkers();
+    startWorkers();
 }
 
 void ThreadGroup::stop()
 {
+    std::unique_lock<std::mutex> workers_lock(workers_mtx_);
     {
         std::unique_lock<std::recursive_mutex> lock(state_mtx_);
         running_ = false;
@@ -236,16 +829,12 @@ void ThreadGroup::stop()
         pause_changed_.notify_all();
     }
     {
-        std::unique_lock<std::recursive_mutex> state_lock(execution_mtx_);
+        auto execution_locks = lockExecution();
     }
     {
-        std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
-        work_available_.notify_all();
-        if(scheduler_thread_.joinable()) {
-            lock.unlock();
+        stopWorkers();
 
-            scheduler_thread_.join();
-        }
+        std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
 
         auto gen = generators_;
         for(TaskGeneratorPtr tg : gen) {
@@ -270,10 +859,17 @@ void ThreadGroup::clear()
 {
     {
         std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
-        tasks_.clear();
+        for(const TaskPtr& task : drainTasks()) {
+            task->setScheduled(false);
+        }
+        for(auto generator : generators_) {
+            for(const TaskPtr& task : generator->takeHeldBackTasks()) {
+                task->setScheduled(false);
+            }
+        }
     }
 
-    std::unique_lock<std::recursive_mutex> state_lock(execution_mtx_);
+    auto execution_locks = lockExecution();
     for(auto generator : generators_) {
         generator->reset();
     }
@@ -323,15 +919,20 @@ std::vector<TaskPtr> ThreadGroup::remove(TaskGenerator* generator)
 
     TaskGeneratorPtr removed;
 
-    for(auto it = tasks_.begin(); it != tasks_.end();) {
-        TaskPtr task = *it;
+    for(const TaskPtr& task : drainTasks()) {
         if(task->getParent() == generator) {
             remaining_tasks.push_back(task);
-            it = tasks_.erase(it);
         } else {
-            ++it;
+            enqueue(selectWorker(), task);
         }
     }
+    std::vector<TaskPtr> held_back = generator->takeHeldBackTasks();
+    remaining_tasks.insert(remaining_tasks.end(), held_back.begin(), held_back.end());
+
+    // the remaining tasks are handed over to the next scheduler
+    for(const TaskPtr& task : remaining_tasks) {
+        task->setScheduled(false);
+    }
 
     for(auto it = generators_.begin(); it != generators_.end();) {
         if(it->get() == generator) {
@@ -355,38 +956,100 @@ void ThreadGroup::schedule(TaskPtr task)
 {
     apex_assert_hard(!destroyed_);
 
-    std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+    if(!task->markScheduled()) {
+        // the task is already queued
+        return;
+    }
 
-    if(!tasks_.empty()) {
-//        for(TaskPtr t : tasks_) {
-        for(auto it = tasks_.begin(); it != tasks_.end(); ++it) {
-            const TaskPtr& t = *it;
-            if(t.get() == task.get()) {
-                return;
-            }
-        }
+    enqueue(selectWorker(), task);
+
+    telemetry_.queue_depth.record(queued_tasks_);
+}
+
+ThreadGroup::Worker* ThreadGroup::selectWorker()
+{
+    // tasks scheduled by a worker of this group stay local
+    if(current_worker_ && current_worker_->group == this && current_worker_->index < active_workers_) {
+        return current_worker_;
     }
 
-    tasks_.insert(task);
+    std::size_t n = active_workers_;
+    apex_assert_hard(n > 0);
+    return workers_[next_worker_++ % n].get();
+}
 
-    task->setScheduled(true);
+void ThreadGroup::enqueue(Worker* worker, const TaskPtr& task)
+{
+    if(task->hasDeadline()) {
+        deadline_tasks_.push(task);
+    } else {
+        worker->tasks.push(task);
+    }
+    if(queued_tasks_++ == 0) {
+        // the group was idle, the wake latency is measured from here
+        wake_requested_at_ = nowInNanoseconds();
+    }
 
-    work_available_.notify_all();
+    if(sleeping_workers_ > 0) {
+        std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+        work_available_.notify_one();
+    } else {
+        growIfNeeded();
+    }
 }
 
-void ThreadGroup::scheduleDelayed(TaskPtr schedulable, std::chrono::system_clock::time_point time)
+TaskPtr ThreadGroup::takeNextTask(Worker* worker)
+{
+    // deadlines first, then prefer the own queue...
+    TaskPtr task = deadline_tasks_.pop();
+    if(!task) {
+        task = worker->tasks.pop();
+    }
+
+    // ...then steal from the other workers, including the inactive ones
+    for(std::size_t i = 1, n = allocated_workers_; !task && i < n; ++i) {
+        task = workers_[(worker->index + i) % n]->tasks.pop();
+    }
+
+    if(task) {
+        --queued_tasks_;
+    }
+    return task;
+}
+
+std::vector<TaskPtr> ThreadGroup::drainTasks()
+{
+    std::vector<TaskPtr> tasks = deadline_tasks_.drain();
+    queued_tasks_ -= tasks.size();
+    for(std::size_t i = 0, n = allocated_workers_; i < n; ++i) {
+        for(const TaskPtr& task : workers_[i]->tasks.drain()) {
+            --queued_tasks_;
+            tasks.push_back(task);
+        }
+    }
+    return tasks;
+}
+
+void ThreadGroup::scheduleDelayed(TaskPtr schedulable, std::chrono::steady_clock::time_point time)
 {
     timed_queue_->schedule(shared_from_this(), schedulable, time);
 }
 
-void ThreadGroup::schedulingLoop()
+void ThreadGroup::schedulingLoop(Worker* worker)
 {
+    current_worker_ = worker;
+
     while(running_) {
-        bool keep_executing = waitForTasks();
+        WaitResult result = waitForTasks(worker);
+        if(result == WaitResult::RELEASED) {
+            // the thread is joined when the worker is started again
+            return;
+        }
+        bool keep_executing = result == WaitResult::TASKS_AVAILABLE;
         while(running_ && keep_executing) {
             handlePause();
 
-            keep_executing = executeNextTask();
+            keep_executing = executeNextTask(worker);
 //            int cpu = sched_getcpu();
 //            if(!getCpuAffinity()->isCpuUsed(cpu)) {
 //                std::stringstream ss;
@@ -401,18 +1064,75 @@ void ThreadGroup::schedulingLoop()
     }
 }
 
-bool ThreadGroup::waitForTasks()
+ThreadGroup::WaitResult ThreadGroup::waitForTasks(Worker* worker)
 {
-    std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
-    while(tasks_.empty()) {
-        work_available_.wait_for(lock, std::chrono::seconds(1));
+    if(queued_tasks_ > 0) {
+        return WaitResult::TASKS_AVAILABLE;
+    }
 
+    // polling avoids the latency of waking up a sleeping thread, but occupies the cpu
+    auto spin_end = std::chrono::steady_clock::now() + getSpinDuration();
+    while(queued_tasks_ == 0) {
         if(!running_) {
-            return false;
+            return WaitResult::STOPPED;
         }
+
+        WaitPolicy policy = wait_policy_;
+        if(policy == WaitPolicy::BLOCK) {
+            break;
+        } else if(policy == WaitPolicy::SPIN_THEN_PARK && std::chrono::steady_clock::now() >= spin_end) {
+            break;
+        }
+
+        cpuRelax();
     }
 
-    return true;
+    if(queued_tasks_ == 0) {
+        std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+        ++sleeping_workers_;
+        auto idle_since = std::chrono::steady_clock::now();
+        while(queued_tasks_ == 0) {
+            std::chrono::milliseconds timeout(1000);
+            if(elastic_) {
+                timeout = std::min(timeout, getIdleTimeout());
+            }
+            work_available_.wait_for(lock, timeout);
+
+            if(!running_) {
+                --sleeping_workers_;
+                return WaitResult::STOPPED;
+            }
+
+            if(elastic_ && queued_tasks_ == 0 &&
+                    std::chrono::steady_clock::now() - idle_since >= getIdleTimeout()) {
+                --sleeping_workers_;
+                releaseWorker(worker);
+                return WaitResult::RELEASED;
+            }
+        }
+        --sleeping_workers_;
+    }
+
+    recordWakeUp();
+
+    return WaitResult::TASKS_AVAILABLE;
+}
+
+void ThreadGroup::recordWakeUp()
+{
+    long long requested = wake_requested_at_.exchange(0);
+    if(requested == 0) {
+        // another worker has already been woken up for this task
+        return;
+    }
+
+    long long latency = nowInNanoseconds() - requested;
+    ++wake_ups_;
+    wake_latency_sum_ += latency;
+
+    long long max = wake_latency_max_;
+    while(latency > max && !wake_latency_max_.compare_exchange_weak(max, latency)) {
+    }
 }
 
 void ThreadGroup::handlePause()
@@ -423,36 +1143,57 @@ void ThreadGroup::handlePause()
     }
 }
 
-bool ThreadGroup::executeNextTask()
+bool ThreadGroup::executeNextTask(Worker* worker)
 {
-    std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
-    if(!tasks_.empty()) {
-        TaskPtr task = *tasks_.begin();
-        tasks_.erase(tasks_.begin());
+    TaskPtr task = takeNextTask(worker);
+    if(!task) {
+        return false;
+    }
 
-        task->setScheduled(false);
+    TaskGenerator* generator = task->getParent();
+    if(generator) {
+        // another worker is executing this generator -> park the task at the generator,
+        // the executing worker reschedules it. Requeueing it here would make this worker
+        // pop the same task over and over until the generator is released.
+        while(!generator->tryLockExecution()) {
+            if(generator->holdBack(task)) {
+                return true;
+            }
+            // the other worker finished in the meantime, but the generator has been taken again
+            std::this_thread::yield();
+        }
+    }
+
+    task->setScheduled(false);
 
-        tasks_lock.unlock();
+    bool executed = false;
+    {
+        std::unique_lock<std::recursive_mutex> state_lock(state_mtx_);
+        if(running_) {
+            state_lock.unlock();
 
-        {
-            std::unique_lock<std::recursive_mutex> state_lock(state_mtx_);
-            if(running_) {
-                state_lock.unlock();
+            executeTask(worker, task);
+            executed = true;
+        }
+    }
 
-                executeTask(task);
-                return true;
-            }
+    if(generator) {
+        for(const TaskPtr& held_back : generator->unlockExecution()) {
+            enqueue(worker, held_back);
         }
     }
 
-    return false;
+    return executed;
 }
 
-void ThreadGroup::executeTask(const TaskPtr& task)
+void ThreadGroup::executeTask(Worker* worker, const TaskPtr& task)
 {
+    // the task can be scheduled again while it is running
+    std::chrono::steady_clock::time_point scheduled = task->getScheduleTime();
     try {
-        std::unique_lock<std::recursive_mutex> state_lock(execution_mtx_);
+        std::unique_lock<std::recursive_mutex> state_lock(worker->execution_mtx);
         task->execute();
+        recordExecution(task, scheduled);
 
     } catch(const std::exception& e) {
         TaskGenerator* gen = task->getParent();
@@ -471,6 +1212,28 @@ void ThreadGroup::executeTask(const TaskPtr& task)
     }
 }
 
+void ThreadGroup::recordExecution(const TaskPtr& task, std::chrono::steady_clock::time_point scheduled)
+{
+    long long run_time = task->getRunTime().count();
+    busy_ns_ += run_time;
+
+    telemetry_.run_time.record(run_time);
+    auto delay = task->getStartTime() - scheduled;
+    telemetry_.scheduling_delay.record(std::max<long long>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count()));
+
+    // the worker that closes a window records its utilization
+    utilization_window_busy_ns_ += run_time;
+    long long now = nowInNanoseconds();
+    long long window_start = utilization_window_start_;
+    long long window = now - window_start;
+    if(window >= std::chrono::duration_cast<std::chrono::nanoseconds>(UTILIZATION_WINDOW).count() &&
+            utilization_window_start_.compare_exchange_strong(window_start, now)) {
+        long long busy = utilization_window_busy_ns_.exchange(0);
+        long long workers = std::max<long long>(1, live_workers_);
+        telemetry_.utilization.record(std::min<long long>(100, busy * 100 / (workers * window)));
+    }
+}
+
 std::vector<TaskGeneratorPtr>::iterator ThreadGroup::begin()
 {
     return generators_.begin();
@@ -495,6 +1258,22 @@ std::vector<TaskGeneratorPtr>::const_iterator ThreadGroup::end() const
 void ThreadGroup::saveSettings(YAML::Node& node)
 {
     node["affinity"] = cpu_affinity_->get();
+    node["workers"] = getWorkerCount();
+    node["wait_policy"] = waitPolicyToString(wait_policy_);
+    node["spin_us"] = spin_duration_us_.load();
+    node["local_payloads"] = local_payloads_.load();
+    node["elastic"] = elastic_.load();
+    node["idle_timeout_ms"] = idle_timeout_ms_.load();
+    node["grow_threshold"] = grow_threshold_.load();
+
+    RealtimeParameters realtime = getRealtimeParameters();
+    YAML::Node rt;
+    rt["policy"] = realtimePolicyToString(realtime.policy);
+    rt["priority"] = realtime.priority;
+    rt["runtime_us"] = (long) realtime.runtime.count();
+    rt["deadline_us"] = (long) realtime.deadline.count();
+    rt["period_us"] = (long) realtime.period.count();
+    node["realtime"] = rt;
 }
 
 
@@ -504,4 +1283,35 @@ void ThreadGroup::loadSettings(const YAML::Node& node)
         std::vector<bool> affinity = node["affinity"].as<std::vector<bool>>();
         cpu_affinity_->set(affinity);
     }
+    if(node["workers"].IsDefined()) {
+        setWorkerCount(node["workers"].as<std::size_t>());
+    }
+    if(node["wait_policy"].IsDefined()) {
+        setWaitPolicy(waitPolicyFromString(node["wait_policy"].as<std::string>()));
+    }
+    if(node["spin_us"].IsDefined()) {
+        setSpinDuration(std::chrono::microseconds(node["spin_us"].as<long>()));
+    }
+    if(node["local_payloads"].IsDefined()) {
+        setLocalPayloads(node["local_payloads"].as<bool>());
+    }
+    if(node["idle_timeout_ms"].IsDefined()) {
+        setIdleTimeout(std::chrono::milliseconds(node["idle_timeout_ms"].as<long>()));
+    }
+    if(node["grow_threshold"].IsDefined()) {
+        setGrowThreshold(node["grow_threshold"].as<std::size_t>());
+    }
+    if(node["elastic"].IsDefined()) {
+        setElastic(node["elastic"].as<bool>());
+    }
+    if(node["realtime"].IsDefined()) {
+        const YAML::Node& rt = node["realtime"];
+        RealtimeParameters realtime;
+        realtime.policy = realtimePolicyFromString(rt["policy"].as<std::string>());
+        realtime.priority = rt["priority"].as<int>(0);
+        realtime.runtime = std::chrono::microseconds(rt["runtime_us"].as<long>(0));
+        realtime.deadline = std::chrono::microseconds(rt["deadline_us"].as<long>(0));
+        realtime.period = std::chrono::microseconds(rt["period_us"].as<long>(0));
+        setRealtimeParameters(realtime);
+    }
 }
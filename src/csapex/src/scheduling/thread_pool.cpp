@@ -12,8 +12,11 @@
 
 /// SYSTEM
 #include <set>
+#include <deque>
 #include <unordered_map>
 #include <iostream>
+#include <limits>
+#include <algorithm>
 
 using namespace csapex;
 
@@ -21,14 +24,16 @@ ThreadPool::ThreadPool(ExceptionHandler& handler, bool enable_threading, bool gr
     : handler_(handler),
       timed_queue_(new TimedQueue),
       enable_threading_(enable_threading), grouping_(grouping),
-      private_group_cpu_affinity_(new CpuAffinity)
+      private_group_cpu_affinity_(new CpuAffinity),
+      private_groups_elastic_(false)
 {
     setup();
 }
 
 ThreadPool::ThreadPool(Executor* parent, ExceptionHandler& handler, bool enable_threading, bool grouping)
     : handler_(handler), enable_threading_(enable_threading), grouping_(grouping),
-      private_group_cpu_affinity_(new CpuAffinity)
+      private_group_cpu_affinity_(new CpuAffinity),
+      private_groups_elastic_(false)
 {
     setup();
     parent->addChild(this);
@@ -256,6 +261,7 @@ void ThreadPool::usePrivateThreadFor(TaskGenerator *task)
                                                              task->getUUID().getShortName());
 
         group->getCpuAffinity()->set(private_group_cpu_affinity_->get());
+        group->setElastic(private_groups_elastic_);
 
         group->setPause(isPaused());
 
@@ -358,6 +364,7 @@ void ThreadPool::removeGroup(int id)
         ThreadGroupPtr group = *it;
         if(group->id() == id) {
             apex_assert_hard(group->isEmpty());
+            forgetAssignmentsTo(group.get());
             groups_.erase(it);
 
             group_removed(group);
@@ -371,6 +378,7 @@ void ThreadPool::removeGroup(ThreadGroup *group)
     for(auto it = groups_.begin(); it != groups_.end(); ++it ) {
         if(it->get() == group) {
             apex_assert_hard(group->isEmpty());
+            forgetAssignmentsTo(group);
             group_removed(*it);
             groups_.erase(it);
 
@@ -381,6 +389,18 @@ void ThreadPool::removeGroup(ThreadGroup *group)
 
 
 
+void ThreadPool::forgetAssignmentsTo(ThreadGroup* group)
+{
+    // generators that are detached from their group, e.g. by an execution plan, are still assigned to it
+    for(auto it = group_assignment_.begin(); it != group_assignment_.end();) {
+        if(it->second == group) {
+            it = group_assignment_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 bool ThreadPool::isStepDone()
 {
     //TRACE std::cerr << " TP CHECK =========== " << std::endl;
@@ -397,6 +417,248 @@ bool ThreadPool::isStepDone()
     return true;
 }
 
+std::vector<std::size_t> ThreadPool::partition(const std::vector<double>& costs,
+                                               const std::vector<std::pair<std::size_t, std::size_t>>& edges,
+                                               std::size_t groups)
+{
+    const std::size_t n = costs.size();
+    std::vector<std::size_t> assignment(n, 0);
+    if(n == 0 || groups <= 1) {
+        return assignment;
+    }
+    groups = std::min(groups, n);
+
+    std::vector<std::vector<std::size_t>> neighbors(n);
+    std::vector<std::size_t> in_degree(n, 0);
+    for(const auto& edge : edges) {
+        if(edge.first == edge.second || edge.first >= n || edge.second >= n) {
+            continue;
+        }
+        neighbors[edge.first].push_back(edge.second);
+        neighbors[edge.second].push_back(edge.first);
+        ++in_degree[edge.second];
+    }
+
+    // order the tasks breadth first, starting at the sources, so that connected tasks are close
+    std::vector<std::size_t> order;
+    std::vector<bool> visited(n, false);
+    auto visit = [&](std::size_t start) {
+        std::deque<std::size_t> Q;
+        Q.push_back(start);
+        visited[start] = true;
+        while(!Q.empty()) {
+            std::size_t top = Q.front();
+            Q.pop_front();
+            order.push_back(top);
+            for(std::size_t neighbor : neighbors[top]) {
+                if(!visited[neighbor]) {
+                    visited[neighbor] = true;
+                    Q.push_back(neighbor);
+                }
+            }
+        }
+    };
+    for(std::size_t i = 0; i < n; ++i) {
+        if(in_degree[i] == 0 && !visited[i]) {
+            visit(i);
+        }
+    }
+    for(std::size_t i = 0; i < n; ++i) {
+        if(!visited[i]) {
+            visit(i);
+        }
+    }
+
+    // cut the order into contiguous chunks of similar cost
+    double total = 0.0;
+    for(double cost : costs) {
+        total += cost;
+    }
+    if(total <= 0.0) {
+        total = n;
+    }
+    const double target = total / groups;
+
+    std::vector<double> load(groups, 0.0);
+    double accumulated = 0.0;
+    for(std::size_t task : order) {
+        double cost = costs[task] > 0.0 ? costs[task] : total / n;
+        std::size_t group = std::min(groups - 1, static_cast<std::size_t>((accumulated + cost / 2.0) / target));
+        assignment[task] = group;
+        load[group] += cost;
+        accumulated += cost;
+    }
+
+    // move tasks to the group of most of their neighbors, as long as the balance allows it
+    const double limit = target * 1.1;
+    for(int pass = 0; pass < 4; ++pass) {
+        bool changed = false;
+        for(std::size_t task : order) {
+            std::map<std::size_t, int> links;
+            for(std::size_t neighbor : neighbors[task]) {
+                ++links[assignment[neighbor]];
+            }
+
+            std::size_t current = assignment[task];
+            std::size_t best = current;
+            for(const auto& pair : links) {
+                if(pair.second > links[best]) {
+                    best = pair.first;
+                }
+            }
+
+            double cost = costs[task] > 0.0 ? costs[task] : total / n;
+            if(best != current && load[best] + cost <= limit) {
+                load[current] -= cost;
+                load[best] += cost;
+                assignment[task] = best;
+                changed = true;
+            }
+        }
+        if(!changed) {
+            break;
+        }
+    }
+
+    return assignment;
+}
+
+std::vector<std::size_t> ThreadPool::placeOnNumaNodes(const std::vector<double>& loads,
+                                                      const std::vector<std::pair<std::size_t, std::size_t>>& edges,
+                                                      const std::vector<std::size_t>& node_cpus)
+{
+    const std::size_t n = loads.size();
+    const std::size_t nodes = node_cpus.size();
+    std::vector<std::size_t> placement(n, 0);
+    if(n == 0 || nodes <= 1) {
+        return placement;
+    }
+
+    std::vector<std::vector<std::size_t>> neighbors(n);
+    for(const auto& edge : edges) {
+        if(edge.first == edge.second || edge.first >= n || edge.second >= n) {
+            continue;
+        }
+        neighbors[edge.first].push_back(edge.second);
+        neighbors[edge.second].push_back(edge.first);
+    }
+
+    double total = 0.0;
+    for(double load : loads) {
+        total += load;
+    }
+    auto loadOf = [&](std::size_t group) {
+        // unprofiled groups count as average ones
+        return loads[group] > 0.0 ? loads[group] : (total > 0.0 ? total / n : 1.0);
+    };
+    total = 0.0;
+    for(std::size_t group = 0; group < n; ++group) {
+        total += loadOf(group);
+    }
+
+    std::size_t cpus = 0;
+    for(std::size_t c : node_cpus) {
+        cpus += c;
+    }
+    std::vector<double> capacity(nodes);
+    for(std::size_t node = 0; node < nodes; ++node) {
+        double share = cpus > 0 ? node_cpus[node] / (double) cpus : 1.0 / nodes;
+        capacity[node] = total * share * 1.1;
+    }
+
+    // collect the connected components, each in breadth first order
+    std::vector<std::vector<std::size_t>> components;
+    std::vector<double> component_load;
+    std::vector<bool> visited(n, false);
+    for(std::size_t start = 0; start < n; ++start) {
+        if(visited[start]) {
+            continue;
+        }
+        components.emplace_back();
+        component_load.push_back(0.0);
+        std::deque<std::size_t> Q;
+        Q.push_back(start);
+        visited[start] = true;
+        while(!Q.empty()) {
+            std::size_t top = Q.front();
+            Q.pop_front();
+            components.back().push_back(top);
+            component_load.back() += loadOf(top);
+            for(std::size_t neighbor : neighbors[top]) {
+                if(!visited[neighbor]) {
+                    visited[neighbor] = true;
+                    Q.push_back(neighbor);
+                }
+            }
+        }
+    }
+
+    std::vector<std::size_t> order(components.size());
+    for(std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return component_load[a] > component_load[b];
+    });
+
+    std::vector<double> used(nodes, 0.0);
+    auto leastUsed = [&](double load) {
+        std::size_t best = 0;
+        double best_fill = std::numeric_limits<double>::infinity();
+        for(std::size_t node = 0; node < nodes; ++node) {
+            if(capacity[node] <= 0.0) {
+                continue;
+            }
+            double fill = (used[node] + load) / capacity[node];
+            if(fill < best_fill) {
+                best_fill = fill;
+                best = node;
+            }
+        }
+        return best;
+    };
+
+    std::vector<bool> placed(n, false);
+    for(std::size_t c : order) {
+        const std::vector<std::size_t>& component = components[c];
+
+        std::size_t node = leastUsed(component_load[c]);
+        if(used[node] + component_load[c] <= capacity[node]) {
+            for(std::size_t group : component) {
+                placement[group] = node;
+                placed[group] = true;
+            }
+            used[node] += component_load[c];
+            continue;
+        }
+
+        // the component is too big for one node, keep each group with most of its placed neighbors
+        for(std::size_t group : component) {
+            double load = loadOf(group);
+
+            std::vector<int> links(nodes, 0);
+            for(std::size_t neighbor : neighbors[group]) {
+                if(placed[neighbor]) {
+                    ++links[placement[neighbor]];
+                }
+            }
+
+            std::size_t best = leastUsed(load);
+            for(std::size_t candidate = 0; candidate < nodes; ++candidate) {
+                if(links[candidate] > links[best] && used[candidate] + load <= capacity[candidate]) {
+                    best = candidate;
+                }
+            }
+
+            placement[group] = best;
+            placed[group] = true;
+            used[best] += load;
+        }
+    }
+
+    return placement;
+}
+
 std::string ThreadPool::nextName()
 {
     std::stringstream name;
@@ -414,6 +676,21 @@ std::vector<bool> ThreadPool::getPrivateThreadGroupCpuAffinity() const
     return private_group_cpu_affinity_->get();
 }
 
+void ThreadPool::setPrivateThreadGroupsElastic(bool elastic)
+{
+    private_groups_elastic_ = elastic;
+    for(const ThreadGroupPtr& group : groups_) {
+        if(group->id() == ThreadGroup::PRIVATE_THREAD) {
+            group->setElastic(elastic);
+        }
+    }
+}
+
+bool ThreadPool::arePrivateThreadGroupsElastic() const
+{
+    return private_groups_elastic_;
+}
+
 void ThreadPool::saveSettings(YAML::Node& node)
 {
     YAML::Node threads(YAML::NodeType::Map);
@@ -439,6 +716,7 @@ void ThreadPool::saveSettings(YAML::Node& node)
     }
     threads["groups"] = groups;
     threads["private_affinity"] = private_group_cpu_affinity_->get();
+    threads["private_elastic"] = private_groups_elastic_;
 
     YAML::Node assignments;
     for(std::map<TaskGenerator*, ThreadGroup*>::const_iterator it = group_assignment_.begin();
@@ -455,6 +733,34 @@ void ThreadPool::saveSettings(YAML::Node& node)
     node["threads"] = threads;
 }
 
+void ThreadPool::saveTelemetry(YAML::Node& node)
+{
+    YAML::Node groups(YAML::NodeType::Sequence);
+
+    auto save = [&groups](const ThreadGroup& group) {
+        YAML::Node g;
+        g["id"] = group.id();
+        g["name"] = group.getName();
+        group.saveTelemetry(g);
+        groups.push_back(g);
+    };
+
+    save(*default_group_);
+    for(const ThreadGroupPtr& group : groups_) {
+        save(*group);
+    }
+
+    node["groups"] = groups;
+}
+
+void ThreadPool::resetTelemetry()
+{
+    default_group_->resetTelemetry();
+    for(const ThreadGroupPtr& group : groups_) {
+        group->resetTelemetry();
+    }
+}
+
 void ThreadPool::loadSettings(YAML::Node& node)
 {
     const YAML::Node& threads = node["threads"];
@@ -464,6 +770,10 @@ void ThreadPool::loadSettings(YAML::Node& node)
             std::vector<bool> a = private_affinity.as<std::vector<bool>>();
             private_group_cpu_affinity_->set(a);
         }
+        const YAML::Node& private_elastic = threads["private_elastic"];
+        if(private_elastic.IsDefined()){
+            setPrivateThreadGroupsElastic(private_elastic.as<bool>());
+        }
 
         const YAML::Node& groups = threads["groups"];
         if(groups.IsDefined()) {
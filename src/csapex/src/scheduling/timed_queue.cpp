@@ -3,138 +3,411 @@
 
 /// COMPONENT
 #include <csapex/scheduling/scheduler.h>
+#include <csapex/scheduling/task.h>
 #include <csapex/utility/thread.h>
 
 /// SYSTEM
 #include <iostream>
+#include <limits>
+#include <algorithm>
+#ifdef __linux__
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <sys/prctl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
 
 using namespace csapex;
 
+const uint64_t TimedQueue::NO_TICK = std::numeric_limits<uint64_t>::max();
+
+namespace
+{
+int lowestBit(uint64_t mask)
+{
+    int bit = 0;
+    while(!(mask & 1)) {
+        mask >>= 1;
+        ++bit;
+    }
+    return bit;
+}
+}
+
+TimedQueue::Lateness::Lateness()
+    : releases(0), last(0), max(0), total(0)
+{
+}
+
+std::chrono::nanoseconds TimedQueue::Lateness::mean() const
+{
+    if(releases == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    return total / releases;
+}
+
 TimedQueue::TimedQueue()
-    : scheduling_running_(false), sleeping_running_(false)
+    : running_(false), alive_(std::make_shared<std::atomic<bool>>(true)),
+      timer_fd_(-1), wake_up_fd_(-1),
+      current_tick_(toTick(Clock::now())), wake_up_tick_(NO_TICK), size_(0),
+      releases_(0)
 {
-    next_wake_up_ = std::chrono::system_clock::now();
+    for(int level = 0; level < LEVELS; ++level) {
+        occupied_[level] = 0;
+    }
+
+#ifdef __linux__
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    wake_up_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(timer_fd_ < 0 || wake_up_fd_ < 0) {
+        std::cerr << "cannot create timer file descriptors, falling back to condition variables" << std::endl;
+        if(timer_fd_ >= 0) {
+            close(timer_fd_);
+        }
+        if(wake_up_fd_ >= 0) {
+            close(wake_up_fd_);
+        }
+        timer_fd_ = -1;
+        wake_up_fd_ = -1;
+    }
+#endif
+
     start();
 }
+
 TimedQueue::~TimedQueue()
 {
+    *alive_ = false;
     stop();
+
+#ifdef __linux__
+    if(timer_fd_ >= 0) {
+        close(timer_fd_);
+    }
+    if(wake_up_fd_ >= 0) {
+        close(wake_up_fd_);
+    }
+#endif
 }
 
 void TimedQueue::start()
 {
-    // this thread schedules tasks that have expired
-    scheduling_thread_ = std::thread([this](){
-        scheduling_running_ = true;
-        loop();
-    });
+    std::unique_lock<std::mutex> lock(mtx_);
+    if(running_) {
+        return;
+    }
+
+    // the flag has to be set before the thread is started,
+    // otherwise a quick call to stop() would not join it
+    running_ = true;
 
-    // this thread sleeps until the time given by 'next_wake_up_' is reached.
-    // it then wakes up the scheduling thread
-    sleeping_thread_ = std::thread([this](){
-        sleeping_running_ = true;
-        sleep();
+    timer_thread_ = std::thread([this](){
+        loop();
     });
 }
 
 void TimedQueue::stop()
 {
-    if(scheduling_running_) {
-        scheduling_running_ = false;
-        tasks_changed_.notify_all();
-        if(scheduling_thread_.joinable()) {
-            scheduling_thread_.join();
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if(!running_) {
+            return;
         }
+        running_ = false;
+        wakeUp();
     }
-    if(sleeping_running_) {
-        sleeping_running_ = false;
-        next_wake_up_changed_.notify_all();
-        if(sleeping_thread_.joinable()) {
-            sleeping_thread_.join();
+
+    if(timer_thread_.joinable()) {
+        if(std::this_thread::get_id() == timer_thread_.get_id()) {
+            // destroyed by the timer thread itself, the loop returns without touching this queue again
+            timer_thread_.detach();
+        } else {
+            timer_thread_.join();
         }
     }
 }
 
+void TimedQueue::schedule(SchedulerPtr scheduler, TaskPtr schedulable, Clock::time_point time)
+{
+    Unit unit;
+    unit.scheduler = scheduler;
+    unit.schedulable = schedulable;
+    unit.time = time;
+    unit.tick = toTick(time);
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    ++size_;
+
+    bool earlier = unit.tick < wake_up_tick_;
+    insert(std::move(unit));
+
+    if(earlier) {
+        // the timer thread sleeps too long -> wake it up to rearm the timer
+        wakeUp();
+    }
+}
+
+std::size_t TimedQueue::size() const
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    return size_;
+}
+
+TimedQueue::Lateness TimedQueue::getLateness(const TaskPtr& task) const
+{
+    std::unique_lock<std::mutex> lock(lateness_mtx_);
+    auto pos = lateness_.find(task.get());
+    if(pos == lateness_.end() || pos->second.task.lock() != task) {
+        return Lateness();
+    }
+    return pos->second.lateness;
+}
+
 void TimedQueue::loop()
 {
-    csapex::thread::set_name("queue:exec");
+    csapex::thread::set_name("queue:timer");
+
+#ifdef __linux__
+    // timer slack would delay every wake up by up to 50us
+    prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+#endif
+
+    std::shared_ptr<std::atomic<bool>> alive = alive_;
+
+    std::vector<Unit> batch;
 
-    std::unique_lock<std::mutex> lock(task_mtx_);
-    while(scheduling_running_) {
-        // wait until a task is available
-        while(tasks_.empty()) {
-            tasks_changed_.wait(lock);
-            if(!scheduling_running_) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    while(running_) {
+        advance(toTick(Clock::now()));
+
+        if(!expired_.empty()) {
+            // release all expired tasks at once
+            batch.swap(expired_);
+            size_ -= batch.size();
+            lock.unlock();
+
+            std::stable_sort(batch.begin(), batch.end(), [](const Unit& a, const Unit& b) {
+                return a.time < b.time;
+            });
+
+            release(batch);
+            batch.clear();
+
+            if(!*alive) {
                 return;
             }
+            lock.lock();
+            continue;
         }
 
-        // schedule all tasks that have expired
-        while(!tasks_.empty()) {
-            const Unit& front = *tasks_.begin();
+        sleepUntil(nextEventTick(), lock);
+    }
+}
+
+void TimedQueue::insert(Unit&& unit)
+{
+    if(unit.tick <= current_tick_) {
+        expired_.push_back(std::move(unit));
+        return;
+    }
 
-            auto now = std::chrono::system_clock::now();
-            if(now >= front.time) {
-                Unit unit = front;
-                tasks_.erase(tasks_.begin());
-                lock.unlock();
+    // the level is given by the highest group of bits in which the deadline differs from now
+    uint64_t diff = unit.tick ^ current_tick_;
+    int level = 0;
+    while(level < LEVELS && (diff >> ((level + 1) * SLOT_BITS)) != 0) {
+        ++level;
+    }
 
+    if(level >= LEVELS) {
+        overflow_.push_back(std::move(unit));
+        return;
+    }
 
-                unit.scheduler->schedule(unit.schedulable);
+    int slot = (unit.tick >> (level * SLOT_BITS)) & (SLOTS - 1);
+    wheel_[level][slot].push_back(std::move(unit));
+    occupied_[level] |= uint64_t(1) << slot;
+}
 
-                lock.lock();
-            } else {
-                break;
+uint64_t TimedQueue::nextEventTick() const
+{
+    uint64_t next = NO_TICK;
+
+    for(int level = 0; level < LEVELS; ++level) {
+        int shift = level * SLOT_BITS;
+        int current_slot = (current_tick_ >> shift) & (SLOTS - 1);
+        if(current_slot == SLOTS - 1) {
+            continue;
+        }
+
+        // only slots after the current one can be occupied on this level
+        uint64_t pending = occupied_[level] & (~uint64_t(0) << (current_slot + 1));
+        if(pending) {
+            int upper = shift + SLOT_BITS;
+            uint64_t slot_start = ((current_tick_ >> upper) << upper) | (uint64_t(lowestBit(pending)) << shift);
+            next = std::min(next, slot_start);
+        }
+    }
+
+    if(!overflow_.empty()) {
+        int upper = LEVELS * SLOT_BITS;
+        next = std::min(next, ((current_tick_ >> upper) + 1) << upper);
+    }
+
+    return next;
+}
+
+void TimedQueue::advance(uint64_t tick)
+{
+    while(true) {
+        uint64_t next = nextEventTick();
+        if(next > tick) {
+            break;
+        }
+
+        current_tick_ = next;
+
+        // cascade the slots that have been reached, from the coarsest level down
+        if(!overflow_.empty() && (current_tick_ & ((uint64_t(1) << (LEVELS * SLOT_BITS)) - 1)) == 0) {
+            std::vector<Unit> units;
+            units.swap(overflow_);
+            for(Unit& unit : units) {
+                insert(std::move(unit));
             }
         }
+        for(int level = LEVELS - 1; level >= 0; --level) {
+            int slot = (current_tick_ >> (level * SLOT_BITS)) & (SLOTS - 1);
+            uint64_t bit = uint64_t(1) << slot;
+            if(occupied_[level] & bit) {
+                std::vector<Unit> units;
+                units.swap(wheel_[level][slot]);
+                occupied_[level] &= ~bit;
+                for(Unit& unit : units) {
+                    insert(std::move(unit));
+                }
+            }
+        }
+    }
 
-        // notify the sleeping thread, if there are remaining tasks
-        if(!tasks_.empty()) {
-            Unit front = *tasks_.begin();
-            lock.unlock();
+    if(tick > current_tick_) {
+        current_tick_ = tick;
+    }
+}
 
-            {
-                std::unique_lock<std::mutex> lock(sleep_mtx_);
-                next_wake_up_ = front.time;
-                next_wake_up_changed_.notify_all();
+void TimedQueue::release(std::vector<Unit>& units)
+{
+    auto now = Clock::now();
+
+    {
+        std::unique_lock<std::mutex> lock(lateness_mtx_);
+        for(const Unit& unit : units) {
+            auto lateness = std::chrono::duration_cast<std::chrono::nanoseconds>(now - unit.time);
+
+            LatenessRecord& record = lateness_[unit.schedulable.get()];
+            if(record.task.lock() != unit.schedulable) {
+                // the address has been reused by another task
+                record = LatenessRecord();
+                record.task = unit.schedulable;
             }
 
-            lock.lock();
+            Lateness& l = record.lateness;
+            ++l.releases;
+            l.last = lateness;
+            l.total += lateness;
+            l.max = std::max(l.max, lateness);
         }
+
+        // forget about tasks that don't exist anymore
+        releases_ += units.size();
+        if(releases_ > 1024) {
+            releases_ = 0;
+            for(auto it = lateness_.begin(); it != lateness_.end();) {
+                if(it->second.task.expired()) {
+                    it = lateness_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+
+    for(Unit& unit : units) {
+        unit.scheduler->schedule(unit.schedulable);
     }
 }
 
-void TimedQueue::sleep()
+void TimedQueue::sleepUntil(uint64_t tick, std::unique_lock<std::mutex>& lock)
 {
-    csapex::thread::set_name("queue:sleep");
-
-    std::unique_lock<std::mutex> lock(sleep_mtx_);
-    while(sleeping_running_) {
-        // wait for a sleep command
-        next_wake_up_changed_.wait(lock);
+    wake_up_tick_ = tick;
 
-        auto now = std::chrono::system_clock::now();
-        if(now < next_wake_up_) {
-            // the next sleep target is in the future -> sleep
-            std::this_thread::sleep_until(next_wake_up_);
-            tasks_changed_.notify_all();
+#ifdef __linux__
+    if(timer_fd_ >= 0) {
+        // arm the timer with an absolute deadline on the monotonic clock
+        itimerspec spec {};
+        if(tick != NO_TICK) {
+            auto deadline = std::chrono::duration_cast<std::chrono::nanoseconds>(fromTick(tick).time_since_epoch()).count();
+            spec.it_value.tv_sec = deadline / 1000000000;
+            spec.it_value.tv_nsec = deadline % 1000000000;
         }
+        timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+
+        lock.unlock();
+
+        pollfd fds[2];
+        fds[0].fd = timer_fd_;
+        fds[0].events = POLLIN;
+        fds[1].fd = wake_up_fd_;
+        fds[1].events = POLLIN;
+        poll(fds, 2, -1);
+
+        uint64_t count;
+        while(read(timer_fd_, &count, sizeof(count)) > 0) {}
+        while(read(wake_up_fd_, &count, sizeof(count)) > 0) {}
+
+        lock.lock();
+
+        wake_up_tick_ = NO_TICK;
+        return;
     }
+#endif
+
+    if(tick == NO_TICK) {
+        wake_up_.wait(lock);
+    } else {
+        wake_up_.wait_until(lock, fromTick(tick));
+    }
+
+    wake_up_tick_ = NO_TICK;
 }
 
-void TimedQueue::schedule(SchedulerPtr scheduler, TaskPtr schedulable, std::chrono::system_clock::time_point time)
+void TimedQueue::wakeUp()
 {
-    Unit unit;
-    unit.scheduler = scheduler;
-    unit.schedulable = schedulable;
-    unit.time = time;
+#ifdef __linux__
+    if(wake_up_fd_ >= 0) {
+        uint64_t one = 1;
+        if(write(wake_up_fd_, &one, sizeof(one)) < 0) {
+            // the counter is already non-zero, the timer thread will wake up anyway
+        }
+        return;
+    }
+#endif
 
-    std::unique_lock<std::mutex> lock(task_mtx_);
-    auto front = tasks_.begin();
-    tasks_.insert(unit);
+    wake_up_.notify_all();
+}
 
-    if(tasks_.begin() != front) {
-        // the earliest entry changed -> notify the scheduling thread immediately
-        tasks_changed_.notify_all();
+uint64_t TimedQueue::toTick(Clock::time_point time)
+{
+    // round up, tasks must never be released early
+    auto t = time.time_since_epoch();
+    auto ticks = std::chrono::duration_cast<Resolution>(t);
+    if(ticks < t) {
+        ticks += Resolution(1);
     }
+    return ticks.count() < 0 ? 0 : ticks.count();
+}
+
+TimedQueue::Clock::time_point TimedQueue::fromTick(uint64_t tick)
+{
+    return Clock::time_point(std::chrono::duration_cast<Clock::duration>(Resolution(tick)));
 }
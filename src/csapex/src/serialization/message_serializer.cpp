@@ -5,6 +5,7 @@
 #include <csapex/utility/assert.h>
 #include <csapex/utility/yaml_node_builder.h>
 #include <csapex/factory/message_factory.h>
+#include <csapex/serialization/serialization_buffer.h>
 
 /// SYSTEM
 #include <fstream>
@@ -12,6 +13,15 @@
 
 using namespace csapex;
 
+namespace
+{
+enum class Encoding : uint8_t
+{
+    YAML = 0,
+    BINARY = 1
+};
+}
+
 MessageSerializer::MessageSerializer()
 {
 }
@@ -24,6 +34,7 @@ MessageSerializer::~MessageSerializer()
 void MessageSerializer::shutdown()
 {
 	type_to_converter.clear();
+    type_to_binary_converter.clear();
 }
 
 TokenData::Ptr MessageSerializer::deserializeMessage(const YAML::Node &node)
@@ -96,6 +107,85 @@ TokenData::Ptr MessageSerializer::readYaml(const YAML::Node &node)
     return msg;
 }
 
+void MessageSerializer::serializeMessage(const TokenData &msg, SerializationBuffer &data)
+{
+    MessageSerializer& i = instance();
+
+    std::string type = msg.typeName();
+    data << type;
+
+    auto binary = i.type_to_binary_converter.find(type);
+    if(binary != i.type_to_binary_converter.end()) {
+        std::size_t start = data.size();
+        data << Encoding::BINARY;
+        if(binary->second.encoder(msg, data)) {
+            return;
+        }
+        // this instance can only be represented as YAML, e.g. a vector of non-primitive entries
+        data.resize(start);
+    }
+
+    auto yaml = i.type_to_converter.find(type);
+    if(yaml == i.type_to_converter.end()) {
+        throw SerializationError(std::string("cannot serialize message of type ")
+                                 + msg.descriptiveName() + ", no converter registered for " + type);
+    }
+
+    data << Encoding::YAML;
+    data << yaml->second.encoder(msg);
+}
+
+TokenData::Ptr MessageSerializer::deserializeMessage(SerializationBuffer &data)
+{
+    MessageSerializer& i = instance();
+
+    std::string type;
+    Encoding encoding;
+    data >> type >> encoding;
+
+    TokenData::Ptr msg;
+    switch(encoding) {
+    case Encoding::BINARY:
+    {
+        auto binary = i.type_to_binary_converter.find(type);
+        if(binary == i.type_to_binary_converter.end()) {
+            throw DeserializationError(std::string("cannot deserialize, no binary converter for type (") + type + ")");
+        }
+        msg = MessageFactory::createMessage(type);
+        binary->second.decoder(data, *msg);
+    }
+        break;
+
+    case Encoding::YAML:
+    {
+        auto yaml = i.type_to_converter.find(type);
+        if(yaml == i.type_to_converter.end()) {
+            throw DeserializationError(std::string("cannot deserialize, no such type (") + type + ")");
+        }
+        YAML::Node node;
+        data >> node;
+        msg = MessageFactory::createMessage(type);
+        try {
+            yaml->second.decoder(node, *msg);
+        } catch(const YAML::Exception& e) {
+            throw DeserializationError(std::string("error while deserializing: ") + e.msg);
+        }
+    }
+        break;
+
+    default:
+        throw DeserializationError(std::string("cannot deserialize, unknown encoding of type (") + type + ")");
+    }
+
+    return msg;
+}
+
+bool MessageSerializer::hasBinaryConverter(const std::string &type)
+{
+    MessageSerializer& i = instance();
+    return i.type_to_binary_converter.find(type) != i.type_to_binary_converter.end();
+}
+
 void MessageSerializer::registerMessage(std::string type, Converter converter)
 {
     MessageSerializer& i = instance();
@@ -110,3 +200,14 @@ void MessageSerializer::registerMessage(std::string type, Converter converter)
 
     i.type_to_converter.insert(std::make_pair(type, converter));
 }
+
+void MessageSerializer::registerBinaryMessage(std::string type, BinaryConverter converter)
+{
+    MessageSerializer& i = instance();
+
+    if(i.type_to_binary_converter.find(type) != i.type_to_binary_converter.end()) {
+        return;
+    }
+
+    i.type_to_binary_converter.insert(std::make_pair(type, converter));
+}
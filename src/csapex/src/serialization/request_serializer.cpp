@@ -79,7 +79,7 @@ SerializablePtr RequestSerializer::deserialize(SerializationBuffer& data)
         uint8_t direction;
         data >> direction;
 
-        uint8_t id;
+        uint32_t id;
         data >> id;
 
         if(direction == 0) {
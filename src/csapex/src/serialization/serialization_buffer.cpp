@@ -106,91 +106,57 @@ SerializationBuffer& SerializationBuffer::readAny (boost::any& any)
 
 
 
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
-union _GFloatIEEE754
-{
-  float v_float;
-  struct {
-    uint mantissa : 23;
-    uint biased_exponent : 8;
-    uint sign : 1;
-  } mpn;
-};
-union _GDoubleIEEE754
-{
-  double v_double;
-  struct {
-    uint mantissa_low : 32;
-    uint mantissa_high : 20;
-    uint biased_exponent : 11;
-    uint sign : 1;
-  } mpn;
-};
-#elif G_BYTE_ORDER == G_BIG_ENDIAN
-union _GFloatIEEE754
-{
-  float v_float;
-  struct {
-    uint sign : 1;
-    uint biased_exponent : 8;
-    uint mantissa : 23;
-  } mpn;
-};
-union _GDoubleIEEE754
-{
-  double v_double;
-  struct {
-    uint sign : 1;
-    uint biased_exponent : 11;
-    uint mantissa_high : 20;
-    uint mantissa_low : 32;
-  } mpn;
-};
-#else /* !G_LITTLE_ENDIAN && !G_BIG_ENDIAN */
-#error unknown ENDIAN type
-#endif /* !G_LITTLE_ENDIAN && !G_BIG_ENDIAN */
+// LENGTHS
+void SerializationBuffer::writeLength(uint64_t length)
+{
+    // LEB128: 7 bits per byte, the highest bit marks that more bytes follow
+    uint8_t bytes[10];
+    std::size_t n = 0;
+    do {
+        uint8_t byte = length & 0x7F;
+        length >>= 7;
+        if(length != 0) {
+            byte |= 0x80;
+        }
+        bytes[n++] = byte;
+    } while(length != 0);
+
+    appendBytes(bytes, n);
+}
+
+uint64_t SerializationBuffer::readLength()
+{
+    uint64_t length = 0;
+    for(std::size_t shift = 0; shift < 64; shift += 7) {
+        apex_assert_lt_hard(pos, size());
+        uint8_t byte = at(pos++);
+        length |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if((byte & 0x80) == 0) {
+            return length;
+        }
+    }
+    apex_assert_hard_msg(false, "malformed length");
+    return length;
+}
+
+
+// FLOATS
+static_assert(std::numeric_limits<float>::is_iec559 && sizeof(float) == sizeof(uint32_t),
+              "floats are transmitted as IEEE 754 single precision numbers");
+static_assert(std::numeric_limits<double>::is_iec559 && sizeof(double) == sizeof(uint64_t),
+              "doubles are transmitted as IEEE 754 double precision numbers");
 
 SerializationBuffer& SerializationBuffer::operator << (float f)
 {
-    _GFloatIEEE754 ieee;
-    ieee.v_float = f;
-
-    /***
-     * sign  | mantissa    |  exponent
-     *   1         23             8
-     *   1   | 2 - 24      | 25 - 32
-     */
-    uint8_t bytes[4];
-    //memset(&bytes[0], 0, 4);
-    bytes[0] = ieee.mpn.sign << 7;
-    bytes[0] |= (ieee.mpn.mantissa >> (23 - 7));
-    bytes[1] = (ieee.mpn.mantissa >> (23 - 7 - 8)) & 0xFF;
-    bytes[2] = (ieee.mpn.mantissa >> (23 - 7 - 16)) & 0xFF;
-    bytes[3] = ieee.mpn.biased_exponent;
-
-    for(uint8_t i = 0; i < 4; ++i) {
-        push_back(bytes[i]);
-    }
-
-    return *this;
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return operator << (bits);
 }
 SerializationBuffer& SerializationBuffer::operator >> (float& f)
 {
-    uint8_t bytes[4];
-    for(uint8_t i = 0; i < 4; ++i) {
-        bytes[i] = at(pos++);
-    }
-
-    _GFloatIEEE754 ieee;
-
-    ieee.mpn.sign = (bytes[0] & (1 << 7)) ? 1 : 0;
-    ieee.mpn.mantissa = ((bytes[0] & (~(1 << 7))) << (23 - 7)) |
-            (bytes[1] << (23 - 7 - 8)) |
-            (bytes[2] << (23 - 7 - 16));
-    ieee.mpn.biased_exponent = bytes[3];
-
-    f = ieee.v_float;
-
+    uint32_t bits;
+    operator >> (bits);
+    std::memcpy(&f, &bits, sizeof(bits));
     return *this;
 }
 
@@ -198,57 +164,15 @@ SerializationBuffer& SerializationBuffer::operator >> (float& f)
 // DOUBLES
 SerializationBuffer& SerializationBuffer::operator << (double d)
 {
-    _GDoubleIEEE754 ieee;
-    ieee.v_double = d;
-
-    /***
-     * sign  | exponent   |  mantissa_high   | mantissa_low
-     *   1         11             20         |   32
-     *   1   | 2 - 12         | 13 - 32      |   32
-     */
-    uint8_t bytes[8];
-    //memset(&bytes[0], 0, 4);
-    bytes[0] = ieee.mpn.sign << 7;
-    bytes[0] |= (ieee.mpn.biased_exponent >> (11 - 7));
-    bytes[1] = (ieee.mpn.biased_exponent << 4);
-    bytes[1] |= (ieee.mpn.mantissa_high >> (20 - 4)) & 0xFF;
-    bytes[2] = (ieee.mpn.mantissa_high >> (20 - 4 - 8)) & 0xFF;
-    bytes[3] = (ieee.mpn.mantissa_high >> (20 - 4 - 16)) & 0xFF;
-    bytes[4] = (ieee.mpn.mantissa_low >> (3*8)) & 0xFF;
-    bytes[5] = (ieee.mpn.mantissa_low >> (2*8)) & 0xFF;
-    bytes[6] = (ieee.mpn.mantissa_low >> (1*8)) & 0xFF;
-    bytes[7] = (ieee.mpn.mantissa_low >> (0*8)) & 0xFF;
-
-
-    for(uint8_t i = 0; i < 8; ++i) {
-        push_back(bytes[i]);
-    }
-
-    return *this;
+    uint64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    return operator << (bits);
 }
 SerializationBuffer& SerializationBuffer::operator >> (double& d)
 {
-    uint8_t bytes[8];
-    for(uint8_t i = 0; i < 8; ++i) {
-        bytes[i] = at(pos++);
-    }
-
-    _GDoubleIEEE754 ieee;
-
-    ieee.mpn.sign = (bytes[0] & (1 << 7)) ? 1 : 0;
-    ieee.mpn.biased_exponent = ((bytes[0] & (~(1 << 7))) << (11 - 7)) |
-            ((bytes[1] & (0xF0)) >> 4);
-    ieee.mpn.mantissa_high = ((bytes[1] & (~(1 << 7))) << (20 - 4)) |
-            (bytes[2] << (20 - 4 - 8)) |
-            (bytes[3] << (20 - 4 - 16));
-
-    ieee.mpn.mantissa_low = (bytes[4] << (3*8)) |
-            (bytes[5] << (2*8)) |
-            (bytes[6] << (1*8)) |
-            (bytes[7] << (0*8));
-
-    d = ieee.v_double;
-
+    uint64_t bits;
+    operator >> (bits);
+    std::memcpy(&d, &bits, sizeof(bits));
     return *this;
 }
 
@@ -256,24 +180,18 @@ SerializationBuffer& SerializationBuffer::operator >> (double& d)
 // STRINGS
 SerializationBuffer& SerializationBuffer::operator << (const std::string& s)
 {
-    apex_assert_lt_hard(s.size(), std::numeric_limits<uint16_t>::max());
-    operator << (static_cast<uint16_t>(s.size()));
-    for(const char& ch : s) {
-        push_back(ch);
-    }
+    writeLength(s.size());
+    appendBytes(s.data(), s.size());
     return *this;
 }
 
 SerializationBuffer& SerializationBuffer::operator >> (std::string& s)
 {
-    uint16_t str_len;
-    operator >> (str_len);
-    apex_assert_lte_hard(pos + str_len, size());
+    uint64_t str_len = readLength();
+    apex_assert_lte_hard(str_len, size() - pos);
 
-    s.resize(str_len, ' ');
-    for(std::size_t i = 0; i < str_len; ++i) {
-        s[i] = at(pos++);
-    }
+    s.assign(reinterpret_cast<const char*>(data() + pos), str_len);
+    pos += str_len;
     return *this;
 }
 
@@ -0,0 +1,243 @@
+/// HEADER
+#include <csapex/utility/cpu_topology.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+#ifndef WIN32
+#include <sched.h>
+#endif
+
+using namespace csapex;
+
+namespace
+{
+bool readFile(const std::string& path, std::string& content)
+{
+    std::ifstream in(path);
+    if(!in) {
+        return false;
+    }
+    std::getline(in, content);
+    return true;
+}
+
+bool readInt(const std::string& path, int& value)
+{
+    std::string content;
+    if(!readFile(path, content)) {
+        return false;
+    }
+    std::stringstream ss(content);
+    return static_cast<bool>(ss >> value);
+}
+}
+
+const CpuTopology& CpuTopology::instance()
+{
+    static CpuTopology topology("/sys/devices/system");
+    return topology;
+}
+
+int CpuTopology::currentNumaNode()
+{
+    const CpuTopology& topology = instance();
+    if(topology.getNumNumaNodes() <= 1) {
+        return -1;
+    }
+#ifndef WIN32
+    int cpu = sched_getcpu();
+    if(cpu >= 0) {
+        return topology.getNumaNode(cpu);
+    }
+#endif
+    return -1;
+}
+
+std::vector<unsigned> CpuTopology::parseCpuList(const std::string& list)
+{
+    std::vector<unsigned> cpus;
+
+    std::stringstream ss(list);
+    std::string range;
+    while(std::getline(ss, range, ',')) {
+        std::size_t dash = range.find('-');
+        try {
+            if(dash == std::string::npos) {
+                cpus.push_back(std::stoul(range));
+            } else {
+                unsigned first = std::stoul(range.substr(0, dash));
+                unsigned last = std::stoul(range.substr(dash + 1));
+                for(unsigned cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            }
+        } catch(const std::logic_error&) {
+            // ignore malformed entries, e.g. trailing whitespace
+        }
+    }
+
+    return cpus;
+}
+
+CpuTopology::CpuTopology(const std::string& sysfs_root)
+    : sockets_(1), numa_nodes_(1), l3_domains_(1)
+{
+    read(sysfs_root);
+}
+
+void CpuTopology::setToDefault(unsigned cpus)
+{
+    cpus_.assign(std::max(1u, cpus), Cpu { 0, 0, 0 });
+    sockets_ = 1;
+    numa_nodes_ = 1;
+    l3_domains_ = 1;
+}
+
+void CpuTopology::read(const std::string& sysfs_root)
+{
+    std::string possible;
+    if(!readFile(sysfs_root + "/cpu/possible", possible)) {
+        setToDefault(std::thread::hardware_concurrency());
+        return;
+    }
+
+    std::vector<unsigned> cpu_ids = parseCpuList(possible);
+    if(cpu_ids.empty()) {
+        setToDefault(std::thread::hardware_concurrency());
+        return;
+    }
+    setToDefault(*std::max_element(cpu_ids.begin(), cpu_ids.end()) + 1);
+
+    std::set<int> sockets;
+    std::map<unsigned, int> l3_domains;
+
+    for(unsigned id : cpu_ids) {
+        std::stringstream dir;
+        dir << sysfs_root << "/cpu/cpu" << id;
+        Cpu& cpu = cpus_[id];
+
+        int socket = 0;
+        if(readInt(dir.str() + "/topology/physical_package_id", socket) && socket >= 0) {
+            cpu.socket = socket;
+        }
+        sockets.insert(cpu.socket);
+
+        // the cache indices are not ordered by level on every architecture
+        for(int index = 0; index < 8; ++index) {
+            std::stringstream cache;
+            cache << dir.str() << "/cache/index" << index;
+
+            int level = 0;
+            if(!readInt(cache.str() + "/level", level)) {
+                break;
+            }
+            std::string shared;
+            if(level == 3 && readFile(cache.str() + "/shared_cpu_list", shared)) {
+                std::vector<unsigned> siblings = parseCpuList(shared);
+                unsigned first = siblings.empty() ? id : *std::min_element(siblings.begin(), siblings.end());
+                auto pos = l3_domains.find(first);
+                if(pos == l3_domains.end()) {
+                    pos = l3_domains.emplace(first, (int) l3_domains.size()).first;
+                }
+                cpu.l3_domain = pos->second;
+                break;
+            }
+        }
+    }
+
+    sockets_ = sockets.size();
+    l3_domains_ = std::max<std::size_t>(1, l3_domains.size());
+
+    std::string online_nodes;
+    if(readFile(sysfs_root + "/node/online", online_nodes)) {
+        std::vector<unsigned> nodes = parseCpuList(online_nodes);
+        for(unsigned node : nodes) {
+            std::stringstream path;
+            path << sysfs_root << "/node/node" << node << "/cpulist";
+            std::string list;
+            if(readFile(path.str(), list)) {
+                for(unsigned cpu : parseCpuList(list)) {
+                    if(cpu < cpus_.size()) {
+                        cpus_[cpu].numa_node = node;
+                    }
+                }
+            }
+        }
+        // nodes without cpus, e.g. memory expanders, cannot host thread groups
+        numa_nodes_ = getNumaNodes().size();
+    }
+}
+
+unsigned CpuTopology::getNumCpus() const
+{
+    return cpus_.size();
+}
+
+unsigned CpuTopology::getNumSockets() const
+{
+    return sockets_;
+}
+
+unsigned CpuTopology::getNumNumaNodes() const
+{
+    return numa_nodes_;
+}
+
+unsigned CpuTopology::getNumL3Domains() const
+{
+    return l3_domains_;
+}
+
+std::vector<int> CpuTopology::getNumaNodes() const
+{
+    std::set<int> nodes;
+    for(const Cpu& cpu : cpus_) {
+        nodes.insert(cpu.numa_node);
+    }
+    return std::vector<int>(nodes.begin(), nodes.end());
+}
+
+int CpuTopology::getSocket(unsigned cpu) const
+{
+    return cpu < cpus_.size() ? cpus_[cpu].socket : -1;
+}
+
+int CpuTopology::getNumaNode(unsigned cpu) const
+{
+    return cpu < cpus_.size() ? cpus_[cpu].numa_node : -1;
+}
+
+int CpuTopology::getL3Domain(unsigned cpu) const
+{
+    return cpu < cpus_.size() ? cpus_[cpu].l3_domain : -1;
+}
+
+std::vector<bool> CpuTopology::getNumaNodeCpus(int node) const
+{
+    std::vector<bool> affinity(cpus_.size(), false);
+    for(std::size_t cpu = 0; cpu < cpus_.size(); ++cpu) {
+        affinity[cpu] = cpus_[cpu].numa_node == node;
+    }
+    return affinity;
+}
+
+int CpuTopology::getNumaNodeOf(const std::vector<bool>& affinity) const
+{
+    int node = -1;
+    std::size_t n = std::min(affinity.size(), cpus_.size());
+    for(std::size_t cpu = 0; cpu < n; ++cpu) {
+        if(affinity[cpu]) {
+            if(node == -1) {
+                node = cpus_[cpu].numa_node;
+            } else if(node != cpus_[cpu].numa_node) {
+                return -1;
+            }
+        }
+    }
+    return node;
+}
@@ -0,0 +1,228 @@
+/// HEADER
+#include <csapex/utility/fd_reactor.h>
+
+/// PROJECT
+#include <csapex/utility/thread.h>
+
+/// SYSTEM
+#include <iostream>
+#ifdef __linux__
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+using namespace csapex;
+
+namespace
+{
+const int MAX_EVENTS = 64;
+}
+
+FdReactor::FdReactor()
+    : running_(false), epoll_fd_(-1), wake_fd_(-1)
+{
+}
+
+FdReactor::~FdReactor()
+{
+    shutdown();
+}
+
+bool FdReactor::watch(int fd, Event event, Callback callback)
+{
+#ifdef __linux__
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if(!running_) {
+            start();
+            if(!running_) {
+                return false;
+            }
+        }
+
+        Watch& watch = watches_[fd];
+        if(event == Event::READABLE) {
+            watch.readable.push_back(callback);
+        } else {
+            watch.writable.push_back(callback);
+        }
+
+        uint32_t events = EPOLLONESHOT;
+        if(!watch.readable.empty()) {
+            events |= EPOLLIN;
+        }
+        if(!watch.writable.empty()) {
+            events |= EPOLLOUT;
+        }
+
+        epoll_event request;
+        request.events = events;
+        request.data.fd = fd;
+
+        // the descriptor may have been closed and reused since it was last watched,
+        // so the kernel's view of the registration is the one that counts
+        if(epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &request) == 0 ||
+                (errno == ENOENT && epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &request) == 0)) {
+            return true;
+        }
+
+        // e.g. regular files, which cannot be watched, but are always ready
+        if(event == Event::READABLE) {
+            watch.readable.pop_back();
+        } else {
+            watch.writable.pop_back();
+        }
+        if(watch.readable.empty() && watch.writable.empty()) {
+            watches_.erase(fd);
+        }
+    }
+
+    callback();
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FdReactor::shutdown()
+{
+#ifdef __linux__
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if(!running_) {
+            return;
+        }
+        running_ = false;
+
+        uint64_t wake = 1;
+        if(::write(wake_fd_, &wake, sizeof(wake)) < 0) {
+            std::cerr << "cannot wake the fd reactor" << std::endl;
+        }
+    }
+
+    if(thread_.joinable()) {
+        thread_.join();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    // waiting callbacks are dropped, their descriptors are never going to be watched again
+    watches_.clear();
+    ::close(wake_fd_);
+    ::close(epoll_fd_);
+    wake_fd_ = -1;
+    epoll_fd_ = -1;
+#endif
+}
+
+void FdReactor::start()
+{
+#ifdef __linux__
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    epoll_event request;
+    request.events = EPOLLIN;
+    request.data.fd = wake_fd_;
+
+    if(epoll_fd_ < 0 || wake_fd_ < 0 || epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &request) != 0) {
+        std::cerr << "cannot create the fd reactor" << std::endl;
+        if(epoll_fd_ >= 0) {
+            ::close(epoll_fd_);
+        }
+        if(wake_fd_ >= 0) {
+            ::close(wake_fd_);
+        }
+        epoll_fd_ = -1;
+        wake_fd_ = -1;
+        return;
+    }
+
+    running_ = true;
+    thread_ = std::thread([this]() {
+        csapex::thread::set_name("fd reactor");
+        run();
+    });
+#endif
+}
+
+void FdReactor::run()
+{
+#ifdef __linux__
+    epoll_event events[MAX_EVENTS];
+
+    while(true) {
+        int n = epoll_wait(epoll_fd_, events, MAX_EVENTS, -1);
+        if(n < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            std::cerr << "the fd reactor has failed to wait" << std::endl;
+            return;
+        }
+
+        std::vector<Callback> ready;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if(!running_) {
+                return;
+            }
+
+            for(int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                auto pos = watches_.find(fd);
+                if(fd == wake_fd_ || pos == watches_.end()) {
+                    continue;
+                }
+
+                Watch& watch = pos->second;
+                bool failed = (events[i].events & (EPOLLERR | EPOLLHUP)) != 0;
+                if(failed || (events[i].events & EPOLLIN)) {
+                    ready.insert(ready.end(), watch.readable.begin(), watch.readable.end());
+                    watch.readable.clear();
+                }
+                if(failed || (events[i].events & EPOLLOUT)) {
+                    ready.insert(ready.end(), watch.writable.begin(), watch.writable.end());
+                    watch.writable.clear();
+                }
+
+                rearm(fd);
+            }
+        }
+
+        for(const Callback& callback : ready) {
+            try {
+                callback();
+            } catch(const std::exception& e) {
+                std::cerr << "a callback of the fd reactor has thrown an exception: " << e.what() << std::endl;
+            }
+        }
+    }
+#endif
+}
+
+void FdReactor::rearm(int fd)
+{
+#ifdef __linux__
+    Watch& watch = watches_[fd];
+
+    if(watch.readable.empty() && watch.writable.empty()) {
+        // the descriptor might already be closed, then the kernel has removed it anyway
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        watches_.erase(fd);
+        return;
+    }
+
+    epoll_event request;
+    request.events = EPOLLONESHOT;
+    if(!watch.readable.empty()) {
+        request.events |= EPOLLIN;
+    }
+    if(!watch.writable.empty()) {
+        request.events |= EPOLLOUT;
+    }
+    request.data.fd = fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &request);
+#endif
+}
@@ -0,0 +1,163 @@
+/// HEADER
+#include <csapex/utility/histogram.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <stdexcept>
+#include <yaml-cpp/yaml.h>
+
+using namespace csapex;
+
+Histogram Histogram::exponential(std::size_t buckets)
+{
+    std::vector<uint64_t> upper_bounds;
+    for(std::size_t i = 0; i + 1 < std::min<std::size_t>(buckets, 65); ++i) {
+        upper_bounds.push_back(uint64_t(1) << i);
+    }
+    return Histogram(upper_bounds);
+}
+
+Histogram Histogram::linear(uint64_t width, std::size_t buckets)
+{
+    std::vector<uint64_t> upper_bounds;
+    for(std::size_t i = 1; i < buckets; ++i) {
+        upper_bounds.push_back(i * width);
+    }
+    return Histogram(upper_bounds);
+}
+
+Histogram::Histogram(const std::vector<uint64_t>& upper_bounds)
+    : upper_bounds_(upper_bounds),
+      counts_(new std::atomic<uint64_t>[upper_bounds.size() + 1]),
+      count_(0), sum_(0), max_(0)
+{
+    if(!std::is_sorted(upper_bounds_.begin(), upper_bounds_.end())) {
+        throw std::invalid_argument("histogram bounds must be ascending");
+    }
+    reset();
+}
+
+Histogram::Histogram(const Histogram& other)
+    : upper_bounds_(other.upper_bounds_),
+      counts_(new std::atomic<uint64_t>[other.upper_bounds_.size() + 1]),
+      count_(other.count_.load()), sum_(other.sum_.load()), max_(other.max_.load())
+{
+    for(std::size_t i = 0, n = getBucketCount(); i < n; ++i) {
+        counts_[i] = other.counts_[i].load();
+    }
+}
+
+Histogram& Histogram::operator = (const Histogram& other)
+{
+    if(this != &other) {
+        if(upper_bounds_ != other.upper_bounds_) {
+            upper_bounds_ = other.upper_bounds_;
+            counts_.reset(new std::atomic<uint64_t>[upper_bounds_.size() + 1]);
+        }
+        for(std::size_t i = 0, n = getBucketCount(); i < n; ++i) {
+            counts_[i] = other.counts_[i].load();
+        }
+        count_ = other.count_.load();
+        sum_ = other.sum_.load();
+        max_ = other.max_.load();
+    }
+    return *this;
+}
+
+void Histogram::record(uint64_t value)
+{
+    std::size_t bucket = std::upper_bound(upper_bounds_.begin(), upper_bounds_.end(), value) - upper_bounds_.begin();
+    counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t max = max_.load(std::memory_order_relaxed);
+    while(value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+void Histogram::reset()
+{
+    for(std::size_t i = 0, n = getBucketCount(); i < n; ++i) {
+        counts_[i] = 0;
+    }
+    count_ = 0;
+    sum_ = 0;
+    max_ = 0;
+}
+
+std::size_t Histogram::getBucketCount() const
+{
+    return upper_bounds_.size() + 1;
+}
+
+uint64_t Histogram::getCount(std::size_t bucket) const
+{
+    return counts_[bucket].load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::getLowerBound(std::size_t bucket) const
+{
+    return bucket == 0 ? 0 : upper_bounds_[bucket - 1];
+}
+
+uint64_t Histogram::getCount() const
+{
+    return count_;
+}
+
+uint64_t Histogram::getMax() const
+{
+    return max_;
+}
+
+double Histogram::getMean() const
+{
+    uint64_t count = count_;
+    return count > 0 ? sum_ / (double) count : 0.0;
+}
+
+uint64_t Histogram::getPercentile(double percentile) const
+{
+    // the bucket counts can be ahead of count_ while samples are recorded, so they are summed up first
+    uint64_t total = 0;
+    for(std::size_t i = 0, n = getBucketCount(); i < n; ++i) {
+        total += getCount(i);
+    }
+    if(total == 0) {
+        return 0;
+    }
+
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(percentile * total + 0.5));
+    uint64_t seen = 0;
+    for(std::size_t i = 0, n = getBucketCount(); i < n; ++i) {
+        seen += getCount(i);
+        if(seen >= rank) {
+            return getLowerBound(i);
+        }
+    }
+    return getLowerBound(getBucketCount() - 1);
+}
+
+void Histogram::save(YAML::Node& node) const
+{
+    node["count"] = getCount();
+    node["mean"] = getMean();
+    node["max"] = getMax();
+    node["p50"] = getPercentile(0.5);
+    node["p90"] = getPercentile(0.9);
+    node["p99"] = getPercentile(0.99);
+
+    // only the buckets that were hit, as pairs of lower bound and count
+    YAML::Node buckets(YAML::NodeType::Sequence);
+    for(std::size_t i = 0, n = getBucketCount(); i < n; ++i) {
+        uint64_t count = getCount(i);
+        if(count > 0) {
+            YAML::Node bucket(YAML::NodeType::Sequence);
+            bucket.push_back(getLowerBound(i));
+            bucket.push_back(count);
+            buckets.push_back(bucket);
+        }
+    }
+    node["buckets"] = buckets;
+}
@@ -0,0 +1,77 @@
+/// HEADER
+#include <csapex/utility/numa_allocator.h>
+
+/// SYSTEM
+#include <new>
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace csapex;
+
+namespace
+{
+thread_local int preferred_node = -1;
+
+// from linux/mempolicy.h, which is not available everywhere
+const int MPOL_PREFERRED_POLICY = 1;
+}
+
+NumaAllocation::PreferredNode::PreferredNode(int node)
+    : previous_(preferred_node)
+{
+    preferred_node = node;
+}
+
+NumaAllocation::PreferredNode::~PreferredNode()
+{
+    preferred_node = previous_;
+}
+
+int NumaAllocation::getPreferredNode()
+{
+    return preferred_node;
+}
+
+int NumaAllocation::getPayloadNode()
+{
+    // asking the kernel for the current cpu is too expensive to do for every token,
+    // so the node is only known while payloads are placed explicitly
+    return preferred_node;
+}
+
+void* NumaAllocation::allocate(std::size_t bytes)
+{
+#if !defined(WIN32) && defined(SYS_mbind)
+    if(bytes >= LARGE_PAYLOAD) {
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+
+        int node = preferred_node;
+        if(node >= 0 && node < (int) (8 * sizeof(unsigned long))) {
+            // the pages are not populated yet, so the policy decides where they are placed.
+            // if binding fails, the pages simply end up on the node that touches them first
+            // the kernel expects the number of mask bits plus one
+            unsigned long mask = 1ul << node;
+            syscall(SYS_mbind, p, bytes, MPOL_PREFERRED_POLICY, &mask, 8 * sizeof(mask) + 1, 0);
+        }
+        return p;
+    }
+#endif
+    return ::operator new(bytes);
+}
+
+void NumaAllocation::deallocate(void* p, std::size_t bytes)
+{
+#if !defined(WIN32) && defined(SYS_mbind)
+    if(bytes >= LARGE_PAYLOAD) {
+        munmap(p, bytes);
+        return;
+    }
+#endif
+    ::operator delete(p);
+}
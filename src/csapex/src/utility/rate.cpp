@@ -10,7 +10,7 @@ Rate::Rate(double frequency, bool immediate)
     : frequency_(frequency),
       immediate_(immediate)
 {
-    last_scheduled_tick_ = std::chrono::system_clock::now();
+    last_scheduled_tick_ = std::chrono::steady_clock::now();
 }
 
 Rate::Rate()
@@ -60,12 +60,11 @@ void Rate::setImmediate(bool immediate)
 
 void Rate::keepUp()
 {
-    std::chrono::milliseconds interval(int(1000.0 / frequency_));
-    auto end_of_cycle = last_scheduled_tick_ + interval;
+    auto end_of_cycle = last_scheduled_tick_ + getInterval();
 
     last_scheduled_tick_ = end_of_cycle;
 
-    auto now = std::chrono::system_clock::now();
+    auto now = std::chrono::steady_clock::now();
     if(end_of_cycle > now) {
         std::this_thread::sleep_until(end_of_cycle);
     }
@@ -73,19 +72,37 @@ void Rate::keepUp()
 
 void Rate::startCycle()
 {
-    last_tick_ = std::chrono::system_clock::now();
+    auto now = std::chrono::steady_clock::now();
+    auto interval = getInterval();
+    auto planned = last_tick_ + interval;
+
+    if(interval > std::chrono::steady_clock::duration::zero() && now >= planned && now - planned < interval) {
+        // stay in phase with the planned cycle, so that wake up latencies don't accumulate
+        last_tick_ = planned;
+    } else {
+        last_tick_ = now;
+    }
 }
 
-std::chrono::system_clock::time_point Rate::endOfCycle() const
+std::chrono::steady_clock::time_point Rate::endOfCycle() const
 {
-    std::chrono::milliseconds interval(int(1000.0 / frequency_));
+    return last_tick_ + getInterval();
+}
+
+std::chrono::steady_clock::duration Rate::getInterval() const
+{
+    if(frequency_ <= 0.0) {
+        return std::chrono::steady_clock::duration::zero();
+    }
 
-    return last_tick_ + interval;
+    // high frequencies need sub-millisecond precision
+    std::chrono::duration<double> interval(1.0 / frequency_);
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval);
 }
 
 void Rate::tick()
 {
-    auto now = std::chrono::system_clock::now();
+    auto now = std::chrono::steady_clock::now();
     real_ticks_.emplace_back(now);
 
     const std::size_t N = 4;
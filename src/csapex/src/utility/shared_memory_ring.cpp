@@ -0,0 +1,320 @@
+/// HEADER
+#include <csapex/utility/shared_memory_ring.h>
+
+/// SYSTEM
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace csapex;
+
+namespace
+{
+const uint32_t MAGIC = 0x43535852; // "CSXR"
+const uint32_t VERSION = 1;
+
+// every record starts with its length, a skip record fills the end of the ring
+const uint32_t SKIP = 0xFFFFFFFF;
+const std::size_t RECORD_HEADER = 8;
+const std::size_t ALIGNMENT = 8;
+
+std::size_t align(std::size_t n)
+{
+    return (n + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+std::string segmentName(const std::string& name)
+{
+    return (!name.empty() && name[0] == '/') ? name : "/" + name;
+}
+
+std::string errorMessage(const std::string& what, const std::string& name)
+{
+    return what + " shared memory segment " + name + ": " + std::strerror(errno);
+}
+}
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex words have to be plain 32 bit integers");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "positions have to be lock-free to be shared between processes");
+
+struct SharedMemoryRing::Header
+{
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint64_t capacity;
+
+    // positions are byte counts since creation, the offset in the ring is the position modulo the capacity
+    alignas(64) std::atomic<uint64_t> head;
+    std::atomic<uint32_t> written;
+    std::atomic<uint32_t> waiting_readers;
+
+    alignas(64) std::atomic<uint64_t> tail;
+    std::atomic<uint32_t> released;
+    std::atomic<uint32_t> waiting_writers;
+};
+
+SharedMemoryRingPtr SharedMemoryRing::create(const std::string& name, std::size_t capacity)
+{
+    std::string segment = segmentName(name);
+    capacity = std::max(align(capacity), 2 * RECORD_HEADER);
+
+    // a segment left behind by a crashed process is replaced
+    ::shm_unlink(segment.c_str());
+
+    int fd = ::shm_open(segment.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if(fd < 0) {
+        throw std::runtime_error(errorMessage("cannot create", segment));
+    }
+
+    std::size_t size = sizeof(Header) + capacity;
+    if(::ftruncate(fd, size) != 0) {
+        std::string error = errorMessage("cannot resize", segment);
+        ::close(fd);
+        ::shm_unlink(segment.c_str());
+        throw std::runtime_error(error);
+    }
+
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(mapping == MAP_FAILED) {
+        std::string error = errorMessage("cannot map", segment);
+        ::close(fd);
+        ::shm_unlink(segment.c_str());
+        throw std::runtime_error(error);
+    }
+
+    Header* header = new (mapping) Header;
+    header->version = VERSION;
+    header->capacity = capacity;
+    header->head = 0;
+    header->written = 0;
+    header->waiting_readers = 0;
+    header->tail = 0;
+    header->released = 0;
+    header->waiting_writers = 0;
+    header->magic.store(MAGIC, std::memory_order_release);
+
+    return SharedMemoryRingPtr(new SharedMemoryRing(segment, fd, mapping, size, true));
+}
+
+SharedMemoryRingPtr SharedMemoryRing::open(const std::string& name)
+{
+    std::string segment = segmentName(name);
+
+    int fd = ::shm_open(segment.c_str(), O_RDWR, 0600);
+    if(fd < 0) {
+        throw std::runtime_error(errorMessage("cannot open", segment));
+    }
+
+    struct stat info;
+    if(::fstat(fd, &info) != 0 || info.st_size < (off_t) sizeof(Header)) {
+        ::close(fd);
+        throw std::runtime_error(std::string("shared memory segment ") + segment + " is not initialized");
+    }
+
+    std::size_t size = info.st_size;
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(mapping == MAP_FAILED) {
+        std::string error = errorMessage("cannot map", segment);
+        ::close(fd);
+        throw std::runtime_error(error);
+    }
+
+    Header* header = static_cast<Header*>(mapping);
+    if(header->magic.load(std::memory_order_acquire) != MAGIC ||
+            header->version != VERSION ||
+            sizeof(Header) + header->capacity > size) {
+        ::munmap(mapping, size);
+        ::close(fd);
+        throw std::runtime_error(std::string("shared memory segment ") + segment + " is not a valid ring");
+    }
+
+    return SharedMemoryRingPtr(new SharedMemoryRing(segment, fd, mapping, size, false));
+}
+
+SharedMemoryRing::SharedMemoryRing(const std::string& name, int fd, void* mapping, std::size_t mapping_size, bool owner)
+    : name_(name), fd_(fd), mapping_(mapping), mapping_size_(mapping_size), owner_(owner),
+      header_(static_cast<Header*>(mapping)),
+      data_(static_cast<uint8_t*>(mapping) + sizeof(Header)),
+      reserved_at_(0), reserved_end_(0)
+{
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+    ::munmap(mapping_, mapping_size_);
+    ::close(fd_);
+    if(owner_) {
+        ::shm_unlink(name_.c_str());
+    }
+}
+
+std::string SharedMemoryRing::getName() const
+{
+    return name_;
+}
+
+std::size_t SharedMemoryRing::getCapacity() const
+{
+    return header_->capacity;
+}
+
+std::size_t SharedMemoryRing::getMaximumRecordSize() const
+{
+    return header_->capacity - RECORD_HEADER;
+}
+
+uint8_t* SharedMemoryRing::reserve(std::size_t length, std::chrono::milliseconds timeout)
+{
+    if(length > getMaximumRecordSize() || length >= SKIP) {
+        throw std::length_error("record does not fit into the shared memory ring");
+    }
+
+    const uint64_t capacity = header_->capacity;
+    const uint64_t total = align(RECORD_HEADER + length);
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    while(true) {
+        uint64_t head = header_->head.load(std::memory_order_relaxed);
+        uint64_t offset = head % capacity;
+        uint64_t contiguous = capacity - offset;
+
+        // records are never split, the rest of the ring is skipped instead
+        uint64_t needed = total <= contiguous ? total : contiguous;
+
+        while(head + needed - header_->tail.load(std::memory_order_acquire) > capacity) {
+            if(std::chrono::steady_clock::now() >= deadline) {
+                return nullptr;
+            }
+            ++header_->waiting_writers;
+            uint32_t released = header_->released.load();
+            if(head + needed - header_->tail.load() > capacity) {
+                wait(header_->released, released, deadline);
+            }
+            --header_->waiting_writers;
+        }
+
+        if(needed < total) {
+            reinterpret_cast<uint32_t&>(data_[offset]) = SKIP;
+            header_->head.store(head + contiguous, std::memory_order_release);
+            ++header_->written;
+            wake(header_->written, header_->waiting_readers);
+            continue;
+        }
+
+        reinterpret_cast<uint32_t&>(data_[offset]) = static_cast<uint32_t>(length);
+        reserved_at_ = head;
+        reserved_end_ = head + total;
+        return data_ + offset + RECORD_HEADER;
+    }
+}
+
+void SharedMemoryRing::commit()
+{
+    if(reserved_end_ == reserved_at_) {
+        return;
+    }
+    header_->head.store(reserved_end_, std::memory_order_release);
+    reserved_at_ = reserved_end_;
+
+    ++header_->written;
+    wake(header_->written, header_->waiting_readers);
+}
+
+bool SharedMemoryRing::write(const void* data, std::size_t length, std::chrono::milliseconds timeout)
+{
+    uint8_t* record = reserve(length, timeout);
+    if(!record) {
+        return false;
+    }
+    std::memcpy(record, data, length);
+    commit();
+    return true;
+}
+
+bool SharedMemoryRing::read(const std::function<void(const uint8_t*, std::size_t)>& reader, std::chrono::milliseconds timeout)
+{
+    const uint64_t capacity = header_->capacity;
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    while(true) {
+        uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+
+        while(header_->head.load(std::memory_order_acquire) == tail) {
+            if(std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            ++header_->waiting_readers;
+            uint32_t written = header_->written.load();
+            if(header_->head.load() == tail) {
+                wait(header_->written, written, deadline);
+            }
+            --header_->waiting_readers;
+        }
+
+        uint64_t offset = tail % capacity;
+        uint32_t length = reinterpret_cast<const uint32_t&>(data_[offset]);
+
+        uint64_t next;
+        bool skip = length == SKIP;
+        if(skip) {
+            next = tail + (capacity - offset);
+        } else {
+            next = tail + align(RECORD_HEADER + length);
+        }
+
+        struct Release
+        {
+            Release(SharedMemoryRing* ring, uint64_t next)
+                : ring(ring), next(next)
+            {}
+            ~Release()
+            {
+                ring->header_->tail.store(next, std::memory_order_release);
+                ++ring->header_->released;
+                wake(ring->header_->released, ring->header_->waiting_writers);
+            }
+            SharedMemoryRing* ring;
+            uint64_t next;
+        } release(this, next);
+
+        if(!skip) {
+            reader(data_ + offset + RECORD_HEADER, length);
+            return true;
+        }
+    }
+}
+
+bool SharedMemoryRing::empty() const
+{
+    return header_->head.load(std::memory_order_acquire) == header_->tail.load(std::memory_order_acquire);
+}
+
+void SharedMemoryRing::wait(std::atomic<uint32_t>& word, uint32_t value, std::chrono::steady_clock::time_point until)
+{
+    auto remaining = until - std::chrono::steady_clock::now();
+    if(remaining <= std::chrono::steady_clock::duration::zero()) {
+        return;
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+
+    timespec timeout;
+    timeout.tv_sec = ns / 1000000000;
+    timeout.tv_nsec = ns % 1000000000;
+
+    // not a private futex, the word is shared between processes
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, value, &timeout, nullptr, 0);
+}
+
+void SharedMemoryRing::wake(std::atomic<uint32_t>& word, std::atomic<uint32_t>& waiting)
+{
+    if(waiting.load() > 0) {
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+}
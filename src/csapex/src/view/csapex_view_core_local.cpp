@@ -214,3 +214,15 @@ void CsApexViewCoreLocal::resetActivity()
 {
     core_->getRoot()->resetActivity();
 }
+
+YAML::Node CsApexViewCoreLocal::getSchedulerTelemetry()
+{
+    YAML::Node telemetry;
+    core_->getThreadPool()->saveTelemetry(telemetry);
+    return telemetry;
+}
+
+void CsApexViewCoreLocal::resetSchedulerTelemetry()
+{
+    core_->getThreadPool()->resetTelemetry();
+}
@@ -49,7 +49,7 @@ CsApexViewCoreRemote::CsApexViewCoreRemote(const std::string &ip, int port, CsAp
 
     const auto& local_facade = core_tmp_->getRoot();
     std::shared_ptr<GraphRemote> remote_root_graph = std::make_shared<GraphRemote>(*std::dynamic_pointer_cast<GraphLocal>(local_facade->getGraph()));
-    remote_root_ = std::make_shared<GraphFacade>(*local_facade->getThreadPool(),
+    remote_root_ = std::make_shared<GraphFacade>(*local_facade->getExecutor(),
                                                  remote_root_graph,
                                                  local_facade->getSubgraphNode(),
                                                  local_facade->getNodeFacade());
@@ -269,3 +269,15 @@ void CsApexViewCoreRemote::resetActivity()
 {
     session_->sendRequest<CoreRequests>(CoreRequests::CoreRequestType::CoreResetActivity);
 }
+
+YAML::Node CsApexViewCoreRemote::getSchedulerTelemetry()
+{
+    auto res = session_->sendRequest<CoreRequests>(CoreRequests::CoreRequestType::CoreGetSchedulerTelemetry);
+    apex_assert_hard(res);
+    return YAML::Load(res->getResult<std::string>());
+}
+
+void CsApexViewCoreRemote::resetSchedulerTelemetry()
+{
+    session_->sendRequest<CoreRequests>(CoreRequests::CoreRequestType::CoreResetSchedulerTelemetry);
+}
@@ -26,6 +26,7 @@
 #include <csapex/profiling/timer.h>
 #include <csapex/scheduling/thread_pool.h>
 #include <csapex/scheduling/thread_group.h>
+#include <csapex/utility/cpu_topology.h>
 #include <csapex/view/designer/designer.h>
 #include <csapex/view/designer/designerio.h>
 #include <csapex/view/designer/tutorial_tree_model.h>
@@ -361,6 +362,21 @@ void CsApexWindow::setupThreadManagement()
         }
     });
 
+    ui->thread_partition->setEnabled(view_core_.getRoot() && view_core_.getRoot()->getThreadPool());
+    QObject::connect(ui->thread_partition, &QPushButton::clicked, [this](bool) {
+        // one group per core
+        std::size_t groups = std::max(1u, std::thread::hardware_concurrency());
+
+        CommandFactory factory(view_core_.getRoot().get());
+        view_core_.getCommandDispatcher()->execute(factory.partitionThreads(groups));
+    });
+
+    ui->thread_numa_placement->setEnabled(CpuTopology::instance().getNumNumaNodes() > 1);
+    QObject::connect(ui->thread_numa_placement, &QPushButton::clicked, [this](bool) {
+        CommandFactory factory(view_core_.getRoot().get());
+        view_core_.getCommandDispatcher()->execute(factory.placeThreadsOnNumaNodes());
+    });
+
     QObject::connect(ui->thread_create, &QPushButton::clicked, [this](bool) {
         bool ok;
         ThreadPool* thread_pool = view_core_.getThreadPool().get();
@@ -0,0 +1,82 @@
+#ifndef MOCKUP_TASK_GENERATOR_H
+#define MOCKUP_TASK_GENERATOR_H
+
+/// PROJECT
+#include <csapex/scheduling/task_generator.h>
+#include <csapex/scheduling/scheduler.h>
+#include <csapex/scheduling/task.h>
+
+/// SYSTEM
+#include <atomic>
+
+namespace csapex
+{
+
+class MockupTaskGenerator : public TaskGenerator
+{
+public:
+    MockupTaskGenerator()
+        : scheduler_(nullptr), paused_(false), running_(0), max_running_(0)
+    {
+    }
+
+    void assignToScheduler(Scheduler* scheduler) override
+    {
+        scheduler_ = scheduler;
+        scheduler_->add(shared_from_this());
+    }
+    Scheduler* getScheduler() const override
+    {
+        return scheduler_;
+    }
+    void detach() override
+    {
+        if(scheduler_) {
+            scheduler_->remove(this);
+            scheduler_ = nullptr;
+        }
+    }
+
+    bool isPaused() const override { return paused_; }
+    void setPause(bool pause) override { paused_ = pause; }
+
+    bool canStartStepping() const override { return true; }
+    void setSteppingMode(bool /*stepping*/) override {}
+    void step() override {}
+    bool isStepping() const override { return false; }
+    bool isStepDone() const override { return true; }
+
+    UUID getUUID() const override { return UUID::NONE; }
+
+    void setError(const std::string& /*msg*/) override {}
+
+    void reset() override {}
+
+    TaskPtr makeTask(std::function<void()> cb, long priority = 0)
+    {
+        return std::make_shared<Task>("mockup", [this, cb]() {
+            int running = ++running_;
+            if(running > max_running_) {
+                max_running_ = running;
+            }
+            cb();
+            --running_;
+        }, priority, this);
+    }
+
+    int getMaximumConcurrency() const
+    {
+        return max_running_;
+    }
+
+private:
+    Scheduler* scheduler_;
+
+    std::atomic<bool> paused_;
+    std::atomic<int> running_;
+    std::atomic<int> max_running_;
+};
+
+}
+
+#endif // MOCKUP_TASK_GENERATOR_H
@@ -0,0 +1,281 @@
+#include <csapex/model/async_process.h>
+#include <csapex/model/graph_facade.h>
+#include <csapex/model/graph/graph_local.h>
+#include <csapex/model/node_facade_local.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/utility/uuid_provider.h>
+
+#include "gtest/gtest.h"
+#include "node_constructing_test.h"
+
+/// SYSTEM
+#include <thread>
+#include <unistd.h>
+
+namespace csapex {
+
+class MockupAsyncNode : public Node
+{
+public:
+    MockupAsyncNode()
+        : min_wait(std::chrono::hours(1))
+    {
+    }
+
+    void setup(NodeModifier& node_modifier) override
+    {
+        in = node_modifier.addInput<int>("input");
+        out = node_modifier.addOutput<int>("output");
+    }
+
+    void setupParameters(Parameterizable& /*parameters*/) override
+    {
+    }
+
+    bool isAsynchronous() const override
+    {
+        return true;
+    }
+
+    void process(NodeModifier& node_modifier, Parameterizable& parameters, Continuation continuation) override
+    {
+        int val = msg::getValue<int>(in);
+        AsyncProcessPtr async = AsyncProcess::make(node_modifier, parameters, continuation);
+        wait(async, val);
+    }
+
+    virtual void wait(AsyncProcessPtr async, int val) = 0;
+
+    void recordWait(AsyncProcess::Clock::time_point start)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        min_wait = std::min(min_wait, AsyncProcess::Clock::now() - start);
+    }
+
+    std::mutex mutex;
+    AsyncProcess::Clock::duration min_wait;
+
+protected:
+    Input* in;
+    Output* out;
+};
+
+class MockupTimerNode : public MockupAsyncNode
+{
+public:
+    void wait(AsyncProcessPtr async, int val) override
+    {
+        auto start = AsyncProcess::Clock::now();
+
+        // wait twice, to check that a step can wait again
+        async->after(std::chrono::milliseconds(2), [this, start, val](NodeModifier&, Parameterizable&, AsyncProcess& async) {
+            async.after(std::chrono::milliseconds(2), [this, start, val](NodeModifier&, Parameterizable&, AsyncProcess&) {
+                recordWait(start);
+                msg::publish(out, 2 * val);
+            });
+        });
+    }
+};
+
+class MockupFutureNode : public MockupAsyncNode
+{
+public:
+    void wait(AsyncProcessPtr async, int val) override
+    {
+        auto start = AsyncProcess::Clock::now();
+
+        std::shared_ptr<std::promise<int>> promise = std::make_shared<std::promise<int>>();
+        std::shared_future<int> future = promise->get_future().share();
+        std::thread([promise, val]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            promise->set_value(3 * val);
+        }).detach();
+
+        async->whenReady(future, [this, start, future](NodeModifier&, Parameterizable&, AsyncProcess&) {
+            recordWait(start);
+            msg::publish(out, future.get());
+        });
+    }
+};
+
+class MockupPipeNode : public MockupAsyncNode
+{
+public:
+    MockupPipeNode()
+    {
+        int result = pipe(fds);
+        apex_assert_hard(result == 0);
+    }
+
+    ~MockupPipeNode()
+    {
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    void wait(AsyncProcessPtr async, int val) override
+    {
+        auto start = AsyncProcess::Clock::now();
+
+        int write_fd = fds[1];
+        std::thread([write_fd, val]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            int value = 5 * val;
+            ssize_t written = write(write_fd, &value, sizeof(value));
+            apex_assert_hard(written == (ssize_t) sizeof(value));
+        }).detach();
+
+        async->whenReadable(fds[0], [this, start](NodeModifier&, Parameterizable&, AsyncProcess&) {
+            recordWait(start);
+            int value = 0;
+            ssize_t received = read(fds[0], &value, sizeof(value));
+            apex_assert_hard(received == (ssize_t) sizeof(value));
+            msg::publish(out, value);
+        });
+    }
+
+    int fds[2];
+};
+
+class MockupAsyncRecordingSink : public Node
+{
+public:
+    void setup(NodeModifier& node_modifier) override
+    {
+        in = node_modifier.addInput<int>("input");
+    }
+
+    void setupParameters(Parameterizable& /*parameters*/) override
+    {
+    }
+
+    void process() override
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        values.push_back(msg::getValue<int>(in));
+    }
+
+    std::vector<int> getValues() const
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return values;
+    }
+
+private:
+    Input* in;
+
+    mutable std::mutex mutex;
+    std::vector<int> values;
+};
+
+class AsyncProcessTest : public NodeConstructingTest
+{
+protected:
+    AsyncProcessTest()
+    {
+        factory.registerNodeType(std::make_shared<NodeConstructor>("MockupTimer", []() {
+            return NodePtr(new MockupTimerNode);
+        }));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("MockupFuture", []() {
+            return NodePtr(new MockupFutureNode);
+        }));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("MockupPipe", []() {
+            return NodePtr(new MockupPipeNode);
+        }));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("MockupAsyncRecordingSink", []() {
+            return NodePtr(new MockupAsyncRecordingSink);
+        }));
+    }
+
+    void SetUp() override
+    {
+        NodeConstructingTest::SetUp();
+
+        main_graph_facade = std::make_shared<GraphFacade>(executor, graph, graph_node);
+    }
+
+    NodeFacadePtr makeNode(const std::string& type, const std::string& name)
+    {
+        NodeFacadePtr node = factory.makeNode(type, UUIDProvider::makeUUID_without_parent(name), graph);
+        apex_assert_hard(node);
+        main_graph_facade->addNode(node);
+        return node;
+    }
+
+    std::vector<int> run(const std::string& type, std::size_t count)
+    {
+        NodeFacadePtr src = makeNode("MockupSource", "src");
+        async = makeNode(type, "async");
+        NodeFacadePtr sink = makeNode("MockupAsyncRecordingSink", "sink");
+
+        main_graph_facade->connect(src, "output", async, "input");
+        main_graph_facade->connect(async, "output", sink, "input");
+
+        // a single thread, so that waiting nodes would stall the whole graph
+        executor.getDefaultGroup()->setWorkerCount(1);
+
+        std::shared_ptr<MockupAsyncRecordingSink> recorder = std::dynamic_pointer_cast<MockupAsyncRecordingSink>(sink->getNode());
+        apex_assert_hard(recorder);
+
+        executor.start();
+
+        auto start = std::chrono::steady_clock::now();
+        while(recorder->getValues().size() < count) {
+            if(std::chrono::steady_clock::now() - start > std::chrono::seconds(10)) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        executor.stop();
+
+        return recorder->getValues();
+    }
+
+    AsyncProcess::Clock::duration getMinimumWait()
+    {
+        std::shared_ptr<MockupAsyncNode> node = std::dynamic_pointer_cast<MockupAsyncNode>(async->getNode());
+        apex_assert_hard(node);
+        std::unique_lock<std::mutex> lock(node->mutex);
+        return node->min_wait;
+    }
+
+    GraphFacadePtr main_graph_facade;
+    NodeFacadePtr async;
+};
+
+TEST_F(AsyncProcessTest, TimerStepsAreExecutedAfterTheDelay)
+{
+    std::vector<int> values = run("MockupTimer", 10);
+    ASSERT_GE(values.size(), 10u);
+    for(std::size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(2 * (int) i, values[i]);
+    }
+
+    EXPECT_GE(getMinimumWait(), std::chrono::milliseconds(4));
+}
+
+TEST_F(AsyncProcessTest, FutureStepsAreExecutedWhenTheFutureIsReady)
+{
+    std::vector<int> values = run("MockupFuture", 10);
+    ASSERT_GE(values.size(), 10u);
+    for(std::size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(3 * (int) i, values[i]);
+    }
+
+    EXPECT_GE(getMinimumWait(), std::chrono::milliseconds(2));
+}
+
+TEST_F(AsyncProcessTest, FileDescriptorStepsAreExecutedWhenReadable)
+{
+    std::vector<int> values = run("MockupPipe", 10);
+    ASSERT_GE(values.size(), 10u);
+    for(std::size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(5 * (int) i, values[i]);
+    }
+
+    EXPECT_GE(getMinimumWait(), std::chrono::milliseconds(2));
+}
+
+}
@@ -4,13 +4,65 @@
 #include <csapex/utility/register_msg.h>
 #include <yaml-cpp/yaml.h>
 #include <csapex/serialization/serialization_buffer.h>
+#include <csapex/serialization/message_serializer.h>
+#include <csapex/msg/generic_vector_message.hpp>
 #include <csapex/msg/io.h>
 
 #include <bitset>
+#include <chrono>
+#include <cstring>
 
 using namespace csapex;
 using namespace connection_types;
 
+namespace csapex
+{
+namespace connection_types
+{
+
+class BinaryMock
+{
+public:
+    std::string payload;
+};
+
+class BinaryMockMessage : public MessageTemplate<BinaryMock, BinaryMockMessage> {};
+
+template <>
+struct type<BinaryMockMessage> {
+    static std::string name() {
+        return "BinaryMockMessage";
+    }
+};
+
+}
+}
+
+namespace YAML {
+template<>
+struct convert<csapex::connection_types::BinaryMockMessage>
+{
+    static Node encode(const csapex::connection_types::BinaryMockMessage& rhs)
+    {
+        Node n;
+        n["payload"] = rhs.value.payload;
+        return n;
+    }
+
+    static bool decode(const Node& node, csapex::connection_types::BinaryMockMessage& rhs)
+    {
+        if(node["payload"].IsDefined()) {
+            rhs.value.payload = node["payload"].as<std::string>();
+        } else {
+            return false;
+        }
+        return true;
+    }
+};
+}
+
+CSAPEX_REGISTER_MESSAGE(csapex::connection_types::BinaryMockMessage);
+
 class BinarySerializationTest : public ::testing::Test
 {
 protected:
@@ -275,3 +327,311 @@ TEST_F(BinarySerializationTest, TestEmptyString)
 
     ASSERT_EQ(str, value);
 }
+
+TEST_F(BinarySerializationTest, TestInt64)
+{
+    std::vector<int64_t> values { 0, -1, 1, std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), 0x0123456789ABCDEF };
+
+    SerializationBuffer buffer;
+    for(int64_t i : values) {
+        buffer << i;
+    }
+    for(int64_t i : values) {
+        int64_t value;
+        buffer >> value;
+        ASSERT_EQ(i, value);
+    }
+}
+
+TEST_F(BinarySerializationTest, TestIntegersAreLittleEndian)
+{
+    SerializationBuffer buffer;
+    buffer << (uint32_t) 0x01020304;
+
+    ASSERT_EQ(SerializationBuffer::HEADER_LENGTH + 4u, buffer.size());
+    ASSERT_EQ(0x04, buffer.at(SerializationBuffer::HEADER_LENGTH));
+    ASSERT_EQ(0x03, buffer.at(SerializationBuffer::HEADER_LENGTH + 1));
+    ASSERT_EQ(0x02, buffer.at(SerializationBuffer::HEADER_LENGTH + 2));
+    ASSERT_EQ(0x01, buffer.at(SerializationBuffer::HEADER_LENGTH + 3));
+}
+
+TEST_F(BinarySerializationTest, TestHeaderContainsLength)
+{
+    SerializationBuffer buffer;
+    buffer << std::string(1000, 'x');
+    buffer.finalize();
+
+    buffer.seek(0);
+    uint32_t length;
+    buffer >> length;
+
+    ASSERT_EQ(buffer.size(), length);
+}
+
+TEST_F(BinarySerializationTest, TestFloatIsExact)
+{
+    std::vector<float> values { 0.0f, -0.0f, 1.0f / 3.0f, std::numeric_limits<float>::denorm_min(),
+                                std::numeric_limits<float>::lowest(), std::numeric_limits<float>::epsilon() };
+    for(float f : values) {
+        SerializationBuffer buffer;
+        buffer << f;
+        float value;
+        buffer >> value;
+
+        ASSERT_EQ(0, std::memcmp(&f, &value, sizeof(float)));
+    }
+}
+
+TEST_F(BinarySerializationTest, TestDoubleIsExact)
+{
+    std::vector<double> values { 0.0, -0.0, 1.0 / 3.0, std::numeric_limits<double>::denorm_min(),
+                                 std::numeric_limits<double>::lowest(), std::numeric_limits<double>::epsilon() };
+    for(double d : values) {
+        SerializationBuffer buffer;
+        buffer << d;
+        double value;
+        buffer >> value;
+
+        ASSERT_EQ(0, std::memcmp(&d, &value, sizeof(double)));
+    }
+}
+
+TEST_F(BinarySerializationTest, TestLengthBoundaries)
+{
+    for(std::size_t length : { 0, 1, 127, 128, 16383, 16384, 65535, 65536, 1 << 21 }) {
+        std::string str(length, 'a');
+
+        SerializationBuffer buffer;
+        buffer << str;
+        std::string value;
+        buffer >> value;
+
+        ASSERT_EQ(str, value);
+    }
+}
+
+TEST_F(BinarySerializationTest, TestLengthIsVarint)
+{
+    SerializationBuffer buffer;
+    buffer << std::string(300, 'a');
+
+    // 300 = 0b10'0101100
+    ASSERT_EQ(SerializationBuffer::HEADER_LENGTH + 2u + 300u, buffer.size());
+    ASSERT_EQ(0xAC, buffer.at(SerializationBuffer::HEADER_LENGTH));
+    ASSERT_EQ(0x02, buffer.at(SerializationBuffer::HEADER_LENGTH + 1));
+}
+
+TEST_F(BinarySerializationTest, TestLargeVector)
+{
+    std::vector<int32_t> vec(100000);
+    for(std::size_t i = 0; i < vec.size(); ++i) {
+        vec[i] = static_cast<int32_t>(i * 7919) - 50000;
+    }
+
+    SerializationBuffer buffer;
+    buffer << vec;
+    std::vector<int32_t> value;
+    buffer >> value;
+
+    ASSERT_EQ(vec, value);
+}
+
+TEST_F(BinarySerializationTest, TestVectorOfStrings)
+{
+    std::vector<std::string> vec;
+    for(std::size_t i = 0; i < 1000; ++i) {
+        vec.push_back(std::string(i % 300, 'a' + (i % 26)));
+    }
+
+    SerializationBuffer buffer;
+    buffer << vec;
+    std::vector<std::string> value;
+    buffer >> value;
+
+    ASSERT_EQ(vec, value);
+}
+
+TEST_F(BinarySerializationTest, TestVectorOfBools)
+{
+    std::vector<bool> vec { true, false, false, true, true };
+
+    SerializationBuffer buffer;
+    buffer << vec;
+    std::vector<bool> value;
+    buffer >> value;
+
+    ASSERT_EQ(vec, value);
+}
+
+TEST_F(BinarySerializationTest, TestReadingPastTheEndThrows)
+{
+    SerializationBuffer buffer;
+    buffer << (uint16_t) 42;
+
+    uint32_t value;
+    ASSERT_ANY_THROW(buffer >> value);
+}
+
+TEST_F(BinarySerializationTest, TestCorruptVectorLengthThrows)
+{
+    SerializationBuffer buffer;
+    buffer.writeLength(std::numeric_limits<uint64_t>::max() / 8);
+
+    std::vector<double> value;
+    ASSERT_ANY_THROW(buffer >> value);
+}
+
+namespace
+{
+double megabytesPerSecond(std::size_t bytes, std::chrono::steady_clock::duration duration)
+{
+    double seconds = std::chrono::duration<double>(duration).count();
+    return bytes / seconds / (1024.0 * 1024.0);
+}
+}
+
+TEST_F(BinarySerializationTest, BenchmarkLargeVectorThroughput)
+{
+    const std::size_t ELEMENTS = 1000000;
+    const int ITERATIONS = 20;
+
+    std::vector<double> vec(ELEMENTS);
+    for(std::size_t i = 0; i < ELEMENTS; ++i) {
+        vec[i] = i * 0.5;
+    }
+
+    std::size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < ITERATIONS; ++i) {
+        SerializationBuffer buffer;
+        buffer << vec;
+        buffer.finalize();
+
+        std::vector<double> value;
+        buffer >> value;
+        ASSERT_EQ(ELEMENTS, value.size());
+
+        bytes += buffer.size();
+    }
+    auto duration = std::chrono::steady_clock::now() - start;
+
+    std::cout << "vector<double> round trip: " << megabytesPerSecond(bytes, duration) << " MB/s" << std::endl;
+}
+
+TEST_F(BinarySerializationTest, BenchmarkSmallPacketThroughput)
+{
+    const int PACKETS = 200000;
+
+    std::size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < PACKETS; ++i) {
+        SerializationBuffer buffer;
+        buffer << (uint8_t) 3 << (int32_t) i << (double) i << std::string("node_42:|:out_0");
+        buffer.finalize();
+
+        uint8_t type;
+        int32_t id;
+        double d;
+        std::string name;
+        buffer >> type >> id >> d >> name;
+        ASSERT_EQ(i, id);
+
+        bytes += buffer.size();
+    }
+    auto duration = std::chrono::steady_clock::now() - start;
+
+    double seconds = std::chrono::duration<double>(duration).count();
+    std::cout << "small packets: " << (PACKETS / seconds) << " packets/s, "
+              << megabytesPerSecond(bytes, duration) << " MB/s" << std::endl;
+}
+
+TEST_F(BinarySerializationTest, ValueMessagesAreEncodedBinary)
+{
+    auto msg = makeEmpty<GenericValueMessage<int>>();
+    msg->value = 42;
+    msg->frame_id = "/base";
+    msg->stamp_micro_seconds = 1234;
+
+    ASSERT_TRUE(MessageSerializer::hasBinaryConverter(msg->typeName()));
+
+    SerializationBuffer buffer;
+    MessageSerializer::serializeMessage(*msg, buffer);
+
+    TokenDataPtr result = MessageSerializer::deserializeMessage(buffer);
+    auto value = std::dynamic_pointer_cast<GenericValueMessage<int>>(result);
+    ASSERT_NE(nullptr, value);
+    ASSERT_EQ(42, value->value);
+    ASSERT_EQ("/base", value->frame_id);
+    ASSERT_EQ(1234u, value->stamp_micro_seconds);
+}
+
+TEST_F(BinarySerializationTest, StringValueMessagesAreEncodedBinary)
+{
+    auto msg = makeEmpty<GenericValueMessage<std::string>>();
+    msg->value = std::string(100000, 'x');
+
+    ASSERT_TRUE(MessageSerializer::hasBinaryConverter(msg->typeName()));
+
+    SerializationBuffer buffer;
+    MessageSerializer::serializeMessage(*msg, buffer);
+
+    auto value = std::dynamic_pointer_cast<GenericValueMessage<std::string>>(MessageSerializer::deserializeMessage(buffer));
+    ASSERT_NE(nullptr, value);
+    ASSERT_EQ(msg->value, value->value);
+}
+
+TEST_F(BinarySerializationTest, VectorMessagesOfNumbersAreEncodedBinary)
+{
+    auto msg = GenericVectorMessage::make<double>();
+    auto values = std::make_shared<std::vector<double>>(100000);
+    for(std::size_t i = 0; i < values->size(); ++i) {
+        values->at(i) = i * 0.25;
+    }
+    msg->set(values);
+    msg->frame_id = "/map";
+
+    SerializationBuffer buffer;
+    MessageSerializer::serializeMessage(*msg, buffer);
+
+    // the vector has to be stored compactly, YAML would need several bytes per entry
+    ASSERT_LT(buffer.size(), values->size() * sizeof(double) + 128);
+
+    auto vector = std::dynamic_pointer_cast<GenericVectorMessage>(MessageSerializer::deserializeMessage(buffer));
+    ASSERT_NE(nullptr, vector);
+    ASSERT_EQ("/map", vector->frame_id);
+    ASSERT_EQ(*values, *vector->makeShared<double>());
+}
+
+TEST_F(BinarySerializationTest, VectorMessagesOfMessagesFallBackToYaml)
+{
+    auto msg = GenericVectorMessage::make<BinaryMockMessage>();
+    auto values = std::make_shared<std::vector<BinaryMockMessage>>(3);
+    values->at(0).value.payload = "a";
+    values->at(1).value.payload = "b";
+    values->at(2).value.payload = "c";
+    msg->set(values);
+
+    SerializationBuffer buffer;
+    MessageSerializer::serializeMessage(*msg, buffer);
+
+    auto vector = std::dynamic_pointer_cast<GenericVectorMessage>(MessageSerializer::deserializeMessage(buffer));
+    ASSERT_NE(nullptr, vector);
+    auto result = vector->makeShared<BinaryMockMessage>();
+    ASSERT_EQ(3u, result->size());
+    ASSERT_EQ("b", result->at(1).value.payload);
+}
+
+TEST_F(BinarySerializationTest, MessagesWithoutBinaryConverterUseYaml)
+{
+    auto msg = std::make_shared<BinaryMockMessage>();
+    msg->value.payload = "foo";
+
+    ASSERT_FALSE(MessageSerializer::hasBinaryConverter(msg->typeName()));
+
+    SerializationBuffer buffer;
+    MessageSerializer::serializeMessage(*msg, buffer);
+
+    auto result = std::dynamic_pointer_cast<BinaryMockMessage>(MessageSerializer::deserializeMessage(buffer));
+    ASSERT_NE(nullptr, result);
+    ASSERT_EQ("foo", result->value.payload);
+}
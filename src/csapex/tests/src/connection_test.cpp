@@ -4,11 +4,15 @@
 #include <csapex/msg/message.h>
 #include <csapex/msg/input.h>
 #include <csapex/msg/static_output.h>
+#include <csapex/msg/io.h>
 #include <csapex/msg/generic_value_message.hpp>
 #include <csapex/msg/direct_connection.h>
 #include <csapex/msg/direct_connection.h>
+#include <csapex/msg/buffered_connection.h>
+#include <csapex/msg/input_transition.h>
 #include <csapex/utility/uuid_provider.h>
 #include <csapex/utility/exceptions.h>
+#include <csapex/utility/numa_allocator.h>
 
 #include "gtest/gtest.h"
 
@@ -115,6 +119,39 @@ TEST_F(ConnectionTest, DirectConnectionCanBeRepeated) {
     recv(23);
 }
 
+TEST_F(ConnectionTest, PayloadIsSharedBetweenConnections) {
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i1 = std::make_shared<Input>(uuid_provider->makeUUID("in1"));
+    InputPtr i2 = std::make_shared<Input>(uuid_provider->makeUUID("in2"));
+
+    DirectConnection::connect(o, i1);
+    DirectConnection::connect(o, i2);
+
+    GenericValueMessage<int>::Ptr msg(new GenericValueMessage<int>);
+    msg->value = 42;
+
+    o->addMessage(std::make_shared<Token>(msg));
+    o->commitMessages(false);
+    o->publish();
+
+    TokenPtr t1 = i1->getToken();
+    TokenPtr t2 = i2->getToken();
+    ASSERT_TRUE(t1 != nullptr);
+    ASSERT_TRUE(t2 != nullptr);
+
+    // every connection has its own meta data...
+    EXPECT_NE(t1.get(), t2.get());
+    // ...but the payload is not copied
+    EXPECT_EQ(msg.get(), t1->getTokenData().get());
+    EXPECT_EQ(msg.get(), t2->getTokenData().get());
+
+    // a mutable message is only created on request
+    GenericValueMessage<int>::Ptr cloned = msg::getClonedMessage<GenericValueMessage<int>>(i1.get());
+    ASSERT_TRUE(cloned != nullptr);
+    EXPECT_NE(msg.get(), cloned.get());
+    EXPECT_EQ(42, cloned->value);
+}
+
 TEST_F(ConnectionTest, InputsCanBeConnectedToOnlyOneOutput) {
     OutputPtr o1 = std::make_shared<StaticOutput>(uuid_provider->makeUUID("o1"));
     OutputPtr o2 = std::make_shared<StaticOutput>(uuid_provider->makeUUID("o2"));
@@ -154,3 +191,291 @@ TEST_F(ConnectionTest, DirectConnectionCanBeDeleted) {
 }
 
 
+
+namespace
+{
+void send(const OutputPtr& o, int val)
+{
+    GenericValueMessage<int>::Ptr msg(new GenericValueMessage<int>);
+    msg->value = val;
+
+    o->addMessage(std::make_shared<Token>(msg));
+    o->commitMessages(false);
+    o->publish();
+}
+
+int valueOf(const TokenConstPtr& token)
+{
+    auto value_message = std::dynamic_pointer_cast<GenericValueMessage<int> const>(token->getTokenData());
+    apex_assert_hard(value_message);
+    return value_message->value;
+}
+}
+
+TEST_F(ConnectionTest, BufferedConnectionHoldsMultipleTokens) {
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+
+    // the transition keeps the input from consuming the tokens immediately
+    InputTransition transition;
+    transition.addInput(i);
+
+    ConnectionPtr connection = BufferedConnection::connect(o, i, 3);
+    EXPECT_EQ(3u, connection->getCapacity());
+    EXPECT_EQ(0u, connection->getOccupancy());
+
+    for(int val = 0; val < 3; ++val) {
+        EXPECT_EQ(Connection::State::DONE, connection->getSourceState());
+        send(o, val);
+        EXPECT_EQ(val + 1, (int) connection->getOccupancy());
+    }
+    EXPECT_EQ(Connection::State::UNREAD, connection->getSourceState());
+
+    // the tokens are presented to the input in order
+    for(int val = 0; val < 3; ++val) {
+        ASSERT_EQ(Connection::State::UNREAD, connection->getState());
+        transition.forwardMessages();
+        EXPECT_EQ(val, valueOf(i->getToken()));
+        transition.notifyMessageProcessed();
+
+        EXPECT_EQ(2 - val, (int) connection->getOccupancy());
+        EXPECT_EQ(Connection::State::DONE, connection->getSourceState());
+    }
+    EXPECT_EQ(Connection::State::DONE, connection->getState());
+}
+
+TEST_F(ConnectionTest, BufferedConnectionNotifiesOutputWhenSpaceIsAvailable) {
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+
+    InputTransition transition;
+    transition.addInput(i);
+
+    ConnectionPtr connection = BufferedConnection::connect(o, i, 2);
+
+    int processed = 0;
+    slim_signal::ScopedConnection c = o->message_processed.connect([&](const ConnectorPtr&) {
+        ++processed;
+    });
+
+    send(o, 1);
+    send(o, 2);
+    EXPECT_EQ(0, processed);
+
+    transition.forwardMessages();
+    transition.notifyMessageProcessed();
+    EXPECT_EQ(1, processed);
+
+    // the buffer was not full, the output is not waiting
+    transition.forwardMessages();
+    transition.notifyMessageProcessed();
+    EXPECT_EQ(1, processed);
+    EXPECT_EQ(0u, connection->getOccupancy());
+}
+
+TEST_F(ConnectionTest, BufferedConnectionWithoutTransitionIsDrained) {
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+
+    ConnectionPtr connection = BufferedConnection::connect(o, i, 4);
+
+    send(o, 42);
+    EXPECT_EQ(42, valueOf(i->getToken()));
+    EXPECT_EQ(0u, connection->getOccupancy());
+
+    send(o, 23);
+    EXPECT_EQ(23, valueOf(i->getToken()));
+}
+
+TEST_F(ConnectionTest, KeepLatestReplacesUnreadTokens) {
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+
+    InputTransition transition;
+    transition.addInput(i);
+
+    ConnectionPtr connection = DirectConnection::connect(o, i);
+    connection->setOverflowPolicy(Connection::OverflowPolicy::KEEP_LATEST);
+
+    int processed = 0;
+    slim_signal::ScopedConnection c = o->message_processed.connect([&](const ConnectorPtr&) {
+        ++processed;
+    });
+
+    // the output never has to wait
+    for(int val = 0; val < 3; ++val) {
+        EXPECT_EQ(Connection::State::DONE, connection->getSourceState());
+        send(o, val);
+    }
+    EXPECT_EQ(2, connection->getDroppedCount());
+
+    transition.forwardMessages();
+    EXPECT_EQ(2, valueOf(i->getToken()));
+
+    // tokens that arrive during processing are presented afterwards, only the newest one is kept
+    send(o, 3);
+    send(o, 4);
+    EXPECT_EQ(3, connection->getDroppedCount());
+
+    transition.notifyMessageProcessed();
+    ASSERT_EQ(Connection::State::UNREAD, connection->getState());
+    transition.forwardMessages();
+    EXPECT_EQ(4, valueOf(i->getToken()));
+    transition.notifyMessageProcessed();
+
+    EXPECT_EQ(0, processed);
+    EXPECT_EQ(0u, connection->getOccupancy());
+}
+
+TEST_F(ConnectionTest, DropOldestKeepsBufferedTokensInOrder) {
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+
+    InputTransition transition;
+    transition.addInput(i);
+
+    ConnectionPtr connection = BufferedConnection::connect(o, i, 3);
+    connection->setOverflowPolicy(Connection::OverflowPolicy::DROP_OLDEST);
+
+    send(o, 0);
+    transition.forwardMessages();
+    EXPECT_EQ(0, valueOf(i->getToken()));
+
+    // the token that is being processed is never dropped
+    for(int val = 1; val < 6; ++val) {
+        EXPECT_EQ(Connection::State::DONE, connection->getSourceState());
+        send(o, val);
+    }
+    EXPECT_EQ(3u, connection->getOccupancy());
+    EXPECT_EQ(3, connection->getDroppedCount());
+
+    for(int val : {4, 5}) {
+        transition.notifyMessageProcessed();
+        transition.forwardMessages();
+        EXPECT_EQ(val, valueOf(i->getToken()));
+    }
+    transition.notifyMessageProcessed();
+    EXPECT_EQ(0u, connection->getOccupancy());
+}
+
+TEST_F(ConnectionTest, KeepLatestBufferKeepsOnlyNewestToken) {
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+
+    InputTransition transition;
+    transition.addInput(i);
+
+    ConnectionPtr connection = BufferedConnection::connect(o, i, 2);
+    connection->setOverflowPolicy(Connection::OverflowPolicy::KEEP_LATEST);
+
+    for(int val = 0; val < 4; ++val) {
+        send(o, val);
+    }
+    EXPECT_EQ(1u, connection->getOccupancy());
+    EXPECT_EQ(3, connection->getDroppedCount());
+
+    transition.forwardMessages();
+    EXPECT_EQ(3, valueOf(i->getToken()));
+}
+
+TEST_F(ConnectionTest, CrossNodeTransfersAreCounted) {
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+
+    InputTransition transition;
+    transition.addInput(i);
+
+    ConnectionPtr connection = DirectConnection::connect(o, i);
+
+    auto consume = [&](int numa_node) {
+        transition.forwardMessages();
+        connection->recordTransfer(numa_node);
+        transition.notifyMessageProcessed();
+    };
+
+    {
+        NumaAllocation::PreferredNode node(1);
+        send(o, 0);
+    }
+    consume(1);
+    EXPECT_EQ(1, connection->getTransferCount());
+    EXPECT_EQ(0, connection->getCrossNodeTransferCount());
+
+    {
+        NumaAllocation::PreferredNode node(0);
+        send(o, 1);
+    }
+    consume(1);
+    EXPECT_EQ(2, connection->getTransferCount());
+    EXPECT_EQ(1, connection->getCrossNodeTransferCount());
+
+    // consumers on unknown nodes are not counted
+    {
+        NumaAllocation::PreferredNode node(0);
+        send(o, 2);
+    }
+    consume(-1);
+    EXPECT_EQ(2, connection->getTransferCount());
+
+    connection->reset();
+    EXPECT_EQ(0, connection->getCrossNodeTransferCount());
+}
+
+TEST_F(ConnectionTest, LeavingBlockReleasesWaitingOutput) {
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+
+    InputTransition transition;
+    transition.addInput(i);
+
+    ConnectionPtr connection = DirectConnection::connect(o, i);
+
+    int processed = 0;
+    slim_signal::ScopedConnection c = o->message_processed.connect([&](const ConnectorPtr&) {
+        ++processed;
+    });
+
+    // the output waits for the blocking connection
+    send(o, 0);
+    transition.forwardMessages();
+    ASSERT_NE(Connection::State::DONE, connection->getSourceState());
+    EXPECT_EQ(0, processed);
+
+    // the token is still being processed, but the output must not wait for it anymore
+    connection->setOverflowPolicy(Connection::OverflowPolicy::KEEP_LATEST);
+    EXPECT_EQ(1, processed);
+    EXPECT_EQ(Connection::State::DONE, connection->getSourceState());
+
+    transition.notifyMessageProcessed();
+    EXPECT_EQ(1, processed);
+}
+
+TEST_F(ConnectionTest, LeavingBlockReleasesOutputWaitingForFullBuffer) {
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+
+    InputTransition transition;
+    transition.addInput(i);
+
+    ConnectionPtr connection = BufferedConnection::connect(o, i, 2);
+
+    int processed = 0;
+    slim_signal::ScopedConnection c = o->message_processed.connect([&](const ConnectorPtr&) {
+        ++processed;
+    });
+
+    send(o, 0);
+    send(o, 1);
+    ASSERT_EQ(Connection::State::UNREAD, connection->getSourceState());
+
+    connection->setOverflowPolicy(Connection::OverflowPolicy::DROP_OLDEST);
+    EXPECT_EQ(1, processed);
+
+    // the output has already been released, processing the tokens does not notify it again
+    for(int val : {0, 1}) {
+        transition.forwardMessages();
+        EXPECT_EQ(val, valueOf(i->getToken()));
+        transition.notifyMessageProcessed();
+    }
+    EXPECT_EQ(1, processed);
+}
@@ -0,0 +1,114 @@
+#include <csapex/utility/cpu_topology.h>
+#include <csapex/utility/numa_allocator.h>
+
+#include "gtest/gtest.h"
+
+/// SYSTEM
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+#include <sys/stat.h>
+
+using namespace csapex;
+
+class CpuTopologyTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char dir[] = "/tmp/csapex_sysfs_XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dir));
+        root = dir;
+    }
+
+    void TearDown() override
+    {
+        std::system(("rm -rf " + root).c_str());
+    }
+
+    void write(const std::string& path, const std::string& content)
+    {
+        // create all parent directories
+        for(std::size_t pos = path.find('/'); pos != std::string::npos; pos = path.find('/', pos + 1)) {
+            mkdir((root + "/" + path.substr(0, pos)).c_str(), 0755);
+        }
+        std::ofstream out(root + "/" + path);
+        out << content << std::endl;
+    }
+
+    // two sockets with four cpus each, every socket is one NUMA node with a shared L3
+    void makeDualSocket()
+    {
+        write("cpu/possible", "0-7");
+        write("node/online", "0-1");
+        write("node/node0/cpulist", "0-3");
+        write("node/node1/cpulist", "4-7");
+        for(int cpu = 0; cpu < 8; ++cpu) {
+            std::string dir = "cpu/cpu" + std::to_string(cpu);
+            write(dir + "/topology/physical_package_id", cpu < 4 ? "0" : "1");
+            write(dir + "/cache/index0/level", "1");
+            write(dir + "/cache/index0/shared_cpu_list", std::to_string(cpu));
+            write(dir + "/cache/index1/level", "3");
+            write(dir + "/cache/index1/shared_cpu_list", cpu < 4 ? "0-3" : "4-7");
+        }
+    }
+
+    std::string root;
+};
+
+TEST_F(CpuTopologyTest, CpuListsAreParsed)
+{
+    std::vector<unsigned> expected { 0, 1, 2, 3, 8, 10, 11 };
+    EXPECT_EQ(expected, CpuTopology::parseCpuList("0-3,8,10-11"));
+    EXPECT_TRUE(CpuTopology::parseCpuList("").empty());
+}
+
+TEST_F(CpuTopologyTest, TopologyIsReadFromSysfs)
+{
+    makeDualSocket();
+    CpuTopology topology(root);
+
+    EXPECT_EQ(8u, topology.getNumCpus());
+    EXPECT_EQ(2u, topology.getNumSockets());
+    EXPECT_EQ(2u, topology.getNumNumaNodes());
+    EXPECT_EQ(2u, topology.getNumL3Domains());
+
+    EXPECT_EQ(0, topology.getSocket(1));
+    EXPECT_EQ(1, topology.getSocket(5));
+    EXPECT_EQ(0, topology.getNumaNode(3));
+    EXPECT_EQ(1, topology.getNumaNode(4));
+    EXPECT_EQ(topology.getL3Domain(0), topology.getL3Domain(3));
+    EXPECT_NE(topology.getL3Domain(0), topology.getL3Domain(7));
+
+    std::vector<bool> node1 = topology.getNumaNodeCpus(1);
+    ASSERT_EQ(8u, node1.size());
+    EXPECT_EQ(4, std::accumulate(node1.begin(), node1.end(), 0));
+    EXPECT_TRUE(node1[4]);
+    EXPECT_FALSE(node1[3]);
+
+    EXPECT_EQ(1, topology.getNumaNodeOf(node1));
+    std::vector<bool> mixed { false, false, false, true, true };
+    EXPECT_EQ(-1, topology.getNumaNodeOf(mixed));
+}
+
+TEST_F(CpuTopologyTest, MissingSysfsIsOneNode)
+{
+    CpuTopology topology(root + "/does_not_exist");
+
+    EXPECT_GE(topology.getNumCpus(), 1u);
+    EXPECT_EQ(1u, topology.getNumSockets());
+    EXPECT_EQ(1u, topology.getNumNumaNodes());
+    EXPECT_EQ(0, topology.getNumaNodeOf(topology.getNumaNodeCpus(0)));
+}
+
+TEST_F(CpuTopologyTest, LargePayloadsCanBeAllocatedForAnotherNode)
+{
+    NumaAllocation::PreferredNode node(0);
+    EXPECT_EQ(0, NumaAllocation::getPreferredNode());
+    EXPECT_EQ(0, NumaAllocation::getPayloadNode());
+
+    std::vector<float, NumaAllocator<float>> large(NumaAllocation::LARGE_PAYLOAD, 1.0f);
+    std::vector<float, NumaAllocator<float>> small(16, 2.0f);
+    EXPECT_EQ(NumaAllocation::LARGE_PAYLOAD, std::accumulate(large.begin(), large.end(), 0.0f));
+    EXPECT_EQ(32.0f, std::accumulate(small.begin(), small.end(), 0.0f));
+}
@@ -0,0 +1,219 @@
+#include <csapex/model/execution_plan.h>
+#include <csapex/model/graph_facade.h>
+#include <csapex/model/node_facade_local.h>
+#include <csapex/model/node_runner.h>
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/model/graph/graph_local.h>
+#include <csapex/utility/uuid_provider.h>
+
+#include "gtest/gtest.h"
+#include "node_constructing_test.h"
+
+/// SYSTEM
+#include <thread>
+
+namespace csapex {
+
+class ExecutionPlanTest : public NodeConstructingTest
+{
+protected:
+    void SetUp() override
+    {
+        NodeConstructingTest::SetUp();
+
+        main_graph_facade = std::make_shared<GraphFacade>(executor, graph, graph_node);
+        graph_local = std::dynamic_pointer_cast<GraphLocal>(graph);
+        ASSERT_NE(nullptr, graph_local);
+    }
+
+    NodeFacadePtr makeNode(const std::string& type, const std::string& name)
+    {
+        NodeFacadePtr node = factory.makeNode(type, UUIDProvider::makeUUID_without_parent(name), graph);
+        apex_assert_hard(node);
+        main_graph_facade->addNode(node);
+        return node;
+    }
+
+    GraphFacadePtr main_graph_facade;
+    GraphLocalPtr graph_local;
+};
+
+TEST_F(ExecutionPlanTest, ComponentsAreOrderedTopologically)
+{
+    NodeFacadePtr sink = makeNode("MockupSink", "sink");
+    NodeFacadePtr combiner = makeNode("DynamicMultiplier", "combiner");
+    NodeFacadePtr times2 = makeNode("StaticMultiplier", "times2");
+    NodeFacadePtr src = makeNode("MockupSource", "src");
+
+    NodeFacadePtr other_src = makeNode("MockupSource", "other_src");
+    NodeFacadePtr other_sink = makeNode("MockupSink", "other_sink");
+
+    main_graph_facade->connect(src, "output", times2, "input");
+    main_graph_facade->connect(times2, "output", combiner, "input_a");
+    main_graph_facade->connect(src, "output", combiner, "input_b");
+    main_graph_facade->connect(combiner, "output", sink, "input");
+    main_graph_facade->connect(other_src, "output", other_sink, "input");
+
+    ExecutionPlan plan(*graph_local);
+    ASSERT_EQ(2u, plan.getComponentCount());
+
+    std::vector<UUID> schedule;
+    for(std::size_t c = 0; c < plan.getComponentCount(); ++c) {
+        std::vector<UUID> s = plan.getSchedule(c);
+        if(s.size() == 4) {
+            schedule = s;
+        } else {
+            EXPECT_EQ(2u, s.size());
+        }
+    }
+    ASSERT_EQ(4u, schedule.size());
+    EXPECT_EQ(src->getUUID(), schedule[0]);
+    EXPECT_EQ(times2->getUUID(), schedule[1]);
+    EXPECT_EQ(combiner->getUUID(), schedule[2]);
+    EXPECT_EQ(sink->getUUID(), schedule[3]);
+}
+
+TEST_F(ExecutionPlanTest, IterationsPassTokensInLockstep)
+{
+    NodeFacadePtr src = makeNode("MockupSource", "src");
+    NodeFacadePtr times2 = makeNode("StaticMultiplier", "times2");
+    NodeFacadePtr combiner = makeNode("DynamicMultiplier", "combiner");
+    NodeFacadePtr sink_p = makeNode("MockupSink", "sink");
+
+    main_graph_facade->connect(src, "output", times2, "input");
+    main_graph_facade->connect(times2, "output", combiner, "input_a");
+    main_graph_facade->connect(src, "output", combiner, "input_b");
+    main_graph_facade->connect(combiner, "output", sink_p, "input");
+
+    std::shared_ptr<MockupSink> sink = std::dynamic_pointer_cast<MockupSink>(sink_p->getNode());
+    ASSERT_NE(nullptr, sink);
+
+    ExecutionPlan plan(*graph_local);
+    ASSERT_EQ(1u, plan.getComponentCount());
+
+    for(int iter = 0; iter < 100; ++iter) {
+        plan.iterate(0);
+        ASSERT_EQ(2 * iter * iter, sink->getValue());
+    }
+    EXPECT_EQ(100, plan.getIterations(0));
+}
+
+TEST_F(ExecutionPlanTest, UnconnectedMandatoryInputsAreRejected)
+{
+    makeNode("MockupSource", "src");
+    makeNode("MockupSink", "sink");
+
+    EXPECT_THROW(ExecutionPlan plan(*graph_local), std::runtime_error);
+}
+
+TEST_F(ExecutionPlanTest, StartedPlanRunsInThreadGroup)
+{
+    NodeFacadePtr src_p = makeNode("MockupSource", "src");
+    NodeFacadePtr sink_p = makeNode("MockupSink", "sink");
+    main_graph_facade->connect(src_p, "output", sink_p, "input");
+
+    std::shared_ptr<MockupSource> src = std::dynamic_pointer_cast<MockupSource>(src_p->getNode());
+    ASSERT_NE(nullptr, src);
+
+    executor.setPause(true);
+    executor.start();
+
+    ExecutionPlan plan(*graph_local);
+    plan.start(executor);
+    executor.setPause(false);
+
+    auto start = std::chrono::steady_clock::now();
+    while(plan.getIterations(0) < 50) {
+        ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // the runners are reattached to the paused groups and cannot process anymore
+    executor.setPause(true);
+    plan.stop();
+
+    // the source has only been processed by the plan
+    EXPECT_EQ(plan.getIterations(0), src->getValue());
+
+    executor.stop();
+}
+
+TEST_F(ExecutionPlanTest, RunnersOfDeletedGroupsReturnToTheDefaultGroup)
+{
+    NodeFacadePtr src_p = makeNode("MockupSource", "src");
+    NodeFacadePtr sink_p = makeNode("MockupSink", "sink");
+    main_graph_facade->connect(src_p, "output", sink_p, "input");
+
+    std::shared_ptr<MockupSource> src = std::dynamic_pointer_cast<MockupSource>(src_p->getNode());
+    ASSERT_NE(nullptr, src);
+
+    NodeRunnerPtr runner = std::dynamic_pointer_cast<NodeFacadeLocal>(src_p)->getNodeRunner();
+    ASSERT_NE(nullptr, runner);
+    int group_id = executor.createNewGroupFor(runner.get(), "deleted");
+
+    executor.start();
+
+    ExecutionPlan plan(*graph_local);
+    plan.start(executor);
+
+    auto start = std::chrono::steady_clock::now();
+    while(plan.getIterations(0) < 10) {
+        ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // the runner is detached, so the group looks empty and can be deleted while the plan runs
+    executor.removeGroup(group_id);
+
+    plan.stop();
+    EXPECT_EQ(executor.getDefaultGroup(), executor.getGroupFor(runner.get()));
+
+    // the source is processed by its runner again
+    int value = src->getValue();
+    start = std::chrono::steady_clock::now();
+    while(src->getValue() <= value) {
+        ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    executor.stop();
+}
+
+TEST_F(ExecutionPlanTest, GraphChangesStopThePlan)
+{
+    NodeFacadePtr src_p = makeNode("MockupSource", "src");
+    NodeFacadePtr sink_p = makeNode("MockupSink", "sink");
+    main_graph_facade->connect(src_p, "output", sink_p, "input");
+
+    executor.start();
+
+    ExecutionPlan plan(*graph_local);
+    bool invalidated = false;
+    plan.invalidated.connect([&]() {
+        invalidated = true;
+    });
+    plan.start(executor);
+
+    auto start = std::chrono::steady_clock::now();
+    while(plan.getIterations(0) < 10) {
+        ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    makeNode("MockupSink", "other_sink");
+
+    EXPECT_TRUE(invalidated);
+    EXPECT_FALSE(plan.isValid());
+    EXPECT_FALSE(plan.isRunning());
+    EXPECT_THROW(plan.iterate(0), std::runtime_error);
+
+    // the iteration in progress has been drained, no further iterations are started
+    long iterations = plan.getIterations(0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(iterations, plan.getIterations(0));
+
+    executor.stop();
+}
+
+}
@@ -0,0 +1,199 @@
+#include <csapex/scheduling/fused_chain.h>
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/scheduling/timed_queue.h>
+
+#include "gtest/gtest.h"
+#include "test_exception_handler.h"
+#include "mockup_task_generator.h"
+
+/// SYSTEM
+#include <thread>
+
+using namespace csapex;
+
+class FusedChainTest : public ::testing::Test
+{
+protected:
+    FusedChainTest()
+        : group(std::make_shared<ThreadGroup>(std::make_shared<TimedQueue>(), eh, "fused")),
+          chain(std::make_shared<FusedChain>(std::vector<UUID>()))
+    {
+        group->setWorkerCount(4);
+        for(int i = 0; i < 3; ++i) {
+            auto generator = std::make_shared<MockupTaskGenerator>();
+            generator->assignToScheduler(group.get());
+            generators.push_back(generator);
+        }
+        group->start();
+    }
+
+    ~FusedChainTest()
+    {
+        group->stop();
+    }
+
+    // a member task runs its body through the chain, like the execution task of a fused node
+    TaskPtr makeMember(std::size_t index, std::function<void()> body)
+    {
+        MockupTaskGenerator* generator = generators.at(index).get();
+        FusedChainPtr c = chain;
+        return generator->makeTask([generator, c, body]() {
+            c->run(generator, body);
+        });
+    }
+
+    // makes a member ready, like an input transition that receives a message
+    void trigger(std::size_t index, const TaskPtr& task)
+    {
+        if(!chain->defer(generators.at(index).get(), task)) {
+            group->schedule(task);
+        }
+    }
+
+    bool waitFor(const std::atomic<int>& counter, int expected)
+    {
+        auto start = std::chrono::steady_clock::now();
+        while(counter < expected) {
+            if(std::chrono::steady_clock::now() - start > std::chrono::seconds(10)) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    TestExceptionHandler eh;
+    ThreadGroupPtr group;
+    FusedChainPtr chain;
+    std::vector<std::shared_ptr<MockupTaskGenerator>> generators;
+};
+
+TEST_F(FusedChainTest, SuccessorsAreExecutedByTheSameTask)
+{
+    std::atomic<int> done(0);
+    std::vector<std::thread::id> threads(3);
+    std::vector<int> order;
+
+    TaskPtr third = makeMember(2, [&]() {
+        threads[2] = std::this_thread::get_id();
+        order.push_back(2);
+        ++done;
+    });
+    TaskPtr second = makeMember(1, [&]() {
+        threads[1] = std::this_thread::get_id();
+        trigger(2, third);
+        order.push_back(1);
+    });
+    TaskPtr first = makeMember(0, [&]() {
+        threads[0] = std::this_thread::get_id();
+        trigger(1, second);
+        order.push_back(0);
+    });
+
+    group->schedule(first);
+    ASSERT_TRUE(waitFor(done, 1));
+
+    EXPECT_EQ(threads[0], threads[1]);
+    EXPECT_EQ(threads[0], threads[2]);
+
+    // successors start after their predecessor is done
+    std::vector<int> expected { 0, 1, 2 };
+    EXPECT_EQ(expected, order);
+
+    EXPECT_EQ(2, chain->getFusedExecutions());
+}
+
+TEST_F(FusedChainTest, TasksAreNotDeferredOutsideOfTheChain)
+{
+    std::atomic<int> done(0);
+    TaskPtr task = makeMember(0, [&]() {
+        ++done;
+    });
+
+    // not executed by a member
+    EXPECT_FALSE(chain->defer(generators[0].get(), task));
+
+    // executed by a member of another chain
+    FusedChainPtr other = std::make_shared<FusedChain>(std::vector<UUID>());
+    bool deferred = true;
+    other->run(generators[1].get(), [&]() {
+        deferred = chain->defer(generators[0].get(), task);
+    });
+    EXPECT_FALSE(deferred);
+    EXPECT_EQ(0, chain->getFusedExecutions());
+    EXPECT_EQ(0, done);
+}
+
+TEST_F(FusedChainTest, BusyMembersAreScheduled)
+{
+    std::atomic<int> done(0);
+    TaskPtr second = makeMember(1, [&]() {
+        ++done;
+    });
+    TaskPtr first = makeMember(0, [&]() {
+        trigger(1, second);
+        ++done;
+    });
+
+    // the second member is executed somewhere else at the moment
+    ASSERT_TRUE(generators[1]->tryLockExecution());
+
+    group->schedule(first);
+    ASSERT_TRUE(waitFor(done, 1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(1, done);
+
+    for(const TaskPtr& held_back : generators[1]->unlockExecution()) {
+        held_back->setScheduled(false);
+        group->schedule(held_back);
+    }
+    ASSERT_TRUE(waitFor(done, 2));
+    EXPECT_EQ(0, chain->getFusedExecutions());
+}
+
+TEST_F(FusedChainTest, PausedMembersAreScheduled)
+{
+    std::atomic<int> done(0);
+    std::vector<std::thread::id> threads(2);
+
+    TaskPtr second = makeMember(1, [&]() {
+        threads[1] = std::this_thread::get_id();
+        ++done;
+    });
+    TaskPtr first = makeMember(0, [&]() {
+        threads[0] = std::this_thread::get_id();
+        trigger(1, second);
+        // paused after the task has been deferred
+        generators[1]->setPause(true);
+        ++done;
+    });
+
+    group->schedule(first);
+    ASSERT_TRUE(waitFor(done, 2));
+    EXPECT_EQ(0, chain->getFusedExecutions());
+}
+
+TEST_F(FusedChainTest, InvalidatedChainsScheduleDeferredTasks)
+{
+    std::atomic<int> done(0);
+    TaskPtr second = makeMember(1, [&]() {
+        ++done;
+    });
+    TaskPtr first = makeMember(0, [&]() {
+        trigger(1, second);
+        // e.g. the graph is edited while the chain is running
+        chain->invalidate();
+        ++done;
+    });
+
+    group->schedule(first);
+    ASSERT_TRUE(waitFor(done, 2));
+    EXPECT_EQ(0, chain->getFusedExecutions());
+
+    // no task is deferred anymore
+    bool deferred = true;
+    chain->run(generators[0].get(), [&]() {
+        deferred = chain->defer(generators[1].get(), second);
+    });
+    EXPECT_FALSE(deferred);
+}
@@ -0,0 +1,86 @@
+#include <csapex/utility/histogram.h>
+
+#include "gtest/gtest.h"
+
+/// SYSTEM
+#include <thread>
+#include <yaml-cpp/yaml.h>
+
+using namespace csapex;
+
+TEST(HistogramTest, ExponentialBucketsAreLogarithmic)
+{
+    Histogram histogram = Histogram::exponential();
+    ASSERT_EQ(64u, histogram.getBucketCount());
+    EXPECT_EQ(0u, histogram.getLowerBound(0));
+    EXPECT_EQ(1u, histogram.getLowerBound(1));
+    EXPECT_EQ(1024u, histogram.getLowerBound(11));
+
+    histogram.record(0);
+    histogram.record(1500);
+    histogram.record(2047);
+    histogram.record(2048);
+
+    EXPECT_EQ(1u, histogram.getCount(0));
+    EXPECT_EQ(2u, histogram.getCount(11));
+    EXPECT_EQ(1u, histogram.getCount(12));
+    EXPECT_EQ(4u, histogram.getCount());
+    EXPECT_EQ(2048u, histogram.getMax());
+    EXPECT_DOUBLE_EQ((1500 + 2047 + 2048) / 4.0, histogram.getMean());
+}
+
+TEST(HistogramTest, PercentilesAreBucketLowerBounds)
+{
+    Histogram histogram = Histogram::linear(10, 11);
+    for(int i = 0; i < 90; ++i) {
+        histogram.record(5);
+    }
+    for(int i = 0; i < 10; ++i) {
+        histogram.record(95);
+    }
+    histogram.record(250);
+
+    EXPECT_EQ(0u, histogram.getPercentile(0.5));
+    EXPECT_EQ(90u, histogram.getPercentile(0.95));
+    EXPECT_EQ(100u, histogram.getPercentile(1.0));
+}
+
+TEST(HistogramTest, CopiesAreSnapshots)
+{
+    Histogram histogram = Histogram::exponential(8);
+    histogram.record(3);
+
+    Histogram snapshot = histogram;
+    histogram.record(3);
+    histogram.reset();
+
+    EXPECT_EQ(0u, histogram.getCount());
+    EXPECT_EQ(1u, snapshot.getCount());
+    EXPECT_EQ(1u, snapshot.getCount(2));
+
+    YAML::Node node;
+    snapshot.save(node);
+    EXPECT_EQ(1u, node["count"].as<uint64_t>());
+    ASSERT_EQ(1u, node["buckets"].size());
+    EXPECT_EQ(2u, node["buckets"][0][0].as<uint64_t>());
+}
+
+TEST(HistogramTest, SamplesCanBeRecordedConcurrently)
+{
+    Histogram histogram = Histogram::exponential();
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t) {
+        threads.emplace_back([&histogram, t]() {
+            for(int i = 0; i < 10000; ++i) {
+                histogram.record(i * (t + 1));
+            }
+        });
+    }
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(40000u, histogram.getCount());
+    EXPECT_EQ(9999u * 4, histogram.getMax());
+}
@@ -0,0 +1,130 @@
+#include <csapex/scheduling/inline_executor.h>
+
+#include "gtest/gtest.h"
+#include "test_exception_handler.h"
+#include "mockup_task_generator.h"
+
+/// SYSTEM
+#include <thread>
+
+using namespace csapex;
+
+class InlineExecutorTest : public ::testing::Test
+{
+protected:
+    InlineExecutorTest()
+        : executor(eh),
+          generator(std::make_shared<MockupTaskGenerator>())
+    {
+        executor.add(generator.get());
+        executor.start();
+    }
+
+    TestExceptionHandler eh;
+    InlineExecutor executor;
+    std::shared_ptr<MockupTaskGenerator> generator;
+};
+
+TEST_F(InlineExecutorTest, TasksAreExecutedOnTheCallingThread)
+{
+    std::thread::id executing_thread;
+    executor.getScheduler()->schedule(generator->makeTask([&]() {
+        executing_thread = std::this_thread::get_id();
+    }));
+
+    EXPECT_EQ(1u, executor.runUntilIdle());
+    EXPECT_EQ(std::this_thread::get_id(), executing_thread);
+    EXPECT_FALSE(executor.spinOnce());
+}
+
+TEST_F(InlineExecutorTest, SuccessorsAreExecutedDepthFirst)
+{
+    Scheduler* scheduler = executor.getScheduler();
+    std::vector<std::string> order;
+
+    auto make = [&](const std::string& name, std::vector<TaskPtr> successors) {
+        return generator->makeTask([&order, scheduler, name, successors]() {
+            order.push_back(name);
+            for(auto it = successors.rbegin(); it != successors.rend(); ++it) {
+                scheduler->schedule(*it);
+            }
+        });
+    };
+
+    // a -> (a1 -> a2), b
+    TaskPtr a2 = make("a2", {});
+    TaskPtr a1 = make("a1", { a2 });
+    TaskPtr a = make("a", { a1 });
+    TaskPtr b = make("b", {});
+
+    scheduler->schedule(b);
+    scheduler->schedule(a);
+
+    EXPECT_EQ(4u, executor.runUntilIdle());
+    std::vector<std::string> expected { "a", "a1", "a2", "b" };
+    EXPECT_EQ(expected, order);
+}
+
+TEST_F(InlineExecutorTest, DelayedTasksAreExecutedWhenDue)
+{
+    int executed = 0;
+    auto due = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+    executor.getScheduler()->scheduleDelayed(generator->makeTask([&]() {
+        ++executed;
+    }), due);
+
+    EXPECT_EQ(0u, executor.runUntilIdle());
+    EXPECT_EQ(0, executed);
+    EXPECT_EQ(due, executor.getScheduler()->getNextDueTime());
+
+    executor.runFor(std::chrono::milliseconds(50));
+    EXPECT_EQ(1, executed);
+    EXPECT_GE(std::chrono::steady_clock::now(), due);
+}
+
+TEST_F(InlineExecutorTest, TasksOfOtherThreadsAreHandedOver)
+{
+    std::atomic<int> executed(0);
+    std::thread::id executing_thread;
+
+    std::thread other([&]() {
+        for(int i = 0; i < 10; ++i) {
+            executor.getScheduler()->schedule(generator->makeTask([&]() {
+                executing_thread = std::this_thread::get_id();
+                ++executed;
+            }));
+        }
+    });
+    other.join();
+
+    EXPECT_EQ(10u, executor.runUntilIdle());
+    EXPECT_EQ(10, executed);
+    EXPECT_EQ(std::this_thread::get_id(), executing_thread);
+}
+
+TEST_F(InlineExecutorTest, PausedExecutorDoesNotExecuteTasks)
+{
+    int executed = 0;
+    executor.setPause(true);
+    executor.getScheduler()->schedule(generator->makeTask([&]() {
+        ++executed;
+    }));
+
+    EXPECT_EQ(0u, executor.runUntilIdle());
+    EXPECT_EQ(0, executed);
+
+    executor.setPause(false);
+    EXPECT_EQ(1u, executor.runUntilIdle());
+    EXPECT_EQ(1, executed);
+}
+
+TEST_F(InlineExecutorTest, RemovedGeneratorsKeepTheirTasks)
+{
+    TaskPtr task = generator->makeTask([]() {});
+    executor.getScheduler()->schedule(task);
+
+    std::vector<TaskPtr> remaining = executor.getScheduler()->remove(generator.get());
+    ASSERT_EQ(1u, remaining.size());
+    EXPECT_EQ(task, remaining.front());
+    EXPECT_EQ(0u, executor.runUntilIdle());
+}
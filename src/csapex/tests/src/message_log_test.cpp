@@ -0,0 +1,221 @@
+#include "gtest/gtest.h"
+
+#include <csapex/msg/message_log_writer.h>
+#include <csapex/msg/message_log_reader.h>
+#include <csapex/msg/message_log_provider.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/param/parameter.h>
+#include <csapex/utility/uuid_provider.h>
+
+/// SYSTEM
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+using namespace csapex;
+using namespace connection_types;
+
+namespace
+{
+std::string logPath(const std::string& test)
+{
+    return "/tmp/csapex_message_log_" + test + "_" + std::to_string(::getpid()) + ".apexlog";
+}
+
+GenericValueMessage<int>::Ptr makeValue(int value, Message::Stamp stamp)
+{
+    auto msg = makeEmpty<GenericValueMessage<int>>();
+    msg->value = value;
+    msg->stamp_micro_seconds = stamp;
+    return msg;
+}
+
+int valueOf(const TokenDataConstPtr& msg)
+{
+    auto value = std::dynamic_pointer_cast<GenericValueMessage<int> const>(msg);
+    return value ? value->value : -1;
+}
+}
+
+class MessageLogTest : public ::testing::Test
+{
+protected:
+    MessageLogTest()
+        : out_a(UUIDProvider::makeUUID_without_parent("node_0:|:out_0")),
+          out_b(UUIDProvider::makeUUID_without_parent("node_1:|:out_0"))
+    {
+    }
+
+    virtual void TearDown() override
+    {
+        for(const std::string& path : paths) {
+            std::remove(path.c_str());
+        }
+    }
+
+    std::string makePath(const std::string& test)
+    {
+        paths.push_back(logPath(test));
+        return paths.back();
+    }
+
+    /// records 0..count-1, alternating between out_a and out_b, 1ms apart
+    void record(const std::string& path, int count, std::size_t chunk_size = 1 << 20)
+    {
+        MessageLogWriter writer(path, chunk_size);
+        for(int i = 0; i < count; ++i) {
+            writer.write(i % 2 == 0 ? out_a : out_b, *makeValue(i, 1000 + i), std::chrono::milliseconds(i));
+        }
+    }
+
+    UUID out_a;
+    UUID out_b;
+
+    std::vector<std::string> paths;
+};
+
+TEST_F(MessageLogTest, RecordsCanBeReadBack)
+{
+    std::string path = makePath("read_back");
+    record(path, 100);
+
+    MessageLogReader reader(path);
+    ASSERT_TRUE(reader.isIndexed());
+    ASSERT_EQ(100u, reader.size());
+
+    std::vector<UUID> outputs = reader.getOutputs();
+    ASSERT_EQ(2u, outputs.size());
+    ASSERT_EQ(out_a, outputs[0]);
+    ASSERT_EQ(out_b, outputs[1]);
+
+    for(std::size_t i = 0; i < reader.size(); ++i) {
+        MessageLogReader::Record record = reader.read(i);
+        ASSERT_EQ((int) i, valueOf(record.message));
+        ASSERT_EQ(1000 + i, record.stamp);
+        ASSERT_EQ(std::chrono::milliseconds(i), record.time);
+        ASSERT_EQ(i % 2, reader.getOutput(i));
+        ASSERT_EQ(outputs[i % 2], record.output);
+    }
+}
+
+TEST_F(MessageLogTest, RecordsCanBeFoundByTime)
+{
+    std::string path = makePath("seek");
+    record(path, 1000, 256);
+
+    MessageLogReader reader(path);
+    ASSERT_EQ(1000u, reader.size());
+
+    ASSERT_EQ(0u, reader.lowerBound(std::chrono::microseconds(0)));
+    ASSERT_EQ(500u, reader.lowerBound(std::chrono::milliseconds(500)));
+    ASSERT_EQ(501u, reader.lowerBound(std::chrono::microseconds(500001)));
+    ASSERT_EQ(1000u, reader.lowerBound(std::chrono::seconds(10)));
+
+    ASSERT_EQ(733, valueOf(reader.read(reader.lowerBound(std::chrono::microseconds(732500))).message));
+}
+
+TEST_F(MessageLogTest, UnfinishedLogsAreIndexedFromTheirChunks)
+{
+    std::string path = makePath("unfinished");
+    std::string copy = makePath("unfinished_copy");
+
+    {
+        MessageLogWriter writer(path, 128);
+        for(int i = 0; i < 50; ++i) {
+            writer.write(i % 2 == 0 ? out_a : out_b, *makeValue(i, i), std::chrono::milliseconds(i));
+        }
+        writer.flush();
+
+        // copy the log before the index is written, as if the recording process had crashed
+        std::ifstream in(path, std::ios::binary);
+        std::ofstream out(copy, std::ios::binary);
+        out << in.rdbuf();
+    }
+
+    MessageLogReader reader(copy);
+    ASSERT_FALSE(reader.isIndexed());
+    ASSERT_EQ(50u, reader.size());
+    ASSERT_EQ(2u, reader.getOutputs().size());
+    ASSERT_EQ(49, valueOf(reader.read(49).message));
+    ASSERT_EQ(20u, reader.lowerBound(std::chrono::milliseconds(20)));
+}
+
+TEST_F(MessageLogTest, OtherFilesAreRejected)
+{
+    std::string path = makePath("invalid");
+    {
+        std::ofstream out(path);
+        out << "this is not a message log";
+    }
+
+    ASSERT_THROW(MessageLogReader reader(path), std::runtime_error);
+}
+
+TEST_F(MessageLogTest, ProviderReplaysEveryOutputInItsSlot)
+{
+    std::string path = makePath("provider");
+    record(path, 10);
+
+    MessageLogProvider provider;
+    provider.load(path);
+
+    ASSERT_EQ(2u, provider.slotCount());
+
+    std::vector<int> slot_a;
+    std::vector<int> slot_b;
+
+    auto start = std::chrono::steady_clock::now();
+    while(provider.getIndex() < 10) {
+        if(!provider.hasNext()) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+        provider.prepareNext();
+        if(Message::Ptr msg = provider.next(0)) {
+            slot_a.push_back(valueOf(msg));
+        }
+        if(Message::Ptr msg = provider.next(1)) {
+            slot_b.push_back(valueOf(msg));
+        }
+    }
+    auto duration = std::chrono::steady_clock::now() - start;
+
+    ASSERT_EQ((std::vector<int> { 0, 2, 4, 6, 8 }), slot_a);
+    ASSERT_EQ((std::vector<int> { 1, 3, 5, 7, 9 }), slot_b);
+    ASSERT_FALSE(provider.hasNext());
+
+    // by default, the recorded rate is kept
+    ASSERT_GE(duration, std::chrono::milliseconds(9));
+}
+
+TEST_F(MessageLogTest, ProviderCanReplayAsFastAsPossible)
+{
+    std::string path = makePath("provider_fast");
+    {
+        MessageLogWriter writer(path);
+        for(int i = 0; i < 10; ++i) {
+            writer.write(out_a, *makeValue(i, i), std::chrono::seconds(i));
+        }
+    }
+
+    MessageLogProvider provider;
+    for(const param::ParameterPtr& p : provider.getParameters()) {
+        if(p->name() == "playback/realtime") {
+            p->set(false);
+        }
+    }
+    provider.load(path);
+
+    for(int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(provider.hasNext());
+        provider.prepareNext();
+        ASSERT_EQ(i, valueOf(provider.next(0)));
+    }
+    ASSERT_FALSE(provider.hasNext());
+
+    provider.seekTime(std::chrono::seconds(7));
+    ASSERT_TRUE(provider.hasNext());
+    provider.prepareNext();
+    ASSERT_EQ(7, valueOf(provider.next(0)));
+}
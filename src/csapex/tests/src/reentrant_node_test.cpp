@@ -0,0 +1,273 @@
+#include <csapex/model/graph_facade.h>
+#include <csapex/model/graph/graph_local.h>
+#include <csapex/model/node_facade_local.h>
+#include <csapex/model/node_worker.h>
+#include <csapex/model/node_state.h>
+#include <csapex/msg/invocation_context.h>
+#include <csapex/msg/input.h>
+#include <csapex/msg/static_output.h>
+#include <csapex/msg/direct_connection.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/param/parameter_factory.h>
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/utility/uuid_provider.h>
+
+#include "gtest/gtest.h"
+#include "node_constructing_test.h"
+
+/// SYSTEM
+#include <thread>
+
+namespace csapex {
+
+class MockupReentrantNode : public Node
+{
+public:
+    MockupReentrantNode()
+        : running(0), max_running(0)
+    {
+    }
+
+    void setup(NodeModifier& node_modifier) override
+    {
+        in = node_modifier.addInput<int>("input");
+        out = node_modifier.addOutput<int>("output");
+    }
+
+    void setupParameters(Parameterizable& /*parameters*/) override
+    {
+    }
+
+    bool isReentrant() const override
+    {
+        return true;
+    }
+
+    void process() override
+    {
+        int now = ++running;
+        int max = max_running;
+        while(now > max && !max_running.compare_exchange_weak(max, now)) {
+        }
+
+        int val = msg::getValue<int>(in);
+
+        // some messages take longer, so that the invocations finish out of order
+        std::this_thread::sleep_for(std::chrono::milliseconds(val % 3 == 0 ? 6 : 1));
+        msg::publish(out, factor() * val);
+
+        --running;
+    }
+
+    std::atomic<int> running;
+    std::atomic<int> max_running;
+
+protected:
+    virtual int factor() const
+    {
+        return 2;
+    }
+
+private:
+    Input* in;
+    Output* out;
+};
+
+class MockupParameterizedReentrantNode : public MockupReentrantNode
+{
+public:
+    void setupParameters(Parameterizable& parameters) override
+    {
+        parameters.addParameter(param::ParameterFactory::declareValue("factor", 2));
+    }
+
+protected:
+    int factor() const override
+    {
+        return readParameter<int>("factor");
+    }
+};
+
+class MockupRecordingSink : public Node
+{
+public:
+    void setup(NodeModifier& node_modifier) override
+    {
+        in = node_modifier.addInput<int>("input");
+    }
+
+    void setupParameters(Parameterizable& /*parameters*/) override
+    {
+    }
+
+    void process() override
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        values.push_back(msg::getValue<int>(in));
+    }
+
+    std::vector<int> getValues() const
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return values;
+    }
+
+private:
+    Input* in;
+
+    mutable std::mutex mutex;
+    std::vector<int> values;
+};
+
+class ReentrantNodeTest : public NodeConstructingTest
+{
+protected:
+    ReentrantNodeTest()
+    {
+        factory.registerNodeType(std::make_shared<NodeConstructor>("MockupReentrant", []() {
+            return NodePtr(new MockupReentrantNode);
+        }));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("MockupParameterizedReentrant", []() {
+            return NodePtr(new MockupParameterizedReentrantNode);
+        }));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("MockupRecordingSink", []() {
+            return NodePtr(new MockupRecordingSink);
+        }));
+    }
+
+    void SetUp() override
+    {
+        NodeConstructingTest::SetUp();
+
+        main_graph_facade = std::make_shared<GraphFacade>(executor, graph, graph_node);
+    }
+
+    NodeFacadePtr makeNode(const std::string& type, const std::string& name)
+    {
+        NodeFacadePtr node = factory.makeNode(type, UUIDProvider::makeUUID_without_parent(name), graph);
+        apex_assert_hard(node);
+        main_graph_facade->addNode(node);
+        return node;
+    }
+
+    std::vector<int> run(NodeFacadePtr reentrant, NodeFacadePtr sink, std::size_t count)
+    {
+        executor.getDefaultGroup()->setWorkerCount(4);
+        std::dynamic_pointer_cast<NodeFacadeLocal>(reentrant)->getNodeWorker()->setMaxConcurrentInvocations(4);
+
+        std::shared_ptr<MockupRecordingSink> recorder = std::dynamic_pointer_cast<MockupRecordingSink>(sink->getNode());
+        apex_assert_hard(recorder);
+
+        executor.start();
+
+        auto start = std::chrono::steady_clock::now();
+        while(recorder->getValues().size() < count) {
+            if(std::chrono::steady_clock::now() - start > std::chrono::seconds(10)) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        executor.stop();
+
+        return recorder->getValues();
+    }
+
+    GraphFacadePtr main_graph_facade;
+};
+
+TEST_F(ReentrantNodeTest, ConcurrentInvocationsKeepMessageOrder)
+{
+    NodeFacadePtr src = makeNode("MockupSource", "src");
+    NodeFacadePtr reentrant = makeNode("MockupReentrant", "reentrant");
+    NodeFacadePtr sink = makeNode("MockupRecordingSink", "sink");
+
+    main_graph_facade->connect(src, "output", reentrant, "input");
+    main_graph_facade->connect(reentrant, "output", sink, "input");
+
+    reentrant->getNodeState()->setExecutionMode(ExecutionMode::PIPELINING);
+
+    std::vector<int> values = run(reentrant, sink, 60);
+    ASSERT_GE(values.size(), 60u);
+    for(std::size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(2 * (int) i, values[i]);
+    }
+
+    std::shared_ptr<MockupReentrantNode> node = std::dynamic_pointer_cast<MockupReentrantNode>(reentrant->getNode());
+    EXPECT_GT(node->max_running.load(), 1);
+    EXPECT_LE(node->max_running.load(), 4);
+}
+
+TEST_F(ReentrantNodeTest, SequentialExecutionIsNotConcurrent)
+{
+    NodeFacadePtr src = makeNode("MockupSource", "src");
+    NodeFacadePtr reentrant = makeNode("MockupReentrant", "reentrant");
+    NodeFacadePtr sink = makeNode("MockupRecordingSink", "sink");
+
+    main_graph_facade->connect(src, "output", reentrant, "input");
+    main_graph_facade->connect(reentrant, "output", sink, "input");
+
+    std::vector<int> values = run(reentrant, sink, 20);
+    ASSERT_GE(values.size(), 20u);
+    for(std::size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(2 * (int) i, values[i]);
+    }
+
+    std::shared_ptr<MockupReentrantNode> node = std::dynamic_pointer_cast<MockupReentrantNode>(reentrant->getNode());
+    EXPECT_EQ(1, node->max_running.load());
+}
+
+TEST_F(ReentrantNodeTest, ConnectedParameterInputsAreNotConcurrent)
+{
+    NodeFacadePtr src = makeNode("MockupSource", "src");
+    NodeFacadePtr reentrant = makeNode("MockupParameterizedReentrant", "reentrant");
+    NodeFacadePtr sink = makeNode("MockupRecordingSink", "sink");
+
+    main_graph_facade->connect(src, "output", reentrant, "input");
+    main_graph_facade->connect(src, "output", reentrant, "factor");
+    main_graph_facade->connect(reentrant, "output", sink, "input");
+
+    reentrant->getNodeState()->setExecutionMode(ExecutionMode::PIPELINING);
+
+    // every message has to be processed with the parameter value that arrived with it
+    std::vector<int> values = run(reentrant, sink, 20);
+    ASSERT_GE(values.size(), 20u);
+    for(std::size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ((int) (i * i), values[i]);
+    }
+
+    std::shared_ptr<MockupReentrantNode> node = std::dynamic_pointer_cast<MockupReentrantNode>(reentrant->getNode());
+    EXPECT_EQ(1, node->max_running.load());
+}
+
+TEST(InvocationContextTest, PortsUseTheTokensOfTheActiveInvocation)
+{
+    UUIDProviderPtr uuid_provider = std::make_shared<UUIDProvider>();
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    ConnectionPtr connection = DirectConnection::connect(o, i);
+
+    TokenPtr current = Token::make(std::make_shared<connection_types::GenericValueMessage<int>>());
+    i->setToken(current);
+
+    TokenPtr snapshot = Token::make(std::make_shared<connection_types::GenericValueMessage<int>>());
+    InvocationContext context(0);
+    context.addInput(i.get(), snapshot);
+    context.addOutput(o.get());
+
+    TokenPtr result = Token::make(std::make_shared<connection_types::GenericValueMessage<int>>());
+    {
+        InvocationContext::Scope scope(&context);
+        EXPECT_EQ(snapshot, i->getToken());
+
+        o->addMessage(result);
+        EXPECT_TRUE(o->hasMessage());
+    }
+
+    // outside of the invocation the ports are unchanged
+    EXPECT_EQ(current, i->getToken());
+    EXPECT_FALSE(o->hasMessage());
+    EXPECT_EQ(result, context.getToken(o.get()));
+}
+
+}
@@ -1,6 +1,9 @@
 #include <csapex/model/graph_facade.h>
 #include <csapex/msg/generic_value_message.hpp>
 #include <csapex/model/graph/graph_local.h>
+#include <csapex/model/graph/vertex.h>
+#include <csapex/model/node_runner.h>
+#include <csapex/model/node_handle.h>
 
 #include "test_exception_handler.h"
 #include "mockup_nodes.h"
@@ -177,4 +180,51 @@ TEST_F(SchedulingTest, SteppingWorksForEventToInput)
 {
 
 }
+
+TEST_F(SchedulingTest, CriticalPathIsDetected)
+{
+    NodeFacadePtr src1 = factory.makeNode("MockupSource", UUIDProvider::makeUUID_without_parent("src1"), graph);
+    main_graph_facade->addNode(src1);
+    NodeFacadePtr src2 = factory.makeNode("MockupSource", UUIDProvider::makeUUID_without_parent("src2"), graph);
+    main_graph_facade->addNode(src2);
+
+    NodeFacadePtr m1 = factory.makeNode("StaticMultiplier", UUIDProvider::makeUUID_without_parent("m1"), graph);
+    main_graph_facade->addNode(m1);
+    NodeFacadePtr m2 = factory.makeNode("StaticMultiplier", UUIDProvider::makeUUID_without_parent("m2"), graph);
+    main_graph_facade->addNode(m2);
+
+    NodeFacadePtr combiner = factory.makeNode("DynamicMultiplier", UUIDProvider::makeUUID_without_parent("combiner"), graph);
+    main_graph_facade->addNode(combiner);
+
+    NodeFacadePtr sink = factory.makeNode("MockupSink", UUIDProvider::makeUUID_without_parent("Sink"), graph);
+    main_graph_facade->addNode(sink);
+
+    // src1 -> m1 -> m2 -> combiner -> sink is longer than src2 -> combiner -> sink
+    main_graph_facade->connect(src1, "output", m1, "input");
+    main_graph_facade->connect(m1, "output", m2, "input");
+    main_graph_facade->connect(m2, "output", combiner, "input_a");
+    main_graph_facade->connect(src2, "output", combiner, "input_b");
+    main_graph_facade->connect(combiner, "output", sink, "input");
+
+    auto criticality = [](NodeFacadePtr nf) {
+        return nf->getNodeHandle()->getVertex()->getNodeCharacteristics().criticality.load();
+    };
+
+    for(NodeFacadePtr nf : { src1, m1, m2, combiner, sink }) {
+        EXPECT_DOUBLE_EQ(1.0, criticality(nf));
+    }
+    EXPECT_LT(criticality(src2), 1.0);
+    EXPECT_GT(criticality(src2), 0.0);
+
+    // the periodic refresh publishes the same result for unchanged profiles
+    double src2_criticality = criticality(src2);
+    main_graph_facade->updateCriticalPaths();
+    EXPECT_DOUBLE_EQ(1.0, criticality(sink));
+    EXPECT_DOUBLE_EQ(src2_criticality, criticality(src2));
+
+    NodeRunnerPtr runner = src2->getNodeRunner();
+    EXPECT_FALSE(runner->isCriticalPathScheduling());
+    runner->setCriticalPathScheduling(true);
+    EXPECT_TRUE(runner->isCriticalPathScheduling());
+}
 }
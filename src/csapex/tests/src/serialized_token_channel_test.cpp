@@ -0,0 +1,134 @@
+#include "gtest/gtest.h"
+
+#include <csapex/msg/serialized_token_channel.h>
+#include <csapex/msg/message_template.hpp>
+#include <csapex/utility/register_msg.h>
+#include <csapex/model/token.h>
+#include <csapex/msg/io.h>
+#include <yaml-cpp/yaml.h>
+
+/// SYSTEM
+#include <thread>
+#include <unistd.h>
+
+using namespace csapex;
+using namespace connection_types;
+
+namespace csapex
+{
+namespace connection_types
+{
+
+class SharedMock
+{
+public:
+    std::string payload;
+};
+
+class SharedMockMessage : public MessageTemplate<SharedMock, SharedMockMessage> {};
+
+template <>
+struct type<SharedMockMessage> {
+    static std::string name() {
+        return "SharedMockMessage";
+    }
+};
+
+}
+}
+
+namespace YAML {
+template<>
+struct convert<csapex::connection_types::SharedMockMessage>
+{
+    static Node encode(const csapex::connection_types::SharedMockMessage& rhs)
+    {
+        Node n;
+        n["payload"] = rhs.value.payload;
+        return n;
+    }
+
+    static bool decode(const Node& node, csapex::connection_types::SharedMockMessage& rhs)
+    {
+        if(node["payload"].IsDefined()) {
+            rhs.value.payload = node["payload"].as<std::string>();
+        } else {
+            return false;
+        }
+        return true;
+    }
+};
+}
+
+CSAPEX_REGISTER_MESSAGE(csapex::connection_types::SharedMockMessage);
+
+namespace
+{
+std::string channelName(const std::string& test)
+{
+    return "csapex_token_channel_" + test + "_" + std::to_string(::getpid());
+}
+
+TokenPtr makeToken(const std::string& payload, int sequence_number)
+{
+    auto msg = std::make_shared<SharedMockMessage>();
+    msg->value.payload = payload;
+    TokenPtr token = Token::make(msg);
+    token->setSequenceNumber(sequence_number);
+    return token;
+}
+}
+
+TEST(SerializedTokenChannelTest, TokensArePassedThroughTheChannel)
+{
+    SerializedTokenChannelPtr publisher = SerializedTokenChannel::create(channelName("tokens"), 4096);
+    SerializedTokenChannelPtr receiver = SerializedTokenChannel::open(channelName("tokens"));
+
+    TokenPtr token = makeToken("foo", 42);
+    token->setActivityModifier(ActivityModifier::ACTIVATE);
+    ASSERT_TRUE(publisher->publish(token, std::chrono::milliseconds(0)));
+
+    TokenPtr received = receiver->receive(std::chrono::milliseconds(1000));
+    ASSERT_NE(nullptr, received);
+    EXPECT_EQ(42, received->getSequenceNumber());
+    EXPECT_EQ(ActivityModifier::ACTIVATE, received->getActivityModifier());
+
+    auto msg = std::dynamic_pointer_cast<SharedMockMessage const>(received->getTokenData());
+    ASSERT_NE(nullptr, msg);
+    EXPECT_EQ("foo", msg->value.payload);
+
+    EXPECT_EQ(nullptr, receiver->receive(std::chrono::milliseconds(5)));
+}
+
+TEST(SerializedTokenChannelTest, LargePayloadsArePassedThroughTheChannel)
+{
+    SerializedTokenChannelPtr publisher = SerializedTokenChannel::create(channelName("large"), 1 << 20);
+    SerializedTokenChannelPtr receiver = SerializedTokenChannel::open(channelName("large"));
+
+    // more data than the channel can hold at once, so that the publisher has to wait for the receiver
+    const int count = 8;
+    const std::string payload(256 << 10, 'x');
+    std::thread producer([&]() {
+        for(int i = 0; i < count; ++i) {
+            ASSERT_TRUE(publisher->publish(makeToken(payload, i), std::chrono::milliseconds(5000)));
+        }
+    });
+
+    for(int i = 0; i < count; ++i) {
+        TokenPtr received = receiver->receive(std::chrono::milliseconds(5000));
+        ASSERT_NE(nullptr, received);
+        EXPECT_EQ(i, received->getSequenceNumber());
+
+        auto msg = std::dynamic_pointer_cast<SharedMockMessage const>(received->getTokenData());
+        ASSERT_NE(nullptr, msg);
+        EXPECT_EQ(payload.size(), msg->value.payload.size());
+    }
+    producer.join();
+}
+
+TEST(SerializedTokenChannelTest, MessagesLargerThanTheChannelAreRejected)
+{
+    SerializedTokenChannelPtr publisher = SerializedTokenChannel::create(channelName("too_large"), 1024);
+
+    EXPECT_THROW(publisher->publish(makeToken(std::string(2048, 'x'), 0), std::chrono::milliseconds(0)), std::length_error);
+}
@@ -0,0 +1,257 @@
+#include "gtest/gtest.h"
+
+#include <csapex/io/session.h>
+#include <csapex/io/request.h>
+#include <csapex/io/protcol/core_requests.h>
+#include <csapex/io/protcol/command_broadcasts.h>
+
+/// SYSTEM
+#include <future>
+#include <set>
+#include <thread>
+
+using namespace csapex;
+using boost::asio::ip::tcp;
+
+namespace
+{
+typedef std::shared_ptr<CoreRequests::CoreResponse const> CoreResponseConstPtr;
+}
+
+class SessionTest : public ::testing::Test
+{
+protected:
+    SessionTest()
+        : work_(new boost::asio::io_service::work(io_service_))
+    {
+        tcp::acceptor acceptor(io_service_, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+
+        tcp::socket client_socket(io_service_);
+        client_socket.connect(acceptor.local_endpoint());
+
+        tcp::socket server_socket(io_service_);
+        acceptor.accept(server_socket);
+
+        client_ = std::make_shared<Session>(std::move(client_socket));
+        server_ = std::make_shared<Session>(std::move(server_socket));
+
+        io_thread_ = std::thread([this]() {
+            io_service_.run();
+        });
+    }
+
+    ~SessionTest()
+    {
+        client_->stop();
+        server_->stop();
+
+        work_.reset();
+        io_service_.stop();
+        io_thread_.join();
+    }
+
+    /// answers every request with its own id, so that responses can be matched
+    void respondWithRequestId()
+    {
+        server_->setRequestHandler([this](const RequestConstPtr& request) {
+            server_->write(std::make_shared<CoreRequests::CoreResponse>(CoreRequests::CoreRequestType::CoreGetPause,
+                                                                        (int) request->getRequestID(),
+                                                                        request->getRequestID()));
+        });
+    }
+
+    CoreResponseConstPtr sendRequest()
+    {
+        return std::dynamic_pointer_cast<CoreRequests::CoreResponse const>(
+                    client_->sendRequest(std::make_shared<CoreRequests::CoreRequest>(CoreRequests::CoreRequestType::CoreGetPause)));
+    }
+
+    boost::asio::io_service io_service_;
+    std::unique_ptr<boost::asio::io_service::work> work_;
+    std::thread io_thread_;
+
+    SessionPtr client_;
+    SessionPtr server_;
+};
+
+TEST_F(SessionTest, MoreThan256RequestsCanBeInFlight)
+{
+    respondWithRequestId();
+
+    server_->start();
+    client_->start();
+
+    const int threads = 8;
+    const int requests_per_thread = 64;
+
+    std::mutex ids_mutex;
+    std::set<uint32_t> ids;
+
+    std::vector<std::thread> clients;
+    for(int t = 0; t < threads; ++t) {
+        clients.emplace_back([&]() {
+            for(int i = 0; i < requests_per_thread; ++i) {
+                CoreResponseConstPtr response = sendRequest();
+                ASSERT_NE(nullptr, response);
+                ASSERT_EQ((int) response->getRequestID(), response->getResult<int>());
+
+                std::unique_lock<std::mutex> lock(ids_mutex);
+                ids.insert(response->getRequestID());
+            }
+        });
+    }
+    for(std::thread& thread : clients) {
+        thread.join();
+    }
+
+    ASSERT_EQ(static_cast<std::size_t>(threads * requests_per_thread), ids.size());
+}
+
+TEST_F(SessionTest, UnansweredRequestsTimeOut)
+{
+    server_->start();
+    client_->start();
+
+    client_->setRequestTimeout(std::chrono::milliseconds(50));
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(nullptr, sendRequest());
+    ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+}
+
+TEST_F(SessionTest, SlowRequestsDoNotBlockOtherRequests)
+{
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<bool> first(true);
+
+    server_->setRequestHandler([&](const RequestConstPtr& request) {
+        if(first.exchange(false)) {
+            released.wait();
+        }
+        server_->write(std::make_shared<CoreRequests::CoreResponse>(CoreRequests::CoreRequestType::CoreGetPause,
+                                                                    (int) request->getRequestID(),
+                                                                    request->getRequestID()));
+    });
+
+    server_->start();
+    client_->start();
+
+    client_->setRequestTimeout(std::chrono::seconds(5));
+
+    std::future<CoreResponseConstPtr> slow = std::async(std::launch::async, [this]() {
+        return sendRequest();
+    });
+    while(first) {
+        std::this_thread::yield();
+    }
+
+    // the first request is still being handled, the second must not wait for it
+    ASSERT_NE(nullptr, sendRequest());
+    ASSERT_EQ(std::future_status::timeout, slow.wait_for(std::chrono::milliseconds(0)));
+
+    release.set_value();
+    ASSERT_NE(nullptr, slow.get());
+}
+
+TEST_F(SessionTest, ReadOnlyRequestsWaitForPrecedingMutatingRequests)
+{
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<bool> mutating_started(false);
+    std::atomic<bool> mutating_done(false);
+    std::atomic<bool> read_before_mutation(false);
+
+    server_->setRequestHandler([&](const RequestConstPtr& request) {
+        if(!request->isReadOnly()) {
+            mutating_started = true;
+            released.wait();
+            mutating_done = true;
+        } else if(!mutating_done) {
+            read_before_mutation = true;
+        }
+        server_->write(std::make_shared<CoreRequests::CoreResponse>(CoreRequests::CoreRequestType::CoreGetPause,
+                                                                    (int) request->getRequestID(),
+                                                                    request->getRequestID()));
+    });
+
+    server_->start();
+    client_->start();
+
+    client_->setRequestTimeout(std::chrono::seconds(5));
+
+    std::future<ResponseConstPtr> mutating = std::async(std::launch::async, [this]() {
+        return client_->sendRequest(std::make_shared<CoreRequests::CoreRequest>(CoreRequests::CoreRequestType::CoreSetPause, true));
+    });
+    while(!mutating_started) {
+        std::this_thread::yield();
+    }
+
+    std::future<CoreResponseConstPtr> reading = std::async(std::launch::async, [this]() {
+        return sendRequest();
+    });
+
+    // the read only request arrived later, so it must not overtake the mutating one
+    ASSERT_EQ(std::future_status::timeout, reading.wait_for(std::chrono::milliseconds(50)));
+
+    release.set_value();
+    ASSERT_NE(nullptr, mutating.get());
+    ASSERT_NE(nullptr, reading.get());
+    ASSERT_FALSE(read_before_mutation);
+}
+
+TEST_F(SessionTest, BurstsOfPacketsAreWrittenTogether)
+{
+    std::atomic<int> received(0);
+    client_->broadcast_received.connect([&](const BroadcastMessageConstPtr&) {
+        ++received;
+    });
+
+    server_->start();
+    client_->start();
+
+    // the burst is shorter than the linger time, so it can be sent as a whole
+    server_->setWriteCoalescing(1 << 20, std::chrono::milliseconds(20));
+
+    const int packets = 100;
+    for(int i = 0; i < packets; ++i) {
+        server_->sendBroadcast<CommandBroadcasts>(CommandBroadcasts::CommandBroadcastType::DirtyChanged, i % 2 == 0);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(received < packets && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(packets, received);
+
+    Session::WriteStatistics stats = server_->getWriteStatistics();
+    ASSERT_EQ(static_cast<uint64_t>(packets), stats.packets);
+    ASSERT_GT(stats.bytes, 0u);
+    ASSERT_LT(stats.syscalls, static_cast<uint64_t>(packets / 10));
+}
+
+TEST_F(SessionTest, FlushThresholdLimitsTheBatchSize)
+{
+    std::atomic<int> received(0);
+    client_->broadcast_received.connect([&](const BroadcastMessageConstPtr&) {
+        ++received;
+    });
+
+    server_->start();
+    client_->start();
+
+    // every packet exceeds the threshold and is written on its own
+    server_->setWriteCoalescing(1, std::chrono::seconds(10));
+
+    const int packets = 10;
+    for(int i = 0; i < packets; ++i) {
+        server_->sendBroadcast<CommandBroadcasts>(CommandBroadcasts::CommandBroadcastType::StateChanged);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(received < packets && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(packets, received);
+    ASSERT_EQ(static_cast<uint64_t>(packets), server_->getWriteStatistics().syscalls);
+}
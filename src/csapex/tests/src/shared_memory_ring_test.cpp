@@ -0,0 +1,125 @@
+#include <csapex/utility/shared_memory_ring.h>
+
+#include "gtest/gtest.h"
+
+/// SYSTEM
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace csapex;
+
+namespace
+{
+std::string uniqueName(const std::string& test)
+{
+    return "csapex_test_" + test + "_" + std::to_string(::getpid());
+}
+
+std::string readString(SharedMemoryRing& ring, std::chrono::milliseconds timeout = std::chrono::milliseconds(1000))
+{
+    std::string result;
+    ring.read([&result](const uint8_t* data, std::size_t length) {
+        result.assign(reinterpret_cast<const char*>(data), length);
+    }, timeout);
+    return result;
+}
+}
+
+TEST(SharedMemoryRingTest, RecordsAreReadInOrder)
+{
+    SharedMemoryRingPtr writer = SharedMemoryRing::create(uniqueName("order"), 1024);
+    SharedMemoryRingPtr reader = SharedMemoryRing::open(uniqueName("order"));
+    EXPECT_EQ(1024u, reader->getCapacity());
+
+    std::string a = "first", b = "second record";
+    ASSERT_TRUE(writer->write(a.data(), a.size(), std::chrono::milliseconds(0)));
+    ASSERT_TRUE(writer->write(b.data(), b.size(), std::chrono::milliseconds(0)));
+
+    EXPECT_EQ(a, readString(*reader));
+    EXPECT_EQ(b, readString(*reader));
+    EXPECT_TRUE(reader->empty());
+}
+
+TEST(SharedMemoryRingTest, TimeoutsAreReported)
+{
+    SharedMemoryRingPtr ring = SharedMemoryRing::create(uniqueName("timeout"), 64);
+
+    bool called = false;
+    EXPECT_FALSE(ring->read([&](const uint8_t*, std::size_t) { called = true; }, std::chrono::milliseconds(5)));
+    EXPECT_FALSE(called);
+
+    std::vector<uint8_t> record(ring->getMaximumRecordSize(), 42);
+    ASSERT_TRUE(ring->write(record.data(), record.size(), std::chrono::milliseconds(0)));
+    EXPECT_FALSE(ring->write(record.data(), 1, std::chrono::milliseconds(5)));
+
+    EXPECT_THROW(ring->reserve(ring->getMaximumRecordSize() + 1, std::chrono::milliseconds(0)), std::length_error);
+}
+
+TEST(SharedMemoryRingTest, RecordsWrapAroundTheEnd)
+{
+    SharedMemoryRingPtr writer = SharedMemoryRing::create(uniqueName("wrap"), 256);
+    SharedMemoryRingPtr reader = SharedMemoryRing::open(uniqueName("wrap"));
+
+    const int count = 2000;
+    std::thread producer([&]() {
+        for(int i = 0; i < count; ++i) {
+            // records of varying size, so that the end of the ring is skipped at different offsets
+            std::string record(1 + (i * 7) % 100, static_cast<char>('a' + i % 26));
+            ASSERT_TRUE(writer->write(record.data(), record.size(), std::chrono::milliseconds(1000)));
+        }
+    });
+
+    for(int i = 0; i < count; ++i) {
+        std::string expected(1 + (i * 7) % 100, static_cast<char>('a' + i % 26));
+        ASSERT_EQ(expected, readString(*reader));
+    }
+    producer.join();
+    EXPECT_TRUE(reader->empty());
+}
+
+TEST(SharedMemoryRingTest, RecordsAreExchangedBetweenProcesses)
+{
+    std::string name = uniqueName("process");
+    SharedMemoryRingPtr reader = SharedMemoryRing::create(name, 4096);
+
+    pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+    if(child == 0) {
+        int status = 0;
+        try {
+            SharedMemoryRingPtr writer = SharedMemoryRing::open(name);
+            for(int i = 0; i < 100; ++i) {
+                uint8_t* record = writer->reserve(sizeof(int), std::chrono::milliseconds(1000));
+                if(!record) {
+                    status = 1;
+                    break;
+                }
+                *reinterpret_cast<int*>(record) = i;
+                writer->commit();
+            }
+        } catch(...) {
+            status = 2;
+        }
+        ::_exit(status);
+    }
+
+    for(int i = 0; i < 100; ++i) {
+        int value = -1;
+        ASSERT_TRUE(reader->read([&value](const uint8_t* data, std::size_t length) {
+            ASSERT_EQ(sizeof(int), length);
+            value = *reinterpret_cast<const int*>(data);
+        }, std::chrono::milliseconds(5000)));
+        ASSERT_EQ(i, value);
+    }
+
+    int status = -1;
+    ::waitpid(child, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+}
+
+TEST(SharedMemoryRingTest, MissingSegmentsCannotBeOpened)
+{
+    EXPECT_THROW(SharedMemoryRing::open(uniqueName("missing")), std::runtime_error);
+}
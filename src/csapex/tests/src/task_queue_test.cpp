@@ -0,0 +1,291 @@
+#include <csapex/scheduling/task_queue.h>
+#include <csapex/scheduling/task.h>
+
+#include "gtest/gtest.h"
+
+/// SYSTEM
+#include <thread>
+#include <set>
+#include <iostream>
+
+using namespace csapex;
+
+namespace
+{
+
+/**
+ * @brief The LockedTaskQueue class replicates the former ThreadGroup queue:
+ *        a sorted multiset behind a recursive mutex with a linear duplicate check.
+ */
+class LockedTaskQueue
+{
+    struct Compare
+    {
+        bool operator () (const TaskPtr& a, const TaskPtr& b) const
+        {
+            return a->getPriority() > b->getPriority();
+        }
+    };
+
+public:
+    void schedule(const TaskPtr& task)
+    {
+        std::unique_lock<std::recursive_mutex> lock(mtx_);
+        for(const TaskPtr& queued : tasks_) {
+            if(queued == task) {
+                return;
+            }
+        }
+        tasks_.insert(task);
+    }
+
+    TaskPtr pop()
+    {
+        std::unique_lock<std::recursive_mutex> lock(mtx_);
+        if(tasks_.empty()) {
+            return nullptr;
+        }
+        TaskPtr task = *tasks_.begin();
+        tasks_.erase(tasks_.begin());
+        return task;
+    }
+
+private:
+    std::recursive_mutex mtx_;
+    std::multiset<TaskPtr, Compare> tasks_;
+};
+
+TaskPtr makeTask(long priority = 0)
+{
+    return std::make_shared<Task>("test", [](){}, priority);
+}
+
+}
+
+class TaskQueueTest : public ::testing::Test
+{
+};
+
+TEST_F(TaskQueueTest, HigherPriorityIsPoppedFirst)
+{
+    TaskQueue queue;
+
+    TaskPtr low = makeTask(-2);
+    TaskPtr normal = makeTask(0);
+    TaskPtr high = makeTask(2);
+
+    queue.push(low);
+    queue.push(normal);
+    queue.push(high);
+
+    ASSERT_EQ(3u, queue.size());
+    EXPECT_EQ(high, queue.pop());
+    EXPECT_EQ(normal, queue.pop());
+    EXPECT_EQ(low, queue.pop());
+    EXPECT_EQ(nullptr, queue.pop());
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(TaskQueueTest, SamePriorityIsFifo)
+{
+    TaskQueue queue;
+
+    std::vector<TaskPtr> tasks;
+    for(int i = 0; i < 10; ++i) {
+        tasks.push_back(makeTask());
+        queue.push(tasks.back());
+    }
+
+    for(const TaskPtr& task : tasks) {
+        EXPECT_EQ(task, queue.pop());
+    }
+}
+
+TEST_F(TaskQueueTest, EarliestDeadlineIsPoppedFirst)
+{
+    TaskQueue queue;
+
+    auto now = std::chrono::steady_clock::now();
+
+    TaskPtr high = makeTask(TaskQueue::MAX_PRIORITY);
+    TaskPtr late = makeTask();
+    late->setDeadline(now + std::chrono::milliseconds(20));
+    TaskPtr early = makeTask(-2);
+    early->setDeadline(now + std::chrono::milliseconds(10));
+    TaskPtr also_late = makeTask();
+    also_late->setDeadline(now + std::chrono::milliseconds(20));
+
+    queue.push(high);
+    queue.push(late);
+    queue.push(early);
+    queue.push(also_late);
+
+    // changing the deadline of a queued task does not affect the queue
+    late->setDeadline(now + std::chrono::milliseconds(30));
+
+    ASSERT_EQ(4u, queue.size());
+    EXPECT_EQ(early, queue.pop());
+    EXPECT_EQ(late, queue.pop());
+    EXPECT_EQ(also_late, queue.pop());
+    EXPECT_EQ(high, queue.pop());
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(TaskQueueTest, PrioritiesOutOfRangeAreClamped)
+{
+    EXPECT_EQ(0, TaskQueue::levelOf(-100));
+    EXPECT_EQ(TaskQueue::PRIORITY_LEVELS - 1, TaskQueue::levelOf(100));
+    EXPECT_EQ(-TaskQueue::MIN_PRIORITY, TaskQueue::levelOf(0));
+}
+
+TEST_F(TaskQueueTest, OverflowKeepsOrder)
+{
+    TaskQueue queue(2);
+
+    std::vector<TaskPtr> tasks;
+    for(int i = 0; i < 10; ++i) {
+        tasks.push_back(makeTask());
+        queue.push(tasks.back());
+    }
+    TaskPtr high = makeTask(1);
+    queue.push(high);
+
+    ASSERT_EQ(11u, queue.size());
+    EXPECT_EQ(high, queue.pop());
+    for(const TaskPtr& task : tasks) {
+        EXPECT_EQ(task, queue.pop());
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(TaskQueueTest, DrainReturnsAllTasks)
+{
+    TaskQueue queue(2);
+    for(int i = 0; i < 10; ++i) {
+        queue.push(makeTask(i % 3));
+    }
+
+    std::vector<TaskPtr> tasks = queue.drain();
+    ASSERT_EQ(10u, tasks.size());
+    for(std::size_t i = 1; i < tasks.size(); ++i) {
+        EXPECT_GE(tasks[i-1]->getPriority(), tasks[i]->getPriority());
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(TaskQueueTest, TasksAreMarkedOnlyOnce)
+{
+    TaskPtr task = makeTask();
+
+    EXPECT_TRUE(task->markScheduled());
+    EXPECT_FALSE(task->markScheduled());
+    EXPECT_TRUE(task->isScheduled());
+
+    task->setScheduled(false);
+    EXPECT_TRUE(task->markScheduled());
+}
+
+TEST_F(TaskQueueTest, ConcurrentProducersAndConsumers)
+{
+    TaskQueue queue(16);
+
+    const int producers = 4;
+    const int per_producer = 10000;
+
+    std::atomic<int> popped(0);
+    std::atomic<bool> done(false);
+
+    std::vector<std::thread> threads;
+    for(int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, p]() {
+            for(int i = 0; i < per_producer; ++i) {
+                queue.push(makeTask(i % 4 - p));
+            }
+        });
+    }
+    for(int c = 0; c < 2; ++c) {
+        threads.emplace_back([&]() {
+            while(!done || !queue.empty()) {
+                if(queue.pop()) {
+                    ++popped;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for(int p = 0; p < producers; ++p) {
+        threads[p].join();
+    }
+    done = true;
+    for(std::size_t t = producers; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    EXPECT_EQ(producers * per_producer, popped);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(TaskQueueTest, ThroughputComparedToLockedQueue)
+{
+    const int threads = 4;
+    const int rounds = 20000;
+    const int tasks_per_thread = 32;
+
+    // every thread reschedules a fixed set of tasks, like node runners do
+    std::vector<std::vector<TaskPtr>> tasks(threads);
+    for(int t = 0; t < threads; ++t) {
+        for(int i = 0; i < tasks_per_thread; ++i) {
+            tasks[t].push_back(makeTask(i % 3 - 1));
+        }
+    }
+
+    auto measure = [&](std::function<void(const TaskPtr&)> schedule, std::function<TaskPtr()> pop) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for(int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                for(int r = 0; r < rounds; ++r) {
+                    for(const TaskPtr& task : tasks[t]) {
+                        schedule(task);
+                    }
+                    for(int i = 0; i < tasks_per_thread; ++i) {
+                        if(TaskPtr task = pop()) {
+                            task->setScheduled(false);
+                        }
+                    }
+                }
+            });
+        }
+        for(std::thread& worker : workers) {
+            worker.join();
+        }
+        while(TaskPtr task = pop()) {
+            task->setScheduled(false);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return threads * rounds * tasks_per_thread / seconds;
+    };
+
+    LockedTaskQueue locked;
+    double locked_rate = measure([&](const TaskPtr& task) {
+        locked.schedule(task);
+    }, [&]() {
+        return locked.pop();
+    });
+
+    TaskQueue lock_free;
+    double lock_free_rate = measure([&](const TaskPtr& task) {
+        if(task->markScheduled()) {
+            lock_free.push(task);
+        }
+    }, [&]() {
+        return lock_free.pop();
+    });
+
+    std::cout << "locked multiset: " << locked_rate << " schedules/s, "
+              << "task queue: " << lock_free_rate << " schedules/s" << std::endl;
+
+    EXPECT_TRUE(lock_free.empty());
+}
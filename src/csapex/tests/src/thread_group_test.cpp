@@ -0,0 +1,393 @@
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/scheduling/timed_queue.h>
+
+#include "gtest/gtest.h"
+#include "test_exception_handler.h"
+#include "mockup_task_generator.h"
+
+/// SYSTEM
+#include <thread>
+#include <yaml-cpp/yaml.h>
+
+using namespace csapex;
+
+class ThreadGroupTest : public ::testing::Test
+{
+protected:
+    ThreadGroupTest()
+        : timed_queue(std::make_shared<TimedQueue>())
+    {
+    }
+
+    bool waitFor(const std::atomic<int>& counter, int expected)
+    {
+        auto start = std::chrono::steady_clock::now();
+        while(counter < expected) {
+            if(std::chrono::steady_clock::now() - start > std::chrono::seconds(10)) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    TestExceptionHandler eh;
+    TimedQueuePtr timed_queue;
+};
+
+TEST_F(ThreadGroupTest, WorkersExecuteGeneratorsConcurrently)
+{
+    ThreadGroupPtr group = std::make_shared<ThreadGroup>(timed_queue, eh, "workers");
+    group->setWorkerCount(4);
+    ASSERT_EQ(4u, group->getWorkerCount());
+
+    std::vector<std::shared_ptr<MockupTaskGenerator>> generators;
+    for(int i = 0; i < 8; ++i) {
+        auto generator = std::make_shared<MockupTaskGenerator>();
+        generator->assignToScheduler(group.get());
+        generators.push_back(generator);
+    }
+
+    std::atomic<int> running(0);
+    std::atomic<int> max_running(0);
+    std::atomic<int> done(0);
+
+    std::vector<TaskPtr> tasks;
+    for(auto& generator : generators) {
+        for(int i = 0; i < 4; ++i) {
+            tasks.push_back(generator->makeTask([&]() {
+                int r = ++running;
+                if(r > max_running) {
+                    max_running = r;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                --running;
+                ++done;
+            }));
+        }
+    }
+
+    group->start();
+    for(const TaskPtr& task : tasks) {
+        group->schedule(task);
+    }
+
+    ASSERT_TRUE(waitFor(done, tasks.size()));
+
+    // a generator is never executed by two workers at once...
+    for(auto& generator : generators) {
+        EXPECT_EQ(1, generator->getMaximumConcurrency());
+    }
+    // ...but different generators are
+    EXPECT_GT(max_running.load(), 1);
+
+    group->stop();
+}
+
+TEST_F(ThreadGroupTest, WorkersCanChangeTheWorkerCountOfTheirGroup)
+{
+    ThreadGroupPtr group = std::make_shared<ThreadGroup>(timed_queue, eh, "workers");
+    group->setWorkerCount(4);
+
+    auto generator = std::make_shared<MockupTaskGenerator>();
+    generator->assignToScheduler(group.get());
+
+    std::atomic<int> done(0);
+    TaskPtr shrink = generator->makeTask([&]() {
+        // the calling worker is removed itself, it must not join its own thread
+        group->setWorkerCount(1);
+        ++done;
+    });
+
+    group->start();
+    group->schedule(shrink);
+    ASSERT_TRUE(waitFor(done, 1));
+
+    auto start = std::chrono::steady_clock::now();
+    while(group->getWorkerCount() != 1u && std::chrono::steady_clock::now() - start < std::chrono::seconds(10)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(1u, group->getWorkerCount());
+
+    // the group keeps executing tasks with the remaining worker
+    TaskPtr task = generator->makeTask([&]() {
+        ++done;
+    });
+    group->schedule(task);
+    ASSERT_TRUE(waitFor(done, 2));
+
+    group->stop();
+}
+
+TEST_F(ThreadGroupTest, ConcurrentResizesDoNotReviveAStoppedGroup)
+{
+    ThreadGroupPtr group = std::make_shared<ThreadGroup>(timed_queue, eh, "workers");
+    group->start();
+
+    std::atomic<bool> stopped(false);
+    std::vector<std::thread> resizers;
+    for(std::size_t t = 0; t < 4; ++t) {
+        resizers.emplace_back([&, t]() {
+            for(std::size_t i = 0; i < 50; ++i) {
+                group->setWorkerCount(1 + (i + t) % 4);
+            }
+            while(!stopped) {
+                group->setWorkerCount(1 + t);
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    group->stop();
+    stopped = true;
+
+    for(std::thread& thread : resizers) {
+        thread.join();
+    }
+
+    // resizes that overlapped with stop() must not have restarted the workers
+    EXPECT_FALSE(group->isRunning());
+    EXPECT_GE(group->getWorkerCount(), 1u);
+    EXPECT_LE(group->getWorkerCount(), 4u);
+}
+
+TEST_F(ThreadGroupTest, WorkerCountIsSaved)
+{
+    ThreadGroup group(timed_queue, eh, "workers");
+    group.setWorkerCount(3);
+
+    YAML::Node node;
+    group.saveSettings(node);
+
+    ThreadGroup loaded(timed_queue, eh, "loaded");
+    ASSERT_EQ(1u, loaded.getWorkerCount());
+    loaded.loadSettings(node);
+    EXPECT_EQ(3u, loaded.getWorkerCount());
+}
+
+TEST_F(ThreadGroupTest, WaitPoliciesExecuteTasks)
+{
+    for(ThreadGroup::WaitPolicy policy : { ThreadGroup::WaitPolicy::BLOCK,
+                                           ThreadGroup::WaitPolicy::SPIN_THEN_PARK,
+                                           ThreadGroup::WaitPolicy::BUSY_POLL }) {
+        ThreadGroupPtr group = std::make_shared<ThreadGroup>(timed_queue, eh, "waiting");
+        group->setWaitPolicy(policy);
+        group->setSpinDuration(std::chrono::microseconds(200));
+
+        auto generator = std::make_shared<MockupTaskGenerator>();
+        generator->assignToScheduler(group.get());
+
+        std::atomic<int> done(0);
+        TaskPtr task = generator->makeTask([&]() {
+            ++done;
+        });
+
+        group->start();
+
+        // the workers are idle before every task, so every task wakes one up
+        for(int i = 1; i <= 10; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            group->schedule(task);
+            ASSERT_TRUE(waitFor(done, i));
+        }
+
+        ThreadGroup::WakeLatency latency = group->getWakeLatency();
+        EXPECT_EQ(10u, latency.wake_ups) << ThreadGroup::waitPolicyToString(policy);
+        EXPECT_LE(latency.mean, latency.max);
+
+        group->resetWakeLatency();
+        EXPECT_EQ(0u, group->getWakeLatency().wake_ups);
+
+        group->stop();
+    }
+}
+
+TEST_F(ThreadGroupTest, WaitPolicyIsSaved)
+{
+    ThreadGroup group(timed_queue, eh, "workers");
+    group.setWaitPolicy(ThreadGroup::WaitPolicy::SPIN_THEN_PARK);
+    group.setSpinDuration(std::chrono::microseconds(20));
+
+    YAML::Node node;
+    group.saveSettings(node);
+
+    ThreadGroup loaded(timed_queue, eh, "loaded");
+    ASSERT_EQ(ThreadGroup::WaitPolicy::BLOCK, loaded.getWaitPolicy());
+    loaded.loadSettings(node);
+    EXPECT_EQ(ThreadGroup::WaitPolicy::SPIN_THEN_PARK, loaded.getWaitPolicy());
+    EXPECT_EQ(20, loaded.getSpinDuration().count());
+}
+
+TEST_F(ThreadGroupTest, TasksAreExecutedEarliestDeadlineFirst)
+{
+    ThreadGroupPtr group = std::make_shared<ThreadGroup>(timed_queue, eh, "deadlines");
+
+    auto generator = std::make_shared<MockupTaskGenerator>();
+    generator->assignToScheduler(group.get());
+
+    std::mutex order_mutex;
+    std::vector<int> order;
+    std::atomic<int> done(0);
+
+    auto now = std::chrono::steady_clock::now();
+    std::vector<TaskPtr> tasks;
+    for(int i = 0; i < 5; ++i) {
+        TaskPtr task = generator->makeTask([&, i]() {
+            std::unique_lock<std::mutex> lock(order_mutex);
+            order.push_back(i);
+            ++done;
+        });
+        // the last task is the most urgent one
+        task->setDeadline(now + std::chrono::milliseconds(10 * (5 - i)));
+        tasks.push_back(task);
+    }
+    TaskPtr best_effort = generator->makeTask([&]() {
+        std::unique_lock<std::mutex> lock(order_mutex);
+        order.push_back(-1);
+        ++done;
+    }, TaskQueue::MAX_PRIORITY);
+
+    group->schedule(best_effort);
+    for(const TaskPtr& task : tasks) {
+        group->schedule(task);
+    }
+    group->start();
+
+    ASSERT_TRUE(waitFor(done, 6));
+    group->stop();
+
+    std::vector<int> expected { 4, 3, 2, 1, 0, -1 };
+    EXPECT_EQ(expected, order);
+}
+
+TEST_F(ThreadGroupTest, RealtimeParametersAreSaved)
+{
+    ThreadGroup group(timed_queue, eh, "workers");
+    ThreadGroup::RealtimeParameters rt;
+    rt.policy = ThreadGroup::RealtimePolicy::DEADLINE;
+    rt.runtime = std::chrono::microseconds(200);
+    rt.deadline = std::chrono::microseconds(500);
+    rt.period = std::chrono::microseconds(500);
+    group.setRealtimeParameters(rt);
+
+    YAML::Node node;
+    group.saveSettings(node);
+
+    ThreadGroup loaded(timed_queue, eh, "loaded");
+    ASSERT_EQ(ThreadGroup::RealtimePolicy::NONE, loaded.getRealtimeParameters().policy);
+    loaded.loadSettings(node);
+
+    ThreadGroup::RealtimeParameters loaded_rt = loaded.getRealtimeParameters();
+    EXPECT_EQ(ThreadGroup::RealtimePolicy::DEADLINE, loaded_rt.policy);
+    EXPECT_EQ(200, loaded_rt.runtime.count());
+    EXPECT_EQ(500, loaded_rt.deadline.count());
+    EXPECT_EQ(500, loaded_rt.period.count());
+}
+
+TEST_F(ThreadGroupTest, ElasticGroupGrowsWithQueueAndReleasesIdleWorkers)
+{
+    ThreadGroupPtr group = std::make_shared<ThreadGroup>(timed_queue, eh, "elastic");
+    group->setWorkerCount(4);
+    group->setElastic(true);
+    group->setGrowThreshold(1);
+    group->setIdleTimeout(std::chrono::milliseconds(20));
+
+    std::vector<std::shared_ptr<MockupTaskGenerator>> generators;
+    for(int i = 0; i < 8; ++i) {
+        auto generator = std::make_shared<MockupTaskGenerator>();
+        generator->assignToScheduler(group.get());
+        generators.push_back(generator);
+    }
+
+    group->start();
+    EXPECT_EQ(1u, group->getLoad().running_workers);
+
+    std::atomic<int> done(0);
+    for(auto& generator : generators) {
+        group->schedule(generator->makeTask([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            ++done;
+        }));
+    }
+    ASSERT_TRUE(waitFor(done, generators.size()));
+
+    ThreadGroup::Load load = group->getLoad();
+    EXPECT_GT(load.started_workers, 1u);
+    EXPECT_LE(load.running_workers, 4u);
+    EXPECT_GT(load.utilization, 0.0);
+
+    // all idle workers are released...
+    auto start = std::chrono::steady_clock::now();
+    while(group->getLoad().running_workers > 0 && std::chrono::steady_clock::now() - start < std::chrono::seconds(10)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(0u, group->getLoad().running_workers);
+    EXPECT_EQ(group->getLoad().started_workers, group->getLoad().released_workers);
+
+    // ...and started again on demand
+    group->schedule(generators.front()->makeTask([&]() {
+        ++done;
+    }));
+    EXPECT_TRUE(waitFor(done, generators.size() + 1));
+
+    group->stop();
+}
+
+TEST_F(ThreadGroupTest, ElasticSettingsAreSaved)
+{
+    ThreadGroup group(timed_queue, eh, "workers");
+    group.setElastic(true);
+    group.setIdleTimeout(std::chrono::milliseconds(250));
+    group.setGrowThreshold(8);
+
+    YAML::Node node;
+    group.saveSettings(node);
+
+    ThreadGroup loaded(timed_queue, eh, "loaded");
+    ASSERT_FALSE(loaded.isElastic());
+    loaded.loadSettings(node);
+
+    EXPECT_TRUE(loaded.isElastic());
+    EXPECT_EQ(250, loaded.getIdleTimeout().count());
+    EXPECT_EQ(8u, loaded.getGrowThreshold());
+}
+
+TEST_F(ThreadGroupTest, TelemetryRecordsDelayAndRunTime)
+{
+    ThreadGroupPtr group = std::make_shared<ThreadGroup>(timed_queue, eh, "telemetry");
+    auto generator = std::make_shared<MockupTaskGenerator>();
+    generator->assignToScheduler(group.get());
+
+    std::atomic<int> done(0);
+    TaskPtr task = generator->makeTask([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        ++done;
+    });
+
+    // the task waits in the queue until the group is started
+    group->schedule(task);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    group->start();
+    ASSERT_TRUE(waitFor(done, 1));
+    group->stop();
+
+    EXPECT_GE(task->getSchedulingDelay(), std::chrono::milliseconds(5));
+    EXPECT_GE(task->getRunTime(), std::chrono::milliseconds(2));
+    EXPECT_LE(task->getScheduleTime(), task->getStartTime());
+    EXPECT_LE(task->getStartTime(), task->getFinishTime());
+
+    ThreadGroup::Telemetry telemetry = group->getTelemetry();
+    EXPECT_EQ(1u, telemetry.queue_depth.getCount());
+    ASSERT_EQ(1u, telemetry.scheduling_delay.getCount());
+    EXPECT_GE(telemetry.scheduling_delay.getMax(), 5000000u);
+    ASSERT_EQ(1u, telemetry.run_time.getCount());
+    EXPECT_GE(telemetry.run_time.getMax(), 2000000u);
+
+    YAML::Node node;
+    group->saveTelemetry(node);
+    EXPECT_EQ(1u, node["run_time_ns"]["count"].as<uint64_t>());
+
+    group->resetTelemetry();
+    EXPECT_EQ(0u, group->getTelemetry().run_time.getCount());
+}
@@ -0,0 +1,126 @@
+#include <csapex/scheduling/thread_pool.h>
+
+#include "gtest/gtest.h"
+
+/// SYSTEM
+#include <numeric>
+
+using namespace csapex;
+
+class ThreadPoolTest : public ::testing::Test
+{
+protected:
+    std::vector<double> loadPerGroup(const std::vector<double>& costs, const std::vector<std::size_t>& assignment, std::size_t groups)
+    {
+        std::vector<double> load(groups, 0.0);
+        for(std::size_t i = 0; i < costs.size(); ++i) {
+            EXPECT_LT(assignment[i], groups);
+            load[assignment[i]] += costs[i];
+        }
+        return load;
+    }
+};
+
+TEST_F(ThreadPoolTest, PartitionIsBalanced)
+{
+    // four independent chains of different costs
+    std::vector<double> costs;
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    for(int chain = 0; chain < 4; ++chain) {
+        for(int i = 0; i < 10; ++i) {
+            if(i > 0) {
+                edges.emplace_back(costs.size() - 1, costs.size());
+            }
+            costs.push_back(1.0 + chain);
+        }
+    }
+
+    const std::size_t groups = 4;
+    std::vector<std::size_t> assignment = ThreadPool::partition(costs, edges, groups);
+    ASSERT_EQ(costs.size(), assignment.size());
+
+    double total = std::accumulate(costs.begin(), costs.end(), 0.0);
+    for(double load : loadPerGroup(costs, assignment, groups)) {
+        EXPECT_LE(load, total / groups * 1.1 + 4.0);
+        EXPECT_GT(load, 0.0);
+    }
+}
+
+TEST_F(ThreadPoolTest, PartitionKeepsChainsTogether)
+{
+    // two chains of equal cost should end up in one group each
+    std::vector<double> costs(20, 1.0);
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    for(std::size_t i = 1; i < 10; ++i) {
+        edges.emplace_back(i - 1, i);
+        edges.emplace_back(10 + i - 1, 10 + i);
+    }
+
+    std::vector<std::size_t> assignment = ThreadPool::partition(costs, edges, 2);
+
+    for(std::size_t i = 1; i < 10; ++i) {
+        EXPECT_EQ(assignment[0], assignment[i]);
+        EXPECT_EQ(assignment[10], assignment[10 + i]);
+    }
+    EXPECT_NE(assignment[0], assignment[10]);
+}
+
+TEST_F(ThreadPoolTest, PartitionWithoutProfilingCountsTasks)
+{
+    std::vector<double> costs(9, 0.0);
+    std::vector<std::size_t> assignment = ThreadPool::partition(costs, {}, 3);
+
+    std::vector<int> count(3, 0);
+    for(std::size_t group : assignment) {
+        ++count.at(group);
+    }
+    EXPECT_EQ(std::vector<int>({3, 3, 3}), count);
+}
+
+TEST_F(ThreadPoolTest, NumaPlacementKeepsConnectedGroupsTogether)
+{
+    // two pipelines of two groups each, two equally sized nodes
+    std::vector<double> loads { 1.0, 1.0, 1.0, 1.0 };
+    std::vector<std::pair<std::size_t, std::size_t>> edges { {0, 2}, {1, 3} };
+
+    std::vector<std::size_t> placement = ThreadPool::placeOnNumaNodes(loads, edges, {4, 4});
+    ASSERT_EQ(loads.size(), placement.size());
+
+    EXPECT_EQ(placement[0], placement[2]);
+    EXPECT_EQ(placement[1], placement[3]);
+    EXPECT_NE(placement[0], placement[1]);
+}
+
+TEST_F(ThreadPoolTest, NumaPlacementFollowsNodeSizes)
+{
+    // independent groups, the first node has three times as many cpus
+    std::vector<double> loads(8, 1.0);
+
+    std::vector<std::size_t> placement = ThreadPool::placeOnNumaNodes(loads, {}, {12, 4});
+    std::vector<double> load = loadPerGroup(loads, placement, 2);
+    EXPECT_EQ(6.0, load[0]);
+    EXPECT_EQ(2.0, load[1]);
+}
+
+TEST_F(ThreadPoolTest, NumaPlacementSplitsOversizedComponents)
+{
+    // one chain that cannot fit onto one node is cut into connected pieces
+    std::vector<double> loads(6, 1.0);
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    for(std::size_t i = 1; i < loads.size(); ++i) {
+        edges.emplace_back(i - 1, i);
+    }
+
+    std::vector<std::size_t> placement = ThreadPool::placeOnNumaNodes(loads, edges, {2, 2});
+    std::vector<double> load = loadPerGroup(loads, placement, 2);
+    EXPECT_EQ(3.0, load[0]);
+    EXPECT_EQ(3.0, load[1]);
+
+    int cuts = 0;
+    for(const auto& edge : edges) {
+        if(placement[edge.first] != placement[edge.second]) {
+            ++cuts;
+        }
+    }
+    EXPECT_EQ(1, cuts);
+}
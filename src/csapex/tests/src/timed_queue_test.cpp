@@ -0,0 +1,155 @@
+#include <csapex/scheduling/timed_queue.h>
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/scheduling/task.h>
+
+#include "gtest/gtest.h"
+#include "test_exception_handler.h"
+
+/// SYSTEM
+#include <thread>
+#include <algorithm>
+
+using namespace csapex;
+
+class TimedQueueTest : public ::testing::Test
+{
+protected:
+    typedef TimedQueue::Clock Clock;
+
+    TimedQueueTest()
+        : timed_queue(std::make_shared<TimedQueue>()),
+          group(std::make_shared<ThreadGroup>(timed_queue, eh, "timed"))
+    {
+        group->start();
+    }
+
+    ~TimedQueueTest()
+    {
+        group->stop();
+        timed_queue->stop();
+    }
+
+    bool waitFor(const std::atomic<int>& counter, int expected)
+    {
+        auto start = Clock::now();
+        while(counter < expected) {
+            if(Clock::now() - start > std::chrono::seconds(10)) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    TestExceptionHandler eh;
+    TimedQueuePtr timed_queue;
+    ThreadGroupPtr group;
+};
+
+TEST_F(TimedQueueTest, TasksAreReleasedInDeadlineOrder)
+{
+    std::mutex order_mtx;
+    std::vector<int> order;
+    std::atomic<int> done(0);
+
+    auto now = Clock::now();
+
+    // the delays span several levels of the timing wheel
+    std::vector<int> delays_ms = { 70, 3, 20, 0, 5, 300, 1 };
+    for(std::size_t i = 0; i < delays_ms.size(); ++i) {
+        int delay = delays_ms[i];
+        TaskPtr task = std::make_shared<Task>("delayed", [&, delay]() {
+            std::unique_lock<std::mutex> lock(order_mtx);
+            order.push_back(delay);
+            ++done;
+        });
+        timed_queue->schedule(group, task, now + std::chrono::milliseconds(delay));
+    }
+
+    ASSERT_TRUE(waitFor(done, delays_ms.size()));
+    EXPECT_EQ(0u, timed_queue->size());
+
+    std::vector<int> expected = delays_ms;
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(expected, order);
+}
+
+TEST_F(TimedQueueTest, TasksAreNeverReleasedEarly)
+{
+    std::atomic<int> done(0);
+
+    std::vector<Clock::time_point> executed(50);
+    std::vector<Clock::time_point> deadlines(50);
+
+    auto now = Clock::now();
+    for(std::size_t i = 0; i < deadlines.size(); ++i) {
+        deadlines[i] = now + std::chrono::microseconds(250 * i + 17);
+        TaskPtr task = std::make_shared<Task>("delayed", [&, i]() {
+            executed[i] = Clock::now();
+            ++done;
+        });
+        timed_queue->schedule(group, task, deadlines[i]);
+    }
+
+    ASSERT_TRUE(waitFor(done, deadlines.size()));
+
+    for(std::size_t i = 0; i < deadlines.size(); ++i) {
+        EXPECT_GE(executed[i], deadlines[i]);
+    }
+}
+
+TEST_F(TimedQueueTest, LatenessIsRecordedPerTask)
+{
+    std::atomic<int> done(0);
+
+    TaskPtr task = std::make_shared<Task>("periodic", [&]() {
+        ++done;
+    });
+    TaskPtr other = std::make_shared<Task>("other", [](){});
+
+    for(int i = 0; i < 5; ++i) {
+        timed_queue->schedule(group, task, Clock::now() + std::chrono::milliseconds(2));
+        ASSERT_TRUE(waitFor(done, i + 1));
+    }
+
+    TimedQueue::Lateness lateness = timed_queue->getLateness(task);
+    EXPECT_EQ(5u, lateness.releases);
+    EXPECT_GE(lateness.last.count(), 0);
+    EXPECT_GE(lateness.max, lateness.mean());
+
+    EXPECT_EQ(0u, timed_queue->getLateness(other).releases);
+}
+
+TEST_F(TimedQueueTest, FarDeadlinesArePending)
+{
+    std::atomic<int> done(0);
+
+    TaskPtr task = std::make_shared<Task>("far", [&]() {
+        ++done;
+    });
+    timed_queue->schedule(group, task, Clock::now() + std::chrono::hours(2));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(0, done);
+    EXPECT_EQ(1u, timed_queue->size());
+}
+
+TEST_F(TimedQueueTest, EarlierDeadlineWakesUpSleepingTimer)
+{
+    std::atomic<int> done(0);
+
+    TaskPtr late = std::make_shared<Task>("late", [](){});
+    timed_queue->schedule(group, late, Clock::now() + std::chrono::seconds(30));
+
+    // give the timer thread time to go to sleep
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    TaskPtr early = std::make_shared<Task>("early", [&]() {
+        ++done;
+    });
+    auto start = Clock::now();
+    timed_queue->schedule(group, early, start + std::chrono::milliseconds(5));
+
+    ASSERT_TRUE(waitFor(done, 1));
+    EXPECT_LT(Clock::now() - start, std::chrono::seconds(1));
+}
@@ -0,0 +1,158 @@
+#include <csapex/model/token.h>
+#include <csapex/model/connection.h>
+#include <csapex/msg/input.h>
+#include <csapex/msg/static_output.h>
+#include <csapex/msg/io.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/msg/direct_connection.h>
+#include <csapex/msg/no_message.h>
+#include <csapex/utility/pool_allocator.hpp>
+#include <csapex/utility/uuid_provider.h>
+
+#include "gtest/gtest.h"
+
+/// SYSTEM
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+// this test runs in its own executable, the replaced operator new would affect all other tests
+namespace
+{
+// counts the allocations of the current thread while enabled
+thread_local bool count_allocations = false;
+thread_local long allocations = 0;
+}
+
+void* operator new(std::size_t size)
+{
+    if(count_allocations) {
+        ++allocations;
+    }
+    if(void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+using namespace csapex;
+using namespace connection_types;
+
+class TokenPoolTest : public ::testing::Test
+{
+protected:
+    TokenPoolTest()
+        : uuid_provider(std::make_shared<UUIDProvider>())
+    {
+    }
+
+    long countAllocations(const std::function<void()>& fn)
+    {
+        allocations = 0;
+        count_allocations = true;
+        fn();
+        count_allocations = false;
+        return allocations;
+    }
+
+    UUIDProviderPtr uuid_provider;
+};
+
+TEST_F(TokenPoolTest, MarkerPayloadsAreShared)
+{
+    TokenPtr a = Token::makeShared<NoMessage>();
+    TokenPtr b = Token::makeShared<NoMessage>();
+
+    EXPECT_NE(a, b);
+    EXPECT_EQ(a->getTokenData(), b->getTokenData());
+
+    // the meta data stays per token
+    a->setSequenceNumber(1);
+    b->setSequenceNumber(2);
+    EXPECT_EQ(1, a->getSequenceNumber());
+}
+
+TEST_F(TokenPoolTest, FreedTokensAreReused)
+{
+    TokenDataConstPtr data = makeSharedEmpty<NoMessage>();
+
+    Token* first = Token::make(data).get();
+    TokenPtr second = Token::make(data);
+    EXPECT_EQ(first, second.get());
+}
+
+TEST_F(TokenPoolTest, BlocksFreedOnOtherThreadsReturnToTheirPool)
+{
+    TokenDataConstPtr data = makeSharedEmpty<NoMessage>();
+
+    TokenPtr token = Token::make(data);
+    Token* address = token.get();
+    std::thread([&]() {
+        token.reset();
+    }).join();
+
+    // the block is handed back once the cached blocks of this thread, at most MAX_BLOCKS, are used up
+    std::vector<TokenPtr> tokens;
+    bool reused = false;
+    for(int n = 0; n < 4096 && !reused; ++n) {
+        tokens.push_back(Token::make(data));
+        reused = tokens.back().get() == address;
+    }
+    EXPECT_TRUE(reused);
+}
+
+TEST_F(TokenPoolTest, BlocksCanOutliveTheirThread)
+{
+    TokenDataConstPtr data = makeSharedEmpty<NoMessage>();
+
+    TokenPtr orphan;
+    std::thread([&]() {
+        orphan = Token::make(data);
+    }).join();
+
+    // the pool of the thread is gone, the block is freed through its control block
+    EXPECT_EQ(data, orphan->getTokenData());
+    orphan.reset();
+}
+
+TEST_F(TokenPoolTest, SteadyStatePublishingDoesNotAllocate)
+{
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+    ConnectionPtr connection = DirectConnection::connect(o, i);
+
+    auto send = [&](int val) {
+        msg::publish(o.get(), val);
+        o->commitMessages(false);
+        o->publish();
+    };
+
+    // the first messages fill the pools and set the type of the output
+    for(int val = 0; val < 10; ++val) {
+        send(val);
+    }
+    o->commitMessages(false);
+    o->publish();
+
+    long count = countAllocations([&]() {
+        for(int val = 0; val < 1000; ++val) {
+            send(val);
+        }
+    });
+    EXPECT_EQ(0, count);
+    EXPECT_EQ(999, msg::getValue<int>(i.get()));
+
+    // sending nothing only produces tokens with the shared NoMessage payload
+    count = countAllocations([&]() {
+        for(int val = 0; val < 1000; ++val) {
+            o->commitMessages(false);
+            o->publish();
+        }
+    });
+    EXPECT_EQ(0, count);
+}
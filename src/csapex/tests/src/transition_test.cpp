@@ -8,6 +8,7 @@
 #include <csapex/msg/direct_connection.h>
 #include <csapex/msg/direct_connection.h>
 #include <csapex/model/connection.h>
+#include <csapex/msg/buffered_connection.h>
 #include <csapex/utility/uuid_provider.h>
 #include <csapex/msg/output_transition.h>
 #include <csapex/msg/input_transition.h>
@@ -410,3 +411,50 @@ TEST_F(TransitionTest, TestBundledAndDirectConnectionsCanBeMixed)
         ASSERT_RECEIVED(*i2, iter);
     }
 }
+
+TEST_F(TransitionTest, BufferedConnectionDecouplesProducerAndConsumer)
+{
+    OutputTransition ot;
+    ot.addOutput(o1);
+
+    InputTransition it;
+    it.addInput(i1);
+
+    ConnectionPtr c = BufferedConnection::connect(o1, i1, 2);
+
+    int processed = 0;
+    ot.messages_processed.connect([&]() {
+        ++processed;
+    });
+
+    // the producer can continue as long as the buffer has space
+    ASSERT_TRUE(ot.canStartSendingMessages());
+    sendMessage(*o1, 0);
+    ot.sendMessages(false);
+    EXPECT_EQ(1, processed);
+
+    ASSERT_TRUE(ot.canStartSendingMessages());
+    sendMessage(*o1, 1);
+    ot.sendMessages(false);
+    EXPECT_EQ(1, processed);
+
+    EXPECT_FALSE(ot.canStartSendingMessages());
+    EXPECT_EQ(2u, c->getOccupancy());
+
+    // consuming the first token frees one slot
+    ASSERT_TRUE(it.isEnabled());
+    it.forwardMessages();
+    ASSERT_RECEIVED(*i1, 0);
+    it.notifyMessageProcessed();
+
+    EXPECT_EQ(2, processed);
+    EXPECT_TRUE(ot.canStartSendingMessages());
+
+    ASSERT_TRUE(it.isEnabled());
+    it.forwardMessages();
+    ASSERT_RECEIVED(*i1, 1);
+    it.notifyMessageProcessed();
+
+    EXPECT_FALSE(it.isEnabled());
+    EXPECT_EQ(0u, c->getOccupancy());
+}